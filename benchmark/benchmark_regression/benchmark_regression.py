@@ -0,0 +1,240 @@
+# Tencent is pleased to support the open source community by making TNN available.
+#
+# Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+#
+# Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+# in compliance with the License. You may obtain a copy of the License at
+#
+# https://opensource.org/licenses/BSD-3-Clause
+#
+# Unless required by applicable law or agreed to in writing, software distributed
+# under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+# CONDITIONS OF ANY KIND, either express or implied. See the License for the
+# specific language governing permissions and limitations under the License.
+
+"""Compare layer and model benchmark json against a baseline taken on the same machine.
+
+Each key (layer/shape/device/precision or model/shape/device/precision) is compared with a
+one sided Mann-Whitney U test on its samples. A key regresses when it is significantly slower
+and its median grew by more than the threshold. A bootstrap confidence interval of the median
+ratio is reported next to it.
+
+    compare: compare two json reports
+    run:     run layer_benchmark and TNNTest, then compare against the baseline, or store
+             the results as the baseline if there is none yet
+"""
+
+import argparse
+import fnmatch
+import glob
+import json
+import math
+import os
+import random
+import subprocess
+import sys
+import tempfile
+
+
+def load_samples(path):
+    with open(path) as f:
+        results = json.load(f)["results"]
+    return {key: value["samples_ms"] for key, value in results.items() if value.get("samples_ms")}
+
+
+def merge_samples(all_samples, samples):
+    for key, values in samples.items():
+        all_samples.setdefault(key, []).extend(values)
+
+
+def median(values):
+    values = sorted(values)
+    n = len(values)
+    return values[n // 2] if n % 2 else 0.5 * (values[n // 2 - 1] + values[n // 2])
+
+
+def mann_whitney_greater(current, baseline):
+    """p value of H1: current is stochastically greater than baseline, normal approximation with tie correction."""
+    n1, n2 = len(current), len(baseline)
+    merged = sorted([(v, 0) for v in current] + [(v, 1) for v in baseline])
+    ranks = [0.0] * len(merged)
+    tie_sum = 0.0
+    i = 0
+    while i < len(merged):
+        j = i
+        while j + 1 < len(merged) and merged[j + 1][0] == merged[i][0]:
+            j += 1
+        for k in range(i, j + 1):
+            ranks[k] = 0.5 * (i + j) + 1
+        t = j - i + 1
+        tie_sum += t * t * t - t
+        i = j + 1
+    rank_sum = sum(rank for rank, (_, group) in zip(ranks, merged) if group == 0)
+    u = rank_sum - n1 * (n1 + 1) / 2.0
+    n = n1 + n2
+    variance = n1 * n2 / 12.0 * ((n + 1) - tie_sum / (n * (n - 1)))
+    if variance <= 0:
+        return 0.5
+    z = (u - n1 * n2 / 2.0 - 0.5) / math.sqrt(variance)
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def bootstrap_median_ratio(current, baseline, resamples=2000, confidence=0.95):
+    rng = random.Random(0)
+    ratios = []
+    for _ in range(resamples):
+        c = median([rng.choice(current) for _ in current])
+        b = median([rng.choice(baseline) for _ in baseline])
+        ratios.append(c / b if b > 0 else float("inf"))
+    ratios.sort()
+    low = ratios[int((1 - confidence) / 2 * resamples)]
+    high = ratios[min(int((1 + confidence) / 2 * resamples), resamples - 1)]
+    return low, high
+
+
+def key_threshold(key, threshold, overrides):
+    # the last matching override wins, ie, --threshold-override "*/int8=0.1"
+    for pattern, value in overrides:
+        if fnmatch.fnmatch(key, pattern):
+            threshold = value
+    return threshold
+
+
+def compare(baseline, current, threshold, overrides, alpha, min_samples):
+    rows = []
+    for key in sorted(set(baseline) | set(current)):
+        row = {"key": key}
+        if key not in current:
+            row["status"] = "missing"
+        elif key not in baseline:
+            row["status"] = "new"
+        elif len(current[key]) < min_samples or len(baseline[key]) < min_samples:
+            row["status"] = "too_few_samples"
+        else:
+            base, cur = baseline[key], current[key]
+            row["baseline_median_ms"] = median(base)
+            row["current_median_ms"] = median(cur)
+            row["change"] = row["current_median_ms"] / row["baseline_median_ms"] - 1
+            row["p_slower"] = mann_whitney_greater(cur, base)
+            row["p_faster"] = mann_whitney_greater(base, cur)
+            row["ratio_ci"] = bootstrap_median_ratio(cur, base)
+            row["threshold"] = key_threshold(key, threshold, overrides)
+            if row["p_slower"] < alpha and row["change"] > row["threshold"]:
+                row["status"] = "regression"
+            elif row["p_faster"] < alpha and -row["change"] > row["threshold"]:
+                row["status"] = "improvement"
+            else:
+                row["status"] = "unchanged"
+        rows.append(row)
+    return rows
+
+
+def print_rows(rows):
+    for row in rows:
+        if "change" in row:
+            print("%-12s %-70s %9.3f -> %9.3f ms  %+7.2f%%  ratio ci [%.3f, %.3f]  p = %.2g" % (
+                row["status"], row["key"], row["baseline_median_ms"], row["current_median_ms"],
+                row["change"] * 100, row["ratio_ci"][0], row["ratio_ci"][1],
+                row["p_slower"] if row["change"] >= 0 else row["p_faster"]))
+        else:
+            print("%-12s %s" % (row["status"], row["key"]))
+    regressions = [row for row in rows if row["status"] == "regression"]
+    print("%d keys compared, %d regressions, %d improvements" % (
+        len([row for row in rows if "change" in row]), len(regressions),
+        len([row for row in rows if row["status"] == "improvement"])))
+    return regressions
+
+
+def compare_and_report(baseline, current, args):
+    rows = compare(baseline, current, args.threshold, args.threshold_override, args.alpha, args.min_samples)
+    regressions = print_rows(rows)
+    if args.report:
+        with open(args.report, "w") as f:
+            json.dump({"rows": rows}, f, indent=2)
+    return 1 if regressions else 0
+
+
+def run_benchmarks(args):
+    samples = {}
+    work_dir = tempfile.mkdtemp(prefix="tnn_benchmark_")
+    for run in range(args.runs):
+        if args.layer_benchmark:
+            path = os.path.join(work_dir, "layer_%d.json" % run)
+            command = [args.layer_benchmark, "-dt", args.device, "-th", str(args.threads), "-ic", str(args.repeat),
+                       "-wc", str(args.warmup), "-bp", args.precisions, "-op", path]
+            if args.layer_filter:
+                command += ["-bf", args.layer_filter]
+            subprocess.check_call(command, stdout=subprocess.DEVNULL)
+            merge_samples(samples, load_samples(path))
+        for model in args.model:
+            for proto in sorted(glob.glob(model)):
+                path = os.path.join(work_dir, "model_%d.json" % run)
+                command = [args.tnntest, "-mp", proto, "-dt", args.device, "-th", str(args.threads), "-ic",
+                           str(args.repeat), "-wc", str(args.warmup), "-bj", path]
+                subprocess.check_call(command, stdout=subprocess.DEVNULL)
+                if not os.path.exists(path):
+                    # TNNTest still exits with 0 if the model fails to load, ie, no weights outside benchmark mode
+                    raise RuntimeError("TNNTest wrote no timings for %s" % proto)
+                merge_samples(samples, load_samples(path))
+                os.remove(path)
+    return samples
+
+
+def write_samples(path, samples):
+    with open(path, "w") as f:
+        json.dump({"results": {key: {"samples_ms": values} for key, values in samples.items()}}, f, indent=1)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--threshold", type=float, default=0.05,
+                        help="relative growth of the median that counts as a regression, default 0.05")
+    parser.add_argument("--threshold-override", action="append", default=[],
+                        type=lambda s: (s.rsplit("=", 1)[0], float(s.rsplit("=", 1)[1])),
+                        help="per key threshold as <key pattern>=<threshold>, ie, */int8=0.1")
+    parser.add_argument("--alpha", type=float, default=0.01, help="significance level, default 0.01")
+    parser.add_argument("--min-samples", type=int, default=8, help="keys with fewer samples are not judged")
+    parser.add_argument("--report", help="write the comparison in json")
+    subparsers = parser.add_subparsers(dest="command")
+
+    compare_parser = subparsers.add_parser("compare", help="compare two benchmark json reports")
+    compare_parser.add_argument("baseline")
+    compare_parser.add_argument("current")
+
+    run_parser = subparsers.add_parser("run", help="run the benchmarks and compare against the baseline")
+    run_parser.add_argument("--baseline", required=True, help="baseline json, created if it does not exist")
+    run_parser.add_argument("--update-baseline", action="store_true",
+                            default=os.environ.get("TNN_UPDATE_BENCHMARK_BASELINE") == "1",
+                            help="store the results as the new baseline, or set TNN_UPDATE_BENCHMARK_BASELINE=1")
+    run_parser.add_argument("--layer-benchmark", help="path of the layer_benchmark binary")
+    run_parser.add_argument("--layer-filter", help="only run the layer cases whose layer name contains it")
+    run_parser.add_argument("--precisions", default="fp32,bfp16,int8")
+    run_parser.add_argument("--tnntest", help="path of the TNNTest binary")
+    run_parser.add_argument("--model", action="append", default=[], help="tnnproto path or glob, repeatable")
+    run_parser.add_argument("--device", default="ARM")
+    run_parser.add_argument("--threads", type=int, default=1)
+    run_parser.add_argument("--runs", type=int, default=3, help="benchmark processes, their samples are merged")
+    run_parser.add_argument("--repeat", type=int, default=10, help="timed iterations of each case in each run")
+    run_parser.add_argument("--warmup", type=int, default=3)
+    run_parser.add_argument("--output", help="also write the merged samples of this run")
+
+    args = parser.parse_args()
+    if args.command == "compare":
+        return compare_and_report(load_samples(args.baseline), load_samples(args.current), args)
+    if args.command == "run":
+        if args.model and not args.tnntest:
+            parser.error("--model needs --tnntest")
+        current = run_benchmarks(args)
+        if args.output:
+            write_samples(args.output, current)
+        if args.update_baseline or not os.path.exists(args.baseline):
+            write_samples(args.baseline, current)
+            print("stored %d keys as the baseline %s" % (len(current), args.baseline))
+            return 0
+        return compare_and_report(load_samples(args.baseline), current, args)
+    parser.print_help()
+    return 1
+
+
+if __name__ == "__main__":
+    sys.exit(main())
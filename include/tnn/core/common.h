@@ -151,6 +151,29 @@ struct PUBLIC ModelConfig {
     }
 };
 
+// time of a startup phase, in ms
+struct PUBLIC StartupPhase {
+    std::string name;
+    double time_ms = 0;
+};
+
+// time of a layer Init, including the weight packing and conversion done by the layer acc
+struct PUBLIC LayerInitTime {
+    std::string layer_name;
+    std::string type_name;
+    double time_ms = 0;
+};
+
+// time spent in TNN::Init or in CreateInst
+struct PUBLIC StartupStats {
+    // in the order the phases ran
+    std::vector<StartupPhase> phases;
+    // the layers slowest to init, slowest first. empty for TNN::GetStartupStats
+    std::vector<LayerInitTime> slowest_layers;
+    // sum of the phases
+    double total_ms = 0;
+};
+
 }  // namespace TNN_NS
 
 #pragma warning(pop)
@@ -17,6 +17,7 @@
 
 #include <functional>
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "tnn/core/blob.h"
@@ -35,6 +36,67 @@ class AbstractModelInterpreter;
 
 struct LayerInfo;
 
+// memory held by an instance, in bytes
+struct PUBLIC MemoryStats {
+    // activation arena of the blob memory pool, shared by the instances of one thread in
+    // SHARE_MEMORY_MODE_SHARE_ONE_THREAD
+    size_t activation_bytes = 0;
+    // weights of the model resource, shared by the instances created from the same TNN
+    size_t weight_bytes = 0;
+    // weights the layer accs packed or converted, ie, winograd filters or fp32 copies of bfp16 weights
+    size_t packed_weight_bytes = 0;
+    // work space of the device context, it grows during the first forward
+    size_t workspace_bytes = 0;
+    // output mats cached by GetOutputMat
+    size_t mat_cache_bytes = 0;
+    // sum of the above
+    size_t total_bytes = 0;
+
+    // bytes allocated through the device Allocate/Free by all instances on it, and the peak since
+    // the process started. only counted by the devices that report their allocations.
+    size_t device_current_bytes = 0;
+    size_t device_peak_bytes    = 0;
+};
+
+typedef enum {
+    HEALTH_ALERT_NAN             = 0x01,
+    HEALTH_ALERT_INF             = 0x02,
+    // a finite value beyond HealthMonitorConfig::abs_max_threshold
+    HEALTH_ALERT_OVERFLOW        = 0x04,
+    // too many int8 values clamped to -128 or 127, the blob scale is likely too small
+    HEALTH_ALERT_INT8_SATURATION = 0x08,
+} PUBLIC HealthAlert;
+
+// statistics of a layer output blob, padding channels of packed layouts are skipped
+struct PUBLIC BlobHealthStats {
+    std::string layer_name;
+    std::string blob_name;
+    DataType data_type = DATA_TYPE_FLOAT;
+    // of the finite values, int8 blobs are reported in quantized units
+    float min  = 0;
+    float max  = 0;
+    float mean = 0;
+    long long count           = 0;
+    long long nan_count       = 0;
+    long long inf_count       = 0;
+    long long saturated_count = 0;
+    // HealthAlert flags raised by the blob
+    int alerts = 0;
+};
+
+typedef std::function<void(const BlobHealthStats& stats)> HealthAlertCallback;
+
+struct PUBLIC HealthMonitorConfig {
+    // check the layer outputs of one in sample_interval forwards
+    int sample_interval = 100;
+    // alert when a finite value exceeds it, 0 disables it. 65504 warns before fp16 overflows.
+    float abs_max_threshold = 0;
+    // alert when the ratio of int8 values clamped to -128 or 127 exceeds it
+    float int8_saturation_ratio = 0.01f;
+    // called on the forward thread for each blob that raises an alert
+    HealthAlertCallback callback = nullptr;
+};
+
 #ifdef FORWARD_CALLBACK_ENABLE
 typedef std::function<void(std::vector<Blob*>& blobs, LayerInfo* info)> BlobStatisticCallback;
 #endif  // end of FORWARD_CALLBACK_ENABLE
@@ -87,6 +149,49 @@ public:
 
     // set threads run on cpu
     virtual Status SetCpuNumThreads(int num_threads);
+
+    // enable or disable the per layer profiler, available in release builds.
+    // while enabled, each layer is synchronized and timed during forward.
+    Status SetLayerProfilerEnabled(bool enable);
+
+    // set the machine peak GFLOP/s and GB/s, the layer profiler summary then reports the
+    // utilization of each layer and whether it is compute bound or bandwidth bound.
+    Status SetLayerProfilerMachinePeak(double peak_gflops, double peak_gbytes_per_second);
+
+    // keep the last max_events layer forwards, 65536 by default, zero keeps all of them. older ones are
+    // dropped and their count is reported as dropped_events in the trace and the summary.
+    Status SetLayerProfilerMaxEvents(size_t max_events);
+
+    // read cycles, instructions, l1d/llc misses and branch misses around each layer with linux
+    // perf_event_open, the summary then reports ipc and the misses per kilo instructions. call it
+    // after SetLayerProfilerEnabled, the counters count the thread running Forward and its openmp threads.
+    // counters the kernel or cpu does not support are skipped, it fails if none is available.
+    Status SetLayerProfilerCountersEnabled(bool enable);
+
+    // get the recorded layer times as chrome trace event json, open it in chrome://tracing
+    Status GetLayerProfilerTrace(std::string& trace);
+
+    // get the per layer summary json: layer, op, shapes, mean/p50/p99 time, call count and thread ids
+    Status GetLayerProfilerSummary(std::string& summary);
+
+    // clear the recorded layer times
+    Status ResetLayerProfiler();
+
+    // get the memory held by the instance, see MemoryStats
+    Status GetMemoryStats(MemoryStats& stats);
+
+    // get the time spent to create the instance: context creation, blob manager init, layer init
+    // including the weight packing, memory allocation and the first reshape, with the top_n layers
+    // slowest to init.
+    Status GetStartupStats(StartupStats& stats, int top_n = 10);
+
+    // enable or disable the numerical health monitor, cpu devices only. on the sampled forwards it
+    // computes min/max/mean and nan/inf counts of every layer output and calls config.callback on alerts.
+    Status SetHealthMonitorEnabled(bool enable, HealthMonitorConfig config = HealthMonitorConfig());
+
+    // get the blob statistics of the last sampled forward
+    Status GetHealthStats(std::vector<BlobHealthStats>& stats);
+
 #if TNN_PROFILE
 public:
     /**start to profile each layer, dont call this func if you only want to profile the whole mode*/
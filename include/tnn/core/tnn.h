@@ -53,6 +53,11 @@ public:
         NetworkConfig& config, Status& status,
         InputShapesMap inputs_shape = InputShapesMap());
 
+    // get the time spent in Init: proto parse and model deserialization, then one optimize
+    // phase for each network optimized by CreateInst, the optimized network is shared by the
+    // instances with the same device and precision. see Instance::GetStartupStats for the rest.
+    Status GetStartupStats(StartupStats& stats);
+
 private:
     std::shared_ptr<TNNImpl> impl_ = nullptr;
 };
@@ -14,6 +14,7 @@
 
 #include "tnn/core/abstract_device.h"
 
+#include <algorithm>
 #include <map>
 #include <mutex>
 
@@ -27,6 +28,31 @@ DeviceType AbstractDevice::GetDeviceType() {
     return device_type_;
 }
 
+void AbstractDevice::GetAllocatedBytes(size_t& current_bytes, size_t& peak_bytes) {
+    std::lock_guard<std::mutex> guard(allocation_mutex_);
+    current_bytes = allocated_bytes_;
+    peak_bytes    = peak_allocated_bytes_;
+}
+
+void AbstractDevice::OnAllocate(void* handle, size_t bytes) {
+    if (!handle) {
+        return;
+    }
+    std::lock_guard<std::mutex> guard(allocation_mutex_);
+    allocation_bytes_[handle] = bytes;
+    allocated_bytes_ += bytes;
+    peak_allocated_bytes_ = std::max(peak_allocated_bytes_, allocated_bytes_);
+}
+
+void AbstractDevice::OnFree(void* handle) {
+    std::lock_guard<std::mutex> guard(allocation_mutex_);
+    auto iter = allocation_bytes_.find(handle);
+    if (iter != allocation_bytes_.end()) {
+        allocated_bytes_ -= iter->second;
+        allocation_bytes_.erase(iter);
+    }
+}
+
 AbstractDevice* GetDevice(DeviceType type) {
     return GetGlobalDeviceMap()[type].get();
 }
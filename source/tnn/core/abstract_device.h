@@ -15,6 +15,9 @@
 #ifndef TNN_SOURCE_TNN_CORE_ABSTRACT_DEVICE_H_
 #define TNN_SOURCE_TNN_CORE_ABSTRACT_DEVICE_H_
 
+#include <map>
+#include <mutex>
+
 #include "tnn/core/abstract_layer_acc.h"
 #include "tnn/core/blob.h"
 #include "tnn/core/common.h"
@@ -73,8 +76,23 @@ public:
     // @brief get factory device type
     DeviceType GetDeviceType();
 
+    // @brief bytes currently allocated through the device by all instances, and the peak of it
+    void GetAllocatedBytes(size_t& current_bytes, size_t& peak_bytes);
+
+protected:
+    // @brief record the bytes of a handle returned by Allocate
+    void OnAllocate(void* handle, size_t bytes);
+
+    // @brief forget the handle released by Free
+    void OnFree(void* handle);
+
 private:
     DeviceType device_type_;
+
+    std::mutex allocation_mutex_;
+    std::map<void*, size_t> allocation_bytes_;
+    size_t allocated_bytes_      = 0;
+    size_t peak_allocated_bytes_ = 0;
 };
 
 // @brief GetGlobalDeviceMap device type map
@@ -93,6 +93,7 @@ void AbstractLayerAcc::UpdateProfilingData(ProfilingData *pdata, LayerParam *par
         }
     }
 }
+#endif
 
 double AbstractLayerAcc::GetFlops() {
     return 0;
@@ -101,7 +102,10 @@ double AbstractLayerAcc::GetFlops() {
 double AbstractLayerAcc::GetBandwidth() {
     return 0;
 }
-#endif
+
+size_t AbstractLayerAcc::GetPackedWeightBytes() {
+    return 0;
+}
 
 Status AbstractLayerAcc::ResolveBlobDataFormat(Blob *blob) {
     BlobDesc desc                        = blob->GetBlobDesc();
@@ -55,11 +55,18 @@ public:
     // @return execution result
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) = 0;
 
+    // @brief mega flops of one forward, 0 if unknown
+    virtual double GetFlops();
+
+    // @brief mega bytes read and written by one forward, 0 if unknown
+    virtual double GetBandwidth();
+
+    // @brief bytes of the weights the acc packed or converted from the layer resource, 0 if none
+    virtual size_t GetPackedWeightBytes();
+
 #if TNN_PROFILE
     virtual void UpdateProfilingData(ProfilingData *pdata, LayerParam *param, DimsVector input_dim,
                                      DimsVector output_dim);
-    virtual double GetFlops();
-    virtual double GetBandwidth();
 #endif
 
 private:
@@ -28,6 +28,60 @@ Status AbstractNetwork::SetCpuNumThreads(int num_threads) {
     return TNN_OK;
 }
 
+Status AbstractNetwork::SetLayerProfilerEnabled(bool enable) {
+    LOGE("layer profiler is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "layer profiler is not supported by this network");
+}
+
+Status AbstractNetwork::SetLayerProfilerMachinePeak(double peak_gflops, double peak_gbytes_per_second) {
+    LOGE("layer profiler is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "layer profiler is not supported by this network");
+}
+
+Status AbstractNetwork::SetLayerProfilerMaxEvents(size_t max_events) {
+    LOGE("layer profiler is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "layer profiler is not supported by this network");
+}
+
+Status AbstractNetwork::SetLayerProfilerCountersEnabled(bool enable) {
+    LOGE("layer profiler is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "layer profiler is not supported by this network");
+}
+
+Status AbstractNetwork::GetLayerProfilerTrace(std::string &trace) {
+    LOGE("layer profiler is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "layer profiler is not supported by this network");
+}
+
+Status AbstractNetwork::GetLayerProfilerSummary(std::string &summary) {
+    LOGE("layer profiler is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "layer profiler is not supported by this network");
+}
+
+Status AbstractNetwork::ResetLayerProfiler() {
+    return TNN_OK;
+}
+
+Status AbstractNetwork::GetMemoryStats(MemoryStats &stats) {
+    LOGE("memory stats is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "memory stats is not supported by this network");
+}
+
+Status AbstractNetwork::SetHealthMonitorEnabled(bool enable, HealthMonitorConfig config) {
+    LOGE("health monitor is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "health monitor is not supported by this network");
+}
+
+Status AbstractNetwork::GetHealthStats(std::vector<BlobHealthStats> &stats) {
+    LOGE("health monitor is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "health monitor is not supported by this network");
+}
+
+Status AbstractNetwork::GetStartupStats(StartupStats &stats, int top_n) {
+    LOGE("startup stats is not supported by this network\n");
+    return Status(TNNERR_UNSUPPORT_NET, "startup stats is not supported by this network");
+}
+
 #if TNN_PROFILE
 void AbstractNetwork::StartProfile() {
     LOGE("subclass should implement the func: StartProfile\n");
@@ -90,6 +90,39 @@ public:
     // @brief set threads run on device
     virtual Status SetCpuNumThreads(int num_threads);
 
+    // @brief enable or disable the per layer profiler at runtime
+    virtual Status SetLayerProfilerEnabled(bool enable);
+
+    // @brief set the machine peak the layer profiler compares each layer against
+    virtual Status SetLayerProfilerMachinePeak(double peak_gflops, double peak_gbytes_per_second);
+
+    // @brief set how many layer forwards the layer profiler keeps
+    virtual Status SetLayerProfilerMaxEvents(size_t max_events);
+
+    // @brief read the hardware counters around each layer in the layer profiler
+    virtual Status SetLayerProfilerCountersEnabled(bool enable);
+
+    // @brief get the recorded layer times in chrome trace event json
+    virtual Status GetLayerProfilerTrace(std::string &trace);
+
+    // @brief get the per layer time summary in json
+    virtual Status GetLayerProfilerSummary(std::string &summary);
+
+    // @brief clear the recorded layer times
+    virtual Status ResetLayerProfiler();
+
+    // @brief get the memory held by the network
+    virtual Status GetMemoryStats(MemoryStats &stats);
+
+    // @brief enable or disable the numerical health monitor of the layer outputs
+    virtual Status SetHealthMonitorEnabled(bool enable, HealthMonitorConfig config);
+
+    // @brief get the blob statistics of the last sampled forward
+    virtual Status GetHealthStats(std::vector<BlobHealthStats> &stats);
+
+    // @brief get the time spent in Init with the top_n layers slowest to init
+    virtual Status GetStartupStats(StartupStats &stats, int top_n);
+
 #if TNN_PROFILE
 public:
     virtual void StartProfile();
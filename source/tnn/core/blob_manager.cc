@@ -18,6 +18,9 @@
 #include <cstring>
 #include <set>
 
+#include "tnn/core/layer_type.h"
+#include "tnn/interpreter/layer_param.h"
+
 #include "tnn/memory_manager/blob_memory_pool_factory.h"
 #include "tnn/memory_manager/blob_memory_size_info.h"
 #include "tnn/memory_manager/memory_mode_state_factory.h"
@@ -30,6 +33,7 @@ namespace TNN_NS {
 BlobManager::BlobManager(AbstractDevice *device) {
     device_            = device;
     blob_memory_pool_  = BlobMemoryPoolFactory::CreateBlobMemoryPool(device);
+    view_memory_pool_  = BlobMemoryPoolFactory::CreateBlobMemoryPool(device);
     net_structure_     = nullptr;
     memory_mode_state_ = nullptr;
 }
@@ -41,6 +45,11 @@ BlobManager::~BlobManager() {
         delete blob_memory_pool_;
         blob_memory_pool_ = NULL;
     }
+
+    if (view_memory_pool_ != NULL) {
+        delete view_memory_pool_;
+        view_memory_pool_ = NULL;
+    }
 }
 
 Status BlobManager::Init(NetworkConfig &config, NetStructure *net_structure, InputShapesMap inputs_shape_map,
@@ -138,7 +147,11 @@ Status BlobManager::AllocateBlobMemory() {
     /*
      *  We reuse blob memory of the previos layers if it is not referenced.
      *  So, a use_count is calculated here.
+     *  The output of a view layer shares the blob memory of its input,
+     *  the use_count of the output is added to the shared blob memory.
      */
+    view_layers_.clear();
+    detached_view_layers_.clear();
     for (int layer_index = 0; layer_index < net_structure_->layers.size(); layer_index++) {
         LayerInfo *layer_info = net_structure_->layers[layer_index].get();
         // allocating blob memory for every out nodes of this layer
@@ -150,6 +163,13 @@ Status BlobManager::AllocateBlobMemory() {
                 return Status(TNNERR_LAYER_ERR, "blob dims is invaid");
             }
 
+            if (blob_memory_mapping_.find(current_blob) == blob_memory_mapping_.end() && IsViewLayer(layer_info)) {
+                BlobMemory *blob_memory = blob_memory_mapping_[blobs_[layer_info->inputs[0]]];
+                blob_memory->SetUseCount(blob_memory->GetUseCount() + GetBlobUseCount(layer_index, current_blob_name));
+                blob_memory_mapping_.insert(std::make_pair(current_blob, blob_memory));
+                view_layers_.push_back(layer_info);
+            }
+
             if (blob_memory_mapping_.find(current_blob) == blob_memory_mapping_.end()) {
                 // calculate the use count of this blob
                 int use_count = GetBlobUseCount(layer_index, current_blob_name);
@@ -225,6 +245,122 @@ int BlobManager::GetBlobUseCount(int layer_index, std::string current_blob_name)
     return use_count;
 }
 
+/*
+ * A view layer only changes the dims of its input, it is legal to share the memory
+ * when the data of the output is laid out the same as the input:
+ *  NCHW: any reshape and any permute keeping the order of non-one dims.
+ *  NC4HW4/NHWC4: batch and channel are unchanged, only h and w are reshaped.
+ */
+bool BlobManager::IsViewLayer(LayerInfo *layer_info) {
+    if (layer_info->inputs.size() != 1 || layer_info->outputs.size() != 1 ||
+        input_blobs_.count(layer_info->inputs[0]) > 0) {
+        return false;
+    }
+
+    if (layer_info->type == LAYER_RESHAPE) {
+        auto param = dynamic_cast<ReshapeLayerParam *>(layer_info->param.get());
+        if (!param || param->reshape_type != 0) {
+            return false;
+        }
+    } else if (layer_info->type != LAYER_FLATTEN && layer_info->type != LAYER_PERMUTE) {
+        return false;
+    }
+
+    auto &input_desc  = blobs_[layer_info->inputs[0]]->GetBlobDesc();
+    auto &output_desc = blobs_[layer_info->outputs[0]]->GetBlobDesc();
+    auto &input_dims  = input_desc.dims;
+    auto &output_dims = output_desc.dims;
+    if (input_desc.data_type != output_desc.data_type || input_desc.data_format != output_desc.data_format ||
+        DimsVectorUtils::Count(input_dims) != DimsVectorUtils::Count(output_dims)) {
+        return false;
+    }
+
+    if (layer_info->type == LAYER_PERMUTE) {
+        auto param = dynamic_cast<PermuteLayerParam *>(layer_info->param.get());
+        if (!param || param->orders.size() != input_dims.size()) {
+            return false;
+        }
+        int last_order = -1;
+        for (auto order : param->orders) {
+            if (order < 0 || order >= input_dims.size()) {
+                return false;
+            }
+            if (input_dims[order] == 1) {
+                continue;
+            }
+            if (order < last_order) {
+                return false;
+            }
+            last_order = order;
+        }
+    }
+
+    if (input_desc.data_format == DATA_FORMAT_NCHW) {
+        return true;
+    } else if (input_desc.data_format == DATA_FORMAT_NC4HW4 || input_desc.data_format == DATA_FORMAT_NHWC4) {
+        return input_dims.size() >= 2 && output_dims.size() >= 2 && input_dims[0] == output_dims[0] &&
+               input_dims[1] == output_dims[1];
+    }
+    return false;
+}
+
+// the blob memory holds blobs of the size, every dim of the memory is at least the dim of the size
+static bool BlobMemoryFits(const BlobMemorySizeInfo &memory_info, const BlobMemorySizeInfo &size_info) {
+    if (memory_info.data_type != size_info.data_type || memory_info.dims.size() != size_info.dims.size()) {
+        return false;
+    }
+    for (int i = 0; i < memory_info.dims.size(); i++) {
+        if (memory_info.dims[i] < size_info.dims[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/*
+ * A view layer legal at Init may not be after reshape, e.g. a permute over a dim that was 1.
+ * Its output gets blob memory of its own and the layer copies the data again. The memory is
+ * sized for the larger of the shared memory and the current dims, and grown by a later reshape
+ * needing more.
+ */
+Status BlobManager::DetachInvalidViewBlobs() {
+    for (auto iter = view_layers_.begin(); iter != view_layers_.end();) {
+        LayerInfo *layer_info = *iter;
+        if (IsViewLayer(layer_info)) {
+            ++iter;
+            continue;
+        }
+        LOGD("view layer %s can not share memory after reshape, copy it\n", layer_info->name.c_str());
+        detached_view_layers_.push_back(layer_info);
+        iter = view_layers_.erase(iter);
+    }
+
+    for (auto layer_info : detached_view_layers_) {
+        Blob *output_blob        = blobs_[layer_info->outputs[0]];
+        BlobMemory *blob_memory  = blob_memory_mapping_[output_blob];
+        BlobMemorySizeInfo info  = device_->Calculate(output_blob->GetBlobDesc());
+        BlobMemorySizeInfo owned = blob_memory->GetBlobMemorySizeInfo();
+        bool shared              = blob_memory == blob_memory_mapping_[blobs_[layer_info->inputs[0]]];
+        if (!shared && BlobMemoryFits(owned, info)) {
+            continue;
+        }
+
+        if (owned.data_type == info.data_type && owned.dims.size() == info.dims.size()) {
+            for (int i = 0; i < info.dims.size(); i++) {
+                info.dims[i] = std::max(info.dims[i], owned.dims[i]);
+            }
+        }
+        blob_memory   = view_memory_pool_->BorrowBlobMemory(1, info, true);
+        Status status = blob_memory->AllocateHandle();
+        if (status != TNN_OK) {
+            return status;
+        }
+        blob_memory_mapping_[output_blob] = blob_memory;
+        output_blob->SetHandle(blob_memory->GetHandle());
+    }
+    return TNN_OK;
+}
+
 Status BlobManager::DeInit() {
     if (config_.share_memory_mode == SHARE_MEMORY_MODE_SHARE_ONE_THREAD) {
         SharedMemoryManager::ReleaseSharedMemory(init_thread_id_, device_, config_.device_id, this);
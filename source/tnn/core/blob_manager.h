@@ -19,6 +19,7 @@
 #include <memory>
 #include <string>
 #include <thread>
+#include <vector>
 
 #include "tnn/core/abstract_device.h"
 #include "tnn/core/blob.h"
@@ -79,19 +80,30 @@ public:
     // @brief replace blob with new_blob, and delete the original blob if exist
     void ReplaceBlob(std::string name, Blob *new_blob);
 
+    // @brief give the outputs of view layers that can no longer share memory with their inputs after
+    // reshape blob memory of their own, large enough for the current dims
+    Status DetachInvalidViewBlobs();
+
 private:
     void BindBlobMemory();
     int GetBlobUseCount(int layer_index, std::string current_blob_name);
+    bool IsViewLayer(LayerInfo *layer_info);
 
     NetworkConfig config_;
     NetStructure *net_structure_;
     BlobMemoryPool *blob_memory_pool_;
+    // blob memory of view outputs detached after reshape, allocated separately from the forward memory
+    BlobMemoryPool *view_memory_pool_;
     AbstractDevice *device_;
     BlobMap input_blobs_;
     BlobMap output_blobs_;
     std::shared_ptr<MemoryAssignStrategy> strategy_;
     std::map<std::string, Blob *> blobs_;
     std::map<Blob *, BlobMemory *> blob_memory_mapping_;
+    // layers whose output shares the blob memory of the input
+    std::vector<LayerInfo *> view_layers_;
+    // view layers whose output got blob memory of its own after reshape
+    std::vector<LayerInfo *> detached_view_layers_;
 
     std::thread::id init_thread_id_;
     MemoryModeState *memory_mode_state_;
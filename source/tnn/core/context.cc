@@ -31,6 +31,10 @@ Status Context::SetNumThreads(int num_threads) {
     return TNN_OK;
 }
 
+size_t Context::GetWorkSpaceBytes() {
+    return 0;
+}
+
 #if TNN_PROFILE
 void Context::StartProfile() {
     profile_layer     = true;
@@ -48,6 +48,9 @@ public:
     // @brief set threads run on device
     virtual Status SetNumThreads(int num_threads);
 
+    // @brief bytes of the work space shared by the layers of the instance
+    virtual size_t GetWorkSpaceBytes();
+
 #if TNN_PROFILE
 public:
     virtual void StartProfile();
@@ -16,15 +16,19 @@
 
 #include <string.h>
 
+#include <algorithm>
+
 #include "tnn/core/blob_int8.h"
+#include "tnn/core/layer_profiler.h"
 #include "tnn/core/profile.h"
+#include "tnn/core/startup_timer.h"
 #include "tnn/interpreter/default_model_interpreter.h"
 #include "tnn/interpreter/layer_param.h"
 #include "tnn/interpreter/layer_resource_generator.h"
-#include "tnn/optimizer/net_optimizer_manager.h"
 #include "tnn/utils/blob_dump_utils.h"
 #include "tnn/utils/blob_transfer_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/layer_cost_utils.h"
 
 namespace TNN_NS {
 
@@ -64,6 +68,9 @@ Status DefaultNetwork::Init(NetworkConfig &net_config, ModelConfig &model_config
         return Status(TNNERR_NULL_PARAM, "network_ is nil, network_type may not support");
     }
 
+    StartupTimer timer;
+    startup_stats_ = StartupStats();
+
     device_ = GetDevice(net_config.device_type);
     if (device_ == NULL) {
         return TNNERR_DEVICE_NOT_SUPPORT;
@@ -78,38 +85,44 @@ Status DefaultNetwork::Init(NetworkConfig &net_config, ModelConfig &model_config
     if (ret != TNN_OK) {
         return ret;
     }
+    timer.Lap("context_create", startup_stats_.phases);
 
-    /*
-     * The NetOptimizeManager holds a list of network optimization processes.
-     * The optimization process may change the network structure accoundingly.
-     * eg. fuse conv+bn, conv+relu.
-     */
-    ret = optimizer::NetOptimizerManager::Optimize(net_structure, net_resource, net_config.device_type);
-    if (ret != TNN_OK) {
-        return ret;
-    }
-
+    // the network has been optimized for the device by TNNImplDefault, see GetOptimizedInterpreter
     blob_manager_ = new BlobManager(device_);
 
     ret = blob_manager_->Init(net_config, net_structure, inputs_shape, GetNetResourceDataType(net_resource));
     if (ret != TNN_OK) {
         return ret;
     }
+    timer.Lap("blob_manager_init", startup_stats_.phases);
 
     ret = InitLayers(net_structure, net_resource);
     if (ret != TNN_OK) {
         return ret;
     }
+    timer.Lap("layer_init", startup_stats_.phases);
+
+    ReportEliminatedReformats(net_structure);
 
     ret = blob_manager_->AllocateBlobMemory();
     if (ret != TNN_OK) {
         return ret;
     }
+    timer.Lap("memory_allocate", startup_stats_.phases);
 
     net_structure_ = net_structure;
+    net_resource_  = net_resource;
 
     InputShapesMap input_shape_map;
-    return Reshape(input_shape_map);
+    ret = Reshape(input_shape_map);
+    timer.Lap("reshape", startup_stats_.phases);
+
+    for (auto &phase : startup_stats_.phases) {
+        startup_stats_.total_ms += phase.time_ms;
+    }
+    std::stable_sort(startup_stats_.slowest_layers.begin(), startup_stats_.slowest_layers.end(),
+                     [](const LayerInitTime &a, const LayerInitTime &b) { return a.time_ms > b.time_ms; });
+    return ret;
 }
 
 /*
@@ -215,17 +228,43 @@ Status DefaultNetwork::InitLayers(NetStructure *net_structure, NetResource *net_
 
         LayerResource *layer_resource = net_resource->resource_map[layer_name].get();
 
+        StartupTimer timer;
         ret = cur_layer->Init(context_, layer_info->param.get(), layer_resource, inputs, outputs, device_);
         if (ret != TNN_OK) {
             LOGE("Error Init layer %s (err: %d or 0x%X)\n", cur_layer->GetLayerName().c_str(), (int)ret, (int)ret);
             return ret;
         }
+        LayerInitTime init_time;
+        init_time.layer_name = layer_name;
+        init_time.type_name  = layer_info->type_str;
+        init_time.time_ms    = timer.ElapsedMs();
+        startup_stats_.slowest_layers.push_back(init_time);
 
         layers_.push_back(cur_layer);
     }
     return ret;
 }
 
+/*
+ * Reformat layers removed by the optimizer are reported once the blob shapes are known.
+ */
+void DefaultNetwork::ReportEliminatedReformats(NetStructure *net_structure) {
+    auto &eliminated = net_structure->eliminated_reformats;
+    if (eliminated.empty()) {
+        return;
+    }
+
+    int64_t saved_bytes = 0;
+    for (auto &iter : eliminated) {
+        auto blob = blob_manager_->GetBlob(iter.dims_blob);
+        if (blob) {
+            saved_bytes += (int64_t)DimsVectorUtils::Count(blob->GetBlobDesc().dims) * iter.bytes_per_element;
+        }
+    }
+    LOGI("%d reformat layers eliminated, %lld bytes of memory traffic saved per forward\n", (int)eliminated.size(),
+         (long long)saved_bytes);
+}
+
 Status DefaultNetwork::GetForwardMemorySize(int &memory_size) {
     memory_size = blob_manager_->GetAllBlobMemorySize();
     return TNN_OK;
@@ -270,7 +309,7 @@ Status DefaultNetwork::Reshape(const InputShapesMap &inputs) {
             return ret;
         }
     }
-    return ret;
+    return blob_manager_->DetachInvalidViewBlobs();
 }
 
 Status DefaultNetwork::DeInit() {
@@ -315,6 +354,7 @@ Status DefaultNetwork::Forward() {
         return result;
     }
 
+    check_health_ = health_monitor_ && health_monitor_->SampleForward();
     context_->OnInstanceForwardBegin();
     int cnt = 0;
     for (auto layer : layers_) {
@@ -342,7 +382,7 @@ Status DefaultNetwork::Forward() {
         }
 #endif  // DUMP_INPUT_BLOB
 
-        result = layer->Forward();
+        result = ForwardLayer(cnt);
         LOGD("layer name: %s, forward result: %d \n", layer->GetLayerName().c_str(), (int)result);
         if (result != TNN_OK) {
             LOGE("Forward error %s, exit\n", result.description().c_str());
@@ -385,6 +425,7 @@ Status DefaultNetwork::ForwardWithCallback(BlobStatisticCallback before, BlobSta
         return result;
     }
 
+    check_health_ = health_monitor_ && health_monitor_->SampleForward();
     context_->OnInstanceForwardBegin();
     int cnt = 0;
     for (auto layer : layers_) {
@@ -395,7 +436,7 @@ Status DefaultNetwork::ForwardWithCallback(BlobStatisticCallback before, BlobSta
         if (before != nullptr)
             before(inputs, layer_info.get());
 
-        result = layer->Forward();
+        result = ForwardLayer(cnt);
         if (result != TNN_OK) {
             LOGE("Forward error %s, exit\n", result.description().c_str());
             return result;
@@ -421,9 +462,10 @@ Status DefaultNetwork::ForwardAsync(Callback call_back) {
         return result;
     }
 
+    check_health_ = health_monitor_ && health_monitor_->SampleForward();
     context_->OnInstanceForwardBegin();
-    for (auto layer : layers_) {
-        result = layer->Forward();
+    for (int i = 0; i < layers_.size(); i++) {
+        result = ForwardLayer(i);
         if (result != TNN_OK) {
             LOGE("Forward error %s, exit\n", result.description().c_str());
             return result;
@@ -433,6 +475,153 @@ Status DefaultNetwork::ForwardAsync(Callback call_back) {
     return result;
 }
 
+Status DefaultNetwork::ForwardLayer(int index) {
+    auto layer    = layers_[index];
+    Status result = layer_profiler_ ? ForwardLayerWithProfiler(index) : layer->Forward();
+    if (result == TNN_OK && check_health_) {
+        health_monitor_->CheckLayer(layer->GetLayerName(), layer->GetOutputBlobs());
+    }
+    return result;
+}
+
+Status DefaultNetwork::ForwardLayerWithProfiler(int index) {
+    auto layer = layers_[index];
+
+    // wait for the queued work of previous layers, so the time belongs to this layer only
+    context_->Synchronize();
+    auto start_counters = layer_profiler_->ReadCounters();
+    double start_us     = LayerProfiler::NowUs();
+    Status result       = layer->Forward();
+    context_->Synchronize();
+    double end_us     = LayerProfiler::NowUs();
+    auto end_counters = layer_profiler_->ReadCounters();
+
+    layer_profiler_->AddEvent(layer->GetLayerName(), net_structure_->layers[index]->type_str, layer->GetInputBlobs(),
+                              layer->GetOutputBlobs(), start_us, end_us, layer->GetFlops(), layer->GetBandwidth(),
+                              start_counters, end_counters);
+    return result;
+}
+
+Status DefaultNetwork::SetLayerProfilerEnabled(bool enable) {
+    if (enable && !layer_profiler_) {
+        layer_profiler_ = std::make_shared<LayerProfiler>();
+        layer_profiler_->SetMachinePeak(peak_gflops_, peak_gbytes_per_second_);
+        layer_profiler_->SetMaxEvents(layer_profiler_max_events_);
+    } else if (!enable) {
+        layer_profiler_ = nullptr;
+    }
+    return TNN_OK;
+}
+
+Status DefaultNetwork::SetLayerProfilerMachinePeak(double peak_gflops, double peak_gbytes_per_second) {
+    peak_gflops_            = peak_gflops;
+    peak_gbytes_per_second_ = peak_gbytes_per_second;
+    if (layer_profiler_) {
+        layer_profiler_->SetMachinePeak(peak_gflops, peak_gbytes_per_second);
+    }
+    return TNN_OK;
+}
+
+Status DefaultNetwork::SetLayerProfilerMaxEvents(size_t max_events) {
+    layer_profiler_max_events_ = max_events;
+    if (layer_profiler_) {
+        layer_profiler_->SetMaxEvents(max_events);
+    }
+    return TNN_OK;
+}
+
+Status DefaultNetwork::SetLayerProfilerCountersEnabled(bool enable) {
+    if (!layer_profiler_) {
+        LOGE("layer profiler is not enabled\n");
+        return Status(TNNERR_NET_ERR, "layer profiler is not enabled");
+    }
+    if (layer_profiler_->SetCountersEnabled(enable) == 0 && enable) {
+        LOGE("hardware counters are not available, perf_event_open failed or is not supported\n");
+        return Status(TNNERR_COMMON_ERROR, "hardware counters are not available");
+    }
+    return TNN_OK;
+}
+
+Status DefaultNetwork::GetLayerProfilerTrace(std::string &trace) {
+    if (!layer_profiler_) {
+        LOGE("layer profiler is not enabled\n");
+        return Status(TNNERR_NET_ERR, "layer profiler is not enabled");
+    }
+    trace = layer_profiler_->GetChromeTrace();
+    return TNN_OK;
+}
+
+Status DefaultNetwork::GetLayerProfilerSummary(std::string &summary) {
+    if (!layer_profiler_) {
+        LOGE("layer profiler is not enabled\n");
+        return Status(TNNERR_NET_ERR, "layer profiler is not enabled");
+    }
+    summary = layer_profiler_->GetSummary();
+    return TNN_OK;
+}
+
+Status DefaultNetwork::ResetLayerProfiler() {
+    if (layer_profiler_) {
+        layer_profiler_->Reset();
+    }
+    return TNN_OK;
+}
+
+Status DefaultNetwork::SetHealthMonitorEnabled(bool enable, HealthMonitorConfig config) {
+    if (!enable) {
+        health_monitor_ = nullptr;
+        check_health_   = false;
+        return TNN_OK;
+    }
+    // the monitor reads the blob data on the host
+    auto device_type = device_ ? device_->GetDeviceType() : DEVICE_NAIVE;
+    if (device_type != DEVICE_ARM && device_type != DEVICE_NAIVE && device_type != DEVICE_X86) {
+        LOGE("health monitor only supports the cpu devices\n");
+        return Status(TNNERR_DEVICE_NOT_SUPPORT, "health monitor only supports the cpu devices");
+    }
+    health_monitor_ = std::make_shared<HealthMonitor>(config);
+    return TNN_OK;
+}
+
+Status DefaultNetwork::GetHealthStats(std::vector<BlobHealthStats> &stats) {
+    if (!health_monitor_) {
+        LOGE("health monitor is not enabled\n");
+        return Status(TNNERR_NET_ERR, "health monitor is not enabled");
+    }
+    stats = health_monitor_->GetStats();
+    return TNN_OK;
+}
+
+Status DefaultNetwork::GetStartupStats(StartupStats &stats, int top_n) {
+    stats = startup_stats_;
+    if (top_n >= 0 && stats.slowest_layers.size() > top_n) {
+        stats.slowest_layers.resize(top_n);
+    }
+    return TNN_OK;
+}
+
+Status DefaultNetwork::GetMemoryStats(MemoryStats &stats) {
+    if (!blob_manager_ || !context_ || !net_resource_) {
+        LOGE("DefaultNetwork is not initialized\n");
+        return Status(TNNERR_NET_ERR, "DefaultNetwork is not initialized");
+    }
+
+    stats                  = MemoryStats();
+    stats.activation_bytes = blob_manager_->GetAllBlobMemorySize();
+    for (auto &iter : net_resource_->resource_map) {
+        stats.weight_bytes += (size_t)GetLayerResourceBytes(iter.second.get());
+    }
+    for (auto layer : layers_) {
+        stats.packed_weight_bytes += layer->GetPackedWeightBytes();
+    }
+    stats.workspace_bytes = context_->GetWorkSpaceBytes();
+    stats.total_bytes =
+        stats.activation_bytes + stats.weight_bytes + stats.packed_weight_bytes + stats.workspace_bytes;
+
+    device_->GetAllocatedBytes(stats.device_current_bytes, stats.device_peak_bytes);
+    return TNN_OK;
+}
+
 #if TNN_PROFILE
 void DefaultNetwork::StartProfile() {
     context_->StartProfile();
@@ -23,6 +23,8 @@
 #include "tnn/core/blob_manager.h"
 #include "tnn/core/common.h"
 #include "tnn/core/context.h"
+#include "tnn/core/health_monitor.h"
+#include "tnn/core/layer_profiler.h"
 #include "tnn/core/macro.h"
 #include "tnn/core/profile.h"
 #include "tnn/core/status.h"
@@ -89,6 +91,39 @@ public:
     // @brief set threads run on device
     virtual Status SetCpuNumThreads(int num_threads);
 
+    // @brief enable or disable the per layer profiler at runtime
+    virtual Status SetLayerProfilerEnabled(bool enable);
+
+    // @brief set the machine peak the layer profiler compares each layer against
+    virtual Status SetLayerProfilerMachinePeak(double peak_gflops, double peak_gbytes_per_second);
+
+    // @brief set how many layer forwards the layer profiler keeps
+    virtual Status SetLayerProfilerMaxEvents(size_t max_events);
+
+    // @brief read the hardware counters around each layer in the layer profiler
+    virtual Status SetLayerProfilerCountersEnabled(bool enable);
+
+    // @brief get the recorded layer times in chrome trace event json
+    virtual Status GetLayerProfilerTrace(std::string &trace);
+
+    // @brief get the per layer time summary in json
+    virtual Status GetLayerProfilerSummary(std::string &summary);
+
+    // @brief clear the recorded layer times
+    virtual Status ResetLayerProfiler();
+
+    // @brief get the memory held by the network
+    virtual Status GetMemoryStats(MemoryStats &stats);
+
+    // @brief enable or disable the numerical health monitor of the layer outputs
+    virtual Status SetHealthMonitorEnabled(bool enable, HealthMonitorConfig config);
+
+    // @brief get the blob statistics of the last sampled forward
+    virtual Status GetHealthStats(std::vector<BlobHealthStats> &stats);
+
+    // @brief get the time spent in Init with the top_n layers slowest to init
+    virtual Status GetStartupStats(StartupStats &stats, int top_n);
+
 #if TNN_PROFILE
 public:
     virtual void StartProfile();
@@ -98,6 +133,12 @@ public:
 private:
     virtual Status InitLayers(NetStructure *net_structure, NetResource *net_resource);
 
+    void ReportEliminatedReformats(NetStructure *net_structure);
+
+    Status ForwardLayer(int index);
+
+    Status ForwardLayerWithProfiler(int index);
+
     AbstractDevice *device_ = nullptr;
     Context *context_       = nullptr;
 
@@ -106,8 +147,23 @@ private:
     BlobManager *blob_manager_ = nullptr;
 
     NetStructure *net_structure_ = nullptr;
+    NetResource *net_resource_   = nullptr;
 
     NetworkConfig _config;
+
+    // null while the layer profiler is disabled
+    std::shared_ptr<LayerProfiler> layer_profiler_ = nullptr;
+    double peak_gflops_                            = 0;
+    double peak_gbytes_per_second_                 = 0;
+    size_t layer_profiler_max_events_              = LayerProfiler::kDefaultMaxEvents;
+
+    // null while the health monitor is disabled
+    std::shared_ptr<HealthMonitor> health_monitor_ = nullptr;
+    // whether the current forward is sampled by the health monitor
+    bool check_health_ = false;
+
+    // phases of Init, the layer init times are sorted slowest first
+    StartupStats startup_stats_;
 };
 
 }  // namespace TNN_NS
@@ -0,0 +1,265 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "tnn/core/health_monitor.h"
+
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "tnn/core/macro.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/half_utils.h"
+
+namespace TNN_NS {
+
+namespace {
+
+struct StatsAccumulator {
+    float min           = FLT_MAX;
+    float max           = -FLT_MAX;
+    double sum          = 0;
+    long long count     = 0;
+    long long nan       = 0;
+    long long inf       = 0;
+    long long saturated = 0;
+};
+
+// elements summed in float lanes before they are flushed to the double sum
+static const int kBlockSize = 4096;
+
+static void AccumulateFiniteScalar(const float *data, int count, StatsAccumulator &acc) {
+    for (int i = 0; i < count; i++) {
+        float v = data[i];
+        if (v != v) {
+            acc.nan++;
+        } else if (fabsf(v) == INFINITY) {
+            acc.inf++;
+        } else {
+            acc.min = std::min(acc.min, v);
+            acc.max = std::max(acc.max, v);
+            acc.sum += v;
+            acc.count++;
+        }
+    }
+}
+
+// four independent lanes without branches, so the compiler vectorizes the loop. a block with
+// nan or inf is rare and recomputed by the scalar loop.
+static void AccumulateFloat(const float *data, int count, StatsAccumulator &acc) {
+    for (int start = 0; start < count; start += kBlockSize) {
+        int block        = std::min(kBlockSize, count - start);
+        const float *ptr = data + start;
+        float min_v[4] = {FLT_MAX, FLT_MAX, FLT_MAX, FLT_MAX};
+        float max_v[4] = {-FLT_MAX, -FLT_MAX, -FLT_MAX, -FLT_MAX};
+        float sum_v[4] = {0, 0, 0, 0};
+        int nonfinite[4] = {0, 0, 0, 0};
+        int i = 0;
+        for (; i + 3 < block; i += 4) {
+            for (int j = 0; j < 4; j++) {
+                float v = ptr[i + j];
+                // v - v is nan for both nan and inf
+                nonfinite[j] += (v - v) != 0.0f;
+                min_v[j] = v < min_v[j] ? v : min_v[j];
+                max_v[j] = v > max_v[j] ? v : max_v[j];
+                sum_v[j] += v;
+            }
+        }
+        if (nonfinite[0] + nonfinite[1] + nonfinite[2] + nonfinite[3] > 0) {
+            AccumulateFiniteScalar(ptr, block, acc);
+            continue;
+        }
+        for (int j = 0; j < 4; j++) {
+            acc.min = std::min(acc.min, min_v[j]);
+            acc.max = std::max(acc.max, max_v[j]);
+            acc.sum += sum_v[j];
+        }
+        acc.count += i;
+        AccumulateFiniteScalar(ptr + i, block - i, acc);
+    }
+}
+
+static void AccumulateBfp16(const uint16_t *data, int count, StatsAccumulator &acc) {
+    float buffer[kBlockSize];
+    for (int start = 0; start < count; start += kBlockSize) {
+        int block = std::min(kBlockSize, count - start);
+        // bfp16 is the high half of fp32
+        for (int i = 0; i < block; i++) {
+            uint32_t bits = (uint32_t)data[start + i] << 16;
+            memcpy(buffer + i, &bits, sizeof(float));
+        }
+        AccumulateFloat(buffer, block, acc);
+    }
+}
+
+static void AccumulateHalf(const uint16_t *data, int count, StatsAccumulator &acc) {
+    float buffer[kBlockSize];
+    for (int start = 0; start < count; start += kBlockSize) {
+        int block = std::min(kBlockSize, count - start);
+        ConvertFromHalfToFloat((void *)(data + start), buffer, block);
+        AccumulateFloat(buffer, block, acc);
+    }
+}
+
+static void AccumulateInt8(const int8_t *data, int count, StatsAccumulator &acc) {
+    int min_v = 127, max_v = -128, saturated = 0;
+    long long sum = 0;
+    for (int i = 0; i < count; i++) {
+        int v = data[i];
+        min_v = std::min(min_v, v);
+        max_v = std::max(max_v, v);
+        saturated += (v == 127) | (v == -128);
+        sum += v;
+    }
+    if (count > 0) {
+        acc.min = std::min(acc.min, (float)min_v);
+        acc.max = std::max(acc.max, (float)max_v);
+    }
+    acc.sum += sum;
+    acc.count += count;
+    acc.saturated += saturated;
+}
+
+// calls func(offset, length) for the runs of valid elements, the padding channels of the packed
+// layouts are skipped
+template <typename F>
+static void ForEachRun(const BlobDesc &desc, F func) {
+    auto &dims  = desc.dims;
+    int batch   = dims.size() > 0 ? dims[0] : 1;
+    int channel = dims.size() > 1 ? dims[1] : 1;
+    int area    = DimsVectorUtils::Count(dims, 2);
+    int c_r4    = ROUND_UP(channel, 4);
+
+    if (desc.data_format == DATA_FORMAT_NC4HW4) {
+        int full_channel = channel / 4 * 4;
+        for (int n = 0; n < batch; n++) {
+            int offset = n * c_r4 * area;
+            if (full_channel > 0) {
+                func(offset, full_channel * area);
+            }
+            for (int i = 0; full_channel < channel && i < area; i++) {
+                func(offset + full_channel * area + i * 4, channel - full_channel);
+            }
+        }
+    } else if (desc.data_format == DATA_FORMAT_NHWC4 && c_r4 != channel) {
+        for (int i = 0; i < batch * area; i++) {
+            func(i * c_r4, channel);
+        }
+    } else {
+        func(0, DimsVectorUtils::Count(dims));
+    }
+}
+
+}  // namespace
+
+HealthMonitor::HealthMonitor(HealthMonitorConfig config) : config_(config) {}
+
+bool HealthMonitor::SampleForward() {
+    int interval = std::max(config_.sample_interval, 1);
+    if (forward_count_++ % interval != 0) {
+        return false;
+    }
+    std::lock_guard<std::mutex> guard(mutex_);
+    stats_.clear();
+    return true;
+}
+
+Status HealthMonitor::ComputeBlobStats(Blob *blob, BlobHealthStats &stats) {
+    auto &desc  = blob->GetBlobDesc();
+    auto handle = blob->GetHandle();
+    if (!handle.base) {
+        return Status(TNNERR_NULL_PARAM, "blob data is null");
+    }
+    const char *ptr = reinterpret_cast<const char *>(handle.base) + handle.bytes_offset;
+
+    StatsAccumulator acc;
+    switch (desc.data_type) {
+        case DATA_TYPE_FLOAT:
+            ForEachRun(desc, [&](int offset, int count) {
+                AccumulateFloat(reinterpret_cast<const float *>(ptr) + offset, count, acc);
+            });
+            break;
+        case DATA_TYPE_BFP16:
+            ForEachRun(desc, [&](int offset, int count) {
+                AccumulateBfp16(reinterpret_cast<const uint16_t *>(ptr) + offset, count, acc);
+            });
+            break;
+        case DATA_TYPE_HALF:
+            ForEachRun(desc, [&](int offset, int count) {
+                AccumulateHalf(reinterpret_cast<const uint16_t *>(ptr) + offset, count, acc);
+            });
+            break;
+        case DATA_TYPE_INT8:
+            ForEachRun(desc, [&](int offset, int count) {
+                AccumulateInt8(reinterpret_cast<const int8_t *>(ptr) + offset, count, acc);
+            });
+            break;
+        default:
+            return Status(TNNERR_PARAM_ERR, "health monitor does not support the blob data type");
+    }
+
+    stats.blob_name       = desc.name;
+    stats.data_type       = desc.data_type;
+    stats.count           = acc.count + acc.nan + acc.inf;
+    stats.nan_count       = acc.nan;
+    stats.inf_count       = acc.inf;
+    stats.saturated_count = acc.saturated;
+    stats.min             = acc.count > 0 ? acc.min : 0;
+    stats.max             = acc.count > 0 ? acc.max : 0;
+    stats.mean            = acc.count > 0 ? (float)(acc.sum / acc.count) : 0;
+    return TNN_OK;
+}
+
+void HealthMonitor::CheckLayer(const std::string &layer_name, const std::vector<Blob *> &outputs) {
+    for (auto blob : outputs) {
+        BlobHealthStats stats;
+        if (ComputeBlobStats(blob, stats) != TNN_OK) {
+            continue;
+        }
+        stats.layer_name = layer_name;
+
+        if (stats.nan_count > 0) {
+            stats.alerts |= HEALTH_ALERT_NAN;
+        }
+        if (stats.inf_count > 0) {
+            stats.alerts |= HEALTH_ALERT_INF;
+        }
+        if (config_.abs_max_threshold > 0 && stats.data_type != DATA_TYPE_INT8 &&
+            std::max(fabsf(stats.min), fabsf(stats.max)) > config_.abs_max_threshold) {
+            stats.alerts |= HEALTH_ALERT_OVERFLOW;
+        }
+        if (stats.data_type == DATA_TYPE_INT8 && stats.count > 0 &&
+            stats.saturated_count > config_.int8_saturation_ratio * stats.count) {
+            stats.alerts |= HEALTH_ALERT_INT8_SATURATION;
+        }
+
+        if (stats.alerts && config_.callback) {
+            config_.callback(stats);
+        }
+
+        std::lock_guard<std::mutex> guard(mutex_);
+        stats_.push_back(stats);
+    }
+}
+
+std::vector<BlobHealthStats> HealthMonitor::GetStats() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    return stats_;
+}
+
+}  // namespace TNN_NS
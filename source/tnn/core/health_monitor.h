@@ -0,0 +1,57 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#ifndef TNN_SOURCE_TNN_CORE_HEALTH_MONITOR_H_
+#define TNN_SOURCE_TNN_CORE_HEALTH_MONITOR_H_
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tnn/core/blob.h"
+#include "tnn/core/instance.h"
+#include "tnn/core/status.h"
+
+namespace TNN_NS {
+
+// @brief HealthMonitor checks the layer outputs of sampled forwards for nan, inf, overflow and
+// int8 saturation. The blob data must be host memory.
+class HealthMonitor {
+public:
+    explicit HealthMonitor(HealthMonitorConfig config);
+
+    // @brief called once per forward, true if the forward is sampled. it clears the last statistics.
+    bool SampleForward();
+
+    // @brief compute the statistics of the output blobs of a layer and raise the alerts
+    void CheckLayer(const std::string &layer_name, const std::vector<Blob *> &outputs);
+
+    // @brief statistics of the last sampled forward
+    std::vector<BlobHealthStats> GetStats();
+
+    // @brief statistics of the blob, padding channels of NC4HW4 and NHWC4 are skipped
+    static Status ComputeBlobStats(Blob *blob, BlobHealthStats &stats);
+
+private:
+    HealthMonitorConfig config_;
+    long long forward_count_ = 0;
+
+    std::vector<BlobHealthStats> stats_;
+    std::mutex mutex_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_HEALTH_MONITOR_H_
@@ -22,6 +22,9 @@
 #include "tnn/core/profile.h"
 #include "tnn/core/status.h"
 #include "tnn/interpreter/abstract_model_interpreter.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/utils/dims_vector_utils.h"
 
 namespace TNN_NS {
 
@@ -39,6 +42,19 @@ Instance::~Instance() {
 }
 
 Status Instance::Init(std::shared_ptr<AbstractModelInterpreter> interpreter, InputShapesMap inputs_shape) {
+    /*
+     * The default network runs the network optimized for the device. TNNImplDefault hands over
+     * interpreters it has optimized already, an interpreter the caller created itself is optimized
+     * here as a copy.
+     */
+    auto default_interpreter = std::dynamic_pointer_cast<DefaultModelInterpreter>(interpreter);
+    if (net_config_.network_type == NETWORK_TYPE_DEFAULT && default_interpreter) {
+        Status status;
+        interpreter = optimizer::NetOptimizerManager::Optimize(default_interpreter, net_config_.device_type, status);
+        if (status != TNN_OK) {
+            return status;
+        }
+    }
     interpreter_ = interpreter;
 
     /*
@@ -103,6 +119,62 @@ Status Instance::SetCpuNumThreads(int num_threads) {
     return network_->SetCpuNumThreads(num_threads);
 }
 
+Status Instance::SetLayerProfilerEnabled(bool enable) {
+    return network_->SetLayerProfilerEnabled(enable);
+}
+
+Status Instance::SetLayerProfilerMachinePeak(double peak_gflops, double peak_gbytes_per_second) {
+    return network_->SetLayerProfilerMachinePeak(peak_gflops, peak_gbytes_per_second);
+}
+
+Status Instance::SetLayerProfilerMaxEvents(size_t max_events) {
+    return network_->SetLayerProfilerMaxEvents(max_events);
+}
+
+Status Instance::SetLayerProfilerCountersEnabled(bool enable) {
+    return network_->SetLayerProfilerCountersEnabled(enable);
+}
+
+Status Instance::GetLayerProfilerTrace(std::string &trace) {
+    return network_->GetLayerProfilerTrace(trace);
+}
+
+Status Instance::GetLayerProfilerSummary(std::string &summary) {
+    return network_->GetLayerProfilerSummary(summary);
+}
+
+Status Instance::ResetLayerProfiler() {
+    return network_->ResetLayerProfiler();
+}
+
+Status Instance::GetMemoryStats(MemoryStats &stats) {
+    auto status = network_->GetMemoryStats(stats);
+    if (status != TNN_OK) {
+        return status;
+    }
+
+    stats.mat_cache_bytes = 0;
+    for (auto &iter : output_mats_) {
+        auto mat          = iter.second;
+        size_t data_bytes = mat->GetMatType() == NCHW_FLOAT ? sizeof(float) : sizeof(char);
+        stats.mat_cache_bytes += DimsVectorUtils::Count(mat->GetDims()) * data_bytes;
+    }
+    stats.total_bytes += stats.mat_cache_bytes;
+    return TNN_OK;
+}
+
+Status Instance::SetHealthMonitorEnabled(bool enable, HealthMonitorConfig config) {
+    return network_->SetHealthMonitorEnabled(enable, config);
+}
+
+Status Instance::GetHealthStats(std::vector<BlobHealthStats> &stats) {
+    return network_->GetHealthStats(stats);
+}
+
+Status Instance::GetStartupStats(StartupStats &stats, int top_n) {
+    return network_->GetStartupStats(stats, top_n);
+}
+
 // set input Mat
 Status Instance::SetInputMat(std::shared_ptr<Mat> mat, MatConvertParam param,
                              std::string input_name) {
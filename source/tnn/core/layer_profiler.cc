@@ -0,0 +1,290 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/layer_profiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+namespace TNN_NS {
+
+static std::string DimsToJson(const std::vector<DimsVector> &dims_list) {
+    std::ostringstream ostr;
+    ostr << "[";
+    for (int i = 0; i < dims_list.size(); i++) {
+        ostr << (i > 0 ? "," : "") << "[";
+        for (int j = 0; j < dims_list[i].size(); j++) {
+            ostr << (j > 0 ? "," : "") << dims_list[i][j];
+        }
+        ostr << "]";
+    }
+    ostr << "]";
+    return ostr.str();
+}
+
+static std::string EscapeJson(const std::string &str) {
+    std::string escaped;
+    for (auto c : str) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+// nearest rank percentile of sorted values
+static double Percentile(const std::vector<double> &sorted, double percent) {
+    int rank = (int)(percent / 100.0 * sorted.size() + 0.5);
+    rank     = std::min(std::max(rank, 1), (int)sorted.size());
+    return sorted[rank - 1];
+}
+
+// supported counters as json fields, with ipc and the misses per kilo instructions
+static std::string CountersToJson(const std::vector<double> &counters) {
+    if (counters.size() != PERF_COUNTER_NUM) {
+        return "";
+    }
+    std::ostringstream ostr;
+    ostr.precision(3);
+    ostr << std::fixed;
+    for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+        if (counters[i] >= 0) {
+            ostr << ",\"" << PerfCounters::GetName((PerfCounterType)i) << "\":" << counters[i];
+        }
+    }
+    double cycles       = counters[PERF_COUNTER_CYCLES];
+    double instructions = counters[PERF_COUNTER_INSTRUCTIONS];
+    if (cycles > 0 && instructions >= 0) {
+        ostr << ",\"ipc\":" << instructions / cycles;
+    }
+    if (instructions > 0) {
+        const PerfCounterType misses[] = {PERF_COUNTER_L1D_MISSES, PERF_COUNTER_LLC_MISSES, PERF_COUNTER_BRANCH_MISSES};
+        const char *names[]            = {"l1d_mpki", "llc_mpki", "branch_mpki"};
+        for (int i = 0; i < 3; i++) {
+            if (counters[misses[i]] >= 0) {
+                ostr << ",\"" << names[i] << "\":" << counters[misses[i]] * 1000 / instructions;
+            }
+        }
+    }
+    return ostr.str();
+}
+
+double LayerProfiler::NowUs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::duration<double, std::micro>>(now).count();
+}
+
+void LayerProfiler::AddEvent(const std::string &layer_name, const std::string &op_name,
+                             const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs, double start_us,
+                             double end_us, double mflops, double mbytes, const std::vector<double> &start_counters,
+                             const std::vector<double> &end_counters) {
+    LayerEvent event;
+    event.layer_name = layer_name;
+    event.op_name    = op_name;
+    for (auto blob : inputs) {
+        event.input_dims.push_back(blob->GetBlobDesc().dims);
+    }
+    for (auto blob : outputs) {
+        event.output_dims.push_back(blob->GetBlobDesc().dims);
+    }
+    event.start_us  = start_us;
+    event.dur_us    = end_us - start_us;
+    event.thread_id = std::hash<std::thread::id>()(std::this_thread::get_id()) % 1000000;
+    event.mflops    = mflops;
+    event.mbytes    = mbytes;
+    if (start_counters.size() == PERF_COUNTER_NUM && end_counters.size() == PERF_COUNTER_NUM) {
+        for (int i = 0; i < PERF_COUNTER_NUM; i++) {
+            bool supported = start_counters[i] >= 0 && end_counters[i] >= 0;
+            event.counters.push_back(supported ? std::max(end_counters[i] - start_counters[i], 0.0) : -1);
+        }
+    }
+
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (max_events_ == 0 || events_.size() < max_events_) {
+        events_.push_back(event);
+        return;
+    }
+    events_[next_event_] = event;
+    next_event_          = (next_event_ + 1) % max_events_;
+    dropped_events_++;
+}
+
+void LayerProfiler::SetMaxEvents(size_t max_events) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    // drop the oldest events beyond the new limit
+    auto events = GetEvents();
+    size_t keep = max_events == 0 ? events.size() : std::min(events.size(), max_events);
+    std::vector<LayerEvent> kept;
+    for (size_t i = events.size() - keep; i < events.size(); i++) {
+        kept.push_back(*events[i]);
+    }
+    dropped_events_ += events.size() - keep;
+    events_.swap(kept);
+    next_event_ = 0;
+    max_events_ = max_events;
+}
+
+std::vector<const LayerProfiler::LayerEvent *> LayerProfiler::GetEvents() {
+    std::vector<const LayerEvent *> events;
+    for (size_t i = 0; i < events_.size(); i++) {
+        events.push_back(&events_[(next_event_ + i) % events_.size()]);
+    }
+    return events;
+}
+
+int LayerProfiler::SetCountersEnabled(bool enable) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    counters_ = nullptr;
+    if (!enable) {
+        return 0;
+    }
+    auto counters = std::make_shared<PerfCounters>();
+    int opened    = counters->Open(PerfCounters::GetComputeThreadIds());
+    if (opened > 0) {
+        counters_ = counters;
+    }
+    return opened;
+}
+
+std::vector<double> LayerProfiler::ReadCounters() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    if (!counters_) {
+        return std::vector<double>();
+    }
+    // the counters follow the thread running Forward and its openmp threads
+    auto &thread_ids = counters_->GetThreadIds();
+    if (std::find(thread_ids.begin(), thread_ids.end(), PerfCounters::GetCurrentThreadId()) == thread_ids.end()) {
+        counters_->Open(PerfCounters::GetComputeThreadIds());
+    }
+    return counters_->Read();
+}
+
+void LayerProfiler::SetMachinePeak(double peak_gflops, double peak_gbytes_per_second) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    peak_gflops_            = peak_gflops;
+    peak_gbytes_per_second_ = peak_gbytes_per_second;
+}
+
+void LayerProfiler::Reset() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    events_.clear();
+    next_event_     = 0;
+    dropped_events_ = 0;
+}
+
+std::string LayerProfiler::GetChromeTrace() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto events = GetEvents();
+    std::ostringstream ostr;
+    ostr.precision(3);
+    ostr << std::fixed << "{\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped_events_
+         << "},\"traceEvents\":[";
+    for (int i = 0; i < events.size(); i++) {
+        auto &event = *events[i];
+        ostr << (i > 0 ? ",\n" : "\n") << "{\"name\":\"" << EscapeJson(event.layer_name) << "\",\"cat\":\""
+             << EscapeJson(event.op_name) << "\",\"ph\":\"X\",\"ts\":" << event.start_us
+             << ",\"dur\":" << event.dur_us << ",\"pid\":0,\"tid\":" << event.thread_id
+             << ",\"args\":{\"op\":\"" << EscapeJson(event.op_name)
+             << "\",\"input_dims\":" << DimsToJson(event.input_dims)
+             << ",\"output_dims\":" << DimsToJson(event.output_dims) << ",\"mflops\":" << event.mflops
+             << ",\"mbytes\":" << event.mbytes << CountersToJson(event.counters) << "}}";
+    }
+    ostr << "\n]}\n";
+    return ostr.str();
+}
+
+std::string LayerProfiler::GetSummary() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    auto events = GetEvents();
+
+    // layers in the order of their first kept forward
+    std::vector<std::string> layer_names;
+    std::map<std::string, std::vector<int>> layer_events;
+    for (int i = 0; i < events.size(); i++) {
+        auto &name = events[i]->layer_name;
+        if (layer_events.find(name) == layer_events.end()) {
+            layer_names.push_back(name);
+        }
+        layer_events[name].push_back(i);
+    }
+
+    std::ostringstream ostr;
+    ostr.precision(6);
+    ostr << std::fixed << "{\"layers\":[";
+    double total_ms = 0;
+    for (int l = 0; l < layer_names.size(); l++) {
+        auto &indexes = layer_events[layer_names[l]];
+        auto &last    = *events[indexes.back()];
+
+        std::vector<double> times_ms;
+        std::vector<size_t> thread_ids;
+        double sum_ms = 0;
+        // mean of the counters, a counter unsupported in any forward is dropped
+        std::vector<double> counters(last.counters.size(), 0);
+        for (auto index : indexes) {
+            auto &event_counters = events[index]->counters;
+            for (int i = 0; i < counters.size(); i++) {
+                bool supported = i < event_counters.size() && event_counters[i] >= 0 && counters[i] >= 0;
+                counters[i]    = supported ? counters[i] + event_counters[i] / indexes.size() : -1;
+            }
+            times_ms.push_back(events[index]->dur_us / 1000.0);
+            sum_ms += times_ms.back();
+            if (std::find(thread_ids.begin(), thread_ids.end(), events[index]->thread_id) == thread_ids.end()) {
+                thread_ids.push_back(events[index]->thread_id);
+            }
+        }
+        std::sort(times_ms.begin(), times_ms.end());
+        total_ms += sum_ms;
+
+        ostr << (l > 0 ? ",\n" : "\n") << "{\"layer\":\"" << EscapeJson(last.layer_name) << "\",\"op\":\""
+             << EscapeJson(last.op_name) << "\",\"input_dims\":" << DimsToJson(last.input_dims)
+             << ",\"output_dims\":" << DimsToJson(last.output_dims) << ",\"count\":" << indexes.size()
+             << ",\"total_ms\":" << sum_ms << ",\"mean_ms\":" << sum_ms / indexes.size()
+             << ",\"p50_ms\":" << Percentile(times_ms, 50) << ",\"p99_ms\":" << Percentile(times_ms, 99)
+             << ",\"thread_ids\":[";
+        for (int t = 0; t < thread_ids.size(); t++) {
+            ostr << (t > 0 ? "," : "") << thread_ids[t];
+        }
+        ostr << "]";
+
+        // MFLOP per ms is GFLOP/s, MB per ms is GB/s
+        double mean_ms = sum_ms / indexes.size();
+        double gflops  = mean_ms > 0 ? last.mflops / mean_ms : 0;
+        double gbytes  = mean_ms > 0 ? last.mbytes / mean_ms : 0;
+        ostr << ",\"mflops\":" << last.mflops << ",\"mbytes\":" << last.mbytes << ",\"gflops_per_s\":" << gflops
+             << ",\"gbytes_per_s\":" << gbytes
+             << ",\"flops_per_byte\":" << (last.mbytes > 0 ? last.mflops / last.mbytes : 0)
+             << CountersToJson(counters);
+        if (peak_gflops_ > 0 && peak_gbytes_per_second_ > 0 && last.mbytes > 0) {
+            // roofline: below the ridge point the layer can not reach the compute peak
+            double ridge = peak_gflops_ / peak_gbytes_per_second_;
+            ostr << ",\"compute_utilization\":" << gflops / peak_gflops_
+                 << ",\"bandwidth_utilization\":" << gbytes / peak_gbytes_per_second_ << ",\"bound\":\""
+                 << (last.mflops / last.mbytes < ridge ? "bandwidth" : "compute") << "\"";
+        }
+        ostr << "}";
+    }
+    ostr << "\n],\"total_ms\":" << total_ms << ",\"dropped_events\":" << dropped_events_;
+    if (peak_gflops_ > 0 && peak_gbytes_per_second_ > 0) {
+        ostr << ",\"peak_gflops\":" << peak_gflops_ << ",\"peak_gbytes_per_s\":" << peak_gbytes_per_second_;
+    }
+    ostr << "}\n";
+    return ostr.str();
+}
+
+}  // namespace TNN_NS
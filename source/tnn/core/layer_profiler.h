@@ -0,0 +1,108 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_CORE_LAYER_PROFILER_H_
+#define TNN_SOURCE_TNN_CORE_LAYER_PROFILER_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tnn/core/blob.h"
+#include "tnn/core/common.h"
+#include "tnn/core/perf_counters.h"
+
+namespace TNN_NS {
+
+// @brief LayerProfiler records the forward time of each layer. It is built in all builds,
+// the network only calls it while profiling is enabled for the instance.
+class LayerProfiler {
+public:
+    // @brief monotonic time in microseconds
+    static double NowUs();
+
+    // @brief record one forward of a layer
+    // @param mflops    mega flops of the forward
+    // @param mbytes    mega bytes moved by the forward
+    // @param start_counters    hardware counters read before the forward, see ReadCounters
+    // @param end_counters      hardware counters read after the forward
+    void AddEvent(const std::string &layer_name, const std::string &op_name, const std::vector<Blob *> &inputs,
+                  const std::vector<Blob *> &outputs, double start_us, double end_us, double mflops = 0,
+                  double mbytes = 0, const std::vector<double> &start_counters = {},
+                  const std::vector<double> &end_counters = {});
+
+    // @brief read cycles, instructions, cache and branch misses around each layer, linux only. the counters
+    // count the calling thread and its openmp threads, and move to the thread reading them if it is another.
+    // @return the number of counters opened, counters the kernel or cpu does not support are skipped
+    int SetCountersEnabled(bool enable);
+
+    // @brief current hardware counter values, empty while the counters are disabled
+    std::vector<double> ReadCounters();
+
+    // @brief set the machine peak, the summary then reports utilization and whether
+    // a layer is compute bound or bandwidth bound. zero disables the comparison.
+    void SetMachinePeak(double peak_gflops, double peak_gbytes_per_second);
+
+    // @brief keep the last max_events events, older ones are dropped and counted in the trace and the summary.
+    // the default keeps kDefaultMaxEvents, zero keeps every event.
+    void SetMaxEvents(size_t max_events);
+
+    // @brief clear all recorded events and the dropped count
+    void Reset();
+
+    // @brief recorded events in chrome trace event format, load it in chrome://tracing or perfetto
+    std::string GetChromeTrace();
+
+    // @brief per layer summary in json: layer, op, shapes, mean/p50/p99 time, call count, thread id,
+    // flops, bytes and the achieved GFLOP/s and GB/s. with the counters enabled, also the mean counter
+    // values, ipc and the misses per kilo instructions. the statistics cover the kept events only.
+    std::string GetSummary();
+
+    // about a minute of forwards of a network with a few hundred layers
+    static const size_t kDefaultMaxEvents = 1 << 16;
+
+private:
+    struct LayerEvent {
+        std::string layer_name;
+        std::string op_name;
+        std::vector<DimsVector> input_dims;
+        std::vector<DimsVector> output_dims;
+        double start_us = 0;
+        double dur_us   = 0;
+        size_t thread_id = 0;
+        double mflops    = 0;
+        double mbytes    = 0;
+        // hardware counter deltas indexed by PerfCounterType, -1 if not supported
+        std::vector<double> counters;
+    };
+
+    // kept events in the order they were added
+    std::vector<const LayerEvent *> GetEvents();
+
+    // ring buffer of the last max_events_ events, next_event_ is the oldest once it is full
+    std::vector<LayerEvent> events_;
+    size_t next_event_     = 0;
+    size_t max_events_     = kDefaultMaxEvents;
+    size_t dropped_events_ = 0;
+    std::shared_ptr<PerfCounters> counters_ = nullptr;
+    double peak_gflops_            = 0;
+    double peak_gbytes_per_second_ = 0;
+    std::mutex mutex_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_LAYER_PROFILER_H_
@@ -208,6 +208,7 @@ static std::map<std::string, LayerType> global_layer_type_map = {
     // LAYER_TRT_ENGINE
 
     {"SignedMul", LAYER_SIGNED_MUL},
+    {"FusedElementwise", LAYER_FUSED_ELEMENTWISE},
 };
 
 LayerType GlobalConvertLayerType(std::string layer_type_str) {
@@ -0,0 +1,210 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#include "tnn/core/perf_counters.h"
+
+#include <algorithm>
+
+#include "tnn/utils/omp_utils.h"
+
+#if defined(__ANDROID__) || defined(__linux__)
+#include <linux/perf_event.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace TNN_NS {
+
+PerfCounters::PerfCounters() {
+    Close();
+}
+
+PerfCounters::~PerfCounters() {
+    Close();
+}
+
+const std::vector<int> &PerfCounters::GetThreadIds() {
+    return thread_ids_;
+}
+
+std::string PerfCounters::GetName(PerfCounterType type) {
+    switch (type) {
+        case PERF_COUNTER_CYCLES:
+            return "cycles";
+        case PERF_COUNTER_INSTRUCTIONS:
+            return "instructions";
+        case PERF_COUNTER_L1D_MISSES:
+            return "l1d_misses";
+        case PERF_COUNTER_LLC_MISSES:
+            return "llc_misses";
+        case PERF_COUNTER_BRANCH_MISSES:
+            return "branch_misses";
+        default:
+            return "unknown";
+    }
+}
+
+bool PerfCounters::IsSupported(PerfCounterType type) {
+    return type >= 0 && type < PERF_COUNTER_NUM && supported_[type];
+}
+
+#if defined(__ANDROID__) || defined(__linux__)
+
+int PerfCounters::GetCurrentThreadId() {
+    return (int)syscall(__NR_gettid);
+}
+
+std::vector<int> PerfCounters::GetComputeThreadIds() {
+    std::vector<int> tids(OMP_MAX_THREADS_NUM_, 0);
+    tids[0] = GetCurrentThreadId();
+    OMP_PARALLEL_FOR_
+    for (int i = 0; i < (int)tids.size(); i++) {
+        tids[OMP_TID_] = GetCurrentThreadId();
+    }
+    std::sort(tids.begin(), tids.end());
+    tids.erase(std::unique(tids.begin(), tids.end()), tids.end());
+    tids.erase(std::remove(tids.begin(), tids.end(), 0), tids.end());
+    return tids;
+}
+
+static void SetEventConfig(PerfCounterType type, struct perf_event_attr &attr) {
+    attr.type = PERF_TYPE_HARDWARE;
+    switch (type) {
+        case PERF_COUNTER_CYCLES:
+            attr.config = PERF_COUNT_HW_CPU_CYCLES;
+            break;
+        case PERF_COUNTER_INSTRUCTIONS:
+            attr.config = PERF_COUNT_HW_INSTRUCTIONS;
+            break;
+        case PERF_COUNTER_L1D_MISSES:
+            attr.type   = PERF_TYPE_HW_CACHE;
+            attr.config = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                          (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+            break;
+        case PERF_COUNTER_LLC_MISSES:
+            attr.config = PERF_COUNT_HW_CACHE_MISSES;
+            break;
+        case PERF_COUNTER_BRANCH_MISSES:
+            attr.config = PERF_COUNT_HW_BRANCH_MISSES;
+            break;
+        default:
+            break;
+    }
+}
+
+int PerfCounters::Open(const std::vector<int> &thread_ids) {
+    Close();
+
+    thread_ids_ = thread_ids;
+    for (auto tid : thread_ids) {
+        ThreadCounters counters;
+        for (int type = 0; type < PERF_COUNTER_NUM; type++) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            SetEventConfig((PerfCounterType)type, attr);
+            // user space only, it works with perf_event_paranoid 2
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            // the kernel refuses a member the group can not schedule together with the others
+            int group_fd = counters.fds.empty() ? -1 : counters.fds[0];
+            int fd       = (int)syscall(__NR_perf_event_open, &attr, tid, -1, group_fd, 0);
+            if (fd >= 0) {
+                counters.fds.push_back(fd);
+                counters.types.push_back((PerfCounterType)type);
+                supported_[type] = true;
+            }
+        }
+        if (!counters.fds.empty()) {
+            thread_counters_.push_back(counters);
+        }
+    }
+
+    int opened = 0;
+    for (int type = 0; type < PERF_COUNTER_NUM; type++) {
+        opened += supported_[type] ? 1 : 0;
+    }
+    return opened;
+}
+
+void PerfCounters::Close() {
+    for (auto &counters : thread_counters_) {
+        for (auto fd : counters.fds) {
+            close(fd);
+        }
+    }
+    thread_counters_.clear();
+    thread_ids_.clear();
+    for (int type = 0; type < PERF_COUNTER_NUM; type++) {
+        supported_[type] = false;
+    }
+}
+
+std::vector<double> PerfCounters::Read() {
+    std::vector<double> values(PERF_COUNTER_NUM, -1);
+    for (int type = 0; type < PERF_COUNTER_NUM; type++) {
+        values[type] = supported_[type] ? 0 : -1;
+    }
+    for (auto &counters : thread_counters_) {
+        // nr, time enabled, time running and the values of the group
+        uint64_t data[3 + PERF_COUNTER_NUM] = {0};
+        const int count                     = (int)counters.fds.size();
+        const ssize_t bytes                 = (3 + count) * sizeof(uint64_t);
+        if (read(counters.fds[0], data, bytes) != bytes || data[0] != count || data[2] == 0) {
+            continue;
+        }
+        // the kernel multiplexes the group when there are more events than hardware counters
+        double scale = data[2] < data[1] ? (double)data[1] / data[2] : 1.0;
+        for (int i = 0; i < count; i++) {
+            values[counters.types[i]] += data[3 + i] * scale;
+        }
+    }
+    return values;
+}
+
+#else
+
+int PerfCounters::GetCurrentThreadId() {
+    return 0;
+}
+
+std::vector<int> PerfCounters::GetComputeThreadIds() {
+    return std::vector<int>();
+}
+
+int PerfCounters::Open(const std::vector<int> &thread_ids) {
+    thread_ids_ = thread_ids;
+    return 0;
+}
+
+void PerfCounters::Close() {
+    thread_ids_.clear();
+    for (int type = 0; type < PERF_COUNTER_NUM; type++) {
+        supported_[type] = false;
+    }
+}
+
+std::vector<double> PerfCounters::Read() {
+    return std::vector<double>(PERF_COUNTER_NUM, -1);
+}
+
+#endif  // __ANDROID__ || __linux__
+
+}  // namespace TNN_NS
@@ -0,0 +1,86 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+
+#ifndef TNN_SOURCE_TNN_CORE_PERF_COUNTERS_H_
+#define TNN_SOURCE_TNN_CORE_PERF_COUNTERS_H_
+
+#include <string>
+#include <vector>
+
+#include "tnn/core/macro.h"
+
+namespace TNN_NS {
+
+enum PerfCounterType {
+    PERF_COUNTER_CYCLES        = 0,
+    PERF_COUNTER_INSTRUCTIONS  = 1,
+    PERF_COUNTER_L1D_MISSES    = 2,
+    PERF_COUNTER_LLC_MISSES    = 3,
+    PERF_COUNTER_BRANCH_MISSES = 4,
+    PERF_COUNTER_NUM           = 5,
+};
+
+// @brief PerfCounters reads the hardware counters of the given threads with linux perf_event_open.
+// The counters of a thread are opened as one group and read with a single read call.
+// Counters the kernel or the cpu does not support stay closed and read as -1, on other systems
+// all counters read as -1.
+class PerfCounters {
+public:
+    PerfCounters();
+
+    ~PerfCounters();
+
+    // @brief open the counters for the threads
+    // @return the number of counters opened on at least one thread
+    int Open(const std::vector<int> &thread_ids);
+
+    // @brief close all counters
+    void Close();
+
+    // @brief whether the counter is opened
+    bool IsSupported(PerfCounterType type);
+
+    // @brief counter values summed over the threads since Open, scaled when the kernel multiplexes
+    // the counters. unsupported counters are -1.
+    std::vector<double> Read();
+
+    // @brief threads the counters are opened on
+    const std::vector<int> &GetThreadIds();
+
+    // @brief name of the counter, ie, cycles
+    static std::string GetName(PerfCounterType type);
+
+    // @brief the calling thread and the openmp threads of its parallel regions, the threads running the
+    // layers when called from the thread running Forward. empty on other systems.
+    static std::vector<int> GetComputeThreadIds();
+
+    // @brief id of the calling thread, 0 on other systems
+    static int GetCurrentThreadId();
+
+private:
+    // counters opened on one thread, the first is the group leader
+    struct ThreadCounters {
+        std::vector<int> fds;
+        std::vector<PerfCounterType> types;
+    };
+
+    std::vector<int> thread_ids_;
+    std::vector<ThreadCounters> thread_counters_;
+    bool supported_[PERF_COUNTER_NUM];
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_PERF_COUNTERS_H_
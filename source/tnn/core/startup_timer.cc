@@ -0,0 +1,46 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/core/startup_timer.h"
+
+#include <chrono>
+
+namespace TNN_NS {
+
+static double NowMs() {
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::duration<double, std::milli>>(now).count();
+}
+
+StartupTimer::StartupTimer() {
+    Reset();
+}
+
+void StartupTimer::Reset() {
+    start_ms_ = NowMs();
+}
+
+double StartupTimer::ElapsedMs() {
+    return NowMs() - start_ms_;
+}
+
+void StartupTimer::Lap(const std::string &name, std::vector<StartupPhase> &phases) {
+    StartupPhase phase;
+    phase.name    = name;
+    phase.time_ms = ElapsedMs();
+    phases.push_back(phase);
+    Reset();
+}
+
+}  // namespace TNN_NS
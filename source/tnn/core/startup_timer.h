@@ -0,0 +1,45 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_CORE_STARTUP_TIMER_H_
+#define TNN_SOURCE_TNN_CORE_STARTUP_TIMER_H_
+
+#include <string>
+#include <vector>
+
+#include "tnn/core/common.h"
+
+namespace TNN_NS {
+
+// @brief StartupTimer times the consecutive phases of TNN::Init and CreateInst
+class StartupTimer {
+public:
+    StartupTimer();
+
+    // @brief restart the timer
+    void Reset();
+
+    // @brief ms since the timer was restarted
+    double ElapsedMs();
+
+    // @brief append the ms since the timer was restarted as a phase, then restart it
+    void Lap(const std::string &name, std::vector<StartupPhase> &phases);
+
+private:
+    double start_ms_ = 0;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_CORE_STARTUP_TIMER_H_
@@ -55,4 +55,12 @@ std::shared_ptr<Instance> TNN::CreateInst(NetworkConfig& config, Status& status,
     return impl_->CreateInst(config, status, inputs_shape);
 }
 
+Status TNN::GetStartupStats(StartupStats& stats) {
+    if (!impl_) {
+        LOGE("Error: impl_ is nil\n");
+        return Status(TNNERR_NET_ERR, "tnn impl_ is nil");
+    }
+    return impl_->GetStartupStats(stats);
+}
+
 }  // namespace TNN_NS
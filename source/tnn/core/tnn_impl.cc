@@ -31,6 +31,11 @@ Status TNNImpl::Init(ModelConfig &config) {
     return TNN_OK;
 }
 
+Status TNNImpl::GetStartupStats(StartupStats &stats) {
+    LOGE("startup stats is not supported by this model type\n");
+    return Status(TNNERR_NET_ERR, "startup stats is not supported by this model type");
+}
+
 std::map<ModelType, std::shared_ptr<AbstractTNNImplFactory>> &TNNImplManager::GetTNNImplFactoryMap() {
     static std::map<ModelType, std::shared_ptr<AbstractTNNImplFactory>> s_tnn_impl_factory_map;
     return s_tnn_impl_factory_map;
@@ -59,6 +59,9 @@ public:
     virtual std::shared_ptr<Instance> CreateInst(NetworkConfig& config, Status& status,
                                                  InputShapesMap inputs_shape = InputShapesMap()) = 0;
 
+    // @brief get the time spent in Init and in the network optimization shared by the instances
+    virtual Status GetStartupStats(StartupStats& stats);
+
 protected:
     ModelConfig model_config_;
 };
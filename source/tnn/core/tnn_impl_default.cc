@@ -14,7 +14,11 @@
 
 #include "tnn/core/tnn_impl_default.h"
 
+#include <sstream>
+
+#include "tnn/core/startup_timer.h"
 #include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
 
 namespace TNN_NS {
 
@@ -37,7 +41,14 @@ Status TNNImplDefault::Init(ModelConfig& config) {
         return Status(TNNERR_NET_ERR, "interpreter is nil");
     }
     interpreter_ = std::shared_ptr<AbstractModelInterpreter>(interpreter);
-    return interpreter_->Interpret(config.params);
+    status       = interpreter_->Interpret(config.params);
+
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter*>(interpreter_.get());
+    if (default_interpreter) {
+        std::lock_guard<std::mutex> guard(optimized_interpreters_mutex_);
+        startup_phases_ = default_interpreter->GetStartupPhases();
+    }
+    return status;
 }
 
 Status TNNImplDefault::DeInit() {
@@ -45,6 +56,16 @@ Status TNNImplDefault::DeInit() {
     return TNN_OK;
 }
 
+Status TNNImplDefault::GetStartupStats(StartupStats& stats) {
+    std::lock_guard<std::mutex> guard(optimized_interpreters_mutex_);
+    stats        = StartupStats();
+    stats.phases = startup_phases_;
+    for (auto& phase : startup_phases_) {
+        stats.total_ms += phase.time_ms;
+    }
+    return TNN_OK;
+}
+
 Status TNNImplDefault::AddOutput(const std::string& layer_name, int output_index) {
     if (!interpreter_) {
         return Status(TNNERR_NET_ERR, "interpreter is nil");
@@ -54,6 +75,10 @@ Status TNNImplDefault::AddOutput(const std::string& layer_name, int output_index
     CHECK_PARAM_NULL(default_interpreter);
 
     default_interpreter->GetNetStructure()->outputs.insert(layer_name);
+
+    // networks optimized before are stale now
+    std::lock_guard<std::mutex> guard(optimized_interpreters_mutex_);
+    optimized_interpreters_.clear();
     return TNN_OK;
 }
 
@@ -64,8 +89,16 @@ std::shared_ptr<Instance> TNNImplDefault::CreateInst(NetworkConfig& net_config,
         return nullptr;
     }
 
+    auto interpreter = interpreter_;
+    if (net_config.network_type == NETWORK_TYPE_DEFAULT) {
+        interpreter = GetOptimizedInterpreter(net_config, status);
+        if (status != TNN_OK) {
+            return nullptr;
+        }
+    }
+
     auto instance = std::make_shared<Instance>(net_config, model_config_);
-    status        = instance->Init(interpreter_, inputs_shape);
+    status        = instance->Init(interpreter, inputs_shape);
 
     if (status != TNN_OK) {
         return nullptr;
@@ -73,4 +106,42 @@ std::shared_ptr<Instance> TNNImplDefault::CreateInst(NetworkConfig& net_config,
     return instance;
 }
 
+std::shared_ptr<AbstractModelInterpreter> TNNImplDefault::GetOptimizedInterpreter(NetworkConfig& config,
+                                                                                  Status& status) {
+    auto default_interpreter = std::dynamic_pointer_cast<DefaultModelInterpreter>(interpreter_);
+    if (!default_interpreter) {
+        status = Status(TNNERR_NET_ERR, "interpreter is not default model interpreter");
+        return nullptr;
+    }
+
+    std::stringstream key;
+    key << config.device_type << "_" << config.precision;
+    for (auto strategy : optimizer::NetOptimizerManager::GetStrategies(config.device_type)) {
+        key << "_" << strategy;
+    }
+
+    std::lock_guard<std::mutex> guard(optimized_interpreters_mutex_);
+    auto iter = optimized_interpreters_.find(key.str());
+    if (iter != optimized_interpreters_.end()) {
+        status = TNN_OK;
+        return iter->second;
+    }
+
+    /*
+     * The NetOptimizeManager holds a list of network optimization processes.
+     * The optimization process may change the network structure accoundingly.
+     * eg. fuse conv+bn, conv+relu.
+     * The interpreter keeps the network as interpreted, a copy is optimized.
+     */
+    StartupTimer timer;
+    auto optimized = optimizer::NetOptimizerManager::Optimize(default_interpreter, config.device_type, status);
+    if (status != TNN_OK) {
+        return nullptr;
+    }
+    timer.Lap("optimize", startup_phases_);
+
+    optimized_interpreters_[key.str()] = optimized;
+    return optimized;
+}
+
 }  // namespace TNN_NS
@@ -15,7 +15,9 @@
 #ifndef TNN_CORE_TNN_IMPL_DEFAULT_H_
 #define TNN_CORE_TNN_IMPL_DEFAULT_H_
 
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 
 #include "tnn/core/common.h"
@@ -64,8 +66,22 @@ public:
         NetworkConfig& config, Status& status,
         InputShapesMap inputs_shape = InputShapesMap());
 
+    // @brief get the time spent in Init and in the network optimization shared by the instances
+    virtual Status GetStartupStats(StartupStats& stats);
+
 private:
+    // @brief get the interpreter holding the network optimized for the config,
+    // the network is optimized once and shared by the instances with the same config
+    std::shared_ptr<AbstractModelInterpreter> GetOptimizedInterpreter(NetworkConfig& config, Status& status);
+
     std::shared_ptr<AbstractModelInterpreter> interpreter_;
+
+    // optimized networks keyed by device, precision and optimizer strategies
+    std::map<std::string, std::shared_ptr<AbstractModelInterpreter>> optimized_interpreters_;
+    std::mutex optimized_interpreters_mutex_;
+
+    // phases of Init, then one optimize phase for each optimized network, guarded by the mutex above
+    std::vector<StartupPhase> startup_phases_;
 };
 
 }  // namespace TNN_NS
@@ -25,6 +25,10 @@ namespace TNN_NS {
 
 ArmBatchNormLayerAcc::~ArmBatchNormLayerAcc() {}
 
+size_t ArmBatchNormLayerAcc::GetPackedWeightBytes() {
+    return buffer_scale_.GetBytesSize() + buffer_bias_.GetBytesSize();
+}
+
 Status ArmBatchNormLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
                                   const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     RETURN_ON_NEQ(ArmLayerAcc::Init(context, param, resource, inputs, outputs), TNN_OK);
@@ -142,6 +142,11 @@ bool ArmBinaryLayerAcc::DataTypeSupported(DataType data_type) {
 
 ArmBinaryLayerAcc::~ArmBinaryLayerAcc() {}
 
+size_t ArmBinaryLayerAcc::GetPackedWeightBytes() {
+    return broadcast_.GetBytesSize() + input0_int_scale_.GetBytesSize() + input1_int_scale_.GetBytesSize() +
+           output_int_scale_.GetBytesSize();
+}
+
 Status ArmBinaryLayerAcc::allocateBufferParam(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto layer_param = dynamic_cast<MultidirBroadcastLayerParam *>(param_);
     CHECK_PARAM_NULL(layer_param);
@@ -35,6 +35,8 @@ public:
 
     virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
 
+    virtual size_t GetPackedWeightBytes() override;
+
 protected:
     Status BinaryFunc(float *output_ptr, float *input0_ptr, float *input1_ptr, DimsVector &dims0, DimsVector &dims1);
 
@@ -13,11 +13,31 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/arm/acc/arm_nchw_layer_acc.h"
-#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/detection_post_processor.h"
 
 namespace TNN_NS {
 
-DECLARE_ARM_NCHW_ACC(DetectionOutput, LAYER_DETECTION_OUTPUT);
+class ArmDetectionOutputLayerAcc : public ArmNchwLayerAcc {
+public:
+    virtual ~ArmDetectionOutputLayerAcc(){};
+    virtual Status Init(Context *context, LayerParam *param, LayerResource *resource, const std::vector<Blob *> &inputs,
+                        const std::vector<Blob *> &outputs);
+    virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+
+private:
+    // keeps its buffers across forwards
+    DetectionPostProcessor post_processor_;
+};
+
+Status ArmDetectionOutputLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
+                                        const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto ret = ArmLayerAcc::Init(context, param, resource, inputs, outputs);
+    RETURN_ON_NEQ(ret, TNN_OK);
+
+    auto layer_param = dynamic_cast<DetectionOutputLayerParam *>(param);
+    CHECK_PARAM_NULL(layer_param);
+    return DetectionPostProcessor::CheckParam(layer_param);
+}
 
 Status ArmDetectionOutputLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto param = dynamic_cast<DetectionOutputLayerParam *>(param_);
@@ -26,9 +46,9 @@ Status ArmDetectionOutputLayerAcc::DoForward(const std::vector<Blob *> &inputs,
     AllocConvertBuffer(inputs, outputs);
 
     UnPackInputs(inputs);
-    // call cpu naive prior box
     if (outputs[0]->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        NaiveDetectionOutput(GetNchwBlobVector(nchw_blob_in), GetNchwBlobVector(nchw_blob_out), param);
+        RETURN_ON_NEQ(post_processor_.Forward(GetNchwBlobVector(nchw_blob_in), GetNchwBlobVector(nchw_blob_out), param),
+                      TNN_OK);
     } else {
         return Status(TNNERR_LAYER_ERR, "NO IMPLEMENT data type");
     }
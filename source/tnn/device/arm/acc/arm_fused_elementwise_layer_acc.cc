@@ -0,0 +1,259 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/arm/acc/arm_fused_elementwise_layer_acc.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "tnn/device/arm/arm_util.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/fused_elementwise_utils.h"
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+// Float4 elements of a block, the whole program runs on one block while it stays in L1
+static const int kFusedElementwiseBlock = 256;
+
+ArmFusedElementwiseLayerAcc::~ArmFusedElementwiseLayerAcc() {}
+
+size_t ArmFusedElementwiseLayerAcc::GetPackedWeightBytes() {
+    size_t bytes = 0;
+    for (auto &constant : packed_constants_) {
+        bytes += constant.GetBytesSize();
+    }
+    return bytes;
+}
+
+bool ArmFusedElementwiseLayerAcc::DataTypeSupported(DataType data_type) {
+    return data_type == DATA_TYPE_FLOAT || data_type == DATA_TYPE_BFP16;
+}
+
+Status ArmFusedElementwiseLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    RETURN_ON_NEQ(ArmLayerAcc::Reshape(inputs, outputs), TNN_OK);
+    auto layer_param = dynamic_cast<FusedElementwiseLayerParam *>(param_);
+    CHECK_PARAM_NULL(layer_param);
+    auto layer_res = dynamic_cast<FusedElementwiseLayerResource *>(resource_);
+
+    packed_constants_.clear();
+    std::vector<DimsVector> shapes;
+    RETURN_ON_NEQ(FusedElementwiseUtils::GetConstantBroadcast(layer_res, outputs[0]->GetBlobDesc().dims, shapes,
+                                                              constant_broadcast_types_),
+                  TNN_OK);
+    if (!layer_res) {
+        return TNN_OK;
+    }
+
+    for (int i = 0; i < layer_res->constant_handles.size(); i++) {
+        auto constant = layer_res->constant_handles[i].force_to<float *>();
+        auto shape    = shapes[i];
+        int type      = constant_broadcast_types_[i];
+        if (type == BroadcastTypeSingle || type == BroadcastTypeWidth) {
+            int count = DimsVectorUtils::Count(shape);
+            RawBuffer packed(count * 4 * sizeof(float));
+            auto packed_ptr = packed.force_to<float *>();
+            for (int j = 0; j < count; j++) {
+                Float4::save(packed_ptr + j * 4, Float4(constant[j]));
+            }
+            packed_constants_.push_back(packed);
+        } else {
+            int batch = shape[0];
+            int plane = DimsVectorUtils::Count(shape, 2);
+            int c_r4  = ROUND_UP(shape[1], 4);
+            RawBuffer packed(batch * c_r4 * plane * sizeof(float));
+            auto packed_ptr = packed.force_to<float *>();
+            for (int b = 0; b < batch; b++) {
+                PackC4(packed_ptr + b * c_r4 * plane, constant + b * shape[1] * plane, plane, shape[1]);
+            }
+            packed_constants_.push_back(packed);
+        }
+    }
+    return TNN_OK;
+}
+
+// returns the operand of a block of Float4s, contiguous operands are read in place
+static const float *GetOperand(const FusedElementwiseOp &op, const float *packed, int broadcast_type,
+                               const float *input, const DimsVector &dims, int n, int c4, int hw, int len,
+                               float *scratch) {
+    if (op.operand == FusedElementwiseOperandInput) {
+        return input;
+    }
+
+    const int c4_count = UP_DIV(dims[1], 4);
+    const int plane    = dims[2] * dims[3];
+    if (broadcast_type == BroadcastTypeSingle || broadcast_type == BroadcastTypeChannel) {
+        Float4 v = Float4::load(broadcast_type == BroadcastTypeSingle ? packed : packed + c4 * 4);
+        for (int i = 0; i < len; i++) {
+            Float4::save(scratch + i * 4, v);
+        }
+        return scratch;
+    } else if (broadcast_type == BroadcastTypeElement) {
+        return packed + (c4 * plane + hw) * 4;
+    } else if (broadcast_type == BroadcastTypeNormal) {
+        return packed + ((n * c4_count + c4) * plane + hw) * 4;
+    } else {
+        for (int i = 0; i < len; i++) {
+            Float4::save(scratch + i * 4, Float4::load(packed + ((hw + i) % dims[3]) * 4));
+        }
+        return scratch;
+    }
+}
+
+static void ApplyOp(const FusedElementwiseOp &op, float *value, const float *operand, int len) {
+    switch (op.type) {
+        case FusedElementwiseOpAdd:
+            for (int i = 0; i < len; i++) {
+                Float4::save(value + i * 4, Float4::load(value + i * 4) + Float4::load(operand + i * 4));
+            }
+            break;
+        case FusedElementwiseOpSub:
+            for (int i = 0; i < len; i++) {
+                Float4 v = Float4::load(value + i * 4);
+                Float4 o = Float4::load(operand + i * 4);
+                Float4::save(value + i * 4, op.operand_first ? o - v : v - o);
+            }
+            break;
+        case FusedElementwiseOpMul:
+            for (int i = 0; i < len; i++) {
+                Float4::save(value + i * 4, Float4::load(value + i * 4) * Float4::load(operand + i * 4));
+            }
+            break;
+        case FusedElementwiseOpDiv:
+            for (int i = 0; i < len; i++) {
+                Float4 v = Float4::load(value + i * 4);
+                Float4 o = Float4::load(operand + i * 4);
+                Float4::save(value + i * 4, op.operand_first ? Float4::div(o, v) : Float4::div(v, o));
+            }
+            break;
+        case FusedElementwiseOpSigmoid:
+            for (int i = 0; i < len; i++) {
+                Float4::save(value + i * 4, Float4::sigmoid(Float4::load(value + i * 4)));
+            }
+            break;
+        case FusedElementwiseOpExp:
+            for (int i = 0; i < len; i++) {
+                Float4::save(value + i * 4, Float4::exp(Float4::load(value + i * 4)));
+            }
+            break;
+        case FusedElementwiseOpClip: {
+            Float4 vmin(op.alpha);
+            Float4 vmax(op.beta);
+            for (int i = 0; i < len; i++) {
+                Float4::save(value + i * 4, Float4::min(Float4::max(Float4::load(value + i * 4), vmin), vmax));
+            }
+        } break;
+        case FusedElementwiseOpHardSigmoid: {
+            Float4 vzero(0.f);
+            Float4 vone(1.f);
+            Float4 vbeta(op.beta);
+            for (int i = 0; i < len; i++) {
+                Float4 v = Float4::load(value + i * 4) * op.alpha + vbeta;
+                Float4::save(value + i * 4, Float4::min(Float4::max(v, vzero), vone));
+            }
+        } break;
+        default:
+            break;
+    }
+}
+
+template <typename T>
+Status ArmFusedElementwiseLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto layer_param = dynamic_cast<FusedElementwiseLayerParam *>(param_);
+    CHECK_PARAM_NULL(layer_param);
+    auto &ops = layer_param->ops;
+    for (auto &op : ops) {
+        if (op.operand == FusedElementwiseOperandConstant && op.constant_index >= packed_constants_.size()) {
+            LOGE("Error: fused elementwise constant is missing\n");
+            return Status(TNNERR_LAYER_ERR, "Error: fused elementwise constant is missing");
+        }
+    }
+
+    bool use_input = false;
+    for (auto &op : ops) {
+        use_input = use_input || op.operand == FusedElementwiseOperandInput;
+    }
+
+    auto dims             = outputs[0]->GetBlobDesc().dims;
+    const int c4_count    = UP_DIV(dims[1], 4);
+    const int planes      = dims[0] * c4_count;
+    const int plane       = dims[2] * dims[3];
+    const int c_remain    = dims[1] % 4;
+    auto &broadcast_types = constant_broadcast_types_;
+    auto input_ptr        = reinterpret_cast<T *>(GetBlobHandlePtr(inputs[0]->GetHandle()));
+    auto output_ptr       = reinterpret_cast<T *>(GetBlobHandlePtr(outputs[0]->GetHandle()));
+
+    OMP_PARALLEL_FOR_
+    for (int p = 0; p < planes; p++) {
+        float value[kFusedElementwiseBlock * 4];
+        float input[kFusedElementwiseBlock * 4];
+        float scratch[kFusedElementwiseBlock * 4];
+        const int n  = p / c4_count;
+        const int c4 = p % c4_count;
+        for (int hw = 0; hw < plane; hw += kFusedElementwiseBlock) {
+            const int len = std::min(kFusedElementwiseBlock, plane - hw);
+            auto src      = input_ptr + (p * plane + hw) * 4;
+            for (int i = 0; i < len; i++) {
+                Float4::save(value + i * 4, Float4::load(src + i * 4));
+            }
+            if (use_input) {
+                memcpy(input, value, len * 4 * sizeof(float));
+            }
+
+            for (auto &op : ops) {
+                const float *operand = nullptr;
+                if (op.operand != FusedElementwiseOperandNone) {
+                    int type            = BroadcastTypeNormal;
+                    const float *packed = nullptr;
+                    if (op.operand == FusedElementwiseOperandConstant) {
+                        type   = broadcast_types[op.constant_index];
+                        packed = packed_constants_[op.constant_index].force_to<float *>();
+                    }
+                    operand = GetOperand(op, packed, type, input, dims, n, c4, hw, len, scratch);
+                }
+                ApplyOp(op, value, operand, len);
+            }
+
+            // keep the padded channels of the last c4 plane zero
+            if (c_remain > 0 && c4 == c4_count - 1) {
+                for (int i = 0; i < len; i++) {
+                    for (int c = c_remain; c < 4; c++) {
+                        value[i * 4 + c] = 0.f;
+                    }
+                }
+            }
+
+            auto dst = output_ptr + (p * plane + hw) * 4;
+            for (int i = 0; i < len; i++) {
+                Float4::save(dst + i * 4, Float4::load(value + i * 4));
+            }
+        }
+    }
+    return TNN_OK;
+}
+
+Status ArmFusedElementwiseLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto data_type = inputs[0]->GetBlobDesc().data_type;
+    if (data_type == DATA_TYPE_FLOAT) {
+        return Exec<float>(inputs, outputs);
+    } else if (data_type == DATA_TYPE_BFP16) {
+        return Exec<bfp16_t>(inputs, outputs);
+    }
+    return Status(TNNERR_LAYER_ERR, "Error: ArmFusedElementwiseLayerAcc got unsupported data type");
+}
+
+REGISTER_ARM_ACC(FusedElementwise, LAYER_FUSED_ELEMENTWISE)
+
+}  // namespace TNN_NS
@@ -0,0 +1,51 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_DEVICE_ARM_ARM_FUSED_ELEMENTWISE_LAYER_ACC_H_
+#define TNN_SOURCE_TNN_DEVICE_ARM_ARM_FUSED_ELEMENTWISE_LAYER_ACC_H_
+
+#include <vector>
+
+#include "tnn/device/arm/acc/arm_layer_acc.h"
+#include "tnn/device/arm/arm_common.h"
+
+namespace TNN_NS {
+
+// @brief runs the expression program of a fused elementwise chain in one pass over memory
+class ArmFusedElementwiseLayerAcc : public ArmLayerAcc {
+public:
+    virtual ~ArmFusedElementwiseLayerAcc();
+
+    virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
+
+    virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) override;
+
+    virtual size_t GetPackedWeightBytes() override;
+
+protected:
+    virtual bool DataTypeSupported(DataType data_type) override;
+
+private:
+    template <typename T>
+    Status Exec(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+
+    // constants packed to nc4hw4, width broadcast constants are repeated on the 4 lanes
+    std::vector<RawBuffer> packed_constants_;
+    // BroadcastType of each constant against the current output shape
+    std::vector<int> constant_broadcast_types_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_DEVICE_ARM_ARM_FUSED_ELEMENTWISE_LAYER_ACC_H_
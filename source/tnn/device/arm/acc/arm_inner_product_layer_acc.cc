@@ -25,6 +25,10 @@ namespace TNN_NS {
 
 ArmInnerProductLayerAcc::~ArmInnerProductLayerAcc() {}
 
+size_t ArmInnerProductLayerAcc::GetPackedWeightBytes() {
+    return buffer_weight_.GetBytesSize() + buffer_bias_.GetBytesSize() + buffer_scale_.GetBytesSize();
+}
+
 // pack int8 kernel: round up c8, round up oc4
 static void packweight_i8(const int8_t *src, int8_t *dst, const int oc, const int ic) {
     auto dst_step = ROUND_UP(ic, 8);
@@ -21,6 +21,7 @@
 #include "tnn/core/profile.h"
 #include "tnn/device/arm/acc/arm_layer_acc.h"
 #include "tnn/device/arm/arm_context.h"
+#include "tnn/utils/layer_cost_utils.h"
 
 namespace TNN_NS {
 
@@ -29,9 +30,11 @@ Status ArmLayerAcc::Init(Context *context, LayerParam *param, LayerResource *res
     AbstractLayerAcc::Init(context, param, resource, inputs, outputs);
     context_ = reinterpret_cast<ArmContext *>(context);
 
-    param_    = param;
-    resource_ = resource;
-    k_param_  = std::make_shared<ArmKernelParam>();
+    param_        = param;
+    resource_     = resource;
+    k_param_      = std::make_shared<ArmKernelParam>();
+    input_blobs_  = inputs;
+    output_blobs_ = outputs;
 
     for (auto blob : inputs) {
         if (blob->GetBlobDesc().data_type == DATA_TYPE_HALF)
@@ -69,6 +72,34 @@ std::vector<DataFormat> ArmLayerAcc::SupportDataFormat(DataType data_type, int d
 
 ArmLayerAcc::~ArmLayerAcc() {}
 
+static std::vector<DimsVector> GetBlobsDims(const std::vector<Blob *> &blobs) {
+    std::vector<DimsVector> dims;
+    for (auto blob : blobs) {
+        dims.push_back(blob->GetBlobDesc().dims);
+    }
+    return dims;
+}
+
+double ArmLayerAcc::GetFlops() {
+    if (!param_) {
+        return 0;
+    }
+    return GetLayerFlops(GlobalConvertLayerType(param_->type), param_, resource_, GetBlobsDims(input_blobs_),
+                         GetBlobsDims(output_blobs_));
+}
+
+double ArmLayerAcc::GetBandwidth() {
+    if (!param_ || input_blobs_.empty()) {
+        return 0;
+    }
+    double weight_bytes = GetPackedWeightBytes();
+    if (weight_bytes == 0) {
+        weight_bytes = GetLayerRuntimeResourceBytes(resource_);
+    }
+    return GetLayerBandwidth(GlobalConvertLayerType(param_->type), param_, GetBlobsDims(input_blobs_),
+                             GetBlobsDims(output_blobs_), input_blobs_[0]->GetBlobDesc().data_type, weight_bytes);
+}
+
 Status ArmLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     // reinit k_param_ h,w
     auto input_dim  = inputs[0]->GetBlobDesc().dims;
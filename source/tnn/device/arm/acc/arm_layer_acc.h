@@ -58,6 +58,11 @@ public:
      */
     virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+    // @brief flops of the direct algorithm, so winograd and gemm convs are reported with effective flops
+    virtual double GetFlops();
+
+    virtual double GetBandwidth();
+
 #if TNN_PROFILE
     Timer timer;
 #endif
@@ -69,6 +74,9 @@ protected:
     ArmContext *context_                     = nullptr;
     std::shared_ptr<ArmKernelParam> k_param_ = nullptr;
 
+    std::vector<Blob *> input_blobs_;
+    std::vector<Blob *> output_blobs_;
+
     virtual bool DataTypeSupported(DataType data_type);
 
 private:
@@ -13,8 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/arm/acc/arm_nchw_layer_acc.h"
-#include "tnn/utils/dims_vector_utils.h"
-#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/permute_utils.h"
 
 namespace TNN_NS {
 
@@ -24,26 +23,21 @@ Status ArmPermuteLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
     auto permute_param = dynamic_cast<PermuteLayerParam *>(param_);
     CHECK_PARAM_NULL(permute_param);
 
+    // the output is a view of the input, see BlobManager::IsViewLayer
+    if (GetBlobHandlePtr(inputs[0]->GetHandle()) == GetBlobHandlePtr(outputs[0]->GetHandle())) {
+        return TNN_OK;
+    }
+
     AllocConvertBuffer(inputs, outputs);
 
     UnPackInputs(inputs);
-    auto input_dims     = nchw_blob_in[0]->GetBlobDesc().dims;
-    auto output_dims    = nchw_blob_out[0]->GetBlobDesc().dims;
-
-    std::vector<int> input_step;
-    std::vector<int> output_step;
-    int num_dims = int(input_dims.size());
-    int output_count = DimsVectorUtils::Count(output_dims);
-    for (int i = 0; i < input_dims.size(); ++i) {
-        input_step.push_back(DimsVectorUtils::Count(input_dims, i + 1));
-        output_step.push_back(DimsVectorUtils::Count(output_dims, i + 1));
-    }
+    auto input_dims = nchw_blob_in[0]->GetBlobDesc().dims;
 
     if (outputs[0]->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
         float *input_data  = reinterpret_cast<float *>(GetBlobHandlePtr(nchw_blob_in[0]->GetHandle()));
         float *output_data = reinterpret_cast<float *>(GetBlobHandlePtr(nchw_blob_out[0]->GetHandle()));
-        NaivePermute<float>(output_count, input_data, permute_param->orders, input_step, output_step, num_dims,
-                            output_data);
+        RETURN_ON_NEQ(PermuteUtils::Permute(input_data, output_data, input_dims, permute_param->orders, sizeof(float)),
+                      TNN_OK);
     }
     PackOutputs(outputs);
     return TNN_OK;
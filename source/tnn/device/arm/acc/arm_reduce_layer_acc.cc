@@ -25,7 +25,15 @@ ArmReduceLayerAcc::~ArmReduceLayerAcc() {}
 Status ArmReduceLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
                                const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto ret = ArmLayerAcc::Init(context, param, resource, inputs, outputs);
-    return ret;
+    RETURN_ON_NEQ(ret, TNN_OK);
+
+    auto reduce_param = dynamic_cast<ReduceLayerParam *>(param);
+    CHECK_PARAM_NULL(reduce_param);
+    if (reduce_param->axis.size() != 1 || reduce_param->all_reduce) {
+        LOGE("Error: arm reduce supports a single axis\n");
+        return Status(TNNERR_LAYER_ERR, "Error: arm reduce supports a single axis");
+    }
+    return TNN_OK;
 }
 
 Status ArmReduceLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
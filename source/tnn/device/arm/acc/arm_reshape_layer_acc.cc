@@ -37,9 +37,14 @@ Status ArmReshapeLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
     int data_byte_size = DataTypeUtils::GetBytesSize(output->GetBlobDesc().data_type);
     auto size_in_bytes = dims_input[0] * ROUND_UP(dims_input[1], 4) * dims_input[2] * dims_input[3] * data_byte_size;
 
-    void *workspace = context_->GetSharedWorkSpace(size_in_bytes);
     char *input_origin  = GetBlobHandlePtr(input->GetHandle());
     char *output_origin = GetBlobHandlePtr(output->GetHandle());
+    // the output is a view of the input, see BlobManager::IsViewLayer
+    if (input_origin == output_origin) {
+        return TNN_OK;
+    }
+
+    void *workspace = context_->GetSharedWorkSpace(size_in_bytes);
 
     if (DATA_FORMAT_NC4HW4 == input->GetBlobDesc().data_format) {
         for (int b = 0; b < dims_output[0]; b++) {
@@ -69,5 +74,6 @@ Status ArmReshapeLayerAcc::DoForward(const std::vector<Blob *> &inputs, const st
 }
 
 REGISTER_ARM_ACC(Reshape, LAYER_RESHAPE);
+REGISTER_ARM_ACC(Reshape, LAYER_FLATTEN);
 
 }  // namespace TNN_NS
@@ -13,15 +13,50 @@
 // specific language governing permissions and limitations under the License.
 #include "tnn/device/arm/acc/arm_softmax_layer_acc.h"
 
-#include <cmath>
+#include <algorithm>
+
 #include "tnn/device/arm/acc/arm_layer_acc.h"
 #include "tnn/device/arm/arm_common.h"
 #include "tnn/device/arm/arm_context.h"
 #include "tnn/utils/bfp16_utils.h"
 #include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/softmax_utils.h"
 
 namespace TNN_NS {
 
+// Float4 for SoftmaxUtils
+struct SoftmaxFloat4 {
+    typedef Float4 F;
+    static const int kWidth = 4;
+
+    static inline F Load(const float *p) {
+        return Float4::load(p);
+    }
+    static inline void Save(float *p, F v) {
+        Float4::save(p, v);
+    }
+    static inline F Set(float v) {
+        return Float4(v);
+    }
+    static inline F Add(F a, F b) {
+        return a + b;
+    }
+    static inline F Sub(F a, F b) {
+        return a - b;
+    }
+    static inline F Mul(F a, F b) {
+        return a * b;
+    }
+    static inline F Max(F a, F b) {
+        return Float4::max(a, b);
+    }
+    static inline F Exp(F v) {
+        return Float4::exp(v);
+    }
+};
+typedef SoftmaxUtils<SoftmaxFloat4> Softmax;
+
 Status ArmSoftmaxLayerAcc::DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto in_data_type = inputs[0]->GetBlobDesc().data_type;
     if (in_data_type == DATA_TYPE_FLOAT) {
@@ -45,13 +80,12 @@ Status ArmSoftmaxLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::ve
     auto input  = inputs[0];
     auto output = outputs[0];
 
-    int data_byte_size = sizeof(float);
-
     auto dims    = output->GetBlobDesc().dims;
     auto width   = dims[3];
     auto height  = dims[2];
     auto batch   = dims[0];
-    size_t count = width * height * batch * dims[1];
+    // blobs are packed in c4
+    size_t count = width * height * batch * ROUND_UP(dims[1], 4);
 
     int inside  = 1;
     int outside = 1;
@@ -66,11 +100,20 @@ Status ArmSoftmaxLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::ve
     }
     auto step_y = channel * inside;
 
-    RawBuffer reorder_buffer(dims[1] * dims[2] * dims[3] * data_byte_size);
-    RawBuffer max_value_buffer(inside * data_byte_size);
-    RawBuffer sum_value_buffer(inside * data_byte_size);
-    RawBuffer input_buffer(count * sizeof(float));
-    RawBuffer output_buffer(count * sizeof(float));
+    int tile, block_size;
+    size_t workspace_per_thread;
+    Softmax::Layout(channel, inside, tile, block_size, workspace_per_thread);
+    int tiles = UP_DIV(inside, tile);
+    int tasks = outside * tiles;
+
+    // reorder buffer, per thread scratch, then the float copies of bfp16 blobs
+    size_t reorder_count   = ROUND_UP(dims[1] * dims[2] * dims[3], 16);
+    size_t workspace_count = workspace_per_thread * OMP_MAX_THREADS_NUM_;
+    size_t convert_count   = in_data_type == DATA_TYPE_BFP16 ? count : 0;
+    float *workspace       = static_cast<float *>(context_->GetSharedWorkSpace(
+        (reorder_count + workspace_count + 2 * convert_count) * sizeof(float)));
+    float *reorder_ptr     = workspace;
+    float *scratch         = workspace + reorder_count;
 
     float *input_orign  = nullptr;
     float *output_orign = nullptr;
@@ -79,60 +122,34 @@ Status ArmSoftmaxLayerAcc::Exec(const std::vector<Blob *> &inputs, const std::ve
         output_orign = reinterpret_cast<float *>(GetBlobHandlePtr(output->GetHandle()));
     } else if (in_data_type == DATA_TYPE_BFP16) {
         bfp16_t *in_ptr = reinterpret_cast<bfp16_t *>(GetBlobHandlePtr(input->GetHandle()));
-        input_orign     = input_buffer.force_to<float *>();
-        output_orign    = output_buffer.force_to<float *>();
+        input_orign     = scratch + workspace_count;
+        output_orign    = input_orign + convert_count;
         ConvertFromBFP16ToFloat(in_ptr, input_orign, count);
     } else {
         return TNNERR_LAYER_ERR;
     }
 
-    auto *max_value_ptr = max_value_buffer.force_to<float *>();
-    auto *sum_value_ptr = sum_value_buffer.force_to<float *>();
-
     for (int batch_idx = 0; batch_idx < batch; batch_idx++) {
         auto input_ptr  = input_orign + batch_idx * width * height * ROUND_UP(dims[1], 4);
         auto output_ptr = output_orign + batch_idx * width * height * ROUND_UP(dims[1], 4);
 
-        UnpackC4(output_ptr, input_ptr, width * height, dims[1]);
-
-        for (int y = 0; y < outside; y++) {
-            auto src_y = output_ptr + y * step_y;
-            auto dst_y = reorder_buffer.force_to<float *>() + y * step_y;
-            memcpy(max_value_ptr, src_y, sizeof(float) * inside);
-
-            auto src = src_y + inside;
-            for (int c = 1; c < channel; ++c, src += inside) {
-                for (int x = 0; x < inside; ++x) {
-                    if (src[x] > max_value_ptr[x])
-                        max_value_ptr[x] = src[x];
-                }
-            }
-
-            memset(sum_value_ptr, 0, sizeof(float) * inside);
-            src        = src_y;
-            float *dst = dst_y;
-            for (int c = 0; c < channel; ++c, src += inside, dst += inside) {
-                for (int x = 0; x < inside; ++x) {
-                    dst[x] = std::exp(src[x] - max_value_ptr[x]);
-                }
-            }
-
-            dst = dst_y;
-            for (int c = 0; c < channel; ++c, src += inside, dst += inside) {
-                for (int x = 0; x < inside; ++x) {
-                    sum_value_ptr[x] += dst[x];
-                }
-            }
-
-            dst = dst_y;
-            for (int c = 0; c < channel; ++c, dst += inside) {
-                for (int x = 0; x < inside; ++x) {
-                    dst[x] /= sum_value_ptr[x];
-                }
+        UnpackC4(reorder_ptr, input_ptr, width * height, dims[1]);
+
+        OMP_PARALLEL_FOR_
+        for (int t = 0; t < tasks; t++) {
+            int y                 = t / tiles;
+            int lane_start        = t % tiles * tile;
+            float *data           = reorder_ptr + y * step_y + lane_start;
+            float *thread_scratch = scratch + workspace_per_thread * OMP_TID_;
+            if (inside == 1) {
+                Softmax::Row(data, data, channel, thread_scratch);
+            } else {
+                Softmax::Tile(data, data, channel, inside, std::min(tile, inside - lane_start), block_size,
+                              thread_scratch);
             }
         }
 
-        PackC4(output_ptr, reorder_buffer.force_to<float *>(), width * height, dims[1]);
+        PackC4(output_ptr, reorder_ptr, width * height, dims[1]);
     }
 
     if (in_data_type == DATA_TYPE_BFP16) {
@@ -33,6 +33,10 @@ bool ArmConvInt8LayerCommon::isPrefered(ConvLayerParam *param, const std::vector
 
 ArmConvInt8LayerCommon::~ArmConvInt8LayerCommon() {}
 
+size_t ArmConvInt8LayerCommon::GetPackedWeightBytes() {
+    return buffer_weight_.GetBytesSize() + buffer_bias_.GetBytesSize() + buffer_scale_.GetBytesSize();
+}
+
 Status ArmConvInt8LayerCommon::allocateBufferWeight(const std::vector<Blob *> &inputs,
                                                     const std::vector<Blob *> &outputs) {
     ConvLayerParam *conv_param = dynamic_cast<ConvLayerParam *>(param_);
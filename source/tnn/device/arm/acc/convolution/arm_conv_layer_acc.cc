@@ -25,6 +25,7 @@
 #include "tnn/device/arm/acc/convolution/arm_conv_layer_depthwise.h"
 #include "tnn/device/arm/acc/convolution/arm_conv_layer_depthwise_s1.h"
 #include "tnn/interpreter/raw_buffer.h"
+#include "tnn/utils/layer_cost_utils.h"
 
 namespace TNN_NS {
 
@@ -67,6 +68,11 @@ Status ArmConvLayerAcc::Init(Context *context, LayerParam *param, LayerResource
 
 ArmConvLayerAcc::~ArmConvLayerAcc() {}
 
+size_t ArmConvLayerAcc::GetPackedWeightBytes() {
+    size_t bytes = conv_acc_impl_ ? conv_acc_impl_->GetPackedWeightBytes() : 0;
+    return bytes + (size_t)GetLayerResourceBytes(conv_acc_f32_resource_.get());
+}
+
 /*
 get different impl based on conv params
 ArmConvInt8LayerCommon always as the last solution
@@ -88,25 +94,43 @@ get different impl based on conv params
 ArmConvLayerCommon always as the last solution
 bfp16 impl included in fp impl
 */
+std::string ArmConvLayerAcc::GetImpFPName(ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                                          const std::vector<Blob *> &outputs) {
+    if (ArmConvLayerC3::isPrefered(param, inputs, outputs)) {
+        return "ArmConvLayerC3";
+    } else if (ArmConvLayer3x3::isPrefered(param, inputs, outputs)) {
+        return "ArmConvLayer3x3";
+    } else if (ArmConvLayer1x1::isPrefered(param, inputs, outputs)) {
+        return "ArmConvLayer1x1";
+    } else if (ArmConvLayerDepthwise::isPrefered(param, inputs, outputs)) {
+        if (ArmConvLayerDepthwiseS1::isPrefered(param, inputs, outputs)) {
+            return "ArmConvLayerDepthwiseS1";
+        }
+        return "ArmConvLayerDepthwise";
+    }
+    return "ArmConvLayerCommon";
+}
+
 void ArmConvLayerAcc::GetImpFP(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
-    if (ArmConvLayerC3::isPrefered(dynamic_cast<ConvLayerParam *>(param_), inputs, outputs)) {
+    auto imp_name = GetImpFPName(dynamic_cast<ConvLayerParam *>(param_), inputs, outputs);
+    if (imp_name == "ArmConvLayerC3") {
         if (!dynamic_cast<ArmConvLayerC3 *>(conv_acc_impl_.get())) {
             conv_acc_impl_ = std::make_shared<ArmConvLayerC3>();
         }
-    } else if (ArmConvLayer3x3::isPrefered(dynamic_cast<ConvLayerParam *>(param_), inputs, outputs)) {
+    } else if (imp_name == "ArmConvLayer3x3") {
         if (!dynamic_cast<ArmConvLayer3x3 *>(conv_acc_impl_.get())) {
             conv_acc_impl_ = std::make_shared<ArmConvLayer3x3>();
         }
-    } else if (ArmConvLayer1x1::isPrefered(dynamic_cast<ConvLayerParam *>(param_), inputs, outputs)) {
+    } else if (imp_name == "ArmConvLayer1x1") {
         if (!dynamic_cast<ArmConvLayer1x1 *>(conv_acc_impl_.get())) {
             conv_acc_impl_ = std::make_shared<ArmConvLayer1x1>();
         }
-    } else if (ArmConvLayerDepthwise::isPrefered(dynamic_cast<ConvLayerParam *>(param_), inputs, outputs)) {
-        if (ArmConvLayerDepthwiseS1::isPrefered(dynamic_cast<ConvLayerParam *>(param_), inputs, outputs)) {
-            if (!dynamic_cast<ArmConvLayerDepthwiseS1 *>(conv_acc_impl_.get())) {
-                conv_acc_impl_ = std::make_shared<ArmConvLayerDepthwiseS1>();
-            }
-        } else if (!dynamic_cast<ArmConvLayerDepthwise *>(conv_acc_impl_.get())) {
+    } else if (imp_name == "ArmConvLayerDepthwiseS1") {
+        if (!dynamic_cast<ArmConvLayerDepthwiseS1 *>(conv_acc_impl_.get())) {
+            conv_acc_impl_ = std::make_shared<ArmConvLayerDepthwiseS1>();
+        }
+    } else if (imp_name == "ArmConvLayerDepthwise") {
+        if (!dynamic_cast<ArmConvLayerDepthwise *>(conv_acc_impl_.get())) {
             conv_acc_impl_ = std::make_shared<ArmConvLayerDepthwise>();
         }
     }
@@ -32,6 +32,13 @@ public:
 
     virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+    // @brief the fp32 copy of bfp16 weights plus the weights packed by the impl
+    virtual size_t GetPackedWeightBytes();
+
+    // @brief class name of the fp impl chosen by GetImpFP for the param and blob shapes
+    static std::string GetImpFPName(ConvLayerParam *param, const std::vector<Blob *> &inputs,
+                                    const std::vector<Blob *> &outputs);
+
 private:
     void GetImpInt8(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
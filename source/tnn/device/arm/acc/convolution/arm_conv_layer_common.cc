@@ -38,6 +38,10 @@ bool ArmConvLayerCommon::isPrefered(ConvLayerParam *param, const std::vector<Blo
 
 ArmConvLayerCommon::~ArmConvLayerCommon() {}
 
+size_t ArmConvLayerCommon::GetPackedWeightBytes() {
+    return buffer_weight_.GetBytesSize() + buffer_bias_.GetBytesSize();
+}
+
 Status ArmConvLayerCommon::allocateBufferWeight(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     ConvLayerParam *conv_param = dynamic_cast<ConvLayerParam *>(param_);
     CHECK_PARAM_NULL(conv_param);
@@ -21,6 +21,7 @@
 
 #include "tnn/device/arm/acc/deconvolution/arm_deconv_layer_common.h"
 #include "tnn/device/arm/acc/deconvolution/arm_deconv_layer_depthwise.h"
+#include "tnn/utils/layer_cost_utils.h"
 
 namespace TNN_NS {
 
@@ -65,6 +66,11 @@ Status ArmDeconvLayerAcc::Init(Context *context, LayerParam *param, LayerResourc
 
 ArmDeconvLayerAcc::~ArmDeconvLayerAcc() {}
 
+size_t ArmDeconvLayerAcc::GetPackedWeightBytes() {
+    size_t bytes = deconv_acc_impl_ ? deconv_acc_impl_->GetPackedWeightBytes() : 0;
+    return bytes + (size_t)GetLayerResourceBytes(deconv_acc_f32_resource_.get());
+}
+
 Status ArmDeconvLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     ArmLayerAcc::Reshape(inputs, outputs);
     // Todo
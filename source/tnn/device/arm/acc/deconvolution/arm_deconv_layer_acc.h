@@ -27,6 +27,7 @@ public:
                 const std::vector<Blob *> &outputs);
     virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
     virtual Status DoForward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+    virtual size_t GetPackedWeightBytes();
 
 protected:
     std::shared_ptr<ArmLayerAcc> deconv_acc_impl_           = nullptr;
@@ -50,6 +50,14 @@ int ArmContext::GetNumThreads() {
     return num_threads_;
 }
 
+size_t ArmContext::GetWorkSpaceBytes() {
+    size_t bytes = 0;
+    for (auto &buffer : work_space_) {
+        bytes += buffer.GetBytesSize();
+    }
+    return bytes;
+}
+
 void* ArmContext::GetSharedWorkSpace(size_t size) {
     return GetSharedWorkSpace(size, 0);
 }
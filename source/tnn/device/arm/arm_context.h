@@ -43,6 +43,9 @@ public:
     // @brief get threads run on device
     virtual int GetNumThreads();
 
+    // @brief bytes of the buffers handed out by GetSharedWorkSpace
+    virtual size_t GetWorkSpaceBytes() override;
+
     void* GetSharedWorkSpace(size_t size);
     void* GetSharedWorkSpace(size_t size, int index);
 
@@ -71,12 +71,14 @@ Status ArmDevice::Allocate(void **handle, BlobMemorySizeInfo &size_info) {
     if (handle) {
         int bytes_size = GetBlobMemoryBytesSize(size_info);
         *handle        = armMalloc(bytes_size + NEON_KERNEL_EXTRA_LOAD);
+        OnAllocate(*handle, bytes_size + NEON_KERNEL_EXTRA_LOAD);
     }
     return TNN_OK;
 }
 
 Status ArmDevice::Free(void *handle) {
     if (handle) {
+        OnFree(handle);
         free(handle);
     }
     return TNN_OK;
@@ -0,0 +1,223 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/cpu/acc/compute/compute_conv.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tnn/core/macro.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+// the unfolded input tile of a task is sized to stay in the l2 cache
+static const int kL2CacheBytes = 256 * 1024;
+static const int kMaxTileColumns = 512;
+
+struct ConvShape {
+    int input_channel;
+    int input_height;
+    int input_width;
+    int output_width;
+    int kernel_y;
+    int kernel_x;
+    int stride_y;
+    int stride_x;
+    int pad_y;
+    int pad_x;
+    int dilation;
+};
+
+int CPU_PACKED_CONV_WEIGHT_COUNT(int output_channel, int input_channel, int group, int kernel_y, int kernel_x) {
+    int output_channel_per_group = output_channel / group;
+    int k_count                  = input_channel / group * kernel_y * kernel_x;
+    return group * ROUND_UP(output_channel_per_group, CPU_GEMM_MR) * k_count;
+}
+
+template <typename Tw>
+void CPU_PACK_CONV_WEIGHTS(const Tw *weights, Tw *packed, int output_channel, int input_channel, int group,
+                           int kernel_y, int kernel_x) {
+    int output_channel_per_group = output_channel / group;
+    int k_count                  = input_channel / group * kernel_y * kernel_x;
+    int m_panels                 = UP_DIV(output_channel_per_group, CPU_GEMM_MR);
+
+    for (int g = 0; g < group; g++) {
+        const Tw *src = weights + g * output_channel_per_group * k_count;
+        for (int mp = 0; mp < m_panels; mp++) {
+            for (int k = 0; k < k_count; k++) {
+                for (int i = 0; i < CPU_GEMM_MR; i++) {
+                    int oc    = mp * CPU_GEMM_MR + i;
+                    *packed++ = oc < output_channel_per_group ? src[oc * k_count + k] : Tw(0);
+                }
+            }
+        }
+    }
+}
+
+template void CPU_PACK_CONV_WEIGHTS(const float *weights, float *packed, int output_channel, int input_channel,
+                                    int group, int kernel_y, int kernel_x);
+template void CPU_PACK_CONV_WEIGHTS(const int8_t *weights, int8_t *packed, int output_channel, int input_channel,
+                                    int group, int kernel_y, int kernel_x);
+
+/*
+ * Unfolds the columns [col_start, col_start + col_count) of one group of the input into panels of
+ * CPU_GEMM_NR columns, each panel laid out as [k][CPU_GEMM_NR]. Values in the padding and the
+ * columns past the tile are zero.
+ */
+template <typename Tin, typename Tw>
+static void Im2ColTile(const Tin *input, Tw *panels, int col_start, int col_count, const ConvShape &shape) {
+    int k_count     = shape.input_channel * shape.kernel_y * shape.kernel_x;
+    int input_size  = shape.input_height * shape.input_width;
+    int panel_count = UP_DIV(col_count, CPU_GEMM_NR);
+
+    for (int p = 0; p < panel_count; p++) {
+        Tw *panel = panels + p * k_count * CPU_GEMM_NR;
+        int y_start[CPU_GEMM_NR], x_start[CPU_GEMM_NR];
+        bool valid[CPU_GEMM_NR];
+        for (int j = 0; j < CPU_GEMM_NR; j++) {
+            int col    = col_start + p * CPU_GEMM_NR + j;
+            valid[j]   = p * CPU_GEMM_NR + j < col_count;
+            y_start[j] = col / shape.output_width * shape.stride_y - shape.pad_y;
+            x_start[j] = col % shape.output_width * shape.stride_x - shape.pad_x;
+        }
+
+        for (int c = 0; c < shape.input_channel; c++) {
+            const Tin *src = input + c * input_size;
+            for (int ky = 0; ky < shape.kernel_y; ky++) {
+                for (int kx = 0; kx < shape.kernel_x; kx++) {
+                    for (int j = 0; j < CPU_GEMM_NR; j++) {
+                        int y    = y_start[j] + ky * shape.dilation;
+                        int x    = x_start[j] + kx * shape.dilation;
+                        bool in  = valid[j] && y >= 0 && y < shape.input_height && x >= 0 && x < shape.input_width;
+                        panel[j] = in ? static_cast<Tw>(src[y * shape.input_width + x]) : Tw(0);
+                    }
+                    panel += CPU_GEMM_NR;
+                }
+            }
+        }
+    }
+}
+
+template <typename Tout>
+static inline void StoreResult(float result, Tout *dst, int oc, int activation_type, const float *scale,
+                               int scale_len) {
+    if (activation_type == ActivationType_ReLU) {
+        result = result > 0.0f ? result : 0.0f;
+    } else if (activation_type == ActivationType_ReLU6) {
+        result = std::min(std::max(result, 0.0f), 6.0f);
+    }
+    *dst = result;
+}
+
+static inline void StoreResult(int32_t result, int8_t *dst, int oc, int activation_type, const float *scale,
+                               int scale_len) {
+    float value = result * scale[scale_len == 1 ? 0 : oc];
+    if (activation_type == ActivationType_ReLU) {
+        value = std::max(0.0f, value);
+    }
+    *dst = float2int8(value);
+}
+
+template <typename Tin, typename Tw, typename Tacc, typename Tout>
+void CPU_CONV_GEMM(const void *input_ptr, void *output_ptr, const Tw *packed_weights, const void *bias,
+                   DimsVector dims_input, DimsVector dims_output, int stride_y, int stride_x, int kernel_y,
+                   int kernel_x, int pad_y, int pad_x, int group, int dilation, int activation_type,
+                   const float *scale, int scale_len) {
+    const Tin *input_data = static_cast<const Tin *>(input_ptr);
+    Tout *output_data     = static_cast<Tout *>(output_ptr);
+    const Tacc *bias_data = static_cast<const Tacc *>(bias);
+
+    int batch                    = dims_output[0];
+    int output_channel           = dims_output[1];
+    int input_channel            = dims_input[1];
+    int output_channel_per_group = output_channel / group;
+    int input_channel_per_group  = input_channel / group;
+    int output_size              = dims_output[2] * dims_output[3];
+    int input_size               = dims_input[2] * dims_input[3];
+
+    ConvShape shape = {input_channel_per_group, dims_input[2], dims_input[3], dims_output[3], kernel_y, kernel_x,
+                       stride_y, stride_x, pad_y, pad_x, dilation};
+    int k_count     = input_channel_per_group * kernel_y * kernel_x;
+    int m_panels    = UP_DIV(output_channel_per_group, CPU_GEMM_MR);
+
+    int tile_cols = kL2CacheBytes / (k_count * (int)sizeof(Tw));
+    tile_cols     = std::min(tile_cols, std::min(kMaxTileColumns, ROUND_UP(output_size, CPU_GEMM_NR)));
+    tile_cols     = std::max(tile_cols / CPU_GEMM_NR * CPU_GEMM_NR, CPU_GEMM_NR);
+    int tiles     = UP_DIV(output_size, tile_cols);
+    int tasks     = batch * group * tiles;
+
+    size_t workspace_per_thread = (size_t)k_count * tile_cols;
+    std::vector<Tw> workspace(workspace_per_thread * OMP_MAX_THREADS_NUM_);
+
+    OMP_PARALLEL_FOR_
+    for (int t = 0; t < tasks; t++) {
+        int tile      = t % tiles;
+        int g         = t / tiles % group;
+        int n         = t / tiles / group;
+        int col_start = tile * tile_cols;
+        int col_count = std::min(tile_cols, output_size - col_start);
+        Tw *panels    = workspace.data() + workspace_per_thread * OMP_TID_;
+
+        Im2ColTile(input_data + (n * input_channel + g * input_channel_per_group) * input_size, panels, col_start,
+                   col_count, shape);
+
+        const Tw *weights = packed_weights + g * m_panels * CPU_GEMM_MR * k_count;
+        Tout *dst         = output_data + (n * output_channel + g * output_channel_per_group) * output_size;
+        for (int mp = 0; mp < m_panels; mp++) {
+            const Tw *a = weights + mp * CPU_GEMM_MR * k_count;
+            for (int np = 0; np * CPU_GEMM_NR < col_count; np++) {
+                Tacc c[CPU_GEMM_MR][CPU_GEMM_NR];
+                CPU_GEMM_KERNEL(a, panels + np * k_count * CPU_GEMM_NR, k_count, c);
+
+                int rows = std::min(CPU_GEMM_MR, output_channel_per_group - mp * CPU_GEMM_MR);
+                int cols = std::min(CPU_GEMM_NR, col_count - np * CPU_GEMM_NR);
+                for (int i = 0; i < rows; i++) {
+                    int oc          = g * output_channel_per_group + mp * CPU_GEMM_MR + i;
+                    Tout *row       = dst + (mp * CPU_GEMM_MR + i) * output_size + col_start + np * CPU_GEMM_NR;
+                    Tacc bias_value = bias_data ? bias_data[oc] : Tacc(0);
+                    for (int j = 0; j < cols; j++) {
+                        StoreResult(c[i][j] + bias_value, row + j, oc, activation_type, scale, scale_len);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template void CPU_CONV_GEMM<float, float, float, float>(const void *input_ptr, void *output_ptr,
+                                                        const float *packed_weights, const void *bias,
+                                                        DimsVector dims_input, DimsVector dims_output, int stride_y,
+                                                        int stride_x, int kernel_y, int kernel_x, int pad_y, int pad_x,
+                                                        int group, int dilation, int activation_type,
+                                                        const float *scale, int scale_len);
+
+template void CPU_CONV_GEMM<bfp16_t, float, float, bfp16_t>(const void *input_ptr, void *output_ptr,
+                                                            const float *packed_weights, const void *bias,
+                                                            DimsVector dims_input, DimsVector dims_output,
+                                                            int stride_y, int stride_x, int kernel_y, int kernel_x,
+                                                            int pad_y, int pad_x, int group, int dilation,
+                                                            int activation_type, const float *scale, int scale_len);
+
+template void CPU_CONV_GEMM<int8_t, int8_t, int32_t, int8_t>(const void *input_ptr, void *output_ptr,
+                                                             const int8_t *packed_weights, const void *bias,
+                                                             DimsVector dims_input, DimsVector dims_output,
+                                                             int stride_y, int stride_x, int kernel_y, int kernel_x,
+                                                             int pad_y, int pad_x, int group, int dilation,
+                                                             int activation_type, const float *scale, int scale_len);
+
+}  // namespace TNN_NS
@@ -0,0 +1,69 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_CONV_H_
+#define TNN_CPU_COMPUTE_CONV_H_
+
+#include <stdint.h>
+
+#include "tnn/core/common.h"
+
+namespace TNN_NS {
+
+// rows of a packed weight panel and columns of a packed im2col panel in the gemm micro kernel
+#define CPU_GEMM_MR 4
+#define CPU_GEMM_NR 8
+
+// c = a * b of a packed panel of CPU_GEMM_MR rows and a packed panel of CPU_GEMM_NR columns, both
+// laid out k major. the accumulators stay in registers.
+template <typename Tw, typename Tacc>
+inline void CPU_GEMM_KERNEL(const Tw *a, const Tw *b, int k_count, Tacc c[CPU_GEMM_MR][CPU_GEMM_NR]) {
+    for (int i = 0; i < CPU_GEMM_MR; i++) {
+        for (int j = 0; j < CPU_GEMM_NR; j++) {
+            c[i][j] = 0;
+        }
+    }
+    for (int k = 0; k < k_count; k++) {
+        for (int i = 0; i < CPU_GEMM_MR; i++) {
+            Tacc a_value = a[i];
+            for (int j = 0; j < CPU_GEMM_NR; j++) {
+                c[i][j] += a_value * static_cast<Tacc>(b[j]);
+            }
+        }
+        a += CPU_GEMM_MR;
+        b += CPU_GEMM_NR;
+    }
+}
+
+// elements of the weights packed by CPU_PACK_CONV_WEIGHTS
+int CPU_PACKED_CONV_WEIGHT_COUNT(int output_channel, int input_channel, int group, int kernel_y, int kernel_x);
+
+// packs the oihw weights of each group into panels of CPU_GEMM_MR output channels, zero padded
+template <typename Tw>
+void CPU_PACK_CONV_WEIGHTS(const Tw *weights, Tw *packed, int output_channel, int input_channel, int group,
+                           int kernel_y, int kernel_x);
+
+// nchw conv as im2col + gemm with the packed weights, the results match NaiveConv:
+// fp32 with relu/relu6, bfp16 in and out with fp32 weights, int8 with int32 bias and accumulation
+// rescaled by scale. the input is unfolded in column tiles sized for the l2 cache, the tiles
+// run in parallel with openmp.
+template <typename Tin, typename Tw, typename Tacc, typename Tout>
+void CPU_CONV_GEMM(const void *input_ptr, void *output_ptr, const Tw *packed_weights, const void *bias,
+                   DimsVector dims_input, DimsVector dims_output, int stride_y, int stride_x, int kernel_y,
+                   int kernel_x, int pad_y, int pad_x, int group, int dilation, int activation_type,
+                   const float *scale, int scale_len);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_CONV_H_
@@ -0,0 +1,146 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/cpu/acc/compute/compute_depthwise.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+bool CPU_DEPTHWISE_SUPPORTED(int kernel_y, int kernel_x, int stride_y, int stride_x, int dilation_y, int dilation_x) {
+    return kernel_y == kernel_x && (kernel_x == 3 || kernel_x == 5) && stride_y == stride_x &&
+           (stride_x == 1 || stride_x == 2) && dilation_y == 1 && dilation_x == 1;
+}
+
+/*
+micro kernel of the depthwise conv, dst += the KERNEL x KERNEL window sliding over the cache lines.
+the width is the innermost loop so the compiler vectorizes across the output row.
+*/
+template <int KERNEL, int STRIDE>
+static void ConvDwSlideW(float *dst, const float *const *cache_line, const float *weight, int dst_width) {
+    for (int ky = 0; ky < KERNEL; ky++) {
+        const float *line = cache_line[ky];
+        for (int kx = 0; kx < KERNEL; kx++) {
+            const float w    = weight[ky * KERNEL + kx];
+            const float *src = line + kx;
+            for (int dx = 0; dx < dst_width; dx++) {
+                dst[dx] += w * src[dx * STRIDE];
+            }
+        }
+    }
+}
+
+typedef void (*ConvDwSlideFunc)(float *dst, const float *const *cache_line, const float *weight, int dst_width);
+
+static ConvDwSlideFunc GetSlideFunc(int kernel, int stride) {
+    if (kernel == 3) {
+        return stride == 1 ? ConvDwSlideW<3, 1> : ConvDwSlideW<3, 2>;
+    }
+    return stride == 1 ? ConvDwSlideW<5, 1> : ConvDwSlideW<5, 2>;
+}
+
+template <typename T>
+void CPU_CONV_DEPTHWISE(const void *input_ptr, void *output_ptr, const float *weights, const void *bias,
+                        DimsVector dims_input, DimsVector dims_output, int stride, int kernel, int pad_y, int pad_x,
+                        int activation_type) {
+    const T *input_data    = static_cast<const T *>(input_ptr);
+    T *output_data         = static_cast<T *>(output_ptr);
+    const float *bias_data = static_cast<const float *>(bias);
+    ConvDwSlideFunc slide  = GetSlideFunc(kernel, stride);
+
+    const int batch         = dims_output[0];
+    const int channel       = dims_output[1];
+    const int output_height = dims_output[2];
+    const int output_width  = dims_output[3];
+    const int input_height  = dims_input[2];
+    const int input_width   = dims_input[3];
+
+    // a cache line holds an input row with the left and right padding as zeros
+    const int line_width = (output_width - 1) * stride + kernel;
+    const int copy_begin = std::min(pad_x, line_width);
+    const int copy_end   = std::max(copy_begin, std::min(pad_x + input_width, line_width));
+
+    // per thread: kernel cache lines, then the accumulated output row
+    size_t workspace_per_thread = (size_t)kernel * line_width + output_width;
+    std::vector<float> workspace(workspace_per_thread * OMP_MAX_THREADS_NUM_);
+
+    OMP_PARALLEL_FOR_
+    for (int bc = 0; bc < batch * channel; bc++) {
+        int c            = bc % channel;
+        const T *src     = input_data + (size_t)bc * input_height * input_width;
+        T *dst           = output_data + (size_t)bc * output_height * output_width;
+        const float *w   = weights + c * kernel * kernel;
+        float bias_value = bias_data ? bias_data[c] : 0.0f;
+
+        float *lines = workspace.data() + workspace_per_thread * OMP_TID_;
+        float *acc   = lines + kernel * line_width;
+        // the padding columns stay zero, only the input columns are loaded
+        std::fill(lines, lines + kernel * line_width, 0.0f);
+
+        // padded row r lives in slot r % kernel, each input row is loaded once
+        int loaded_rows = 0;
+        const float *cache_line[5];
+        for (int dy = 0; dy < output_height; dy++) {
+            int first_row = dy * stride;
+            for (; loaded_rows < first_row + kernel; loaded_rows++) {
+                float *line = lines + (loaded_rows % kernel) * line_width;
+                int sy      = loaded_rows - pad_y;
+                if (sy < 0 || sy >= input_height) {
+                    std::fill(line + copy_begin, line + copy_end, 0.0f);
+                    continue;
+                }
+                const T *row = src + sy * input_width + copy_begin - pad_x;
+                for (int x = copy_begin; x < copy_end; x++) {
+                    line[x] = static_cast<float>(*row++);
+                }
+            }
+            for (int ky = 0; ky < kernel; ky++) {
+                cache_line[ky] = lines + ((first_row + ky) % kernel) * line_width;
+            }
+
+            std::fill(acc, acc + output_width, bias_value);
+            slide(acc, cache_line, w, output_width);
+
+            T *dst_row = dst + dy * output_width;
+            if (activation_type == ActivationType_ReLU) {
+                for (int dx = 0; dx < output_width; dx++) {
+                    dst_row[dx] = std::max(acc[dx], 0.0f);
+                }
+            } else if (activation_type == ActivationType_ReLU6) {
+                for (int dx = 0; dx < output_width; dx++) {
+                    dst_row[dx] = std::min(std::max(acc[dx], 0.0f), 6.0f);
+                }
+            } else {
+                for (int dx = 0; dx < output_width; dx++) {
+                    dst_row[dx] = acc[dx];
+                }
+            }
+        }
+    }
+}
+
+template void CPU_CONV_DEPTHWISE<float>(const void *input_ptr, void *output_ptr, const float *weights,
+                                        const void *bias, DimsVector dims_input, DimsVector dims_output, int stride,
+                                        int kernel, int pad_y, int pad_x, int activation_type);
+
+template void CPU_CONV_DEPTHWISE<bfp16_t>(const void *input_ptr, void *output_ptr, const float *weights,
+                                          const void *bias, DimsVector dims_input, DimsVector dims_output,
+                                          int stride, int kernel, int pad_y, int pad_x, int activation_type);
+
+}  // namespace TNN_NS
@@ -0,0 +1,36 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_DEPTHWISE_H_
+#define TNN_CPU_COMPUTE_DEPTHWISE_H_
+
+#include "tnn/core/common.h"
+
+namespace TNN_NS {
+
+// whether CPU_CONV_DEPTHWISE has a kernel for the window, 3x3 or 5x5 with stride 1 or 2 and no dilation
+bool CPU_DEPTHWISE_SUPPORTED(int kernel_y, int kernel_x, int stride_y, int stride_x, int dilation_y, int dilation_x);
+
+// nchw depthwise conv with the oihw weights of one input channel per group, fp32 or bfp16 blobs.
+// the padded input rows of a channel slide through kernel sized cache lines, each output row is
+// accumulated across the width and written with the bias and relu/relu6 applied. channels run in
+// parallel with openmp.
+template <typename T>
+void CPU_CONV_DEPTHWISE(const void *input_ptr, void *output_ptr, const float *weights, const void *bias,
+                        DimsVector dims_input, DimsVector dims_output, int stride, int kernel, int pad_y, int pad_x,
+                        int activation_type);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_DEPTHWISE_H_
@@ -15,8 +15,6 @@
 #include "tnn/device/cpu/acc/compute/compute_elewise.h"
 
 #include <cstring>
-#include <functional>
-#include <type_traits>
 
 #include "math.h"
 
@@ -27,113 +25,233 @@
 
 namespace TNN_NS {
 
-typedef std::function<float(float, float)> ELEWISE_OP;
+CpuBroadcastPlan CPU_BROADCAST_PLAN(const DimsVector &input_shape, const DimsVector &output_shape) {
+    CpuBroadcastPlan plan;
+    const int rank = (int)output_shape.size();
+    DimsVector dims(rank, 1);
+    for (int i = 0; i < (int)input_shape.size() && i < rank; i++) {
+        dims[rank - 1 - i] = input_shape[input_shape.size() - 1 - i];
+    }
+
+    // group the output dims into runs the operand either follows or broadcasts over,
+    // dims of size 1 join any run
+    std::vector<bool> run_broadcast;
+    std::vector<int> run_size;
+    int input_count = 1;
+    for (int i = 0; i < rank; i++) {
+        input_count *= dims[i];
+        if (output_shape[i] == 1) {
+            continue;
+        }
+        bool broadcast = dims[i] == 1;
+        if (run_broadcast.empty() || run_broadcast.back() != broadcast) {
+            run_broadcast.push_back(broadcast);
+            run_size.push_back(1);
+        }
+        run_size.back() *= output_shape[i];
+    }
+
+    const int runs = (int)run_broadcast.size();
+    if (runs == 0 || (runs == 1 && !run_broadcast[0])) {
+        plan.pattern = CPU_BROADCAST_SAME;
+    } else if (input_count == 1) {
+        plan.pattern = CPU_BROADCAST_SCALAR;
+    } else if (runs == 2 && run_broadcast[0]) {
+        plan.pattern = CPU_BROADCAST_ROW;
+        plan.outer   = run_size[0];
+        plan.inner   = run_size[1];
+    } else if (runs == 2 || (runs == 3 && run_broadcast[0])) {
+        plan.pattern = CPU_BROADCAST_CHANNEL;
+        plan.outer   = runs == 3 ? run_size[0] : 1;
+        plan.mid     = run_size[runs - 2];
+        plan.inner   = run_size[runs - 1];
+    } else {
+        plan.pattern = CPU_BROADCAST_GENERAL;
+        plan.dims    = output_shape;
+        plan.strides = DimsVector(rank, 0);
+        int stride   = 1;
+        for (int i = rank - 1; i >= 0; i--) {
+            plan.strides[i] = dims[i] == 1 ? 0 : stride;
+            stride *= dims[i];
+        }
+    }
+    return plan;
+}
+
+struct MinOp {
+    static inline float Apply(float a, float b) {
+        return std::min(a, b);
+    }
+};
+struct MaxOp {
+    static inline float Apply(float a, float b) {
+        return std::max(a, b);
+    }
+};
+struct MulOp {
+    static inline float Apply(float a, float b) {
+        return a * b;
+    }
+};
+struct AddOp {
+    static inline float Apply(float a, float b) {
+        return a + b;
+    }
+};
+struct DivOp {
+    static inline float Apply(float a, float b) {
+        return a / b;
+    }
+};
+struct SubOp {
+    static inline float Apply(float a, float b) {
+        return a - b;
+    }
+};
+// broadcasts the first input into the output
+struct CopyOp {
+    static inline float Apply(float a, float b) {
+        return b;
+    }
+};
 
 /*
- * Output[i] = input0[i] op input1[i] op ... op  input..n[i]
- * CPU_ELEWISE supports broadcast on all dimensions
+ * output[i] = OP(a[i], b[broadcast index of i]), a has the output shape.
+ * the loops of each pattern are inlined per op so they vectorize.
  */
-void CPU_ELEWISE(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
-                 DimsVector shape_output, ELEWISE_OP op) {
-    const int batch        = shape_output[0];
-    const int channel      = shape_output[1];
-    const int height       = shape_output[2];
-    const int width        = shape_output[3];
-    const int channel_size = height * width;
-    const int count        = shape_output[0] * shape_output[1] * shape_output[2] * shape_output[3];
-    float *output_data     = static_cast<float *>(output);
-
-    for (int i = 0; i < input_ptrs.size(); i++) {
-        float *input_data = static_cast<float *>(input_ptrs[i]);
-        auto input_shape  = input_shapes[i];
-
-        for (int b = 0; b < batch; b++) {
-            int output_index_b = b * channel * channel_size;
-
-            int input_index_b = std::min(b, input_shape[0] - 1) * input_shape[1] * input_shape[2] * input_shape[3];
-            OMP_PARALLEL_FOR_
-            for (int c = 0; c < channel; c++) {
-                int output_index_c = c * channel_size + output_index_b;
-
-                int input_index_c = std::min(c, input_shape[1] - 1) * input_shape[2] * input_shape[3] + input_index_b;
-                for (int h = 0; h < height; h++) {
-                    int output_index_h = h * width + output_index_c;
-
-                    int input_index_h = std::min(h, input_shape[2] - 1) * input_shape[3] + input_index_c;
-                    for (int w = 0; w < width; w++) {
-                        int input_index_w = std::min(w, input_shape[3] - 1) + input_index_h;
-                        float new_value;
-                        if (i == 0) {
-                            new_value = input_data[input_index_w];
-                        } else {
-                            new_value = op(output_data[output_index_h + w], input_data[input_index_w]);
-                        }
-                        output_data[output_index_h + w] = new_value;
-                    }
-                }
+template <typename OP>
+static void BinaryBroadcast(const float *a, const float *b, const CpuBroadcastPlan &plan, float *output, int count) {
+    if (plan.pattern == CPU_BROADCAST_SAME) {
+        OMP_PARALLEL_FOR_
+        for (int i = 0; i < count; i++) {
+            output[i] = OP::Apply(a[i], b[i]);
+        }
+    } else if (plan.pattern == CPU_BROADCAST_SCALAR) {
+        const float value = b[0];
+        OMP_PARALLEL_FOR_
+        for (int i = 0; i < count; i++) {
+            output[i] = OP::Apply(a[i], value);
+        }
+    } else if (plan.pattern == CPU_BROADCAST_CHANNEL) {
+        OMP_PARALLEL_FOR_
+        for (int om = 0; om < plan.outer * plan.mid; om++) {
+            const float value = b[om % plan.mid];
+            const float *src  = a + (size_t)om * plan.inner;
+            float *dst        = output + (size_t)om * plan.inner;
+            for (int i = 0; i < plan.inner; i++) {
+                dst[i] = OP::Apply(src[i], value);
+            }
+        }
+    } else if (plan.pattern == CPU_BROADCAST_ROW) {
+        OMP_PARALLEL_FOR_
+        for (int o = 0; o < plan.outer; o++) {
+            const float *src = a + (size_t)o * plan.inner;
+            float *dst       = output + (size_t)o * plan.inner;
+            for (int i = 0; i < plan.inner; i++) {
+                dst[i] = OP::Apply(src[i], b[i]);
             }
         }
+    } else {
+        const int rank         = (int)plan.dims.size();
+        const int width        = plan.dims[rank - 1];
+        const int width_stride = plan.strides[rank - 1];
+        OMP_PARALLEL_FOR_
+        for (int row = 0; row < count / width; row++) {
+            // offset of the operand row from the outer dims of the output row
+            int offset = 0;
+            for (int i = rank - 2, index = row; i >= 0; i--) {
+                offset += index % plan.dims[i] * plan.strides[i];
+                index /= plan.dims[i];
+            }
+            const float *src     = a + (size_t)row * width;
+            const float *operand = b + offset;
+            float *dst           = output + (size_t)row * width;
+            for (int i = 0; i < width; i++) {
+                dst[i] = OP::Apply(src[i], operand[i * width_stride]);
+            }
+        }
+    }
+}
+
+/*
+ * Output[i] = input0[i] op input1[i] op ... op  input..n[i]
+ * CPU_ELEWISE supports broadcast on all dimensions of any rank
+ */
+template <typename OP>
+static void CPU_ELEWISE(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans,
+                        void *output, const DimsVector &shape_output) {
+    int count          = 1;
+    float *output_data = static_cast<float *>(output);
+    for (auto dim : shape_output) {
+        count *= dim;
+    }
+    if (count == 0) {
+        return;
+    }
+
+    const float *first = static_cast<const float *>(input_ptrs[0]);
+    if (plans[0].pattern != CPU_BROADCAST_SAME) {
+        BinaryBroadcast<CopyOp>(output_data, first, plans[0], output_data, count);
+        first = output_data;
+    }
+    for (int i = 1; i < (int)input_ptrs.size(); i++) {
+        BinaryBroadcast<OP>(i == 1 ? first : output_data, static_cast<const float *>(input_ptrs[i]), plans[i],
+                            output_data, count);
     }
 }
 
 /*
  * Output[i] = min(input0[i], input1[i], input..n[i])
- * Broadcast is supported on n, c, h, w dims
+ * Broadcast is supported on all dimensions
  */
-void CPU_MIN(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_MIN(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output) {
-    ELEWISE_OP min_op = [](float a, float b) -> float { return std::min(a, b); };
-    CPU_ELEWISE(input_ptrs, input_shapes, output, shape_output, min_op);
+    CPU_ELEWISE<MinOp>(input_ptrs, plans, output, shape_output);
 }
 
 /*
  * Output[i] = max(input0[i], input1[i], input..n[i])
- * Broadcast is supported on each dimension of NCHW
+ * Broadcast is supported on all dimensions
  */
-void CPU_MAX(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_MAX(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output) {
-    ELEWISE_OP max_op = [](float a, float b) -> float { return std::max(a, b); };
-    CPU_ELEWISE(input_ptrs, input_shapes, output, shape_output, max_op);
+    CPU_ELEWISE<MaxOp>(input_ptrs, plans, output, shape_output);
 }
 
 /*
  * Output[i] = input0[i] * input1[i] * ... *  input..n[i]
  * Broadcast is supported on all dimensions
  */
-void CPU_MUL(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_MUL(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output) {
-    ELEWISE_OP mul_op = [](float a, float b) -> float { return a * b; };
-    CPU_ELEWISE(input_ptrs, input_shapes, output, shape_output, mul_op);
+    CPU_ELEWISE<MulOp>(input_ptrs, plans, output, shape_output);
 }
 
 /*
  * Output[i] = input0[i] + input1[i] + ... +  input..n[i]
  * CPU_ADD supports broadcast on all dimensions
  */
-void CPU_ADD(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_ADD(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output) {
-    ELEWISE_OP add_op = [](float a, float b) -> float { return a + b; };
-    CPU_ELEWISE(input_ptrs, input_shapes, output, shape_output, add_op);
+    CPU_ELEWISE<AddOp>(input_ptrs, plans, output, shape_output);
 }
 
 /*
  * Output[i] = input0[i] / input1[i] / ... /  input..n[i]
  * CPU_DIV supports broadcast on all dimensions
  */
-void CPU_DIV(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_DIV(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output) {
-    ELEWISE_OP div_op = [](float a, float b) -> float { return a / b; };
-    CPU_ELEWISE(input_ptrs, input_shapes, output, shape_output, div_op);
+    CPU_ELEWISE<DivOp>(input_ptrs, plans, output, shape_output);
 }
 
 /*
  * Output[i] = input0[i] - input1[i] - ... -  input..n[i]
  * CPU_SUB supports broadcast on all dimensions
  */
-void CPU_SUB(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_SUB(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output) {
-    ELEWISE_OP sub_op = [](float a, float b) -> float { return a - b; };
-    CPU_ELEWISE(input_ptrs, input_shapes, output, shape_output, sub_op);
+    CPU_ELEWISE<SubOp>(input_ptrs, plans, output, shape_output);
 }
 
 }  // namespace TNN_NS
\ No newline at end of file
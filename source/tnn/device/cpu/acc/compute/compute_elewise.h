@@ -20,28 +20,57 @@
 #include <stdlib.h>
 #include <algorithm>
 #include <cmath>
+#include <vector>
 
 #include "tnn/core/common.h"
 
 namespace TNN_NS {
 
-// float add
-void CPU_MIN(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+// how an operand of a broadcast element-wise op lines up with the output, shorter shapes are
+// aligned to the trailing dims of the output
+enum CpuBroadcastPattern {
+    // same count as the output
+    CPU_BROADCAST_SAME = 0,
+    // a single value
+    CPU_BROADCAST_SCALAR = 1,
+    // one value per mid of the output seen as outer x mid x inner, e.g. 1c11 against nchw
+    CPU_BROADCAST_CHANNEL = 2,
+    // inner values repeated over the outer of the output, e.g. 11hw or 1chw against nchw
+    CPU_BROADCAST_ROW = 3,
+    // any other shape, indexed through per dim strides
+    CPU_BROADCAST_GENERAL = 4,
+};
+
+struct CpuBroadcastPlan {
+    CpuBroadcastPattern pattern = CPU_BROADCAST_SAME;
+    int outer                   = 1;
+    int mid                     = 1;
+    int inner                   = 1;
+    // CPU_BROADCAST_GENERAL only: the output dims and the operand stride of each, 0 if broadcast
+    DimsVector dims;
+    DimsVector strides;
+};
+
+// classifies the broadcast of an operand once, the plans are passed to the ops below
+CpuBroadcastPlan CPU_BROADCAST_PLAN(const DimsVector &input_shape, const DimsVector &output_shape);
+
+// Output = input0 op input1 op ... op input..n of float blobs of any rank, with a plan per input
+void CPU_MIN(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output);
 
-void CPU_MAX(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_MAX(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output);
 
-void CPU_MUL(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_MUL(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output);
 
-void CPU_ADD(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_ADD(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output);
 
-void CPU_DIV(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_DIV(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output);
 
-void CPU_SUB(const std::vector<void *> &input_ptrs, const std::vector<DimsVector> &input_shapes, void *output,
+void CPU_SUB(const std::vector<void *> &input_ptrs, const std::vector<CpuBroadcastPlan> &plans, void *output,
              DimsVector shape_output);
 
 }  // namespace TNN_NS
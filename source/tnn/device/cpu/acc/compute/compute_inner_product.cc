@@ -0,0 +1,164 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/cpu/acc/compute/compute_inner_product.h"
+
+#include <algorithm>
+
+#include "tnn/core/macro.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+// the packed samples of a block stay in the l2 cache while every weight panel passes over them,
+// sized for fp32 so that int8 blocks fit as well
+static const int kL2CacheBytes = 256 * 1024;
+
+// samples of one block, a multiple of CPU_GEMM_NR
+static int BlockSamples(int batch, int input_size) {
+    int samples = kL2CacheBytes / (input_size * (int)sizeof(float));
+    samples     = std::min(samples, ROUND_UP(batch, CPU_GEMM_NR));
+    return std::max(samples / CPU_GEMM_NR * CPU_GEMM_NR, CPU_GEMM_NR);
+}
+
+size_t CPU_INNER_PRODUCT_WORKSPACE_COUNT(int batch, int input_size) {
+    if (batch <= 1) {
+        return 0;
+    }
+    return (size_t)BlockSamples(batch, input_size) * input_size;
+}
+
+/*
+ * Packs the samples [n_start, n_start + n_count) into panels of CPU_GEMM_NR samples, each panel laid
+ * out as [k][CPU_GEMM_NR]. The samples past the batch are zero.
+ */
+template <typename Tin, typename Tw>
+static void PackSamples(const Tin *input, Tw *panels, int n_start, int n_count, int input_size) {
+    int panel_count = UP_DIV(n_count, CPU_GEMM_NR);
+    OMP_PARALLEL_FOR_
+    for (int p = 0; p < panel_count; p++) {
+        Tw *panel = panels + (size_t)p * input_size * CPU_GEMM_NR;
+        for (int j = 0; j < CPU_GEMM_NR; j++) {
+            int n = p * CPU_GEMM_NR + j;
+            if (n < n_count) {
+                const Tin *src = input + (size_t)(n_start + n) * input_size;
+                for (int k = 0; k < input_size; k++) {
+                    panel[k * CPU_GEMM_NR + j] = static_cast<Tw>(src[k]);
+                }
+            } else {
+                for (int k = 0; k < input_size; k++) {
+                    panel[k * CPU_GEMM_NR + j] = Tw(0);
+                }
+            }
+        }
+    }
+}
+
+template <typename Tout>
+static inline void StoreResult(float result, Tout *dst, int oc, const float *scale, int scale_len) {
+    *dst = result;
+}
+
+static inline void StoreResult(int32_t result, int8_t *dst, int oc, const float *scale, int scale_len) {
+    *dst = float2int8(result * scale[scale_len == 1 ? 0 : oc]);
+}
+
+// one sample: each task runs down CPU_GEMM_MR output channels of the packed weights
+template <typename Tin, typename Tw, typename Tacc, typename Tout>
+static void InnerProductGemv(const Tin *input, Tout *output, const Tw *packed_weights, const Tacc *bias,
+                             int output_channel, int input_size, const float *scale, int scale_len) {
+    int m_panels = UP_DIV(output_channel, CPU_GEMM_MR);
+    OMP_PARALLEL_FOR_
+    for (int mp = 0; mp < m_panels; mp++) {
+        const Tw *a = packed_weights + (size_t)mp * CPU_GEMM_MR * input_size;
+        Tacc acc[CPU_GEMM_MR];
+        for (int i = 0; i < CPU_GEMM_MR; i++) {
+            acc[i] = 0;
+        }
+        for (int k = 0; k < input_size; k++) {
+            Tacc x = static_cast<Tacc>(static_cast<Tw>(input[k]));
+            for (int i = 0; i < CPU_GEMM_MR; i++) {
+                acc[i] += static_cast<Tacc>(a[i]) * x;
+            }
+            a += CPU_GEMM_MR;
+        }
+        int rows = std::min(CPU_GEMM_MR, output_channel - mp * CPU_GEMM_MR);
+        for (int i = 0; i < rows; i++) {
+            int oc = mp * CPU_GEMM_MR + i;
+            StoreResult(acc[i] + (bias ? bias[oc] : Tacc(0)), output + oc, oc, scale, scale_len);
+        }
+    }
+}
+
+template <typename Tin, typename Tw, typename Tacc, typename Tout>
+void CPU_INNER_PRODUCT(const void *input_ptr, void *output_ptr, const Tw *packed_weights, const void *bias,
+                       int batch, int output_channel, int input_size, const float *scale, int scale_len,
+                       Tw *workspace) {
+    const Tin *input_data = static_cast<const Tin *>(input_ptr);
+    Tout *output_data     = static_cast<Tout *>(output_ptr);
+    const Tacc *bias_data = static_cast<const Tacc *>(bias);
+
+    if (batch == 1) {
+        InnerProductGemv(input_data, output_data, packed_weights, bias_data, output_channel, input_size, scale,
+                         scale_len);
+        return;
+    }
+
+    int m_panels      = UP_DIV(output_channel, CPU_GEMM_MR);
+    int block_samples = BlockSamples(batch, input_size);
+    for (int n_start = 0; n_start < batch; n_start += block_samples) {
+        int n_count = std::min(block_samples, batch - n_start);
+        PackSamples(input_data, workspace, n_start, n_count, input_size);
+
+        OMP_PARALLEL_FOR_
+        for (int mp = 0; mp < m_panels; mp++) {
+            const Tw *a = packed_weights + (size_t)mp * CPU_GEMM_MR * input_size;
+            int rows    = std::min(CPU_GEMM_MR, output_channel - mp * CPU_GEMM_MR);
+            for (int np = 0; np * CPU_GEMM_NR < n_count; np++) {
+                Tacc c[CPU_GEMM_MR][CPU_GEMM_NR];
+                CPU_GEMM_KERNEL(a, workspace + (size_t)np * input_size * CPU_GEMM_NR, input_size, c);
+
+                int cols = std::min(CPU_GEMM_NR, n_count - np * CPU_GEMM_NR);
+                for (int i = 0; i < rows; i++) {
+                    int oc          = mp * CPU_GEMM_MR + i;
+                    Tacc bias_value = bias_data ? bias_data[oc] : Tacc(0);
+                    Tout *dst       = output_data + (size_t)(n_start + np * CPU_GEMM_NR) * output_channel + oc;
+                    for (int j = 0; j < cols; j++) {
+                        StoreResult(c[i][j] + bias_value, dst + j * output_channel, oc, scale, scale_len);
+                    }
+                }
+            }
+        }
+    }
+}
+
+template void CPU_INNER_PRODUCT<float, float, float, float>(const void *input_ptr, void *output_ptr,
+                                                            const float *packed_weights, const void *bias, int batch,
+                                                            int output_channel, int input_size, const float *scale,
+                                                            int scale_len, float *workspace);
+
+template void CPU_INNER_PRODUCT<bfp16_t, float, float, bfp16_t>(const void *input_ptr, void *output_ptr,
+                                                                const float *packed_weights, const void *bias,
+                                                                int batch, int output_channel, int input_size,
+                                                                const float *scale, int scale_len, float *workspace);
+
+template void CPU_INNER_PRODUCT<int8_t, int8_t, int32_t, int8_t>(const void *input_ptr, void *output_ptr,
+                                                                 const int8_t *packed_weights, const void *bias,
+                                                                 int batch, int output_channel, int input_size,
+                                                                 const float *scale, int scale_len,
+                                                                 int8_t *workspace);
+
+}  // namespace TNN_NS
@@ -0,0 +1,43 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_INNER_PRODUCT_H_
+#define TNN_CPU_COMPUTE_INNER_PRODUCT_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tnn/device/cpu/acc/compute/compute_conv.h"
+
+namespace TNN_NS {
+
+// elements of the weight type in the workspace of CPU_INNER_PRODUCT, 0 for a batch of 1
+size_t CPU_INNER_PRODUCT_WORKSPACE_COUNT(int batch, int input_size);
+
+/*
+ * output[n][oc] = sum_k input[n][k] * weights[oc][k] + bias[oc], the weights packed by CPU_PACK_CONV_WEIGHTS
+ * as a 1x1 conv of input_size channels. a batch of 1 is a gemv over the weight panels; larger batches are
+ * packed into panels of CPU_GEMM_NR samples in blocks sized for the l2 cache, and every weight panel is
+ * applied to the whole block while it is in cache, so the weights are read once per block instead of
+ * once per sample. the types follow CPU_CONV_GEMM: fp32, bfp16 in and out with fp32 weights, int8 with
+ * int32 bias and accumulation rescaled by scale.
+ */
+template <typename Tin, typename Tw, typename Tacc, typename Tout>
+void CPU_INNER_PRODUCT(const void *input_ptr, void *output_ptr, const Tw *packed_weights, const void *bias,
+                       int batch, int output_channel, int input_size, const float *scale, int scale_len,
+                       Tw *workspace);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_INNER_PRODUCT_H_
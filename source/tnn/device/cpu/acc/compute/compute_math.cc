@@ -0,0 +1,127 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/cpu/acc/compute/compute_math.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "tnn/device/cpu/acc/compute/compute_vec.h"
+#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/softmax_utils.h"
+
+namespace TNN_NS {
+
+// x + x^3 * p(x^2) below 0.625, 1 - 2 / (e^2x + 1) above, the sign is restored last
+static inline F TanhVec(F x) {
+    const F sign_mask = VecF::Set(-0.0f);
+    F sign            = VecF::And(x, sign_mask);
+    F abs             = VecF::Xor(x, sign);
+
+    F z     = VecF::Mul(abs, abs);
+    F small = VecF::Set(-5.70498872745E-3f);
+    small   = VecF::Fma(small, z, VecF::Set(2.06390887954E-2f));
+    small   = VecF::Fma(small, z, VecF::Set(-5.37397155531E-2f));
+    small   = VecF::Fma(small, z, VecF::Set(1.33314422036E-1f));
+    small   = VecF::Fma(small, z, VecF::Set(-3.33332819422E-1f));
+    small   = VecF::Fma(VecF::Mul(small, z), abs, abs);
+
+    F large = ExpVec(VecF::Add(abs, abs));
+    large   = VecF::Sub(VecF::Set(1.0f), VecF::Div(VecF::Set(2.0f), VecF::Add(large, VecF::Set(1.0f))));
+
+    F result = VecF::Select(VecF::Less(abs, VecF::Set(0.625f)), small, large);
+    result   = VecF::Xor(result, sign);
+    return VecF::Select(VecF::IsNan(x), x, result);
+}
+
+static inline F SigmoidVec(F x) {
+    F e = ExpVec(VecF::Xor(x, VecF::Set(-0.0f)));
+    return VecF::Div(VecF::Set(1.0f), VecF::Add(e, VecF::Set(1.0f)));
+}
+
+// full registers, then the tail through a zero padded register
+template <F (*FUNC)(F)>
+static void ApplyVec(const float *src, float *dst, int count) {
+    int i = 0;
+    for (; i + VecF::kWidth <= count; i += VecF::kWidth) {
+        VecF::Save(dst + i, FUNC(VecF::Load(src + i)));
+    }
+    if (i < count) {
+        float tail[VecF::kWidth] = {0};
+        memcpy(tail, src + i, (count - i) * sizeof(float));
+        VecF::Save(tail, FUNC(VecF::Load(tail)));
+        memcpy(dst + i, tail, (count - i) * sizeof(float));
+    }
+}
+
+void CPU_EXP(const float *src, float *dst, int count) {
+    ApplyVec<ExpVec>(src, dst, count);
+}
+
+void CPU_LOG(const float *src, float *dst, int count) {
+    ApplyVec<LogVec>(src, dst, count);
+}
+
+void CPU_TANH(const float *src, float *dst, int count) {
+    ApplyVec<TanhVec>(src, dst, count);
+}
+
+void CPU_SIGMOID(const float *src, float *dst, int count) {
+    ApplyVec<SigmoidVec>(src, dst, count);
+}
+
+// the register of this build for SoftmaxUtils
+struct SoftmaxVec : VecF {
+    static inline F Exp(F x) {
+        return ExpVec(x);
+    }
+};
+typedef SoftmaxUtils<SoftmaxVec> Softmax;
+
+size_t CPU_SOFTMAX_WORKSPACE_COUNT(int channel, int inside) {
+    int tile, block_size;
+    size_t workspace_per_thread;
+    Softmax::Layout(channel, inside, tile, block_size, workspace_per_thread);
+    return workspace_per_thread * OMP_MAX_THREADS_NUM_;
+}
+
+void CPU_SOFTMAX(const float *src, float *dst, int outer, int channel, int inside, float *workspace) {
+    int tile, block_size;
+    size_t workspace_per_thread;
+    Softmax::Layout(channel, inside, tile, block_size, workspace_per_thread);
+
+    if (inside == 1) {
+        OMP_PARALLEL_FOR_
+        for (int n = 0; n < outer; n++) {
+            Softmax::Row(src + (size_t)n * channel, dst + (size_t)n * channel, channel,
+                         workspace + workspace_per_thread * OMP_TID_);
+        }
+        return;
+    }
+
+    int tiles = UP_DIV(inside, tile);
+    int tasks = outer * tiles;
+    OMP_PARALLEL_FOR_
+    for (int t = 0; t < tasks; t++) {
+        int n          = t / tiles;
+        int lane_start = t % tiles * tile;
+        size_t offset  = (size_t)n * channel * inside + lane_start;
+        Softmax::Tile(src + offset, dst + offset, channel, inside, std::min(tile, inside - lane_start), block_size,
+                      workspace + workspace_per_thread * OMP_TID_);
+    }
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,51 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_MATH_H_
+#define TNN_CPU_COMPUTE_MATH_H_
+
+#include <stddef.h>
+
+#include "tnn/core/macro.h"
+
+namespace TNN_NS {
+
+/*
+ * vectorized transcendental functions on float arrays, dst may be src.
+ * polynomial approximations after cephes, run with avx2 + fma, sse2 or plain c depending on the
+ * target. max error against the correctly rounded result, measured over all floats of the range:
+ *   CPU_EXP      1.3 ulp, inputs above 88.72 give inf, below -87.33 give 0 (no denormals)
+ *   CPU_LOG      0.8 ulp on normal floats, log(0) = -inf, negative inputs give nan
+ *   CPU_TANH     1.4 ulp
+ *   CPU_SIGMOID  3.2 ulp
+ */
+void CPU_EXP(const float *src, float *dst, int count);
+
+void CPU_LOG(const float *src, float *dst, int count);
+
+void CPU_TANH(const float *src, float *dst, int count);
+
+void CPU_SIGMOID(const float *src, float *dst, int count);
+
+/*
+ * softmax along the middle dim of [outer, channel, inside], dst may be src, see SoftmaxUtils.
+ * workspace holds CPU_SOFTMAX_WORKSPACE_COUNT floats.
+ */
+size_t CPU_SOFTMAX_WORKSPACE_COUNT(int channel, int inside);
+
+void CPU_SOFTMAX(const float *src, float *dst, int outer, int channel, int inside, float *workspace);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_MATH_H_
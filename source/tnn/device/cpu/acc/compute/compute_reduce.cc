@@ -0,0 +1,408 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/cpu/acc/compute/compute_reduce.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tnn/device/cpu/acc/compute/compute_vec.h"
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+// each reduce op as map, combine and finalize, with the combine of a sum flagged for the compensated total
+struct ReduceSumOp {
+    static const bool kSum = true;
+    static inline float Init() {
+        return 0.0f;
+    }
+    static inline F MapVec(F x) {
+        return x;
+    }
+    static inline float Map(float x) {
+        return x;
+    }
+    static inline F CombineVec(F a, F b) {
+        return VecF::Add(a, b);
+    }
+    static inline float Combine(float a, float b) {
+        return a + b;
+    }
+    static inline float Finalize(float v, int count) {
+        return v;
+    }
+};
+
+struct ReduceMeanOp : ReduceSumOp {
+    static inline float Finalize(float v, int count) {
+        return v / count;
+    }
+};
+
+struct ReduceLogSumOp : ReduceSumOp {
+    static inline float Finalize(float v, int count) {
+        return std::log(v);
+    }
+};
+
+struct ReduceL1Op : ReduceSumOp {
+    static inline F MapVec(F x) {
+        return VecF::Xor(x, VecF::And(x, VecF::Set(-0.0f)));
+    }
+    static inline float Map(float x) {
+        return std::fabs(x);
+    }
+};
+
+struct ReduceSumSquareOp : ReduceSumOp {
+    static inline F MapVec(F x) {
+        return VecF::Mul(x, x);
+    }
+    static inline float Map(float x) {
+        return x * x;
+    }
+};
+
+struct ReduceL2Op : ReduceSumSquareOp {
+    static inline float Finalize(float v, int count) {
+        return std::sqrt(v);
+    }
+};
+
+struct ReduceLogSumExpOp : ReduceSumOp {
+    static inline F MapVec(F x) {
+        return ExpVec(x);
+    }
+    static inline float Map(float x) {
+        return std::exp(x);
+    }
+    static inline float Finalize(float v, int count) {
+        return std::log(v);
+    }
+};
+
+struct ReduceMaxOp {
+    static const bool kSum = false;
+    static inline float Init() {
+        return -INFINITY;
+    }
+    static inline F MapVec(F x) {
+        return x;
+    }
+    static inline float Map(float x) {
+        return x;
+    }
+    static inline F CombineVec(F a, F b) {
+        return VecF::Max(a, b);
+    }
+    static inline float Combine(float a, float b) {
+        return std::max(a, b);
+    }
+    static inline float Finalize(float v, int count) {
+        return v;
+    }
+};
+
+struct ReduceMinOp : ReduceMaxOp {
+    static inline float Init() {
+        return INFINITY;
+    }
+    static inline F CombineVec(F a, F b) {
+        return VecF::Min(a, b);
+    }
+    static inline float Combine(float a, float b) {
+        return std::min(a, b);
+    }
+};
+
+struct ReduceProdOp : ReduceMaxOp {
+    static inline float Init() {
+        return 1.0f;
+    }
+    static inline F CombineVec(F a, F b) {
+        return VecF::Mul(a, b);
+    }
+    static inline float Combine(float a, float b) {
+        return a * b;
+    }
+};
+
+// rows of a tile combined into a partial before the partial joins the compensated total
+static const int kReduceBlockSize = 16;
+// outputs of one task when the trailing dim is kept
+static const int kReduceTileSize = 256;
+
+// total += partial with kahan compensation, element-wise over count lanes
+static inline void KahanAdd(float *total, float *compensation, const float *partial, int count) {
+    int i = 0;
+    for (; i + VecF::kWidth <= count; i += VecF::kWidth) {
+        F y = VecF::Sub(VecF::Load(partial + i), VecF::Load(compensation + i));
+        F t = VecF::Add(VecF::Load(total + i), y);
+        VecF::Save(compensation + i, VecF::Sub(VecF::Sub(t, VecF::Load(total + i)), y));
+        VecF::Save(total + i, t);
+    }
+    for (; i < count; i++) {
+        float y         = partial[i] - compensation[i];
+        float t         = total[i] + y;
+        compensation[i] = (t - total[i]) - y;
+        total[i]        = t;
+    }
+}
+
+static inline void KahanAddVec(F &total, F &compensation, F partial) {
+    F y          = VecF::Sub(partial, compensation);
+    F t          = VecF::Add(total, y);
+    compensation = VecF::Sub(VecF::Sub(t, total), y);
+    total        = t;
+}
+
+// acc = combine(acc, map(src)) element-wise over count lanes
+template <typename OP>
+static inline void CombineLanes(float *acc, const float *src, int count) {
+    int i = 0;
+    for (; i + VecF::kWidth <= count; i += VecF::kWidth) {
+        VecF::Save(acc + i, OP::CombineVec(VecF::Load(acc + i), OP::MapVec(VecF::Load(src + i))));
+    }
+    for (; i < count; i++) {
+        acc[i] = OP::Combine(acc[i], OP::Map(src[i]));
+    }
+}
+
+// the trailing dim is kept: the lanes of a tile are reduced side by side, one reduce offset at a time
+template <typename OP>
+static void ReduceTile(const float *src, float *dst, const std::vector<int> &reduce_offsets, int count,
+                       int reduce_count) {
+    float total[kReduceTileSize];
+    float compensation[kReduceTileSize];
+    float partial[kReduceTileSize];
+    std::fill(total, total + count, OP::Init());
+    std::fill(compensation, compensation + count, 0.0f);
+
+    int reduce_size = (int)reduce_offsets.size();
+    if (!OP::kSum) {
+        for (int r = 0; r < reduce_size; r++) {
+            CombineLanes<OP>(total, src + reduce_offsets[r], count);
+        }
+    } else {
+        for (int start = 0; start < reduce_size; start += kReduceBlockSize) {
+            int end = std::min(reduce_size, start + kReduceBlockSize);
+            std::fill(partial, partial + count, OP::Init());
+            for (int r = start; r < end; r++) {
+                CombineLanes<OP>(partial, src + reduce_offsets[r], count);
+            }
+            KahanAdd(total, compensation, partial, count);
+        }
+    }
+
+    for (int i = 0; i < count; i++) {
+        dst[i] = OP::Finalize(total[i], reduce_count);
+    }
+}
+
+// combine(init, map(src[0..count))) over a contiguous row, four registers in flight
+template <typename OP>
+static inline float ReduceRow(const float *src, int count) {
+    const int step = 4 * VecF::kWidth;
+    F acc[4];
+    for (int k = 0; k < 4; k++) {
+        acc[k] = VecF::Set(OP::Init());
+    }
+    int i = 0;
+    for (; i + step <= count; i += step) {
+        for (int k = 0; k < 4; k++) {
+            acc[k] = OP::CombineVec(acc[k], OP::MapVec(VecF::Load(src + i + k * VecF::kWidth)));
+        }
+    }
+    acc[0] = OP::CombineVec(OP::CombineVec(acc[0], acc[1]), OP::CombineVec(acc[2], acc[3]));
+    float lanes[VecF::kWidth];
+    VecF::Save(lanes, acc[0]);
+    float result = OP::Init();
+    for (int k = 0; k < VecF::kWidth; k++) {
+        result = OP::Combine(result, lanes[k]);
+    }
+    for (; i < count; i++) {
+        result = OP::Combine(result, OP::Map(src[i]));
+    }
+    return result;
+}
+
+// sum of map(src[0..count)): eight registers are added as a tree, then join a compensated total per lane.
+// the values past the last full register are returned for the caller to add
+template <typename OP>
+static inline float SumRow(const float *src, int count, F &total, F &compensation) {
+    const int step = 8 * VecF::kWidth;
+    int i          = 0;
+    for (; i + step <= count; i += step) {
+        F v[8];
+        for (int k = 0; k < 8; k++) {
+            v[k] = OP::MapVec(VecF::Load(src + i + k * VecF::kWidth));
+        }
+        for (int k = 0; k < 4; k++) {
+            v[k] = VecF::Add(v[2 * k], v[2 * k + 1]);
+        }
+        F partial = VecF::Add(VecF::Add(v[0], v[1]), VecF::Add(v[2], v[3]));
+        KahanAddVec(total, compensation, partial);
+    }
+    for (; i + VecF::kWidth <= count; i += VecF::kWidth) {
+        KahanAddVec(total, compensation, OP::MapVec(VecF::Load(src + i)));
+    }
+    float tail = 0.0f;
+    for (; i < count; i++) {
+        tail += OP::Map(src[i]);
+    }
+    return tail;
+}
+
+// the trailing dim is reduced: contiguous rows
+template <typename OP>
+static float ReduceRows(const float *src, const std::vector<int> &reduce_offsets, int row, int reduce_count) {
+    float total = OP::Init();
+    if (!OP::kSum) {
+        for (int offset : reduce_offsets) {
+            total = OP::Combine(total, ReduceRow<OP>(src + offset, row));
+        }
+        return OP::Finalize(total, reduce_count);
+    }
+
+    F lanes_total        = VecF::Set(0.0f);
+    F lanes_compensation = VecF::Set(0.0f);
+    float compensation   = 0.0f;
+    for (int offset : reduce_offsets) {
+        float tail = SumRow<OP>(src + offset, row, lanes_total, lanes_compensation);
+        KahanAdd(&total, &compensation, &tail, 1);
+    }
+    float lanes[VecF::kWidth];
+    VecF::Save(lanes, VecF::Sub(lanes_total, lanes_compensation));
+    for (int k = 0; k < VecF::kWidth; k++) {
+        KahanAdd(&total, &compensation, &lanes[k], 1);
+    }
+    return OP::Finalize(total, reduce_count);
+}
+
+template <typename OP>
+static void Reduce(const float *src, float *dst, const CpuReducePlan &plan) {
+    int outer_size = (int)plan.outer_offsets.size();
+    if (plan.inner == 1) {
+        OMP_PARALLEL_FOR_
+        for (int o = 0; o < outer_size; o++) {
+            dst[o] = ReduceRows<OP>(src + plan.outer_offsets[o], plan.reduce_offsets, plan.row, plan.reduce_count);
+        }
+        return;
+    }
+
+    int tiles = UP_DIV(plan.inner, kReduceTileSize);
+    int tasks = outer_size * tiles;
+    OMP_PARALLEL_FOR_
+    for (int t = 0; t < tasks; t++) {
+        int o     = t / tiles;
+        int start = t % tiles * kReduceTileSize;
+        int count = std::min(kReduceTileSize, plan.inner - start);
+        ReduceTile<OP>(src + plan.outer_offsets[o] + start, dst + o * plan.inner + start, plan.reduce_offsets, count,
+                       plan.reduce_count);
+    }
+}
+
+// offsets of all the coordinates of the given (size, stride) dims, the last dim fastest
+static std::vector<int> EnumerateOffsets(const std::vector<std::pair<int, int>> &dims) {
+    std::vector<int> offsets = {0};
+    for (const auto &dim : dims) {
+        std::vector<int> next;
+        next.reserve(offsets.size() * dim.first);
+        for (int offset : offsets) {
+            for (int i = 0; i < dim.first; i++) {
+                next.push_back(offset + i * dim.second);
+            }
+        }
+        offsets.swap(next);
+    }
+    return offsets;
+}
+
+CpuReducePlan CPU_REDUCE_PLAN(const DimsVector &dims, const std::vector<int> &axes) {
+    // merge adjacent dims reduced alike, dims of size 1 are dropped
+    std::vector<int> sizes;
+    std::vector<bool> reduced;
+    for (int d = 0; d < (int)dims.size(); d++) {
+        if (dims[d] == 1) {
+            continue;
+        }
+        bool is_reduced = std::find(axes.begin(), axes.end(), d) != axes.end();
+        if (!sizes.empty() && reduced.back() == is_reduced) {
+            sizes.back() *= dims[d];
+        } else {
+            sizes.push_back(dims[d]);
+            reduced.push_back(is_reduced);
+        }
+    }
+
+    CpuReducePlan plan;
+    int stride = 1;
+    std::vector<std::pair<int, int>> outer_dims, reduce_dims;
+    for (int g = (int)sizes.size() - 1; g >= 0; g--) {
+        if (g == (int)sizes.size() - 1) {
+            if (reduced[g]) {
+                plan.row = sizes[g];
+            } else {
+                plan.inner = sizes[g];
+            }
+        } else if (reduced[g]) {
+            reduce_dims.insert(reduce_dims.begin(), std::make_pair(sizes[g], stride));
+        } else {
+            outer_dims.insert(outer_dims.begin(), std::make_pair(sizes[g], stride));
+        }
+        stride *= sizes[g];
+    }
+    plan.outer_offsets  = EnumerateOffsets(outer_dims);
+    plan.reduce_offsets = EnumerateOffsets(reduce_dims);
+    plan.reduce_count   = (int)plan.reduce_offsets.size() * plan.row;
+    return plan;
+}
+
+void CPU_REDUCE(CpuReduceType type, const float *src, float *dst, const CpuReducePlan &plan) {
+    switch (type) {
+        case CPU_REDUCE_SUM:
+            Reduce<ReduceSumOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_MEAN:
+            Reduce<ReduceMeanOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_MAX:
+            Reduce<ReduceMaxOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_MIN:
+            Reduce<ReduceMinOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_PROD:
+            Reduce<ReduceProdOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_L1:
+            Reduce<ReduceL1Op>(src, dst, plan);
+            break;
+        case CPU_REDUCE_L2:
+            Reduce<ReduceL2Op>(src, dst, plan);
+            break;
+        case CPU_REDUCE_SUM_SQUARE:
+            Reduce<ReduceSumSquareOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_LOG_SUM:
+            Reduce<ReduceLogSumOp>(src, dst, plan);
+            break;
+        case CPU_REDUCE_LOG_SUM_EXP:
+            Reduce<ReduceLogSumExpOp>(src, dst, plan);
+            break;
+    }
+}
+
+}  // namespace TNN_NS
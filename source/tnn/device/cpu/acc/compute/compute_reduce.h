@@ -0,0 +1,58 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_REDUCE_H_
+#define TNN_CPU_COMPUTE_REDUCE_H_
+
+#include <vector>
+
+#include "tnn/core/common.h"
+
+namespace TNN_NS {
+
+enum CpuReduceType {
+    CPU_REDUCE_SUM = 0,
+    CPU_REDUCE_MEAN,
+    CPU_REDUCE_MAX,
+    CPU_REDUCE_MIN,
+    CPU_REDUCE_PROD,
+    CPU_REDUCE_L1,
+    CPU_REDUCE_L2,
+    CPU_REDUCE_SUM_SQUARE,
+    CPU_REDUCE_LOG_SUM,
+    CPU_REDUCE_LOG_SUM_EXP,
+};
+
+// the reduced axes seen as blocks: output o * inner + i reduces
+// src[outer_offsets[o] + reduce_offsets[r] + j + i] over all r and j < row.
+// adjacent dims reduced alike are merged first, the trailing block is either kept (inner > 1, row 1)
+// or reduced (inner 1, row its size)
+struct CpuReducePlan {
+    std::vector<int> outer_offsets;
+    std::vector<int> reduce_offsets;
+    int row   = 1;
+    int inner = 1;
+    // elements reduced into each output
+    int reduce_count = 1;
+};
+
+// axes are non negative and may come in any order
+CpuReducePlan CPU_REDUCE_PLAN(const DimsVector &dims, const std::vector<int> &axes);
+
+// one pass over src for all the axes of the plan, sums are accumulated in blocks with a compensated total
+void CPU_REDUCE(CpuReduceType type, const float *src, float *dst, const CpuReducePlan &plan);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_REDUCE_H_
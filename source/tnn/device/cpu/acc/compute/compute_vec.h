@@ -0,0 +1,381 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_VEC_H_
+#define TNN_CPU_COMPUTE_VEC_H_
+
+#include <stdint.h>
+#include <string.h>
+
+#include <cmath>
+
+#include "tnn/core/macro.h"
+
+#if defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TNN_NS {
+
+/*
+ * the lanes of one register, the functions below are written once against this interface
+ */
+#if defined(__AVX2__) && defined(__FMA__)
+struct VecF {
+    typedef __m256 F;
+    typedef __m256i I;
+    static const int kWidth = 8;
+
+    static inline F Load(const float *p) {
+        return _mm256_loadu_ps(p);
+    }
+    static inline void Save(float *p, F v) {
+        _mm256_storeu_ps(p, v);
+    }
+    static inline F Set(float v) {
+        return _mm256_set1_ps(v);
+    }
+    static inline F Add(F a, F b) {
+        return _mm256_add_ps(a, b);
+    }
+    static inline F Sub(F a, F b) {
+        return _mm256_sub_ps(a, b);
+    }
+    static inline F Mul(F a, F b) {
+        return _mm256_mul_ps(a, b);
+    }
+    static inline F Div(F a, F b) {
+        return _mm256_div_ps(a, b);
+    }
+    // a * b + c
+    static inline F Fma(F a, F b, F c) {
+        return _mm256_fmadd_ps(a, b, c);
+    }
+    static inline F Max(F a, F b) {
+        return _mm256_max_ps(a, b);
+    }
+    static inline F Min(F a, F b) {
+        return _mm256_min_ps(a, b);
+    }
+    static inline F Less(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_LT_OQ);
+    }
+    static inline F Equal(F a, F b) {
+        return _mm256_cmp_ps(a, b, _CMP_EQ_OQ);
+    }
+    static inline F IsNan(F a) {
+        return _mm256_cmp_ps(a, a, _CMP_UNORD_Q);
+    }
+    static inline F And(F a, F b) {
+        return _mm256_and_ps(a, b);
+    }
+    static inline F Xor(F a, F b) {
+        return _mm256_xor_ps(a, b);
+    }
+    // mask ? a : b
+    static inline F Select(F mask, F a, F b) {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+    static inline I Round(F a) {
+        return _mm256_cvtps_epi32(a);
+    }
+    static inline F ToFloat(I a) {
+        return _mm256_cvtepi32_ps(a);
+    }
+    static inline I AddInt(I a, int b) {
+        return _mm256_add_epi32(a, _mm256_set1_epi32(b));
+    }
+    static inline I MinInt(I a, int b) {
+        return _mm256_min_epi32(a, _mm256_set1_epi32(b));
+    }
+    static inline I ShiftLeft23(I a) {
+        return _mm256_slli_epi32(a, 23);
+    }
+    static inline I ShiftRight23(I a) {
+        return _mm256_srli_epi32(a, 23);
+    }
+    static inline I AndInt(I a, int b) {
+        return _mm256_and_si256(a, _mm256_set1_epi32(b));
+    }
+    static inline I OrInt(I a, int b) {
+        return _mm256_or_si256(a, _mm256_set1_epi32(b));
+    }
+    static inline F AsFloat(I a) {
+        return _mm256_castsi256_ps(a);
+    }
+    static inline I AsInt(F a) {
+        return _mm256_castps_si256(a);
+    }
+};
+#elif defined(__SSE2__)
+struct VecF {
+    typedef __m128 F;
+    typedef __m128i I;
+    static const int kWidth = 4;
+
+    static inline F Load(const float *p) {
+        return _mm_loadu_ps(p);
+    }
+    static inline void Save(float *p, F v) {
+        _mm_storeu_ps(p, v);
+    }
+    static inline F Set(float v) {
+        return _mm_set1_ps(v);
+    }
+    static inline F Add(F a, F b) {
+        return _mm_add_ps(a, b);
+    }
+    static inline F Sub(F a, F b) {
+        return _mm_sub_ps(a, b);
+    }
+    static inline F Mul(F a, F b) {
+        return _mm_mul_ps(a, b);
+    }
+    static inline F Div(F a, F b) {
+        return _mm_div_ps(a, b);
+    }
+    static inline F Fma(F a, F b, F c) {
+        return _mm_add_ps(_mm_mul_ps(a, b), c);
+    }
+    static inline F Max(F a, F b) {
+        return _mm_max_ps(a, b);
+    }
+    static inline F Min(F a, F b) {
+        return _mm_min_ps(a, b);
+    }
+    static inline F Less(F a, F b) {
+        return _mm_cmplt_ps(a, b);
+    }
+    static inline F Equal(F a, F b) {
+        return _mm_cmpeq_ps(a, b);
+    }
+    static inline F IsNan(F a) {
+        return _mm_cmpunord_ps(a, a);
+    }
+    static inline F And(F a, F b) {
+        return _mm_and_ps(a, b);
+    }
+    static inline F Xor(F a, F b) {
+        return _mm_xor_ps(a, b);
+    }
+    static inline F Select(F mask, F a, F b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+    static inline I Round(F a) {
+        return _mm_cvtps_epi32(a);
+    }
+    static inline F ToFloat(I a) {
+        return _mm_cvtepi32_ps(a);
+    }
+    static inline I AddInt(I a, int b) {
+        return _mm_add_epi32(a, _mm_set1_epi32(b));
+    }
+    // sse2 has no 32 bit integer min
+    static inline I MinInt(I a, int b) {
+        __m128i limit = _mm_set1_epi32(b);
+        __m128i mask  = _mm_cmpgt_epi32(a, limit);
+        return _mm_or_si128(_mm_and_si128(mask, limit), _mm_andnot_si128(mask, a));
+    }
+    static inline I ShiftLeft23(I a) {
+        return _mm_slli_epi32(a, 23);
+    }
+    static inline I ShiftRight23(I a) {
+        return _mm_srli_epi32(a, 23);
+    }
+    static inline I AndInt(I a, int b) {
+        return _mm_and_si128(a, _mm_set1_epi32(b));
+    }
+    static inline I OrInt(I a, int b) {
+        return _mm_or_si128(a, _mm_set1_epi32(b));
+    }
+    static inline F AsFloat(I a) {
+        return _mm_castsi128_ps(a);
+    }
+    static inline I AsInt(F a) {
+        return _mm_castps_si128(a);
+    }
+};
+#else
+struct VecF {
+    typedef float F;
+    typedef int32_t I;
+    static const int kWidth = 1;
+
+    static inline F Load(const float *p) {
+        return *p;
+    }
+    static inline void Save(float *p, F v) {
+        *p = v;
+    }
+    static inline F Set(float v) {
+        return v;
+    }
+    static inline F Add(F a, F b) {
+        return a + b;
+    }
+    static inline F Sub(F a, F b) {
+        return a - b;
+    }
+    static inline F Mul(F a, F b) {
+        return a * b;
+    }
+    static inline F Div(F a, F b) {
+        return a / b;
+    }
+    static inline F Fma(F a, F b, F c) {
+        return a * b + c;
+    }
+    static inline F Max(F a, F b) {
+        return a > b ? a : b;
+    }
+    static inline F Min(F a, F b) {
+        return a < b ? a : b;
+    }
+    // masks are all ones or all zeros, as the simd compares
+    static inline F Less(F a, F b) {
+        return AsFloat(a < b ? -1 : 0);
+    }
+    static inline F Equal(F a, F b) {
+        return AsFloat(a == b ? -1 : 0);
+    }
+    static inline F IsNan(F a) {
+        return AsFloat(a != a ? -1 : 0);
+    }
+    static inline F And(F a, F b) {
+        return AsFloat(AsInt(a) & AsInt(b));
+    }
+    static inline F Xor(F a, F b) {
+        return AsFloat(AsInt(a) ^ AsInt(b));
+    }
+    static inline F Select(F mask, F a, F b) {
+        return AsInt(mask) ? a : b;
+    }
+    static inline I Round(F a) {
+        return static_cast<I>(std::nearbyint(a));
+    }
+    static inline F ToFloat(I a) {
+        return static_cast<F>(a);
+    }
+    static inline I AddInt(I a, int b) {
+        return a + b;
+    }
+    static inline I MinInt(I a, int b) {
+        return a < b ? a : b;
+    }
+    static inline I ShiftLeft23(I a) {
+        return static_cast<I>(static_cast<uint32_t>(a) << 23);
+    }
+    static inline I ShiftRight23(I a) {
+        return static_cast<I>(static_cast<uint32_t>(a) >> 23);
+    }
+    static inline I AndInt(I a, int b) {
+        return a & b;
+    }
+    static inline I OrInt(I a, int b) {
+        return a | b;
+    }
+    static inline F AsFloat(I a) {
+        F f;
+        memcpy(&f, &a, sizeof(f));
+        return f;
+    }
+    static inline I AsInt(F a) {
+        I i;
+        memcpy(&i, &a, sizeof(i));
+        return i;
+    }
+};
+#endif
+
+typedef VecF::F F;
+typedef VecF::I I;
+
+// e^x = 2^n * e^r with r = x - n * ln2 in [-ln2 / 2, ln2 / 2], e^r from a degree 6 polynomial
+static inline F ExpVec(F x) {
+    const F upper = VecF::Set(88.72283935546875f);
+    const F lower = VecF::Set(-87.33654022216797f);
+    F overflow    = VecF::Less(upper, x);
+    F underflow   = VecF::Less(x, lower);
+    F nan         = VecF::IsNan(x);
+    F value       = VecF::Min(VecF::Max(x, lower), upper);
+
+    I n  = VecF::Round(VecF::Mul(value, VecF::Set(1.44269504088896341f)));
+    F fn = VecF::ToFloat(n);
+    // n reaches 128 just below the overflow, 2^128 is applied as 2^127 * 2
+    I n_scale = VecF::MinInt(n, 127);
+    F extra   = VecF::Add(VecF::Set(1.0f), VecF::Sub(fn, VecF::ToFloat(n_scale)));
+    // ln2 split in two so r keeps its low bits
+    F r = VecF::Fma(fn, VecF::Set(-0.693359375f), value);
+    r   = VecF::Fma(fn, VecF::Set(2.12194440e-4f), r);
+
+    F p = VecF::Set(1.9875691500E-4f);
+    p   = VecF::Fma(p, r, VecF::Set(1.3981999507E-3f));
+    p   = VecF::Fma(p, r, VecF::Set(8.3334519073E-3f));
+    p   = VecF::Fma(p, r, VecF::Set(4.1665795894E-2f));
+    p   = VecF::Fma(p, r, VecF::Set(1.6666665459E-1f));
+    p   = VecF::Fma(p, r, VecF::Set(5.0000001201E-1f));
+    p   = VecF::Fma(p, VecF::Mul(r, r), VecF::Add(r, VecF::Set(1.0f)));
+
+    F result = VecF::Mul(VecF::Mul(p, extra), VecF::AsFloat(VecF::ShiftLeft23(VecF::AddInt(n_scale, 127))));
+    result   = VecF::Select(overflow, VecF::Set(INFINITY), result);
+    result   = VecF::Select(underflow, VecF::Set(0.0f), result);
+    return VecF::Select(nan, x, result);
+}
+
+// log(x) = e * ln2 + log(m) with m in [sqrt(0.5), sqrt(2)), log(m) from a degree 9 polynomial
+static inline F LogVec(F x) {
+    F zero     = VecF::Equal(x, VecF::Set(0.0f));
+    F negative = VecF::Less(x, VecF::Set(0.0f));
+    F infinite = VecF::Equal(x, VecF::Set(INFINITY));
+    F nan      = VecF::IsNan(x);
+    // denormals are taken as the smallest normal
+    F value = VecF::Max(x, VecF::Set(1.17549435e-38f));
+
+    I bits = VecF::AsInt(value);
+    F e    = VecF::ToFloat(VecF::AddInt(VecF::ShiftRight23(bits), -126));
+    // mantissa in [0.5, 1)
+    F m = VecF::AsFloat(VecF::OrInt(VecF::AndInt(bits, 0x007fffff), 0x3f000000));
+
+    F small = VecF::Less(m, VecF::Set(0.707106781186547524f));
+    e       = VecF::Sub(e, VecF::And(small, VecF::Set(1.0f)));
+    m       = VecF::Sub(VecF::Add(m, VecF::And(small, m)), VecF::Set(1.0f));
+
+    F z = VecF::Mul(m, m);
+    F p = VecF::Set(7.0376836292E-2f);
+    p   = VecF::Fma(p, m, VecF::Set(-1.1514610310E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(1.1676998740E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(-1.2420140846E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(1.4249322787E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(-1.6668057665E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(2.0000714765E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(-2.4999993993E-1f));
+    p   = VecF::Fma(p, m, VecF::Set(3.3333331174E-1f));
+    p   = VecF::Mul(VecF::Mul(p, m), z);
+
+    p        = VecF::Fma(e, VecF::Set(-2.12194440e-4f), p);
+    p        = VecF::Fma(z, VecF::Set(-0.5f), p);
+    F result = VecF::Add(m, p);
+    result   = VecF::Fma(e, VecF::Set(0.693359375f), result);
+
+    result = VecF::Select(zero, VecF::Set(-INFINITY), result);
+    result = VecF::Select(negative, VecF::Set(NAN), result);
+    result = VecF::Select(infinite, x, result);
+    return VecF::Select(nan, x, result);
+}
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_VEC_H_
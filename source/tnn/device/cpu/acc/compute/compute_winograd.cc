@@ -0,0 +1,353 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/device/cpu/acc/compute/compute_winograd.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tnn/core/macro.h"
+#include "tnn/device/cpu/acc/compute/compute_conv.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/wingorad_generater.h"
+
+namespace TNN_NS {
+
+static const int kKernelSize    = 3;
+static const int kL2CacheBytes  = 256 * 1024;
+static const int kMaxBlockTiles = 64;
+// alpha of F(6x6, 3x3)
+static const int kMaxAlpha = 8;
+
+// transform matrices of F(unit x unit, 3x3), row major
+struct WinogradMatrices {
+    explicit WinogradMatrices(int unit) {
+        WinogradGenerater generater(unit, kKernelSize);
+        alpha = unit + kKernelSize - 1;
+        a.assign(std::get<0>(generater.A()).get(), std::get<0>(generater.A()).get() + alpha * unit);
+        b.assign(std::get<0>(generater.B()).get(), std::get<0>(generater.B()).get() + alpha * alpha);
+        g.assign(std::get<0>(generater.G()).get(), std::get<0>(generater.G()).get() + alpha * kKernelSize);
+    }
+
+    int alpha;
+    // alpha x unit
+    std::vector<float> a;
+    // alpha x alpha
+    std::vector<float> b;
+    // alpha x 3
+    std::vector<float> g;
+};
+
+static const WinogradMatrices &GetWinogradMatrices(int unit) {
+    static const WinogradMatrices f4(4);
+    static const WinogradMatrices f6(6);
+    return unit == 4 ? f4 : f6;
+}
+
+int CPU_WINOGRAD_SELECT_UNIT(int input_channel, int output_channel, int output_height, int output_width) {
+    float origin_cost = (float)output_height * output_width * input_channel * output_channel * kKernelSize * kKernelSize;
+    int best_unit     = 0;
+    float best_rate   = 1.f;
+
+    for (int unit = 4; unit <= 6; unit += 2) {
+        float alpha = (float)(unit + kKernelSize - 1);
+        float tiles = (float)UP_DIV(output_height, unit) * UP_DIV(output_width, unit);
+        // source transform + gemm of each winograd point + destination transform
+        float src_cost      = 2 * alpha * alpha * alpha * input_channel;
+        float gemm_cost     = alpha * alpha * input_channel * output_channel;
+        float dst_cost      = (alpha * alpha * unit + alpha * unit * unit) * output_channel;
+        float winograd_cost = (src_cost + gemm_cost + dst_cost) * tiles;
+        float rate          = origin_cost / winograd_cost;
+        if (rate > best_rate * 1.1f) {
+            best_rate = rate;
+            best_unit = unit;
+        }
+    }
+    // the transforms miss the cache more than the gemm, ask for a 10% margin
+    return best_rate < 1.1f ? 0 : best_unit;
+}
+
+int CPU_WINOGRAD_WEIGHT_COUNT(int unit, int input_channel, int output_channel) {
+    int alpha = unit + kKernelSize - 1;
+    return alpha * alpha * ROUND_UP(output_channel, CPU_GEMM_MR) * input_channel;
+}
+
+void CPU_WINOGRAD_TRANSFORM_WEIGHTS(const float *weights, float *transformed, int unit, int input_channel,
+                                    int output_channel) {
+    const WinogradMatrices &matrices = GetWinogradMatrices(unit);
+    const int alpha                  = matrices.alpha;
+    const int alpha2                 = alpha * alpha;
+    const int m_panels               = UP_DIV(output_channel, CPU_GEMM_MR);
+    const float *g                   = matrices.g.data();
+
+    // u[oc][ic][alpha * alpha] = G * w * GT
+    std::vector<float> u((size_t)output_channel * input_channel * alpha2);
+    for (int i = 0; i < output_channel * input_channel; i++) {
+        const float *w = weights + i * kKernelSize * kKernelSize;
+        float gw[kMaxAlpha][kKernelSize];
+        for (int y = 0; y < alpha; y++) {
+            for (int x = 0; x < kKernelSize; x++) {
+                float sum = 0;
+                for (int k = 0; k < kKernelSize; k++) {
+                    sum += g[y * kKernelSize + k] * w[k * kKernelSize + x];
+                }
+                gw[y][x] = sum;
+            }
+        }
+        float *dst = u.data() + (size_t)i * alpha2;
+        for (int y = 0; y < alpha; y++) {
+            for (int x = 0; x < alpha; x++) {
+                float sum = 0;
+                for (int k = 0; k < kKernelSize; k++) {
+                    sum += gw[y][k] * g[x * kKernelSize + k];
+                }
+                dst[y * alpha + x] = sum;
+            }
+        }
+    }
+
+    // one gemm weight matrix per winograd point, packed in panels of CPU_GEMM_MR output channels
+    for (int xi = 0; xi < alpha2; xi++) {
+        for (int mp = 0; mp < m_panels; mp++) {
+            for (int ic = 0; ic < input_channel; ic++) {
+                for (int i = 0; i < CPU_GEMM_MR; i++) {
+                    int oc         = mp * CPU_GEMM_MR + i;
+                    *transformed++ = oc < output_channel ? u[((size_t)oc * input_channel + ic) * alpha2 + xi] : 0.0f;
+                }
+            }
+        }
+    }
+}
+
+// v = BT * d * B for a panel of CPU_GEMM_NR tiles, d and v are [alpha * alpha][CPU_GEMM_NR]
+static inline void SrcTransform(const float *d, float *v, const float *b, int alpha) {
+    float tmp[kMaxAlpha * kMaxAlpha * CPU_GEMM_NR];
+    for (int y = 0; y < alpha; y++) {
+        for (int x = 0; x < alpha; x++) {
+            float *t = tmp + (y * alpha + x) * CPU_GEMM_NR;
+            std::fill(t, t + CPU_GEMM_NR, 0.0f);
+            for (int k = 0; k < alpha; k++) {
+                // half of the transform coefficients are zero
+                float coef = b[k * alpha + y];
+                if (coef == 0.0f) {
+                    continue;
+                }
+                const float *s = d + (k * alpha + x) * CPU_GEMM_NR;
+                for (int j = 0; j < CPU_GEMM_NR; j++) {
+                    t[j] += coef * s[j];
+                }
+            }
+        }
+    }
+    for (int y = 0; y < alpha; y++) {
+        for (int x = 0; x < alpha; x++) {
+            float *o = v + (y * alpha + x) * CPU_GEMM_NR;
+            std::fill(o, o + CPU_GEMM_NR, 0.0f);
+            for (int k = 0; k < alpha; k++) {
+                float coef = b[k * alpha + x];
+                if (coef == 0.0f) {
+                    continue;
+                }
+                const float *s = tmp + (y * alpha + k) * CPU_GEMM_NR;
+                for (int j = 0; j < CPU_GEMM_NR; j++) {
+                    o[j] += coef * s[j];
+                }
+            }
+        }
+    }
+}
+
+// y = AT * m * A for a panel of CPU_GEMM_NR tiles, the m of a winograd point are m_step apart
+static inline void DstTransform(const float *m, size_t m_step, float *y, const float *a, int alpha, int unit) {
+    float tmp[kMaxAlpha * kMaxAlpha * CPU_GEMM_NR];
+    for (int i = 0; i < unit; i++) {
+        for (int x = 0; x < alpha; x++) {
+            float *t = tmp + (i * alpha + x) * CPU_GEMM_NR;
+            std::fill(t, t + CPU_GEMM_NR, 0.0f);
+            for (int k = 0; k < alpha; k++) {
+                float coef = a[k * unit + i];
+                if (coef == 0.0f) {
+                    continue;
+                }
+                const float *s = m + (k * alpha + x) * m_step;
+                for (int j = 0; j < CPU_GEMM_NR; j++) {
+                    t[j] += coef * s[j];
+                }
+            }
+        }
+    }
+    for (int i = 0; i < unit; i++) {
+        for (int x = 0; x < unit; x++) {
+            float *o = y + (i * unit + x) * CPU_GEMM_NR;
+            std::fill(o, o + CPU_GEMM_NR, 0.0f);
+            for (int k = 0; k < alpha; k++) {
+                float coef = a[k * unit + x];
+                if (coef == 0.0f) {
+                    continue;
+                }
+                const float *s = tmp + (i * alpha + k) * CPU_GEMM_NR;
+                for (int j = 0; j < CPU_GEMM_NR; j++) {
+                    o[j] += coef * s[j];
+                }
+            }
+        }
+    }
+}
+
+template <typename T>
+void CPU_CONV_WINOGRAD(const void *input_ptr, void *output_ptr, const float *transformed_weights, const void *bias,
+                       DimsVector dims_input, DimsVector dims_output, int pad_y, int pad_x, int unit,
+                       int activation_type) {
+    const T *input_data              = static_cast<const T *>(input_ptr);
+    T *output_data                   = static_cast<T *>(output_ptr);
+    const float *bias_data           = static_cast<const float *>(bias);
+    const WinogradMatrices &matrices = GetWinogradMatrices(unit);
+
+    const int batch          = dims_output[0];
+    const int output_channel = dims_output[1];
+    const int output_height  = dims_output[2];
+    const int output_width   = dims_output[3];
+    const int input_channel  = dims_input[1];
+    const int input_height   = dims_input[2];
+    const int input_width    = dims_input[3];
+    const int alpha          = matrices.alpha;
+    const int alpha2         = alpha * alpha;
+    const int m_panels       = UP_DIV(output_channel, CPU_GEMM_MR);
+    const int weight_step    = m_panels * CPU_GEMM_MR * input_channel;
+
+    const int tiles_w    = UP_DIV(output_width, unit);
+    const int tile_count = UP_DIV(output_height, unit) * tiles_w;
+
+    // the transformed inputs and products of a block of tiles stay in the l2 cache
+    int block  = kL2CacheBytes / (alpha2 * (input_channel + output_channel) * (int)sizeof(float));
+    block      = std::min(block, std::min(kMaxBlockTiles, ROUND_UP(tile_count, CPU_GEMM_NR)));
+    block      = std::max(block / CPU_GEMM_NR * CPU_GEMM_NR, CPU_GEMM_NR);
+    int blocks = UP_DIV(tile_count, block);
+    int tasks  = batch * blocks;
+
+    // per thread: transformed inputs [alpha2][block / NR][ic][NR], then products [alpha2][oc][block]
+    size_t src_size             = (size_t)alpha2 * input_channel * block;
+    size_t workspace_per_thread = src_size + (size_t)alpha2 * output_channel * block;
+    std::vector<float> workspace(workspace_per_thread * OMP_MAX_THREADS_NUM_);
+
+    OMP_PARALLEL_FOR_
+    for (int t = 0; t < tasks; t++) {
+        int n          = t / blocks;
+        int tile_start = t % blocks * block;
+        int count      = std::min(block, tile_count - tile_start);
+        int n_panels   = UP_DIV(count, CPU_GEMM_NR);
+        float *src_buf = workspace.data() + workspace_per_thread * OMP_TID_;
+        float *dst_buf = src_buf + src_size;
+
+        for (int np = 0; np < n_panels; np++) {
+            for (int c = 0; c < input_channel; c++) {
+                const T *src = input_data + ((size_t)n * input_channel + c) * input_height * input_width;
+                float d[kMaxAlpha * kMaxAlpha * CPU_GEMM_NR], v[kMaxAlpha * kMaxAlpha * CPU_GEMM_NR];
+                for (int j = 0; j < CPU_GEMM_NR; j++) {
+                    int tile = tile_start + np * CPU_GEMM_NR + j;
+                    int y0   = tile / tiles_w * unit - pad_y;
+                    int x0   = tile % tiles_w * unit - pad_x;
+                    if (tile < tile_start + count && y0 >= 0 && x0 >= 0 && y0 + alpha <= input_height &&
+                        x0 + alpha <= input_width) {
+                        for (int y = 0; y < alpha; y++) {
+                            const T *row = src + (y0 + y) * input_width + x0;
+                            for (int x = 0; x < alpha; x++) {
+                                d[(y * alpha + x) * CPU_GEMM_NR + j] = static_cast<float>(row[x]);
+                            }
+                        }
+                        continue;
+                    }
+                    // the columns past the last tile feed the gemm but are never stored
+                    bool valid = tile < tile_start + count;
+                    for (int y = 0; y < alpha; y++) {
+                        for (int x = 0; x < alpha; x++) {
+                            int sy  = y0 + y, sx = x0 + x;
+                            bool in = valid && sy >= 0 && sy < input_height && sx >= 0 && sx < input_width;
+                            d[(y * alpha + x) * CPU_GEMM_NR + j] =
+                                in ? static_cast<float>(src[sy * input_width + sx]) : 0.0f;
+                        }
+                    }
+                }
+                SrcTransform(d, v, matrices.b.data(), alpha);
+                float *dst = src_buf + ((size_t)np * input_channel + c) * CPU_GEMM_NR;
+                for (int xi = 0; xi < alpha2; xi++) {
+                    std::copy(v + xi * CPU_GEMM_NR, v + (xi + 1) * CPU_GEMM_NR,
+                              dst + (size_t)xi * input_channel * block);
+                }
+            }
+        }
+
+        for (int xi = 0; xi < alpha2; xi++) {
+            const float *weights = transformed_weights + (size_t)xi * weight_step;
+            const float *src     = src_buf + (size_t)xi * input_channel * block;
+            float *dst           = dst_buf + (size_t)xi * output_channel * block;
+            for (int mp = 0; mp < m_panels; mp++) {
+                for (int np = 0; np < n_panels; np++) {
+                    float c[CPU_GEMM_MR][CPU_GEMM_NR];
+                    CPU_GEMM_KERNEL(weights + mp * CPU_GEMM_MR * input_channel,
+                                    src + np * input_channel * CPU_GEMM_NR, input_channel, c);
+                    int rows = std::min(CPU_GEMM_MR, output_channel - mp * CPU_GEMM_MR);
+                    for (int i = 0; i < rows; i++) {
+                        float *row = dst + (mp * CPU_GEMM_MR + i) * block + np * CPU_GEMM_NR;
+                        for (int j = 0; j < CPU_GEMM_NR; j++) {
+                            row[j] = c[i][j];
+                        }
+                    }
+                }
+            }
+        }
+
+        for (int oc = 0; oc < output_channel; oc++) {
+            T *dst           = output_data + ((size_t)n * output_channel + oc) * output_height * output_width;
+            float bias_value = bias_data ? bias_data[oc] : 0.0f;
+            for (int np = 0; np < n_panels; np++) {
+                float y[kMaxAlpha * kMaxAlpha * CPU_GEMM_NR];
+                DstTransform(dst_buf + (size_t)oc * block + np * CPU_GEMM_NR, (size_t)output_channel * block, y,
+                             matrices.a.data(), alpha, unit);
+
+                int panel_count = std::min(CPU_GEMM_NR, count - np * CPU_GEMM_NR);
+                for (int j = 0; j < panel_count; j++) {
+                    int tile = tile_start + np * CPU_GEMM_NR + j;
+                    int y0   = tile / tiles_w * unit;
+                    int x0   = tile % tiles_w * unit;
+                    int ey   = std::min(unit, output_height - y0);
+                    int ex   = std::min(unit, output_width - x0);
+                    for (int i = 0; i < ey; i++) {
+                        for (int k = 0; k < ex; k++) {
+                            float value = y[(i * unit + k) * CPU_GEMM_NR + j] + bias_value;
+                            if (activation_type == ActivationType_ReLU) {
+                                value = value > 0.0f ? value : 0.0f;
+                            } else if (activation_type == ActivationType_ReLU6) {
+                                value = std::min(std::max(value, 0.0f), 6.0f);
+                            }
+                            dst[(y0 + i) * output_width + x0 + k] = value;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+template void CPU_CONV_WINOGRAD<float>(const void *input_ptr, void *output_ptr, const float *transformed_weights,
+                                       const void *bias, DimsVector dims_input, DimsVector dims_output, int pad_y,
+                                       int pad_x, int unit, int activation_type);
+
+template void CPU_CONV_WINOGRAD<bfp16_t>(const void *input_ptr, void *output_ptr, const float *transformed_weights,
+                                         const void *bias, DimsVector dims_input, DimsVector dims_output, int pad_y,
+                                         int pad_x, int unit, int activation_type);
+
+}  // namespace TNN_NS
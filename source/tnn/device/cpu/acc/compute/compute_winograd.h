@@ -0,0 +1,43 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_CPU_COMPUTE_WINOGRAD_H_
+#define TNN_CPU_COMPUTE_WINOGRAD_H_
+
+#include "tnn/core/common.h"
+
+namespace TNN_NS {
+
+// output tile size n of the F(n x n, 3x3) winograd worth using instead of the gemm conv for a
+// 3x3 stride 1 conv, 4 or 6. 0 if the transforms cost more than they save.
+int CPU_WINOGRAD_SELECT_UNIT(int input_channel, int output_channel, int output_height, int output_width);
+
+// elements of the weights transformed by CPU_WINOGRAD_TRANSFORM_WEIGHTS
+int CPU_WINOGRAD_WEIGHT_COUNT(int unit, int input_channel, int output_channel);
+
+// G * g * GT of the oihw 3x3 weights, laid out as (unit + 2)^2 gemm weight panels
+void CPU_WINOGRAD_TRANSFORM_WEIGHTS(const float *weights, float *transformed, int unit, int input_channel,
+                                    int output_channel);
+
+// nchw 3x3 stride 1 conv of a single group with the transformed weights, fp32 or bfp16 blobs.
+// blocks of tiles run in parallel with openmp, each block is transformed, multiplied per winograd
+// point and transformed back with the bias and relu/relu6 applied.
+template <typename T>
+void CPU_CONV_WINOGRAD(const void *input_ptr, void *output_ptr, const float *transformed_weights, const void *bias,
+                       DimsVector dims_input, DimsVector dims_output, int pad_y, int pad_x, int unit,
+                       int activation_type);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_CPU_COMPUTE_WINOGRAD_H_
@@ -22,7 +22,7 @@ DECLARE_CPU_BINARY_OP_ACC(Add, LAYER_ADD);
 Status CpuAddLayerAcc::Calculate(const std::vector<Blob *> &input_blobs, const std::vector<void *> &input_ptrs,
                                  const std::vector<DimsVector> &input_shapes, Blob *output) {
     if (output->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        CPU_ADD(input_ptrs, input_shapes, output->GetHandle().base, output->GetBlobDesc().dims);
+        CPU_ADD(input_ptrs, broadcast_plans_, output->GetHandle().base, output->GetBlobDesc().dims);
     } else if (output->GetBlobDesc().data_type == DATA_TYPE_INT8) {
         std::vector<float *> scale_ptrs;
 
@@ -21,10 +21,23 @@ namespace TNN_NS {
 CpuBinaryOpLayerAcc::~CpuBinaryOpLayerAcc() {}
 
 Status CpuBinaryOpLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    std::vector<void *> input_ptrs;
+    std::vector<DimsVector> input_shapes;
+    Status status = GetInputs(inputs, input_ptrs, input_shapes);
+    if (status != TNN_OK) {
+        return status;
+    }
+
+    auto dims = outputs[0]->GetBlobDesc().dims;
+    broadcast_plans_.clear();
+    for (const auto &input_shape : input_shapes) {
+        broadcast_plans_.push_back(CPU_BROADCAST_PLAN(input_shape, dims));
+    }
     return TNN_OK;
 }
 
-Status CpuBinaryOpLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+Status CpuBinaryOpLayerAcc::GetInputs(const std::vector<Blob *> &inputs, std::vector<void *> &input_ptrs,
+                                      std::vector<DimsVector> &input_shapes) {
     auto layer_param = dynamic_cast<MultidirBroadcastLayerParam *>(param_);
     if (!layer_param) {
         LOGE("Error: layer param is nil\n");
@@ -36,11 +49,6 @@ Status CpuBinaryOpLayerAcc::Forward(const std::vector<Blob *> &inputs, const std
         return Status(TNNERR_LAYER_ERR, "CpuBinaryLayerAcc invalid inputs count");
     }
 
-    auto output = outputs[0];
-    auto dims   = output->GetBlobDesc().dims;
-    std::vector<void *> input_ptrs;
-    std::vector<DimsVector> input_shapes;
-
     if (inputs.size() >= 2) {
         for (size_t inid = 0; inid < inputs.size(); inid++) {
             input_ptrs.push_back(inputs[inid]->GetHandle().base);
@@ -62,7 +70,17 @@ Status CpuBinaryOpLayerAcc::Forward(const std::vector<Blob *> &inputs, const std
             input_shapes.push_back(layer_res->element_shape);
         }
     }
-    Status status = Calculate(inputs, input_ptrs, input_shapes, output);
-    return status;
+    return TNN_OK;
+}
+
+Status CpuBinaryOpLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    std::vector<void *> input_ptrs;
+    std::vector<DimsVector> input_shapes;
+    Status status = GetInputs(inputs, input_ptrs, input_shapes);
+    if (status != TNN_OK) {
+        return status;
+    }
+
+    return Calculate(inputs, input_ptrs, input_shapes, outputs[0]);
 }
 }  // namespace TNN_NS
\ No newline at end of file
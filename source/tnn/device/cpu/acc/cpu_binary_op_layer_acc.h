@@ -30,7 +30,15 @@ public:
 
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+protected:
+    // broadcast of each input against the output, classified in Reshape
+    std::vector<CpuBroadcastPlan> broadcast_plans_;
+
 private:
+    // the inputs in op order, the element resource takes the place of a missing input
+    Status GetInputs(const std::vector<Blob *> &inputs, std::vector<void *> &input_ptrs,
+                     std::vector<DimsVector> &input_shapes);
+
     virtual Status Calculate(const std::vector<Blob *> &input_blobs, const std::vector<void *> &input_ptrs,
                              const std::vector<DimsVector> &input_shapes, Blob *output) = 0;
 };
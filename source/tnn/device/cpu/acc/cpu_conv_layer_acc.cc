@@ -15,12 +15,28 @@
 #include "tnn/device/cpu/acc/cpu_conv_layer_acc.h"
 
 #include "tnn/core/blob_int8.h"
-#include "tnn/utils/naive_compute.h"
+#include "tnn/device/cpu/acc/compute/compute_conv.h"
+#include "tnn/device/cpu/acc/compute/compute_depthwise.h"
+#include "tnn/device/cpu/acc/compute/compute_winograd.h"
 
 namespace TNN_NS {
 
 CpuConvLayerAcc::~CpuConvLayerAcc() {}
 
+size_t CpuConvLayerAcc::GetPackedWeightBytes() {
+    return buffer_scale_.GetBytesSize() + packed_weights_.GetBytesSize();
+}
+
+std::string CpuConvLayerAcc::GetImplName() {
+    if (depthwise_) {
+        return "depthwise";
+    }
+    if (winograd_unit_ > 0) {
+        return "winograd" + std::to_string(winograd_unit_);
+    }
+    return "gemm";
+}
+
 Status CpuConvLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
                              const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto status = CpuLayerAcc::Init(context, param, resource, inputs, outputs);
@@ -62,6 +78,56 @@ Status CpuConvLayerAcc::Init(Context *context, LayerParam *param, LayerResource
             buffer_scale_ = temp_buffer;
         }
     }
+
+    auto dims_input  = inputs[0]->GetBlobDesc().dims;
+    auto dims_output = outputs[0]->GetBlobDesc().dims;
+    auto data_type   = outputs[0]->GetBlobDesc().data_type;
+    bool is_depthwise = conv_param->group == dims_input[1] && conv_param->group == dims_output[1];
+    depthwise_        = data_type != DATA_TYPE_INT8 && is_depthwise &&
+                 CPU_DEPTHWISE_SUPPORTED(conv_param->kernels[1], conv_param->kernels[0], conv_param->strides[1],
+                                         conv_param->strides[0], conv_param->dialations[1], conv_param->dialations[0]);
+    if (depthwise_) {
+        // the depthwise kernel reads the weights as they are, only half weights are converted
+        if (conv_res->filter_handle.GetDataType() == DATA_TYPE_HALF && !packed_weights_.GetBytesSize()) {
+            packed_weights_ = ConvertHalfHandle(conv_res->filter_handle);
+        }
+        return TNN_OK;
+    }
+
+    if (!packed_weights_.GetBytesSize()) {
+        bool is_3x3_s1 = conv_param->kernels[0] == 3 && conv_param->kernels[1] == 3 && conv_param->strides[0] == 1 &&
+                         conv_param->strides[1] == 1 && conv_param->dialations[0] == 1 &&
+                         conv_param->dialations[1] == 1;
+        if (data_type != DATA_TYPE_INT8 && is_3x3_s1 && conv_param->group == 1) {
+            winograd_unit_ =
+                CPU_WINOGRAD_SELECT_UNIT(dims_input[1], dims_output[1], dims_output[2], dims_output[3]);
+        }
+        if (winograd_unit_ > 0) {
+            RawBuffer filter = ConvertHalfHandle(conv_res->filter_handle);
+            RawBuffer transformed(CPU_WINOGRAD_WEIGHT_COUNT(winograd_unit_, dims_input[1], dims_output[1]) *
+                                  sizeof(float));
+            CPU_WINOGRAD_TRANSFORM_WEIGHTS(filter.force_to<float *>(), transformed.force_to<float *>(),
+                                           winograd_unit_, dims_input[1], dims_output[1]);
+            packed_weights_ = transformed;
+            return TNN_OK;
+        }
+
+        int packed_count = CPU_PACKED_CONV_WEIGHT_COUNT(dims_output[1], dims_input[1], conv_param->group,
+                                                        conv_param->kernels[1], conv_param->kernels[0]);
+        if (outputs[0]->GetBlobDesc().data_type == DATA_TYPE_INT8) {
+            RawBuffer packed(packed_count * sizeof(int8_t));
+            CPU_PACK_CONV_WEIGHTS(conv_res->filter_handle.force_to<int8_t *>(), packed.force_to<int8_t *>(),
+                                  dims_output[1], dims_input[1], conv_param->group, conv_param->kernels[1],
+                                  conv_param->kernels[0]);
+            packed_weights_ = packed;
+        } else {
+            RawBuffer filter = ConvertHalfHandle(conv_res->filter_handle);
+            RawBuffer packed(packed_count * sizeof(float));
+            CPU_PACK_CONV_WEIGHTS(filter.force_to<float *>(), packed.force_to<float *>(), dims_output[1],
+                                  dims_input[1], conv_param->group, conv_param->kernels[1], conv_param->kernels[0]);
+            packed_weights_ = packed;
+        }
+    }
     return TNN_OK;
 }
 
@@ -80,7 +146,6 @@ Status CpuConvLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::ve
     Blob *output_blob  = outputs[0];
     void *input_ptr    = input_blob->GetHandle().base;
     void *output_ptr   = output_blob->GetHandle().base;
-    void *weight_ptr   = resource->filter_handle.force_to<void *>();
     void *bias_ptr     = NULL;
     DataType data_type = output_blob->GetBlobDesc().data_type;
     if (param->bias || data_type == DATA_TYPE_INT8) {
@@ -89,22 +154,41 @@ Status CpuConvLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::ve
     DimsVector output_dims = output_blob->GetBlobDesc().dims;
     DimsVector input_dims  = input_blob->GetBlobDesc().dims;
 
-    if (data_type == DATA_TYPE_FLOAT) {
-        NaiveConv<float, float, float, float>(input_ptr, output_ptr, weight_ptr, bias_ptr, input_dims, output_dims,
-                                            param->strides[1], param->strides[0], param->kernels[1], param->kernels[0],
-                                            param->pads[2], param->pads[0], param->group, param->dialations[1],
-                                            param->activation_type, NULL, 0);
+    if (depthwise_) {
+        const float *weights = packed_weights_.GetBytesSize() ? packed_weights_.force_to<float *>()
+                                                              : resource->filter_handle.force_to<float *>();
+        if (data_type == DATA_TYPE_FLOAT) {
+            CPU_CONV_DEPTHWISE<float>(input_ptr, output_ptr, weights, bias_ptr, input_dims, output_dims,
+                                      param->strides[0], param->kernels[0], param->pads[2], param->pads[0],
+                                      param->activation_type);
+        } else {
+            CPU_CONV_DEPTHWISE<bfp16_t>(input_ptr, output_ptr, weights, bias_ptr, input_dims, output_dims,
+                                        param->strides[0], param->kernels[0], param->pads[2], param->pads[0],
+                                        param->activation_type);
+        }
+    } else if (winograd_unit_ > 0 && data_type == DATA_TYPE_FLOAT) {
+        CPU_CONV_WINOGRAD<float>(input_ptr, output_ptr, packed_weights_.force_to<float *>(), bias_ptr, input_dims,
+                                 output_dims, param->pads[2], param->pads[0], winograd_unit_, param->activation_type);
+    } else if (winograd_unit_ > 0 && data_type == DATA_TYPE_BFP16) {
+        CPU_CONV_WINOGRAD<bfp16_t>(input_ptr, output_ptr, packed_weights_.force_to<float *>(), bias_ptr, input_dims,
+                                   output_dims, param->pads[2], param->pads[0], winograd_unit_,
+                                   param->activation_type);
+    } else if (data_type == DATA_TYPE_FLOAT) {
+        CPU_CONV_GEMM<float, float, float, float>(
+            input_ptr, output_ptr, packed_weights_.force_to<float *>(), bias_ptr, input_dims, output_dims,
+            param->strides[1], param->strides[0], param->kernels[1], param->kernels[0], param->pads[2], param->pads[0],
+            param->group, param->dialations[1], param->activation_type, NULL, 0);
     } else if (data_type == DATA_TYPE_BFP16) {
-        NaiveConv<bfp16_t, float, float, bfp16_t>(input_ptr, output_ptr, weight_ptr, bias_ptr, input_dims, output_dims,
-                                                param->strides[1], param->strides[0], param->kernels[1],
-                                                param->kernels[0], param->pads[2], param->pads[0], param->group,
-                                                param->dialations[1], param->activation_type, NULL, 0);
+        CPU_CONV_GEMM<bfp16_t, float, float, bfp16_t>(
+            input_ptr, output_ptr, packed_weights_.force_to<float *>(), bias_ptr, input_dims, output_dims,
+            param->strides[1], param->strides[0], param->kernels[1], param->kernels[0], param->pads[2], param->pads[0],
+            param->group, param->dialations[1], param->activation_type, NULL, 0);
     } else if (data_type == DATA_TYPE_INT8) {
         float *scale_ptr = buffer_scale_.force_to<float *>();
-        NaiveConv<int8_t, int8_t, int32_t, int8_t>(
-            input_ptr, output_ptr, weight_ptr, bias_ptr, input_dims, output_dims, param->strides[1], param->strides[0],
-            param->kernels[1], param->kernels[0], param->pads[2], param->pads[0], param->group, param->dialations[1],
-            param->activation_type, scale_ptr, buffer_scale_.GetDataCount());
+        CPU_CONV_GEMM<int8_t, int8_t, int32_t, int8_t>(
+            input_ptr, output_ptr, packed_weights_.force_to<int8_t *>(), bias_ptr, input_dims, output_dims,
+            param->strides[1], param->strides[0], param->kernels[1], param->kernels[0], param->pads[2], param->pads[0],
+            param->group, param->dialations[1], param->activation_type, scale_ptr, buffer_scale_.GetDataCount());
     } else {
         return Status(TNNERR_LAYER_ERR, "data type not support in conv");
     }
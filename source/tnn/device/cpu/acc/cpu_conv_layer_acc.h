@@ -15,6 +15,7 @@
 #ifndef TNN_SOURCE_TNN_DEVICE_CPU_CPU_CONV_LAYER_ACC_H_
 #define TNN_SOURCE_TNN_DEVICE_CPU_CPU_CONV_LAYER_ACC_H_
 
+#include <string>
 #include <vector>
 
 #include "tnn/core/blob.h"
@@ -35,8 +36,20 @@ class CpuConvLayerAcc : public CpuLayerAcc {
 
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+    virtual size_t GetPackedWeightBytes();
+
+public:
+    // @brief kernel selected in Init: depthwise, winograd4, winograd6 or gemm
+    std::string GetImplName();
+
 private:
     RawBuffer buffer_scale_;
+    // weights packed for CPU_CONV_GEMM, fp32 for the fp32/bfp16 blobs,
+    // or transformed for CPU_CONV_WINOGRAD when winograd_unit_ is set
+    RawBuffer packed_weights_;
+    int winograd_unit_ = 0;
+    // fp32/bfp16 depthwise convs run CPU_CONV_DEPTHWISE on the oihw weights
+    bool depthwise_ = false;
 };
 
 }  // namespace TNN_NS
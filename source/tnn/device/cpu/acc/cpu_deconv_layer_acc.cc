@@ -33,6 +33,10 @@ static int LeastCommonMultiple(int m, int n) {
 
 CpuDeconvLayerAcc::~CpuDeconvLayerAcc() {}
 
+size_t CpuDeconvLayerAcc::GetPackedWeightBytes() {
+    return buffer_scale_.GetBytesSize();
+}
+
 Status CpuDeconvLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
                                const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto status = CpuLayerAcc::Init(context, param, resource, inputs, outputs);
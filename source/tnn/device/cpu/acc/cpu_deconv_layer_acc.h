@@ -38,6 +38,8 @@ class CpuDeconvLayerAcc : public CpuLayerAcc {
 
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+    virtual size_t GetPackedWeightBytes();
+
 private:
     RawBuffer buffer_scale_;
 };
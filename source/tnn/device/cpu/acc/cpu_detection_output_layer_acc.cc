@@ -14,16 +14,20 @@
 
 #include "tnn/device/cpu/acc/cpu_detection_output_layer_acc.h"
 
-#include <algorithm>
-#include <cmath>
-
-#include "tnn/device/cpu/acc/compute/normalized_bbox.h"
-#include "tnn/utils/bbox_util.h"
-
 namespace TNN_NS {
 
 CpuDetectionOuputLayerAcc::~CpuDetectionOuputLayerAcc(){};
 
+Status CpuDetectionOuputLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
+                                       const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto ret = CpuLayerAcc::Init(context, param, resource, inputs, outputs);
+    RETURN_ON_NEQ(ret, TNN_OK);
+
+    auto layer_param = dynamic_cast<DetectionOutputLayerParam *>(param);
+    CHECK_PARAM_NULL(layer_param);
+    return DetectionPostProcessor::CheckParam(layer_param);
+}
+
 Status CpuDetectionOuputLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     return TNN_OK;
 }
@@ -31,8 +35,7 @@ Status CpuDetectionOuputLayerAcc::Reshape(const std::vector<Blob *> &inputs, con
 Status CpuDetectionOuputLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     DetectionOutputLayerParam *param = dynamic_cast<DetectionOutputLayerParam *>(param_);
     CHECK_PARAM_NULL(param);
-    NaiveDetectionOutput(inputs, outputs, param);
-    return TNN_OK;
+    return post_processor_.Forward(inputs, outputs, param);
 }
 
 CpuTypeLayerAccRegister<TypeLayerAccCreator<CpuDetectionOuputLayerAcc>> g_cpu_detection_output_layer_acc_register(
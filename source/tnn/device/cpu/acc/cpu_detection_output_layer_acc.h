@@ -17,7 +17,7 @@
 
 #include "tnn/device/cpu/acc/cpu_layer_acc.h"
 #include "tnn/device/cpu/cpu_device.h"
-#include "tnn/utils/bbox_util.h"
+#include "tnn/utils/detection_post_processor.h"
 
 namespace TNN_NS {
 
@@ -26,6 +26,10 @@ class CpuDetectionOuputLayerAcc : public CpuLayerAcc {
     // @brief virtual destrcutor
     virtual ~CpuDetectionOuputLayerAcc();
 
+    // @brief rejects the nms params the post processor can not run
+    virtual Status Init(Context *context, LayerParam *param, LayerResource *resource, const std::vector<Blob *> &inputs,
+                        const std::vector<Blob *> &outputs);
+
     /**
      * @brief input or output blobs reshape.
      * @param inputs    input blobs
@@ -42,6 +46,9 @@ class CpuDetectionOuputLayerAcc : public CpuLayerAcc {
      */
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+private:
+    // keeps its buffers across forwards
+    DetectionPostProcessor post_processor_;
 };
 
 }  // namespace TNN_NS
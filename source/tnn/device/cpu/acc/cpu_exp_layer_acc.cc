@@ -22,6 +22,9 @@ typedef struct exp_operator : unary_operator {
     virtual float operator()(float in) {
         return exp(in);
     }
+    virtual void Compute(const float *in, float *out, int count) {
+        CPU_EXP(in, out, count);
+    }
 } EXP_OP;
 
 DECLARE_UNARY_ACC(Exp, LAYER_EXP, EXP_OP);
@@ -0,0 +1,189 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "tnn/device/cpu/acc/cpu_layer_acc.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/fused_elementwise_utils.h"
+#include "tnn/utils/omp_utils.h"
+
+namespace TNN_NS {
+
+// elements of a block, the whole program runs on one block while it stays in L1
+static const int kFusedElementwiseBlock = 512;
+
+class CpuFusedElementwiseLayerAcc : public CpuLayerAcc {
+public:
+    virtual ~CpuFusedElementwiseLayerAcc(){};
+    virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+    virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
+
+private:
+    // BroadcastType of each constant against the current output shape
+    std::vector<int> constant_broadcast_types_;
+};
+
+Status CpuFusedElementwiseLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    std::vector<DimsVector> shapes;
+    return FusedElementwiseUtils::GetConstantBroadcast(dynamic_cast<FusedElementwiseLayerResource *>(resource_),
+                                                       outputs[0]->GetBlobDesc().dims, shapes,
+                                                       constant_broadcast_types_);
+}
+
+// returns the operand of a block, contiguous operands are read in place
+static const float *GetOperand(const FusedElementwiseOp &op, FusedElementwiseLayerResource *resource,
+                               int broadcast_type, const float *input, const DimsVector &dims, int n, int c, int hw,
+                               int len, float *scratch) {
+    if (op.operand == FusedElementwiseOperandInput) {
+        return input;
+    }
+
+    const int channel = dims[1];
+    const int plane   = dims[2] * dims[3];
+    auto constant     = resource->constant_handles[op.constant_index].force_to<float *>();
+    if (broadcast_type == BroadcastTypeSingle) {
+        std::fill(scratch, scratch + len, constant[0]);
+        return scratch;
+    } else if (broadcast_type == BroadcastTypeChannel) {
+        std::fill(scratch, scratch + len, constant[c]);
+        return scratch;
+    } else if (broadcast_type == BroadcastTypeElement) {
+        return constant + c * plane + hw;
+    } else if (broadcast_type == BroadcastTypeNormal) {
+        return constant + (n * channel + c) * plane + hw;
+    } else {
+        for (int i = 0; i < len; i++) {
+            scratch[i] = constant[(hw + i) % dims[3]];
+        }
+        return scratch;
+    }
+}
+
+static void ApplyOp(const FusedElementwiseOp &op, float *value, const float *operand, int len) {
+    switch (op.type) {
+        case FusedElementwiseOpAdd:
+            for (int i = 0; i < len; i++) {
+                value[i] = value[i] + operand[i];
+            }
+            break;
+        case FusedElementwiseOpSub:
+            if (op.operand_first) {
+                for (int i = 0; i < len; i++) {
+                    value[i] = operand[i] - value[i];
+                }
+            } else {
+                for (int i = 0; i < len; i++) {
+                    value[i] = value[i] - operand[i];
+                }
+            }
+            break;
+        case FusedElementwiseOpMul:
+            for (int i = 0; i < len; i++) {
+                value[i] = value[i] * operand[i];
+            }
+            break;
+        case FusedElementwiseOpDiv:
+            if (op.operand_first) {
+                for (int i = 0; i < len; i++) {
+                    value[i] = operand[i] / value[i];
+                }
+            } else {
+                for (int i = 0; i < len; i++) {
+                    value[i] = value[i] / operand[i];
+                }
+            }
+            break;
+        case FusedElementwiseOpSigmoid:
+            for (int i = 0; i < len; i++) {
+                value[i] = 1.0f / (1.0f + std::exp(-value[i]));
+            }
+            break;
+        case FusedElementwiseOpExp:
+            for (int i = 0; i < len; i++) {
+                value[i] = std::exp(value[i]);
+            }
+            break;
+        case FusedElementwiseOpClip:
+            for (int i = 0; i < len; i++) {
+                value[i] = std::min(std::max(value[i], op.alpha), op.beta);
+            }
+            break;
+        case FusedElementwiseOpHardSigmoid:
+            for (int i = 0; i < len; i++) {
+                value[i] = std::min(std::max(value[i] * op.alpha + op.beta, 0.0f), 1.0f);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+Status CpuFusedElementwiseLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    auto layer_param = dynamic_cast<FusedElementwiseLayerParam *>(param_);
+    CHECK_PARAM_NULL(layer_param);
+    auto layer_res = dynamic_cast<FusedElementwiseLayerResource *>(resource_);
+
+    auto output = outputs[0];
+    if (output->GetBlobDesc().data_type != DATA_TYPE_FLOAT) {
+        LOGE("Error: CpuFusedElementwiseLayerAcc don't support data type: %d\n", output->GetBlobDesc().data_type);
+        return Status(TNNERR_MODEL_ERR, "Error: CpuFusedElementwiseLayerAcc don't support data type");
+    }
+    for (auto &op : layer_param->ops) {
+        if (op.operand == FusedElementwiseOperandConstant &&
+            (!layer_res || op.constant_index >= constant_broadcast_types_.size())) {
+            LOGE("Error: fused elementwise constant is missing\n");
+            return Status(TNNERR_LAYER_ERR, "Error: fused elementwise constant is missing");
+        }
+    }
+
+    auto dims             = output->GetBlobDesc().dims;
+    const int planes      = dims[0] * dims[1];
+    const int plane       = DimsVectorUtils::Count(dims, 2);
+    auto input_data       = static_cast<float *>(inputs[0]->GetHandle().base);
+    auto output_data      = static_cast<float *>(output->GetHandle().base);
+    auto &ops             = layer_param->ops;
+    auto &broadcast_types = constant_broadcast_types_;
+
+    OMP_PARALLEL_FOR_
+    for (int p = 0; p < planes; p++) {
+        float value[kFusedElementwiseBlock];
+        float scratch[kFusedElementwiseBlock];
+        const int n = p / dims[1];
+        const int c = p % dims[1];
+        for (int hw = 0; hw < plane; hw += kFusedElementwiseBlock) {
+            const int len    = std::min(kFusedElementwiseBlock, plane - hw);
+            const float *src = input_data + p * plane + hw;
+            memcpy(value, src, len * sizeof(float));
+            for (auto &op : ops) {
+                const float *operand = nullptr;
+                if (op.operand != FusedElementwiseOperandNone) {
+                    int type = op.operand == FusedElementwiseOperandConstant ? broadcast_types[op.constant_index]
+                                                                              : BroadcastTypeNormal;
+                    operand  = GetOperand(op, layer_res, type, src, dims, n, c, hw, len, scratch);
+                }
+                ApplyOp(op, value, operand, len);
+            }
+            memcpy(output_data + p * plane + hw, value, len * sizeof(float));
+        }
+    }
+    return TNN_OK;
+}
+
+REGISTER_CPU_ACC(FusedElementwise, LAYER_FUSED_ELEMENTWISE);
+
+}  // namespace TNN_NS
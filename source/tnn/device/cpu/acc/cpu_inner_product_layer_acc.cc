@@ -13,10 +13,10 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/core/blob_int8.h"
+#include "tnn/device/cpu/acc/compute/compute_inner_product.h"
 #include "tnn/device/cpu/acc/cpu_layer_acc.h"
 #include "tnn/utils/bfp16.h"
-#include "tnn/utils/bfp16_utils.h"
-#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/dims_vector_utils.h"
 
 namespace TNN_NS {
 
@@ -30,10 +30,20 @@ public:
     virtual Status Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
+    virtual size_t GetPackedWeightBytes();
+
 private:
     RawBuffer buffer_scale_;
+    // weights packed for CPU_INNER_PRODUCT, fp32 for the fp32/bfp16 blobs
+    RawBuffer packed_weights_;
+    // fp32 bias for the fp32/bfp16 blobs, the model may store it in half
+    RawBuffer bias_;
 };
 
+size_t CpuInnerProductLayerAcc::GetPackedWeightBytes() {
+    return buffer_scale_.GetBytesSize() + packed_weights_.GetBytesSize();
+}
+
 Status CpuInnerProductLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
                                      const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto status = CpuLayerAcc::Init(context, param, resource, inputs, outputs);
@@ -70,6 +80,28 @@ Status CpuInnerProductLayerAcc::Init(Context *context, LayerParam *param, LayerR
             buffer_scale_ = temp_buffer;
         }
     }
+
+    if (!packed_weights_.GetBytesSize()) {
+        int output_channel = outputs[0]->GetBlobDesc().dims[1];
+        int input_size     = DimsVectorUtils::Count(inputs[0]->GetBlobDesc().dims, 1);
+        int packed_count   = CPU_PACKED_CONV_WEIGHT_COUNT(output_channel, input_size, 1, 1, 1);
+        if (outputs[0]->GetBlobDesc().data_type == DATA_TYPE_INT8) {
+            RawBuffer packed(packed_count * sizeof(int8_t));
+            CPU_PACK_CONV_WEIGHTS(layer_res->weight_handle.force_to<int8_t *>(), packed.force_to<int8_t *>(),
+                                  output_channel, input_size, 1, 1, 1);
+            packed_weights_ = packed;
+        } else {
+            RawBuffer weights = ConvertHalfHandle(layer_res->weight_handle);
+            RawBuffer packed(packed_count * sizeof(float));
+            CPU_PACK_CONV_WEIGHTS(weights.force_to<float *>(), packed.force_to<float *>(), output_channel,
+                                  input_size, 1, 1, 1);
+            packed_weights_ = packed;
+        }
+    }
+
+    if (outputs[0]->GetBlobDesc().data_type != DATA_TYPE_INT8 && layer_param->has_bias) {
+        bias_ = ConvertHalfHandle(layer_res->bias_handle);
+    }
     return TNN_OK;
 }
 
@@ -90,32 +122,38 @@ Status CpuInnerProductLayerAcc::Forward(const std::vector<Blob *> &inputs, const
     Blob *input_blob  = inputs[0];
     Blob *output_blob = outputs[0];
 
-    int has_bias   = param->has_bias;
-    int num_output = param->num_output;
-
     void *input_data  = input_blob->GetHandle().base;
     void *output_data = output_blob->GetHandle().base;
-    void *weight_data = resource->weight_handle.force_to<void *>();
     void *bias_data   = nullptr;
-    if (has_bias) {
-        bias_data = resource->bias_handle.force_to<void *>();
+    if (param->has_bias) {
+        bias_data = bias_.GetBytesSize() ? bias_.force_to<void *>() : resource->bias_handle.force_to<void *>();
     }
 
-    auto dims_input  = input_blob->GetBlobDesc().dims;
-    auto dims_output = output_blob->GetBlobDesc().dims;
-    if (output_blob->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        NaiveFC((float *)input_data, (float *)output_data, (float *)weight_data, (float *)bias_data, dims_input,
-                dims_output);
-    } else if (output_blob->GetBlobDesc().data_type == DATA_TYPE_INT8) {
-        NaiveFC(input_data, output_data, weight_data, buffer_scale_.force_to<float *>(),
-                reinterpret_cast<BlobInt8 *>(inputs[0])->GetIntResource()->scale_handle.GetDataCount(), bias_data,
-                dims_input, dims_output);
-    } else if (output_blob->GetBlobDesc().data_type == DATA_TYPE_BFP16) {
-        RawBuffer weight_bf16 = RawBuffer(resource->weight_handle.GetDataCount() * sizeof(bfp16_t));
-        ConvertFromFloatToBFP16((float *)weight_data, weight_bf16.force_to<void *>(),
-                                resource->weight_handle.GetDataCount());
-        NaiveFC((bfp16_t *)input_data, (bfp16_t *)output_data, weight_bf16.force_to<bfp16_t *>(), (float *)bias_data,
-                dims_input, dims_output);
+    int batch              = output_blob->GetBlobDesc().dims[0];
+    int output_channel     = output_blob->GetBlobDesc().dims[1];
+    int input_size         = DimsVectorUtils::Count(input_blob->GetBlobDesc().dims, 1);
+    size_t workspace_count = CPU_INNER_PRODUCT_WORKSPACE_COUNT(batch, input_size);
+
+    auto data_type = output_blob->GetBlobDesc().data_type;
+    if (data_type == DATA_TYPE_FLOAT || data_type == DATA_TYPE_BFP16) {
+        float *workspace = static_cast<float *>(context_->GetSharedWorkSpace(workspace_count * sizeof(float)));
+        if (data_type == DATA_TYPE_FLOAT) {
+            CPU_INNER_PRODUCT<float, float, float, float>(input_data, output_data, packed_weights_.force_to<float *>(),
+                                                          bias_data, batch, output_channel, input_size, nullptr, 0,
+                                                          workspace);
+        } else {
+            CPU_INNER_PRODUCT<bfp16_t, float, float, bfp16_t>(input_data, output_data,
+                                                              packed_weights_.force_to<float *>(), bias_data, batch,
+                                                              output_channel, input_size, nullptr, 0, workspace);
+        }
+    } else if (data_type == DATA_TYPE_INT8) {
+        // the scale buffer holds one rescale per output channel
+        int8_t *workspace = static_cast<int8_t *>(context_->GetSharedWorkSpace(workspace_count * sizeof(int8_t)));
+        CPU_INNER_PRODUCT<int8_t, int8_t, int32_t, int8_t>(input_data, output_data,
+                                                           packed_weights_.force_to<int8_t *>(), bias_data, batch,
+                                                           output_channel, input_size,
+                                                           buffer_scale_.force_to<float *>(), output_channel,
+                                                           workspace);
     } else {
         return Status(TNNERR_MODEL_ERR, "blob type is unsupported");
     }
@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/cpu/acc/cpu_layer_acc.h"
+#include "tnn/utils/layer_cost_utils.h"
 
 namespace TNN_NS {
 
@@ -22,11 +23,42 @@ Status CpuLayerAcc::Init(Context *context, LayerParam *param, LayerResource *res
                          const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     AbstractLayerAcc::Init(context, param, resource, inputs, outputs);
 
-    param_    = param;
-    resource_ = resource;
+    context_      = dynamic_cast<CpuContext *>(context);
+    param_        = param;
+    resource_     = resource;
+    input_blobs_  = inputs;
+    output_blobs_ = outputs;
     return Reshape(inputs, outputs);
 }
 
+static std::vector<DimsVector> GetBlobsDims(const std::vector<Blob *> &blobs) {
+    std::vector<DimsVector> dims;
+    for (auto blob : blobs) {
+        dims.push_back(blob->GetBlobDesc().dims);
+    }
+    return dims;
+}
+
+double CpuLayerAcc::GetFlops() {
+    if (!param_) {
+        return 0;
+    }
+    return GetLayerFlops(GlobalConvertLayerType(param_->type), param_, resource_, GetBlobsDims(input_blobs_),
+                         GetBlobsDims(output_blobs_));
+}
+
+double CpuLayerAcc::GetBandwidth() {
+    if (!param_ || input_blobs_.empty()) {
+        return 0;
+    }
+    double weight_bytes = GetPackedWeightBytes();
+    if (weight_bytes == 0) {
+        weight_bytes = GetLayerRuntimeResourceBytes(resource_);
+    }
+    return GetLayerBandwidth(GlobalConvertLayerType(param_->type), param_, GetBlobsDims(input_blobs_),
+                             GetBlobsDims(output_blobs_), input_blobs_[0]->GetBlobDesc().data_type, weight_bytes);
+}
+
 std::vector<DataFormat> CpuLayerAcc::SupportDataFormat(DataType data_type, int dims_size) {
     std::vector<DataFormat> support_list;
     if (dims_size == 4) {
@@ -20,6 +20,7 @@
 #include "tnn/core/abstract_layer_acc.h"
 #include "tnn/device/cpu/acc/compute/compute_elewise.h"
 #include "tnn/device/cpu/acc/compute/compute_int8.h"
+#include "tnn/device/cpu/cpu_context.h"
 #include "tnn/device/cpu/cpu_device.h"
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/bfp16_utils.h"
@@ -39,9 +40,17 @@ public:
 
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) = 0;
 
+    virtual double GetFlops();
+
+    virtual double GetBandwidth();
+
 protected:
     LayerParam *param_       = nullptr;
     LayerResource *resource_ = nullptr;
+    CpuContext *context_     = nullptr;
+
+    std::vector<Blob *> input_blobs_;
+    std::vector<Blob *> output_blobs_;
 
 private:
     // @brief return device layer acc support data format
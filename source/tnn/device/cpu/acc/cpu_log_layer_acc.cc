@@ -22,6 +22,9 @@ typedef struct log_operator : unary_operator {
     virtual float operator()(float in) {
         return log(in);
     }
+    virtual void Compute(const float *in, float *out, int count) {
+        CPU_LOG(in, out, count);
+    }
 } LOG_OP;
 
 DECLARE_UNARY_ACC(Log, LAYER_LOG, LOG_OP);
@@ -22,6 +22,24 @@ typedef struct log_sigmoid_operator : unary_operator {
     virtual float operator()(float in) {
         return log(1.0f / (1.0f + exp(-in)));
     }
+    // min(x, 0) - log(1 + e^-|x|) does not overflow for large -x
+    virtual void Compute(const float *in, float *out, int count) {
+        float temp[kUnaryTempSize];
+        for (int start = 0; start < count; start += kUnaryTempSize) {
+            int len = std::min(kUnaryTempSize, count - start);
+            for (int i = 0; i < len; i++) {
+                temp[i] = -std::fabs(in[start + i]);
+            }
+            CPU_EXP(temp, temp, len);
+            for (int i = 0; i < len; i++) {
+                temp[i] += 1.0f;
+            }
+            CPU_LOG(temp, temp, len);
+            for (int i = 0; i < len; i++) {
+                out[start + i] = std::min(in[start + i], 0.0f) - temp[i];
+            }
+        }
+    }
 } LOG_SIGMOID_OP;
 
 DECLARE_UNARY_ACC(LogSigmoid, LAYER_LOGSIGMOID, LOG_SIGMOID_OP);
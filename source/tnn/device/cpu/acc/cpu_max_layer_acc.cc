@@ -21,7 +21,7 @@ DECLARE_CPU_BINARY_OP_ACC(Max, LAYER_MAXIMUM);
 Status CpuMaxLayerAcc::Calculate(const std::vector<Blob *> &input_blobs, const std::vector<void *> &input_ptrs,
                                  const std::vector<DimsVector> &input_shapes, Blob *output) {
     if (output->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        CPU_MAX(input_ptrs, input_shapes, output->GetHandle().base, output->GetBlobDesc().dims);
+        CPU_MAX(input_ptrs, broadcast_plans_, output->GetHandle().base, output->GetBlobDesc().dims);
     } else {
         LOGE("Error: CpuMaxLayerAcc don't support data type: %d\n", output->GetBlobDesc().data_type);
         return Status(TNNERR_MODEL_ERR, "Error: CpuMaxLayerAcc don't support data type");
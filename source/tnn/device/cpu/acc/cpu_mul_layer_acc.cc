@@ -22,7 +22,7 @@ DECLARE_CPU_BINARY_OP_ACC(Mul, LAYER_SUB);
 Status CpuMulLayerAcc::Calculate(const std::vector<Blob *> &input_blobs, const std::vector<void *> &input_ptrs,
                                  const std::vector<DimsVector> &input_shapes, Blob *output) {
     if (output->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        CPU_MUL(input_ptrs, input_shapes, output->GetHandle().base, output->GetBlobDesc().dims);
+        CPU_MUL(input_ptrs, broadcast_plans_, output->GetHandle().base, output->GetBlobDesc().dims);
     } else if (output->GetBlobDesc().data_type == DATA_TYPE_INT8) {
         LOGE("Error: CpuMulLayerAcc don't support data type: %d\n", output->GetBlobDesc().data_type);
         return Status(TNNERR_MODEL_ERR, "Error: CpuMulLayerAcc don't support data type");
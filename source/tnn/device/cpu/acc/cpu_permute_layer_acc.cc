@@ -13,7 +13,8 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/cpu/acc/cpu_permute_layer_acc.h"
-#include "tnn/utils/naive_compute.h"
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/permute_utils.h"
 
 namespace TNN_NS {
 
@@ -39,40 +40,18 @@ Status CpuPermuteLayerAcc::Forward(const std::vector<Blob *> &inputs, const std:
     }
     Blob *input_blob       = inputs[0];
     Blob *output_blob      = outputs[0];
+    // the output is a view of the input, see BlobManager::IsViewLayer
+    if (input_blob->GetHandle().base == output_blob->GetHandle().base) {
+        return TNN_OK;
+    }
     DataType data_type     = output_blob->GetBlobDesc().data_type;
     DimsVector input_dims  = input_blob->GetBlobDesc().dims;
-    DimsVector output_dims = output_blob->GetBlobDesc().dims;
-    int n, c, h, w;
-    if (input_blob->GetBlobDesc().data_format == DATA_FORMAT_NCHW) {
-        n = input_dims[0];
-        c = input_dims[1];
-        h = input_dims[2];
-        w = input_dims[3];
-    } else {
+    if (input_blob->GetBlobDesc().data_format != DATA_FORMAT_NCHW) {
         return Status(TNNERR_MODEL_ERR, "Error: TNN only suport [n, c, h, w]");
     }
-    const int output_count = n * c * h * w;
-
-    std::vector<int> input_step;
-    std::vector<int> output_step;
-    int num_dims = int(input_blob->GetBlobDesc().dims.size());
-    ASSERT(input_dims.size() == output_dims.size());
-    for (int i = 0; i < input_dims.size(); ++i) {
-        input_step.push_back(CpuPermuteLayerAcc::count(input_dims, i + 1));
-        output_step.push_back(CpuPermuteLayerAcc::count(output_dims, i + 1));
-    }
 
-    if (data_type != DATA_TYPE_INT8) {
-        float *input_data  = static_cast<float *>(input_blob->GetHandle().base);
-        float *output_data = static_cast<float *>(output_blob->GetHandle().base);
-        NaivePermute<float>(output_count, input_data, param->orders, input_step, output_step, num_dims, output_data);
-    } else {
-        // DATA_TYPE_INT8
-        int8_t *input_data  = static_cast<int8_t *>(input_blob->GetHandle().base);
-        int8_t *output_data = static_cast<int8_t *>(output_blob->GetHandle().base);
-        NaivePermute<int8_t>(output_count, input_data, param->orders, input_step, output_step, num_dims, output_data);
-    }
-    return TNN_OK;
+    return PermuteUtils::Permute(input_blob->GetHandle().base, output_blob->GetHandle().base, input_dims,
+                                 param->orders, DataTypeUtils::GetBytesSize(data_type));
 }
 
 CpuTypeLayerAccRegister<TypeLayerAccCreator<CpuPermuteLayerAcc>> g_cpu_permute_layer_acc_register(LAYER_PERMUTE);
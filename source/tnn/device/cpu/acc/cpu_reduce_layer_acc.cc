@@ -13,58 +13,48 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/device/cpu/acc/cpu_reduce_layer_acc.h"
-#include "tnn/utils/naive_compute.h"
 #include "tnn/utils/data_type_utils.h"
-#include "tnn/utils/dims_vector_utils.h"
 
 namespace TNN_NS {
 
 CpuReduceLayerAcc::~CpuReduceLayerAcc() {}
 
 Status CpuReduceLayerAcc::Reshape(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
-    return TNN_OK;
-}
-
-Status CpuReduceLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
-    if (inputs.size() < 1) {
-        LOGE("Error: invalid inputs count\n");
-        return Status(TNNERR_LAYER_ERR, "layer's inputs size must >= 2");
-    }
     auto layer_param = dynamic_cast<ReduceLayerParam *>(param_);
-    if (!layer_param || layer_param->axis.size() != 1) {
+    if (!layer_param) {
         LOGE("Error: layer param is invalid\n");
         return Status(TNNERR_MODEL_ERR, "Error: layer param is invalid");
     }
 
-    Blob *input_blob  = inputs[0];
-    Blob *output_blob = outputs[0];
-    auto input_dims   = input_blob->GetBlobDesc().dims;
-
-    int axis = layer_param->axis[0];
-    axis     = axis >= 0 ? axis : axis + (int)input_dims.size();
-    if (axis < 0 || axis >= input_dims.size()) {
-        LOGE("Error: layer param axis is invalid\n");
-        return Status(TNNERR_MODEL_ERR, "Error: layer param axis is invalid");
+    auto input_dims = inputs[0]->GetBlobDesc().dims;
+    std::vector<int> axes;
+    if (layer_param->all_reduce) {
+        for (int d = 0; d < (int)input_dims.size(); d++) {
+            axes.push_back(d);
+        }
+    } else {
+        for (int axis : layer_param->axis) {
+            axis = axis >= 0 ? axis : axis + (int)input_dims.size();
+            if (axis < 0 || axis >= input_dims.size()) {
+                LOGE("Error: layer param axis is invalid\n");
+                return Status(TNNERR_MODEL_ERR, "Error: layer param axis is invalid");
+            }
+            axes.push_back(axis);
+        }
     }
 
-    int channels  = input_dims[axis];
-    int outer_dim = DimsVectorUtils::Count(input_dims, 0, axis);
-    int inner_dim = DimsVectorUtils::Count(input_dims, axis + 1);
-    if (inner_dim == 0) {
-        inner_dim = 1;
-    }
+    plan_ = CPU_REDUCE_PLAN(input_dims, axes);
+    return TNN_OK;
+}
+
+Status CpuReduceLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
+    Blob *input_blob  = inputs[0];
+    Blob *output_blob = outputs[0];
 
     if (output_blob->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
         float *input_data  = static_cast<float *>(input_blob->GetHandle().base);
         float *output_data = static_cast<float *>(output_blob->GetHandle().base);
-
-        int output_size = DimsVectorUtils::Count(output_blob->GetBlobDesc().dims);
-        memset(output_data, 0, outer_dim * inner_dim * sizeof(float));
-
-        CalculateReduce(output_data, input_data, outer_dim, channels, inner_dim);
-    } else if (output_blob->GetBlobDesc().data_type == DATA_TYPE_INT8) {
-        LOGE("Error: layer acc dont support datatype: %d\n", output_blob->GetBlobDesc().data_type);
-        return Status(TNNERR_MODEL_ERR, "Error: layer acc dont support datatype");
+        CPU_REDUCE(type_, input_data, output_data, plan_);
     } else {
         LOGE("Error: layer acc dont support datatype: %d\n", output_blob->GetBlobDesc().data_type);
         return Status(TNNERR_MODEL_ERR, "Error: layer acc dont support datatype");
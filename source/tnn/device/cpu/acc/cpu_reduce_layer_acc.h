@@ -17,6 +17,7 @@
 
 #include <vector>
 
+#include "tnn/device/cpu/acc/compute/compute_reduce.h"
 #include "tnn/device/cpu/acc/cpu_layer_acc.h"
 #include "tnn/device/cpu/cpu_device.h"
 #include "tnn/utils/bfp16.h"
@@ -27,6 +28,8 @@ namespace TNN_NS {
 // @brief reduce layer acc
 class CpuReduceLayerAcc : public CpuLayerAcc {
 public:
+    explicit CpuReduceLayerAcc(CpuReduceType type) : type_(type) {}
+
     // @brief virtual destrcutor
     virtual ~CpuReduceLayerAcc();
 
@@ -35,18 +38,16 @@ public:
     virtual Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs);
 
 private:
-    virtual Status CalculateReduce(float *output_data, float *input_data, int outer_dim, int channels,
-                                   int inner_dim) = 0;
+    CpuReduceType type_;
+    // the reduced axes of the current input shape
+    CpuReducePlan plan_;
 };
 
-#define DECLARE_CPU_REDUCE_ACC(type_string, layer_type)                                                                \
+#define DECLARE_CPU_REDUCE_ACC(type_string, reduce_type)                                                               \
     class Cpu##type_string##LayerAcc : public CpuReduceLayerAcc {                                                      \
     public:                                                                                                            \
+        Cpu##type_string##LayerAcc() : CpuReduceLayerAcc(reduce_type) {}                                               \
         virtual ~Cpu##type_string##LayerAcc(){};                                                                       \
-                                                                                                                       \
-    private:                                                                                                           \
-        virtual Status CalculateReduce(float *output_data, float *input_data, int outer_dim, int channels,             \
-                                       int inner_dim);                                                                 \
     }
 
 #define REGISTER_CPU_REDUCE_ACC(type_string, layer_type)                                                               \
@@ -37,5 +37,6 @@ Status CpuReshapeLayerAcc::Forward(const std::vector<Blob *> &inputs, const std:
 }
 
 REGISTER_CPU_ACC(Reshape, LAYER_RESHAPE);
+REGISTER_CPU_ACC(Reshape, LAYER_FLATTEN);
 
 }  // namespace TNN_NS
@@ -41,6 +41,21 @@ public:
         return temp;
     }
 
+    virtual void Compute(const float *in, float *out, int count) {
+        float temp[kUnaryTempSize];
+        for (int start = 0; start < count; start += kUnaryTempSize) {
+            int len = std::min(kUnaryTempSize, count - start);
+            for (int i = 0; i < len; i++) {
+                temp[i] = std::min(in[start + i], 0.0f);
+            }
+            CPU_EXP(temp, temp, len);
+            for (int i = 0; i < len; i++) {
+                float value    = in[start + i];
+                out[start + i] = value <= 0 ? gamma_ * (alpha_ * temp[i] - alpha_) : gamma_ * value;
+            }
+        }
+    }
+
 private:
     float alpha_ = 0.f, gamma_ = 0.f;
 } SELU_OP;
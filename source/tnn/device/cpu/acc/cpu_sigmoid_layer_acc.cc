@@ -22,6 +22,9 @@ typedef struct sigmoid_operator : unary_operator {
     virtual float operator()(float in) {
         return 1.0f / (1.0f + exp(-in));
     }
+    virtual void Compute(const float *in, float *out, int count) {
+        CPU_SIGMOID(in, out, count);
+    }
 } SIGMOID_OP;
 
 DECLARE_UNARY_ACC(Sigmoid, LAYER_SIGMOID, SIGMOID_OP);
@@ -12,9 +12,7 @@
 // CONDITIONS OF ANY KIND, either express or implied. See the License for the
 // specific language governing permissions and limitations under the License.
 
-#include <algorithm>
-#include <cmath>
-
+#include "tnn/device/cpu/acc/compute/compute_math.h"
 #include "tnn/device/cpu/acc/cpu_layer_acc.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
@@ -45,54 +43,11 @@ Status CpuSoftMaxLayerAcc::Forward(const std::vector<Blob *> &inputs, const std:
     int batch          = DimsVectorUtils::Count(dims, 0, axis);
     int channel        = dims[axis];
     int count          = DimsVectorUtils::Count(dims, axis + 1);
-    ;
-
-    float *const temp = new float[count];
-
-    for (int n = 0; n < batch; n++) {
-        float *const input_batch  = input_data + n * channel * count;
-        float *const output_batch = output_data + n * channel * count;
-        // max
-        memcpy(temp, input_batch, count * sizeof(float));
-        for (int c = 1; c < channel; c++) {
-            float *input_channel = input_batch + c * count;
-            for (int ele = 0; ele < count; ele++) {
-                temp[ele] = std::max(temp[ele], input_channel[ele]);
-            }
-        }
-
-        // exp
-        for (int c = 0; c < channel; c++) {
-            float *input_channel  = input_batch + c * count;
-            float *output_channel = output_batch + c * count;
 
-            for (int ele = 0; ele < count; ele++) {
-                output_channel[ele] = expf(input_channel[ele] - temp[ele]);
-            }
-        }
-
-        // sum
-        memcpy(temp, output_batch, count * sizeof(float));
-        for (int c = 1; c < channel; c++) {
-            float *output_channel = output_batch + c * count;
-            for (int ele = 0; ele < count; ele++) {
-                temp[ele] += output_channel[ele];
-            }
-        }
-
-        // division
-        for (int ele = 0; ele < count; ele++) {
-            temp[ele] = 1.0f / temp[ele];
-        }
-        for (int c = 0; c < channel; c++) {
-            float *output_channel = output_batch + c * count;
-            for (int ele = 0; ele < count; ele++) {
-                output_channel[ele] *= temp[ele];
-            }
-        }
-    }
+    float *workspace = static_cast<float *>(
+        context_->GetSharedWorkSpace(CPU_SOFTMAX_WORKSPACE_COUNT(channel, count) * sizeof(float)));
+    CPU_SOFTMAX(input_data, output_data, batch, channel, count, workspace);
 
-    delete[] temp;
     return TNN_OK;
 }
 
@@ -26,7 +26,7 @@ DECLARE_CPU_BINARY_OP_ACC(Sub, LAYER_SUB);
 Status CpuSubLayerAcc::Calculate(const std::vector<Blob *> &input_blobs, const std::vector<void *> &input_ptrs,
                                  const std::vector<DimsVector> &input_shapes, Blob *output) {
     if (output->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
-        CPU_SUB(input_ptrs, input_shapes, output->GetHandle().base, output->GetBlobDesc().dims);
+        CPU_SUB(input_ptrs, broadcast_plans_, output->GetHandle().base, output->GetBlobDesc().dims);
     } else if (output->GetBlobDesc().data_type == DATA_TYPE_INT8) {
         std::vector<float *> scale_ptrs;
 
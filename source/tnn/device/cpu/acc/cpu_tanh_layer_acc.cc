@@ -22,6 +22,9 @@ typedef struct tanh_operator : unary_operator {
     virtual float operator()(float in) {
         return tanh(in);
     }
+    virtual void Compute(const float *in, float *out, int count) {
+        CPU_TANH(in, out, count);
+    }
 } TANH_OP;
 
 DECLARE_UNARY_ACC(Tanh, LAYER_TANH, TANH_OP);
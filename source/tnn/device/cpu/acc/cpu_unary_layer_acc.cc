@@ -18,9 +18,13 @@
 #include "tnn/utils/naive_compute.h"
 #include "tnn/utils/data_type_utils.h"
 #include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/omp_utils.h"
 
 namespace TNN_NS {
 
+// elements each thread runs the op on at a time
+static const int kUnaryBlockSize = 4096;
+
 Status CpuUnaryLayerAcc::Init(Context *context, LayerParam *param, LayerResource *resource,
                               const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto ret = CpuLayerAcc::Init(context, param, resource, inputs, outputs);
@@ -55,8 +59,11 @@ Status CpuUnaryLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::v
     if (output_blob->GetBlobDesc().data_type == DATA_TYPE_FLOAT) {
         float *input_data  = static_cast<float *>(input_blob->GetHandle().base);
         float *output_data = static_cast<float *>(output_blob->GetHandle().base);
-        for (int index = 0; index < count; ++index) {
-            output_data[index] = (*op_)(input_data[index]);
+        int blocks         = UP_DIV(count, kUnaryBlockSize);
+        OMP_PARALLEL_FOR_
+        for (int b = 0; b < blocks; b++) {
+            int start = b * kUnaryBlockSize;
+            op_->Compute(input_data + start, output_data + start, std::min(kUnaryBlockSize, count - start));
         }
     } else if (output_blob->GetBlobDesc().data_type == DATA_TYPE_INT8) {
         LOGE("Error: layer acc dont support datatype: %d\n", output_blob->GetBlobDesc().data_type);
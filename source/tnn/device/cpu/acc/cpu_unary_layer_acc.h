@@ -15,12 +15,14 @@
 #ifndef TNN_SOURCE_TNN_DEVICE_CPU_CPU_UNARY_LAYER_ACC_H_
 #define TNN_SOURCE_TNN_DEVICE_CPU_CPU_UNARY_LAYER_ACC_H_
 
+#include <algorithm>
 #include <cmath>
 #include <functional>
 #include <memory>
 #include <vector>
 
 #include "tnn/core/abstract_layer_acc.h"
+#include "tnn/device/cpu/acc/compute/compute_math.h"
 #include "tnn/device/cpu/acc/cpu_layer_acc.h"
 #include "tnn/device/cpu/cpu_device.h"
 #include "tnn/interpreter/layer_param.h"
@@ -29,6 +31,9 @@
 
 namespace TNN_NS {
 
+// elements of the stack buffer the ops composed of several vectorized functions step through
+static const int kUnaryTempSize = 256;
+
 typedef struct unary_operator {
 public:
     virtual Status Init(LayerParam *param = NULL) {
@@ -41,6 +46,12 @@ public:
     virtual bfp16_t operator()(bfp16_t in) {
         return in;
     }
+    // the op on an array, the transcendental ops override it with the vectorized compute_math
+    virtual void Compute(const float *in, float *out, int count) {
+        for (int i = 0; i < count; i++) {
+            out[i] = (*this)(in[i]);
+        }
+    }
 
 protected:
     LayerParam *param_ = NULL;
@@ -36,4 +36,15 @@ Status CpuContext::Synchronize() {
     return TNN_OK;
 }
 
+size_t CpuContext::GetWorkSpaceBytes() {
+    return work_space_.GetBytesSize();
+}
+
+void* CpuContext::GetSharedWorkSpace(size_t size) {
+    if (work_space_.GetBytesSize() < size) {
+        work_space_ = RawBuffer(ROUND_UP(size, 64));
+    }
+    return work_space_.force_to<void*>();
+}
+
 }  // namespace TNN_NS
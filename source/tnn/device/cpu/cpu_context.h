@@ -19,6 +19,7 @@
 #include <vector>
 
 #include "tnn/core/context.h"
+#include "tnn/interpreter/raw_buffer.h"
 
 namespace TNN_NS {
 
@@ -39,6 +40,15 @@ public:
 
     // @brief wait for jobs in the current context to complete
     virtual Status Synchronize() override;
+
+    // @brief bytes of the buffers handed out by GetSharedWorkSpace
+    virtual size_t GetWorkSpaceBytes() override;
+
+    // @brief scratch shared by the layers of the instance, valid until the next call
+    void* GetSharedWorkSpace(size_t size);
+
+private:
+    RawBuffer work_space_;
 };
 
 }  // namespace TNN_NS
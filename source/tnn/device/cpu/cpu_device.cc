@@ -43,13 +43,16 @@ Status CpuDevice::Allocate(void** handle, MatType mat_type, DimsVector dims) {
 
 Status CpuDevice::Allocate(void** handle, BlobMemorySizeInfo& size_info) {
     if (handle) {
-        *handle = malloc(GetBlobMemoryBytesSize(size_info));
+        int bytes_size = GetBlobMemoryBytesSize(size_info);
+        *handle        = malloc(bytes_size);
+        OnAllocate(*handle, bytes_size);
     }
     return TNN_OK;
 }
 
 Status CpuDevice::Free(void* handle) {
     if (handle) {
+        OnFree(handle);
         free(handle);
     }
     return TNN_OK;
@@ -24,7 +24,7 @@ Status MetalReduceLayerAcc::AllocateBufferParam(const std::vector<Blob *> &input
 
     id<MTLDevice> device = [TNNMetalDeviceImpl sharedDevice];
     auto layer_param     = dynamic_cast<ReduceLayerParam *>(param_);
-    if (!layer_param || layer_param->axis.size() != 1) {
+    if (!layer_param || layer_param->axis.size() != 1 || layer_param->all_reduce) {
         LOGE("Error: layer param is invalid\n");
         return Status(TNNERR_MODEL_ERR, "Error: layer param is invalid");
     }
@@ -57,7 +57,7 @@ std::string MetalReduceLayerAcc::KernelName() {
 
 Status MetalReduceLayerAcc::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs) {
     auto layer_param = dynamic_cast<ReduceLayerParam *>(param_);
-    if (!layer_param || layer_param->axis.size() != 1) {
+    if (!layer_param || layer_param->axis.size() != 1 || layer_param->all_reduce) {
         LOGE("Error: layer param is invalid\n");
         return Status(TNNERR_MODEL_ERR, "Error: layer param is invalid");
     }
@@ -18,6 +18,25 @@
 
 using namespace metal;
 
+// add value4 to the exp sums of the running max per lane, the sum of a lane is rescaled when its max grows
+static inline void softmax_accumulate(float4 value4, thread float4 &max4, thread float4 &sum4) {
+    float4 exp4 = exp(-abs(value4 - max4));
+    sum4 = select(sum4 + exp4, sum4 * exp4 + 1.0f, value4 > max4);
+    max4 = max(max4, value4);
+}
+
+// reduce the running max and exp sum of the four lanes
+static inline void softmax_reduce_lanes(thread float4 &max4, thread float4 &sum4) {
+    auto max_01 = max(max4, max4.yzwx);
+    auto max_23 = max(max4.zwxy, max4.wxyz);
+    auto lane_max4 = max(max_01, max_23);
+    sum4 = sum4 * exp(max4 - lane_max4);
+    float4 sum_01 = sum4 + sum4.yzwx;
+    float4 sum_23 = sum4.zwxy + sum4.wxyz;
+    sum4 = sum_01 + sum_23;
+    max4 = lane_max4;
+}
+
 kernel void softmax_axis_2_common(
                                             const device ftype4 *src                [[buffer(0)]],
                                             device ftype4 *dst                      [[buffer(1)]],
@@ -31,35 +50,18 @@ kernel void softmax_axis_2_common(
     auto const src_data = src + index;
     auto const dst_data = dst + index;
     
-    //max
-    auto src_data_ptr = src_data;
-    auto max4 = *src_data_ptr;
-    for (int s = 1; s < params.output_height; s++) {
-        src_data_ptr += params.output_width;
-        max4 = max(max4, *src_data_ptr);
-    }
-    
-    //exp
-    src_data_ptr = src_data;
-    auto dst_data_ptr = dst_data;
-    float4 sum4 = float4(0,0,0,0);
+    //max and exp sum in one pass
+    float4 max4 = float4(-FLT_MAX);
+    float4 sum4 = float4(0);
     for (int s = 0; s < params.output_height; s++) {
-        auto temp = exp(float4(*src_data_ptr - max4));
-        *dst_data_ptr = ftype4(temp);
-        sum4 += temp;
-        
-        src_data_ptr += params.output_width;
-        dst_data_ptr += params.output_width;
+        softmax_accumulate(float4(src_data[s * params.output_width]), max4, sum4);
     }
-    
-    //sum
     sum4 = 1.0f/sum4;
     
-    //division
-    dst_data_ptr = dst_data;
+    //exp and division
     for (int s = 0; s < params.output_height; s++) {
-        *dst_data_ptr = ftype4(float4(*dst_data_ptr)*sum4);
-        dst_data_ptr += params.output_width;
+        int offset = s * params.output_width;
+        dst_data[offset] = ftype4(exp(float4(src_data[offset]) - max4) * sum4);
     }
 }
 
@@ -76,41 +78,19 @@ kernel void softmax_axis_1_common_mode_0(
     auto const src_data = src + index;
     auto const dst_data = dst + index;
     
-    //max
-    auto src_data_ptr = src_data;
-    auto max4 = *src_data_ptr;
-    for (int s = 1; s < params.output_slice; s++) {
-        src_data_ptr += params.output_size;
-        max4 = fmax(max4, *src_data_ptr);
-    }
-    auto max_01 = fmax(max4, max4.yzwx);
-    auto max_23 = fmax(max4.zwxy, max4.wxyz);
-    max4 = fmax(max_01, max_23);
-    
-    //exp
-    src_data_ptr = src_data;
-    auto dst_data_ptr = dst_data;
-    float4 sum4 = float4(0,0,0,0);
+    //max and exp sum in one pass
+    float4 max4 = float4(-FLT_MAX);
+    float4 sum4 = float4(0);
     for (int s = 0; s < params.output_slice; s++) {
-        auto temp = exp(float4(*src_data_ptr - max4));
-        *dst_data_ptr = ftype4(temp);
-        sum4 += temp;
-        
-        src_data_ptr += params.output_size;
-        dst_data_ptr += params.output_size;
+        softmax_accumulate(float4(src_data[s * params.output_size]), max4, sum4);
     }
-    
-    //sum
-    float4 sum_01 = sum4 + sum4.yzwx;
-    float4 sum_23 = sum4.zwxy + sum4.wxyz;
-    sum4 = sum_01 + sum_23;
+    softmax_reduce_lanes(max4, sum4);
     sum4 = 1.0f/sum4;
     
-    //division
-    dst_data_ptr = dst_data;
+    //exp and division
     for (int s = 0; s < params.output_slice; s++) {
-        *dst_data_ptr = ftype4(float4(*dst_data_ptr)*sum4);
-        dst_data_ptr += params.output_size;
+        int offset = s * params.output_size;
+        dst_data[offset] = ftype4(exp(float4(src_data[offset]) - max4) * sum4);
     }
 }
 
@@ -128,67 +108,34 @@ kernel void softmax_axis_1_common(
     auto const dst_data = dst + index;
     
     int low_slice = params.channel_remain > 0 ? params.output_slice-1 : params.output_slice;
-    //max
-    auto src_data_ptr = src_data;
-    auto max4 = *src_data_ptr;
-    for (int s = 1; s < low_slice; s++) {
-        src_data_ptr += params.output_size;
-        max4 = max(max4, *src_data_ptr);
-    }
-    if (params.channel_remain == 1) {
-        auto max4_remain = *(src_data_ptr + params.output_size);
-        max4 = max(max4, max4_remain.xxxx);
-    } else if (params.channel_remain == 2) {
-        auto max4_remain = *(src_data_ptr + params.output_size);
-        max4 = max(max4, max4_remain.xyxy);
-    } else if (params.channel_remain == 3) {
-        auto max4_remain = *(src_data_ptr + params.output_size);
-        max4 = max(max4, max4_remain.xyzx);
-    }
-    auto max_01 = max(max4, max4.yzwx);
-    auto max_23 = max(max4.zwxy, max4.wxyz);
-    max4 = max(max_01, max_23);
-    
-    //exp
-    src_data_ptr = src_data;
-    auto dst_data_ptr = dst_data;
-    float4 sum4 = float4(0,0,0,0);
+    // lanes of the last slice holding channels
+    bool4 remain_lanes = int4(0, 1, 2, 3) < params.channel_remain;
+
+    //max and exp sum in one pass
+    float4 max4 = float4(-FLT_MAX);
+    float4 sum4 = float4(0);
     for (int s = 0; s < low_slice; s++) {
-        auto temp = exp(float4(*src_data_ptr - max4));
-        *dst_data_ptr = ftype4(temp);
-        sum4 += temp;
-        
-        src_data_ptr += params.output_size;
-        dst_data_ptr += params.output_size;
+        softmax_accumulate(float4(src_data[s * params.output_size]), max4, sum4);
     }
-    if (params.channel_remain == 1) {
-        auto temp = exp(float4(*src_data_ptr - max4));
-        temp = float4(temp.x, 0, 0, 0);
-        *dst_data_ptr = ftype4(temp);
-        sum4 += temp;
-    } else if (params.channel_remain == 2) {
-        auto temp = exp(float4(*src_data_ptr - max4));
-        temp = float4(temp.xy, 0, 0);
-        *dst_data_ptr = ftype4(temp);
-        sum4 += temp;
-    } else if (params.channel_remain == 3) {
-        auto temp = exp(float4(*src_data_ptr - max4));
-        temp = float4(temp.xyz, 0);
-        *dst_data_ptr = ftype4(temp);
-        sum4 += temp;
+    if (params.channel_remain > 0) {
+        float4 remain_max4 = max4;
+        float4 remain_sum4 = sum4;
+        softmax_accumulate(float4(src_data[low_slice * params.output_size]), remain_max4, remain_sum4);
+        max4 = select(max4, remain_max4, remain_lanes);
+        sum4 = select(sum4, remain_sum4, remain_lanes);
     }
-    
-    //sum
-    float4 sum_01 = sum4 + sum4.yzwx;
-    float4 sum_23 = sum4.zwxy + sum4.wxyz;
-    sum4 = sum_01 + sum_23;
+    softmax_reduce_lanes(max4, sum4);
     sum4 = 1.0f/sum4;
     
-    //division
-    dst_data_ptr = dst_data;
-    for (int s = 0; s < params.output_slice; s++) {
-        *dst_data_ptr = ftype4(float4(*dst_data_ptr)*sum4);
-        dst_data_ptr += params.output_size;
+    //exp and division
+    for (int s = 0; s < low_slice; s++) {
+        int offset = s * params.output_size;
+        dst_data[offset] = ftype4(exp(float4(src_data[offset]) - max4) * sum4);
+    }
+    if (params.channel_remain > 0) {
+        int offset = low_slice * params.output_size;
+        float4 temp = exp(float4(src_data[offset]) - max4) * sum4;
+        dst_data[offset] = ftype4(select(float4(0), temp, remain_lanes));
     }
 }
 
@@ -28,6 +28,10 @@ Status OpenCLReduceLayerAcc::Init(Context *context, LayerParam *param, LayerReso
         LOGE("Error: layer param is null\n");
         return Status(TNNERR_MODEL_ERR, "Error: layer param is null");
     }
+    if (reduce_param->axis.size() != 1 || reduce_param->all_reduce) {
+        LOGE("Error: opencl reduce supports a single axis\n");
+        return Status(TNNERR_LAYER_ERR, "Error: opencl reduce supports a single axis");
+    }
 
     auto input_dims  = inputs[0]->GetBlobDesc().dims;
     int axis = reduce_param->axis[0];
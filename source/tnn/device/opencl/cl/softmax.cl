@@ -6,15 +6,14 @@ __kernel void SoftmaxHeight(__read_only image2d_t input, __write_only image2d_t
     int wc = get_global_id(0);
     int b = get_global_id(1);
     if (wc < shape.y*shape.w && b < shape.x) {
-        /*Compute Max */
+        /*Compute Max and Exp Sum in one pass, the sum is rescaled when the max grows */
         FLOAT4 maxValue = RI_F(input, SAMPLER, (int2)(wc, b*shape.z));
+        FLOAT4 sumValue = (FLOAT4)1;
         for (int i=1; i<shape.z; ++i) {
-            maxValue = fmax(maxValue, RI_F(input, SAMPLER, (int2)(wc, b*shape.z+i)));
-        }
-        /*Compute Exp Sum*/
-        FLOAT4 sumValue = (FLOAT4)0;
-        for (int i=0; i<shape.z; ++i) {
-            sumValue += exp(RI_F(input, SAMPLER, (int2)(wc, b*shape.z+i)) - maxValue);
+            FLOAT4 value = RI_F(input, SAMPLER, (int2)(wc, b*shape.z+i));
+            FLOAT4 expValue = exp(-fabs(value - maxValue));
+            sumValue = select(sumValue + expValue, sumValue * expValue + (FLOAT4)1, value > maxValue);
+            maxValue = fmax(maxValue, value);
         }
         /*Compute Result */
         for (int i=0; i<shape.z; ++i) {
@@ -24,6 +23,13 @@ __kernel void SoftmaxHeight(__read_only image2d_t input, __write_only image2d_t
     }
 }
 
+// add value to the exp sum of the running max, the sum is rescaled when the max grows
+inline void SoftmaxAccumulate(FLOAT value, FLOAT *max_value, FLOAT *sum) {
+    FLOAT exp_value = exp(-fabs(value - *max_value));
+    *sum            = value > *max_value ? *sum * exp_value + (FLOAT)1 : *sum + exp_value;
+    *max_value      = fmax(*max_value, value);
+}
+
 __kernel void SoftmaxChannel(GLOBAL_SIZE_3_DIMS __read_only image2d_t input, __write_only image2d_t output, __private const int output_channels,
                               __private const int remain_channels) {
 
@@ -36,58 +42,26 @@ __kernel void SoftmaxChannel(GLOBAL_SIZE_3_DIMS __read_only image2d_t input, __w
     // const int width     = global_size_dim1;
 
     FLOAT float_max_value = -FLT_MAX;
+    FLOAT accum_result    = 0;
     FLOAT4 input_data;
     for (short i = 0; i < global_size_dim0 - 1; ++i) {
-        input_data      = RI_F(input, SAMPLER, (int2)(width_idx + i * global_size_dim1, batch_height_idx));
-        float_max_value = max(float_max_value, input_data.x);
-        float_max_value = max(float_max_value, input_data.y);
-        float_max_value = max(float_max_value, input_data.z);
-        float_max_value = max(float_max_value, input_data.w);
+        input_data = RI_F(input, SAMPLER, (int2)(width_idx + i * global_size_dim1, batch_height_idx));
+        SoftmaxAccumulate(input_data.x, &float_max_value, &accum_result);
+        SoftmaxAccumulate(input_data.y, &float_max_value, &accum_result);
+        SoftmaxAccumulate(input_data.z, &float_max_value, &accum_result);
+        SoftmaxAccumulate(input_data.w, &float_max_value, &accum_result);
     }
 
     input_data = RI_F(input, SAMPLER, (int2)(width_idx + (global_size_dim0 - 1) * global_size_dim1 , batch_height_idx));
-    if (remain_channels == 0) {
-        float_max_value = max(float_max_value, input_data.w);
-        float_max_value = max(float_max_value, input_data.z);
-        float_max_value = max(float_max_value, input_data.y);
-        float_max_value = max(float_max_value, input_data.x);
-    } else if (remain_channels == 1) {
-        float_max_value = max(float_max_value, input_data.z);
-        float_max_value = max(float_max_value, input_data.y);
-        float_max_value = max(float_max_value, input_data.x);
-    } else if (remain_channels == 2) {
-        float_max_value = max(float_max_value, input_data.y);
-        float_max_value = max(float_max_value, input_data.x);
-    } else if (remain_channels == 3) {
-        float_max_value = max(float_max_value, input_data.x);
+    SoftmaxAccumulate(input_data.x, &float_max_value, &accum_result);
+    if (remain_channels < 3) {
+        SoftmaxAccumulate(input_data.y, &float_max_value, &accum_result);
     }
-
-    FLOAT accum_result       = 0;
-    for (short i = 0; i < global_size_dim0 - 1; ++i) {
-        input_data = RI_F(input, SAMPLER, (int2)(width_idx + i * global_size_dim1, batch_height_idx));
-        input_data = exp(input_data - float_max_value);
-        accum_result += input_data.x;
-        accum_result += input_data.y;
-        accum_result += input_data.z;
-        accum_result += input_data.w;
+    if (remain_channels < 2) {
+        SoftmaxAccumulate(input_data.z, &float_max_value, &accum_result);
     }
-
-    input_data = RI_F(input, SAMPLER, (int2)(width_idx + (global_size_dim0 - 1) * global_size_dim1, batch_height_idx));
-    input_data -= float_max_value;
-    if (remain_channels == 0) {
-        accum_result += exp(input_data.w);
-        accum_result += exp(input_data.z);
-        accum_result += exp(input_data.y);
-        accum_result += exp(input_data.x);
-    } else if (remain_channels == 1) {
-        accum_result += exp(input_data.z);
-        accum_result += exp(input_data.y);
-        accum_result += exp(input_data.x);
-    } else if (remain_channels == 2) {
-        accum_result += exp(input_data.y);
-        accum_result += exp(input_data.x);
-    } else if (remain_channels == 3) {
-        accum_result += exp(input_data.x);
+    if (remain_channels < 1) {
+        SoftmaxAccumulate(input_data.w, &float_max_value, &accum_result);
     }
 
     int cur_out_width_pos  = mad24(channel_block_idx, global_size_dim1, width_idx);
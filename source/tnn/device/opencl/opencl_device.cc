@@ -56,8 +56,11 @@ Status OpenCLDevice::Allocate(void** handle, BlobMemorySizeInfo& desc) {
     ASSERT(desc.dims.size() == 2);
     cl_mem_flags mem_flag     = CL_MEM_READ_WRITE;
     cl_channel_type data_type = CL_FLOAT;
-    if (opencl_runtime->GetFp16Enable())
-        data_type = CL_HALF_FLOAT;
+    int element_bytes         = 4;
+    if (opencl_runtime->GetFp16Enable()) {
+        data_type     = CL_HALF_FLOAT;
+        element_bytes = 2;
+    }
     int w = desc.dims[0];
     int h = desc.dims[1];
     cl_int error;
@@ -67,14 +70,18 @@ Status OpenCLDevice::Allocate(void** handle, BlobMemorySizeInfo& desc) {
         CHECK_CL_SUCCESS(error);
         return Status(TNNERR_OPENCL_API_ERROR, "OpenCL Allocate Image falied");
     }
+    // rgba texels
+    OnAllocate(*handle, (size_t)w * h * 4 * element_bytes);
     return TNN_OK;
 }
 
 //release clImage
 Status OpenCLDevice::Free(void* handle) {
     cl::Image2D* buffer = static_cast<cl::Image2D*>(handle);
-    if (buffer != NULL)
+    if (buffer != NULL) {
+        OnFree(handle);
         delete buffer;
+    }
     return TNN_OK;
 }
 
@@ -17,8 +17,10 @@
 namespace TNN_NS {
 
 DefaultModelInterpreter::DefaultModelInterpreter() {
-    net_structure_ = new NetStructure();
-    net_resource_  = new NetResource();
+    net_structure_    = new NetStructure();
+    net_resource_     = new NetResource();
+    optimized_        = false;
+    optimized_device_ = DEVICE_NAIVE;
 }
 
 DefaultModelInterpreter::~DefaultModelInterpreter() {
@@ -34,4 +36,40 @@ NetResource *DefaultModelInterpreter::GetNetResource() {
     return net_resource_;
 }
 
+bool DefaultModelInterpreter::IsOptimized(DeviceType device) {
+    return optimized_ && optimized_device_ == device;
+}
+
+void DefaultModelInterpreter::SetOptimized(DeviceType device) {
+    optimized_        = true;
+    optimized_device_ = device;
+}
+
+std::vector<StartupPhase> &DefaultModelInterpreter::GetStartupPhases() {
+    return startup_phases_;
+}
+
+// @brief CopiedModelInterpreter holds a network copied from another interpreter
+class CopiedModelInterpreter : public DefaultModelInterpreter {
+public:
+    virtual ~CopiedModelInterpreter() {}
+
+    virtual Status Interpret(std::vector<std::string> params) {
+        return Status(TNNERR_INVALID_MODEL, "copied model interpreter can not interpret model");
+    }
+};
+
+std::shared_ptr<DefaultModelInterpreter> DefaultModelInterpreter::Copy() {
+    auto interpreter = std::make_shared<CopiedModelInterpreter>();
+
+    NetStructure *structure = interpreter->GetNetStructure();
+    *structure              = *net_structure_;
+    for (auto &layer : structure->layers) {
+        layer = std::make_shared<LayerInfo>(*layer);
+    }
+    *interpreter->GetNetResource() = *net_resource_;
+
+    return interpreter;
+}
+
 }  // namespace TNN_NS
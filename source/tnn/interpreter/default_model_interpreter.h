@@ -15,6 +15,10 @@
 #ifndef TNN_SOURCE_TNN_INTERPRETER_DEFAULT_MODEL_INTERPRETER_H_
 #define TNN_SOURCE_TNN_INTERPRETER_DEFAULT_MODEL_INTERPRETER_H_
 
+#include <memory>
+#include <vector>
+
+#include "tnn/core/common.h"
 #include "tnn/core/status.h"
 #include "tnn/interpreter/abstract_model_interpreter.h"
 #include "tnn/interpreter/net_resource.h"
@@ -41,9 +45,27 @@ public:
     //@brief GetNetResource return network weights data
     virtual NetResource *GetNetResource();
 
+    //@brief Copy return an interpreter holding a copy of the network, layers are copied
+    // and resources are shared, so the copy can be optimized without changing this one
+    virtual std::shared_ptr<DefaultModelInterpreter> Copy();
+
+    //@brief IsOptimized return whether the network has been optimized for the device by NetOptimizerManager
+    bool IsOptimized(DeviceType device);
+
+    //@brief SetOptimized mark the network as optimized for the device
+    void SetOptimized(DeviceType device);
+
+    //@brief GetStartupPhases return the time spent to interpret the model, empty for a copy
+    std::vector<StartupPhase> &GetStartupPhases();
+
+protected:
+    std::vector<StartupPhase> startup_phases_;
+
 private:
     NetStructure *net_structure_;
     NetResource *net_resource_;
+    bool optimized_;
+    DeviceType optimized_device_;
 };
 
 }  // namespace TNN_NS
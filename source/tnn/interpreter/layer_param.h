@@ -254,6 +254,44 @@ struct HardSigmoidLayerParam : public LayerParam {
     float beta  = 0.0f;
 };
 
+typedef enum {
+    FusedElementwiseOpAdd         = 0,
+    FusedElementwiseOpSub         = 1,
+    FusedElementwiseOpMul         = 2,
+    FusedElementwiseOpDiv         = 3,
+    FusedElementwiseOpSigmoid     = 4,
+    FusedElementwiseOpExp         = 5,
+    FusedElementwiseOpClip        = 6,
+    FusedElementwiseOpHardSigmoid = 7,
+} FusedElementwiseOpType;
+
+typedef enum {
+    // unary op
+    FusedElementwiseOperandNone = 0,
+    // the input blob of the fused layer
+    FusedElementwiseOperandInput = 1,
+    // constant in FusedElementwiseLayerResource
+    FusedElementwiseOperandConstant = 2,
+} FusedElementwiseOperand;
+
+// @brief one step of the expression program of a fused elementwise layer,
+// it reads the result of the previous step and the operand
+struct FusedElementwiseOp {
+    FusedElementwiseOpType type     = FusedElementwiseOpAdd;
+    FusedElementwiseOperand operand = FusedElementwiseOperandNone;
+    // index of the constant in FusedElementwiseLayerResource
+    int constant_index = -1;
+    // operand is the left hand side of the binary op
+    bool operand_first = false;
+    // min and max for clip, alpha and beta for hard sigmoid
+    float alpha = 0.0f;
+    float beta  = 0.0f;
+};
+
+struct FusedElementwiseLayerParam : public LayerParam {
+    std::vector<FusedElementwiseOp> ops;
+};
+
 typedef enum {
     // only data_type
     QUANT_ONLY   = 0,
@@ -294,6 +332,15 @@ struct PriorBoxLayerParam : public LayerParam {
     float offset = 0.5;
 };
 
+typedef enum {
+    // drop the boxes that overlap a kept box by more than nms_threshold
+    NMSTypeHard = 0,
+    // scale the score of an overlapping box by 1 - iou once the iou is above nms_threshold
+    NMSTypeSoftLinear = 1,
+    // scale the score of an overlapping box by exp(-iou * iou / soft_nms_sigma)
+    NMSTypeSoftGaussian = 2,
+} NMSType;
+
 struct DetectionOutputLayerParam : public LayerParam {
     int num_classes;
     bool share_location;
@@ -308,6 +355,11 @@ struct DetectionOutputLayerParam : public LayerParam {
         int top_k;
     } nms_param;
     float eta;
+
+    // 1 runs one nms over the boxes of all classes instead of one nms per class
+    int class_agnostic   = 0;
+    int nms_type         = NMSTypeHard;
+    float soft_nms_sigma = 0.5f;
 };
 
 struct LRNLayerParam : public LayerParam {
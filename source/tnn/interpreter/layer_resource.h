@@ -62,6 +62,13 @@ struct EltwiseLayerResource : public LayerResource {
     std::vector<int> element_shape;
 };
 
+struct FusedElementwiseLayerResource : public LayerResource {
+    // float constants of the binary ops
+    std::vector<RawBuffer> constant_handles;
+
+    std::vector<DimsVector> constant_shapes;
+};
+
 struct InnerProductLayerResource : public LayerResource {
     // weight buffer
     RawBuffer weight_handle;
@@ -19,6 +19,7 @@
 
 #include "tnn/core/common.h"
 #include "tnn/core/macro.h"
+#include "tnn/core/startup_timer.h"
 #include "tnn/interpreter/ncnn/layer_interpreter/abstract_layer_interpreter.h"
 #include "tnn/interpreter/ncnn/ncnn_layer_type.h"
 #include "tnn/interpreter/ncnn/ncnn_model_interpreter.h"
@@ -35,12 +36,16 @@ namespace ncnn {
         MODEL_TYPE_NCNN);
 
     Status NCNNModelInterpreter::Interpret(std::vector<std::string> params) {
+        StartupTimer timer;
         std::string proto_content = params.size() > 0 ? params[0] : "";
         RETURN_ON_ERROR(InterpretProto(proto_content));
+        timer.Lap("proto_parse", startup_phases_);
         std::string model_content = params.size() > 1 ? params[1] : "";
         RETURN_ON_ERROR(InterpretModel(model_content));
+        timer.Lap("model_deserialize", startup_phases_);
         RETURN_ON_ERROR(NCNNOptimizerManager::Optimize(GetNetStructure(), GetNetResource()));
         RETURN_ON_ERROR(FindOutputs());
+        timer.Lap("ncnn_optimize", startup_phases_);
 
         return TNN_OK;
     }
@@ -20,6 +20,8 @@
 #include <mutex>
 #include <set>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "tnn/core/blob.h"
 #include "tnn/core/common.h"
@@ -41,6 +43,16 @@ struct LayerInfo {
     std::shared_ptr<LayerParam> param = nullptr;
 };
 
+// @brief EliminatedReformat describes a reformat layer removed by optimizer
+struct EliminatedReformat {
+    // input blob of the removed reformat
+    std::string blob;
+    // blob left in the network with the dims of the reformat, the input blob may be removed too
+    std::string dims_blob;
+    // bytes per element the reformat moved
+    int bytes_per_element;
+};
+
 // @brief NetStruture describes network build info
 struct NetStructure {
     InputShapesMap inputs_shape_map;
@@ -48,6 +60,7 @@ struct NetStructure {
     std::vector<std::shared_ptr<LayerInfo>> layers;
     std::set<std::string> blobs;
     ModelType source_model_type = MODEL_TYPE_TNN;
+    std::vector<EliminatedReformat> eliminated_reformats;
 };
 
 std::shared_ptr<LayerInfo> GetLayerInfoFromName(NetStructure* net_struct, std::string name);
@@ -19,6 +19,7 @@
 #include "tnn/utils/bfp16.h"
 #include "tnn/utils/bfp16_utils.h"
 #include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/permute_utils.h"
 
 using namespace TNN_NS;
 
@@ -50,35 +51,22 @@ RawBuffer::RawBuffer(const RawBuffer &buf) {
     this->buff_       = buf.buff_;
 }
 
-template <typename T>
-void permute(void *in, void *out, size_t outter, size_t inner) {
-    T *in_ptr  = static_cast<T *>(in);
-    T *out_ptr = static_cast<T *>(out);
-    for (int i = 0; i < outter; i++) {
-        for (int j = 0; j < inner; j++) {
-            out_ptr[j * outter + i] = in_ptr[i * inner + j];
-        }
+Status RawBuffer::Permute(size_t outter, size_t inner) {
+    int element_size = DataTypeUtils::GetBytesSize(data_type_);
+    if (element_size <= 0) {
+        LOGE("RawBuffer permute does not support data type %d\n", data_type_);
+        return Status(TNNERR_PARAM_ERR, "RawBuffer permute does not support the data type");
     }
-}
 
-void RawBuffer::Permute(size_t outter, size_t inner) {
     RawBuffer tmp(bytes_size_);
-    switch (data_type_) {
-        case DATA_TYPE_FLOAT:
-            permute<float>(buff_.get(), tmp.buff_.get(), outter, inner);
-            break;
-        case DATA_TYPE_HALF:
-            permute<short>(buff_.get(), tmp.buff_.get(), outter, inner);
-            break;
-        case DATA_TYPE_INT8:
-            permute<int8_t>(buff_.get(), tmp.buff_.get(), outter, inner);
-            break;
-        default:
-            break;
+    Status status = PermuteUtils::Transpose(buff_.get(), tmp.buff_.get(), (int)outter, (int)inner, (int)inner,
+                                            (int)outter, element_size);
+    if (status != TNN_OK) {
+        LOGE("RawBuffer permute failed: %s\n", status.description().c_str());
+        return status;
     }
-
     buff_ = tmp.buff_;
-    return;
+    return TNN_OK;
 }
 
 RawBuffer &RawBuffer::operator=(RawBuffer buf) {
@@ -21,6 +21,7 @@
 #include <string>
 #include <typeinfo>
 #include "tnn/core/common.h"
+#include "tnn/core/status.h"
 #include "tnn/interpreter/raw_buffer.h"
 #include "tnn/utils/half_utils.h"
 
@@ -44,7 +45,8 @@ public:
     int GetBytesSize();
     int GetDataCount();
 
-    void Permute(size_t outter, size_t inner);
+    // @brief transpose the [outter][inner] elements to [inner][outter]
+    Status Permute(size_t outter, size_t inner);
 
     template <typename T>
     T force_to() {
@@ -13,6 +13,7 @@
 // specific language governing permissions and limitations under the License.
 
 #include "tnn/interpreter/tnn/layer_interpreter/abstract_layer_interpreter.h"
+#include "tnn/utils/detection_post_processor.h"
 
 #include <stdlib.h>
 
@@ -39,8 +40,11 @@ Status DetectionOutputLayerInterpreter::InterpretProto(str_arr layer_cfg_arr, in
     GET_FLOAT_2(p->confidence_threshold, p->nms_param.nms_threshold);
     GET_INT_1(p->nms_param.top_k);
     GET_FLOAT_1(p->eta);
+    GET_INT_1_OR_DEFAULT(p->class_agnostic, 0);
+    GET_INT_1_OR_DEFAULT(p->nms_type, NMSTypeHard);
+    GET_FLOAT_1_OR_DEFAULT(p->soft_nms_sigma, 0.5f);
 
-    return TNN_OK;
+    return DetectionPostProcessor::CheckParam(p);
 }
 
 Status DetectionOutputLayerInterpreter::InterpretResource(Deserializer &deserializer, LayerResource **Resource) {
@@ -60,6 +64,9 @@ Status DetectionOutputLayerInterpreter::SaveProto(std::ofstream &output_stream,
     output_stream << layer_param->nms_param.nms_threshold << " ";
     output_stream << layer_param->nms_param.top_k << " ";
     output_stream << layer_param->eta << " ";
+    output_stream << layer_param->class_agnostic << " ";
+    output_stream << layer_param->nms_type << " ";
+    output_stream << layer_param->soft_nms_sigma << " ";
 
     return TNN_OK;
 }
@@ -17,6 +17,7 @@
 #include <sstream>
 
 #include "tnn/core/common.h"
+#include "tnn/core/startup_timer.h"
 #include "tnn/interpreter/tnn/layer_interpreter/abstract_layer_interpreter.h"
 #include "tnn/interpreter/tnn/objseri.h"
 
@@ -40,13 +41,16 @@ std::shared_ptr<Deserializer> ModelInterpreter::GetDeserializer(std::istream &is
 
 // Interpret the proto and model.
 Status ModelInterpreter::Interpret(std::vector<std::string> params) {
+    StartupTimer timer;
     auto proto_content = params.size() > 0 ? params[0] : "";
     Status status = InterpretProto(proto_content);
     if (status != TNN_OK) {
         return status;
     }
+    timer.Lap("proto_parse", startup_phases_);
     auto model_content = params.size() > 1 ? params[1] : "";
     status = InterpretModel(model_content);
+    timer.Lap("model_deserialize", startup_phases_);
     return status;
 }
 
@@ -123,6 +123,18 @@ std::vector<Blob*> BaseLayer::GetOutputBlobs() {
     return output_blobs_;
 }
 
+double BaseLayer::GetFlops() {
+    return layer_acc_ ? layer_acc_->GetFlops() : 0;
+}
+
+double BaseLayer::GetBandwidth() {
+    return layer_acc_ ? layer_acc_->GetBandwidth() : 0;
+}
+
+size_t BaseLayer::GetPackedWeightBytes() {
+    return layer_acc_ ? layer_acc_->GetPackedWeightBytes() : 0;
+}
+
 #ifdef BENCHMARK
 Status BaseLayer::InferShapeAhead(std::vector<Blob*>& input_blobs, std::vector<Blob*>& output_blobs, LayerParam* param,
                                   LayerResource* resource) {
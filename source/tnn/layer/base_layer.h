@@ -61,6 +61,15 @@ public:
     //@brief get all output blobs
     virtual std::vector<Blob*> GetOutputBlobs();
 
+    //@brief mega flops of one forward, given by the layer acc
+    double GetFlops();
+
+    //@brief mega bytes moved by one forward, given by the layer acc
+    double GetBandwidth();
+
+    //@brief bytes of the weights packed or converted by the layer acc
+    size_t GetPackedWeightBytes();
+
 #ifdef BENCHMARK
     //@brief infer shape ahead for generate resource
     virtual Status InferShapeAhead(std::vector<Blob*>& input_blobs, std::vector<Blob*>& output_blobs, LayerParam* param,
@@ -0,0 +1,42 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/layer/base_layer.h"
+#include "tnn/utils/fused_elementwise_utils.h"
+
+namespace TNN_NS {
+
+DECLARE_LAYER(FusedElementwise, LAYER_FUSED_ELEMENTWISE);
+
+Status FusedElementwiseLayer::InferOutputDataType() {
+    return BaseLayer::InferOutputDataType();
+}
+
+Status FusedElementwiseLayer::InferOutputShape() {
+    auto layer_param = dynamic_cast<FusedElementwiseLayerParam *>(param_);
+    CHECK_PARAM_NULL(layer_param);
+    auto layer_res = dynamic_cast<FusedElementwiseLayerResource *>(resource_);
+
+    auto dims                            = input_blobs_[0]->GetBlobDesc().dims;
+    output_blobs_[0]->GetBlobDesc().dims = dims;
+
+    // reject constants the fused kernels cannot read at Init, the accs keep their own normalized shapes
+    std::vector<DimsVector> shapes;
+    std::vector<int> types;
+    return FusedElementwiseUtils::GetConstantBroadcast(layer_res, dims, shapes, types);
+}
+
+REGISTER_LAYER(FusedElementwise, LAYER_FUSED_ELEMENTWISE);
+
+}  // namespace TNN_NS
@@ -20,24 +20,34 @@ namespace TNN_NS {
 
 Status ReduceLayer::InferOutputShape() {
     auto layer_param = dynamic_cast<ReduceLayerParam*>(param_);
-    if (!layer_param || layer_param->axis.size() != 1) {
-        LOGE("Error: Reduce may not support axes != 1, depend on device\n");
-        return Status(TNNERR_MODEL_ERR, "Error: Reduce may not support axes != 1, depend on device");
+    if (!layer_param || (layer_param->axis.empty() && !layer_param->all_reduce)) {
+        LOGE("Error: layer param is invalid\n");
+        return Status(TNNERR_MODEL_ERR, "Error: layer param is invalid");
     }
 
     Blob* input_blob  = input_blobs_[0];
     Blob* output_blob = output_blobs_[0];
     auto dims         = input_blob->GetBlobDesc().dims;
 
-    int axis             = layer_param->axis[0];
-    axis                 = axis >= 0 ? axis : axis + (int)dims.size();
-    layer_param->axis[0] = axis;
-    if (axis < 0 || axis >= dims.size()) {
-        LOGE("Error: layer param axis is invalid\n");
-        return Status(TNNERR_MODEL_ERR, "Error: layer param axis is invalid");
+    if (layer_param->all_reduce) {
+        for (auto& dim : dims) {
+            dim = 1;
+        }
+        output_blob->GetBlobDesc().dims = dims;
+        return TNN_OK;
     }
 
-    dims[layer_param->axis[0]]      = 1;
+    // several axes are reduced together, devices that only support one check it in their acc
+    std::vector<bool> reduced(dims.size(), false);
+    for (auto& axis : layer_param->axis) {
+        axis = axis >= 0 ? axis : axis + (int)dims.size();
+        if (axis < 0 || axis >= dims.size() || reduced[axis]) {
+            LOGE("Error: layer param axis is invalid\n");
+            return Status(TNNERR_MODEL_ERR, "Error: layer param axis is invalid");
+        }
+        reduced[axis] = true;
+        dims[axis]    = 1;
+    }
     output_blob->GetBlobDesc().dims = dims;
 
     return TNN_OK;
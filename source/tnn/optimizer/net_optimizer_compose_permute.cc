@@ -0,0 +1,149 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/optimizer/net_optimizer_compose_permute.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "tnn/core/layer_type.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/optimizer/optimizer_const.h"
+
+namespace TNN_NS {
+
+namespace optimizer {
+
+    // P1 priority: compose permutes before other layers are fused with them
+    NetOptimizerRegister<NetOptimizerComposePermute> g_net_optimizer_compose_permute(OptPriority::P1);
+
+    static PermuteLayerParam *GetPermuteParam(std::shared_ptr<LayerInfo> layer) {
+        if (layer->type != LAYER_PERMUTE || layer->inputs.size() != 1 || layer->outputs.size() != 1) {
+            return nullptr;
+        }
+        return dynamic_cast<PermuteLayerParam *>(layer->param.get());
+    }
+
+    static bool IsIdentityOrders(const std::vector<int> &orders) {
+        for (int i = 0; i < orders.size(); i++) {
+            if (orders[i] != i) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // identity permutes are removed, their consumers read the input of the permute instead
+    static void RemoveIdentityPermute(NetStructure *structure) {
+        std::vector<std::shared_ptr<LayerInfo>> layers_kept;
+        std::map<std::string, std::string> rename_map;
+        for (auto layer : structure->layers) {
+            for (auto &name : layer->inputs) {
+                while (rename_map.find(name) != rename_map.end()) {
+                    name = rename_map[name];
+                }
+            }
+
+            auto param = GetPermuteParam(layer);
+            if (param && IsIdentityOrders(param->orders) && structure->outputs.count(layer->outputs[0]) == 0) {
+                rename_map[layer->outputs[0]] = layer->inputs[0];
+                structure->blobs.erase(layer->outputs[0]);
+                continue;
+            }
+            layers_kept.push_back(layer);
+        }
+        structure->layers = layers_kept;
+    }
+
+    // permute(permute(x, first), second) equals permute(x, composed) with composed[i] = first[second[i]]
+    static void ComposePermute(NetStructure *structure) {
+        std::map<std::string, int> consumer_count;
+        for (auto layer : structure->layers) {
+            for (auto name : layer->inputs) {
+                consumer_count[name] += 1;
+            }
+        }
+
+        std::map<std::string, std::shared_ptr<LayerInfo>> producers;
+        std::set<std::shared_ptr<LayerInfo>> composed_layers;
+        for (auto layer : structure->layers) {
+            auto param = GetPermuteParam(layer);
+            if (!param) {
+                continue;
+            }
+
+            auto producer = producers.find(layer->inputs[0]);
+            if (producer != producers.end()) {
+                auto first = GetPermuteParam(producer->second);
+                if (first->orders.size() == param->orders.size()) {
+                    auto composed = std::make_shared<PermuteLayerParam>(*param);
+                    for (int i = 0; i < param->orders.size(); i++) {
+                        composed->orders[i] = first->orders[param->orders[i]];
+                    }
+                    structure->blobs.erase(layer->inputs[0]);
+                    composed_layers.insert(producer->second);
+                    layer->inputs = producer->second->inputs;
+                    layer->param  = composed;
+                    param         = composed.get();
+                    LOGD("Compose permute %s into %s\n", producer->second->name.c_str(), layer->name.c_str());
+                }
+            }
+
+            auto output = layer->outputs[0];
+            if (consumer_count[output] == 1 && structure->outputs.count(output) == 0) {
+                producers[output] = layer;
+            }
+        }
+
+        std::vector<std::shared_ptr<LayerInfo>> layers_kept;
+        for (auto layer : structure->layers) {
+            if (composed_layers.count(layer) == 0) {
+                layers_kept.push_back(layer);
+            }
+        }
+        structure->layers = layers_kept;
+    }
+
+    std::string NetOptimizerComposePermute::Strategy() {
+        return kNetOptimizerComposePermute;
+    }
+
+    bool NetOptimizerComposePermute::SupportDevice(DeviceType device) {
+        return true;
+    }
+
+    Status NetOptimizerComposePermute::Optimize(NetStructure *structure, NetResource *resource) {
+        if (!structure) {
+            LOGE("Error: empty NetStructure\n");
+            return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
+        }
+
+        if (structure->layers.size() <= 1) {
+            return TNN_OK;
+        }
+
+        RemoveIdentityPermute(structure);
+        ComposePermute(structure);
+        // composed permutes may cancel each other out
+        RemoveIdentityPermute(structure);
+
+        return TNN_OK;
+    }
+
+}  // namespace optimizer
+
+}  // namespace TNN_NS
@@ -0,0 +1,274 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/optimizer/net_optimizer_eliminate_reformat.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <typeinfo>
+#include <vector>
+
+#include "tnn/core/layer_type.h"
+#include "tnn/core/macro.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/optimizer/optimizer_const.h"
+
+namespace TNN_NS {
+
+namespace optimizer {
+
+    // PPOST priority: must run after reformat layers are inserted
+    NetOptimizerRegister<NetOptimizerEliminateReformat> g_net_optimizer_eliminate_reformat(OptPriority::PPOST);
+
+    static const std::string blob_scale_suffix = "_scale_data_";
+
+    // int8 kernels of these layers write the output with the scale of the input,
+    // so the layer can run in the int8 or in the float domain
+    static std::set<LayerType> kScalePreservingLayers = {LAYER_RELU, LAYER_POOLING};
+
+    typedef std::map<std::string, std::vector<std::shared_ptr<LayerInfo>>> BlobConsumerMap;
+    typedef std::map<std::string, std::shared_ptr<LayerInfo>> BlobProducerMap;
+
+    static int DataBytes(DataType data_type) {
+        return data_type == DATA_TYPE_INT8 ? 1 : 4;
+    }
+
+    // memory traffic in bytes per element saved by removing the reformat: read src and write dst
+    static int SavedBytes(ReformatLayerParam *param) {
+        return DataBytes(param->src_type) + DataBytes(param->dst_type);
+    }
+
+    // the param may be shared with the unoptimized network, change a copy of it.
+    // LayerParam has no virtual copy, only the exact param types of kScalePreservingLayers are copied,
+    // nullptr for anything else so that derived fields are never sliced off.
+    static std::shared_ptr<LayerParam> CopyParam(std::shared_ptr<LayerInfo> layer) {
+        auto param = layer->param.get();
+        if (!param) {
+            return nullptr;
+        }
+        if (typeid(*param) == typeid(PoolingLayerParam)) {
+            return std::make_shared<PoolingLayerParam>(*dynamic_cast<PoolingLayerParam *>(param));
+        }
+        if (typeid(*param) == typeid(LayerParam)) {
+            return std::make_shared<LayerParam>(*param);
+        }
+        return nullptr;
+    }
+
+    static ReformatLayerParam *GetReformatParam(std::shared_ptr<LayerInfo> layer) {
+        if (!layer || layer->type != LAYER_REFORMAT || layer->inputs.size() != 1 || layer->outputs.size() != 1) {
+            return nullptr;
+        }
+        return dynamic_cast<ReformatLayerParam *>(layer->param.get());
+    }
+
+    static void BuildBlobMap(NetStructure *structure, BlobProducerMap &producers, BlobConsumerMap &consumers) {
+        producers.clear();
+        consumers.clear();
+        for (auto layer : structure->layers) {
+            for (auto name : layer->outputs) {
+                producers[name] = layer;
+            }
+            for (auto name : layer->inputs) {
+                consumers[name].push_back(layer);
+            }
+        }
+    }
+
+    static void RemoveLayers(NetStructure *structure, std::set<std::shared_ptr<LayerInfo>> removed) {
+        auto &layers = structure->layers;
+        layers.erase(std::remove_if(layers.begin(), layers.end(),
+                                    [&](std::shared_ptr<LayerInfo> layer) { return removed.count(layer) > 0; }),
+                     layers.end());
+    }
+
+    static bool SameScale(NetResource *resource, const std::string &blob0, const std::string &blob1) {
+        if (!resource) {
+            return false;
+        }
+        auto &resource_map = resource->resource_map;
+        auto iter0         = resource_map.find(blob0 + blob_scale_suffix);
+        auto iter1         = resource_map.find(blob1 + blob_scale_suffix);
+        if (iter0 == resource_map.end() || iter1 == resource_map.end()) {
+            return false;
+        }
+        if (iter0->second == iter1->second) {
+            return true;
+        }
+
+        auto scale0 = dynamic_cast<IntScaleResource *>(iter0->second.get());
+        auto scale1 = dynamic_cast<IntScaleResource *>(iter1->second.get());
+        if (!scale0 || !scale1) {
+            return false;
+        }
+        auto same_buffer = [](RawBuffer &buffer0, RawBuffer &buffer1) {
+            int bytes = buffer0.GetBytesSize();
+            if (bytes != buffer1.GetBytesSize()) {
+                return false;
+            }
+            return bytes == 0 || memcmp(buffer0.force_to<char *>(), buffer1.force_to<char *>(), bytes) == 0;
+        };
+        return same_buffer(scale0->scale_handle, scale1->scale_handle) &&
+               same_buffer(scale0->bias_handle, scale1->bias_handle);
+    }
+
+    // reformat(src -> a) -> layer(a -> b) -> reformat(b -> dst) becomes layer(src -> dst)
+    // running in the domain of src and dst
+    static bool MoveLayerDomain(NetStructure *structure, NetResource *resource) {
+        BlobProducerMap producers;
+        BlobConsumerMap consumers;
+        BuildBlobMap(structure, producers, consumers);
+
+        for (auto layer : structure->layers) {
+            if (kScalePreservingLayers.count(layer->type) == 0 || layer->inputs.size() != 1 ||
+                layer->outputs.size() != 1) {
+                continue;
+            }
+            auto in_name  = layer->inputs[0];
+            auto out_name = layer->outputs[0];
+            if (structure->outputs.count(in_name) > 0 || structure->outputs.count(out_name) > 0) {
+                continue;
+            }
+            if (consumers[in_name].size() != 1 || consumers[out_name].size() != 1) {
+                continue;
+            }
+
+            auto reformat_in        = producers[in_name];
+            auto reformat_out       = consumers[out_name][0];
+            auto reformat_in_param  = GetReformatParam(reformat_in);
+            auto reformat_out_param = GetReformatParam(reformat_out);
+            if (!reformat_in_param || !reformat_out_param ||
+                reformat_in_param->src_type != reformat_out_param->dst_type) {
+                continue;
+            }
+
+            // no cost model: the layers of kScalePreservingLayers are bandwidth bound and the move removes
+            // a full read and write of both blobs, which is never slower than running the layer in the
+            // other precision
+            bool quantized = reformat_in_param->src_type == DATA_TYPE_INT8;
+            if (!layer->param || quantized == layer->param->quantized) {
+                continue;
+            }
+            auto moved_param = CopyParam(layer);
+            if (!moved_param) {
+                continue;
+            }
+
+            auto src_name = reformat_in->inputs[0];
+            auto dst_name = reformat_out->outputs[0];
+            // the int8 kernel writes dst with the scale of src, consumers of dst are calibrated to the scale of dst
+            if (quantized && !SameScale(resource, src_name, dst_name)) {
+                continue;
+            }
+
+            LOGD("Move layer %s to %s domain, remove reformat %s and %s\n", layer->name.c_str(),
+                 quantized ? "int8" : "float", reformat_in->name.c_str(), reformat_out->name.c_str());
+            layer->param            = moved_param;
+            layer->param->quantized = quantized;
+            layer->inputs           = {src_name};
+            layer->outputs          = {dst_name};
+            structure->blobs.erase(in_name);
+            structure->blobs.erase(out_name);
+            structure->eliminated_reformats.push_back({src_name, src_name, SavedBytes(reformat_in_param)});
+            structure->eliminated_reformats.push_back({out_name, dst_name, SavedBytes(reformat_out_param)});
+            RemoveLayers(structure, {reformat_in, reformat_out});
+            return true;
+        }
+        return false;
+    }
+
+    // reformat(a -> b) -> reformat(b -> c) becomes a, consumers of c read a instead.
+    // int8 -> float -> int8 is only removed if a and c share the same scale.
+    static bool CancelReformatPair(NetStructure *structure, NetResource *resource) {
+        BlobProducerMap producers;
+        BlobConsumerMap consumers;
+        BuildBlobMap(structure, producers, consumers);
+
+        for (auto first : structure->layers) {
+            auto first_param = GetReformatParam(first);
+            if (!first_param) {
+                continue;
+            }
+            auto mid_name = first->outputs[0];
+            if (structure->outputs.count(mid_name) > 0 || consumers[mid_name].size() != 1) {
+                continue;
+            }
+            auto second       = consumers[mid_name][0];
+            auto second_param = GetReformatParam(second);
+            if (!second_param || first_param->src_type != second_param->dst_type) {
+                continue;
+            }
+
+            auto src_name = first->inputs[0];
+            auto dst_name = second->outputs[0];
+            if (structure->outputs.count(dst_name) > 0) {
+                continue;
+            }
+            if (first_param->src_type == DATA_TYPE_INT8 && !SameScale(resource, src_name, dst_name)) {
+                continue;
+            }
+
+            LOGD("Cancel reformat pair %s and %s\n", first->name.c_str(), second->name.c_str());
+            for (auto consumer : consumers[dst_name]) {
+                for (auto &name : consumer->inputs) {
+                    if (name == dst_name) {
+                        name = src_name;
+                    }
+                }
+            }
+            structure->blobs.erase(mid_name);
+            structure->blobs.erase(dst_name);
+            structure->eliminated_reformats.push_back({src_name, src_name, SavedBytes(first_param)});
+            structure->eliminated_reformats.push_back({mid_name, src_name, SavedBytes(second_param)});
+            RemoveLayers(structure, {first, second});
+            return true;
+        }
+        return false;
+    }
+
+    std::string NetOptimizerEliminateReformat::Strategy() {
+        return kNetOptimizerEliminateReformat;
+    }
+
+    bool NetOptimizerEliminateReformat::SupportDevice(DeviceType device) {
+        return device == DEVICE_ARM || device == DEVICE_NAIVE;
+    }
+
+    Status NetOptimizerEliminateReformat::Optimize(NetStructure *structure, NetResource *resource) {
+        if (!structure) {
+            LOGE("Error: empty NetStructure\n");
+            return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
+        }
+
+        auto has_reformat = std::find_if(structure->layers.begin(), structure->layers.end(),
+                                         [](std::shared_ptr<LayerInfo> iter) { return iter->type == LAYER_REFORMAT; });
+        if (has_reformat == structure->layers.end()) {
+            return TNN_OK;
+        }
+
+        while (MoveLayerDomain(structure, resource) || CancelReformatPair(structure, resource)) {
+        }
+
+        return TNN_OK;
+    }
+
+}  // namespace optimizer
+
+}  // namespace TNN_NS
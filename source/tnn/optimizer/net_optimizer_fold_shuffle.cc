@@ -0,0 +1,628 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/optimizer/net_optimizer_fold_shuffle.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "tnn/core/layer_type.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/optimizer/optimizer_const.h"
+
+namespace TNN_NS {
+
+namespace optimizer {
+
+    // P1 priority: fold shuffles before conv relu fuse hides the activations
+    NetOptimizerRegister<NetOptimizerFoldShuffle> g_net_optimizer_fold_shuffle(OptPriority::P1);
+
+    static std::set<LayerType> kChannelwiseLayers = {LAYER_RELU, LAYER_RELU6, LAYER_POOLING};
+
+    // the data of logical channel c of a blob is stored in channel order[c], empty for the identity
+    typedef std::vector<int> ChannelOrder;
+
+    struct ChannelGraph {
+        NetStructure *structure;
+        NetResource *resource;
+        std::map<std::string, std::shared_ptr<LayerInfo>> producers;
+        std::map<std::string, std::vector<std::shared_ptr<LayerInfo>>> consumers;
+        // channels of a blob, missing if the layers around it do not tell
+        std::map<std::string, int> channels;
+        // shuffles to remove, their consumers read the input of the shuffle
+        std::set<std::shared_ptr<LayerInfo>> removed;
+        // slice j of the m equal channel ranges of a removed shuffle reads channels j, j + m, j + 2m ... of its input
+        std::map<std::shared_ptr<LayerInfo>, std::pair<int, int>> strided_slices;
+    };
+
+    // a conv whose weights can be permuted: float weights in OIHW
+    static ConvLayerParam *GetConvParam(std::shared_ptr<LayerInfo> layer, NetResource *resource) {
+        if (layer->type != LAYER_CONVOLUTION || layer->param->quantized || layer->inputs.size() != 1 ||
+            layer->outputs.size() != 1 || resource->resource_map.count(layer->name) == 0) {
+            return nullptr;
+        }
+        auto conv_res = dynamic_cast<ConvLayerResource *>(resource->resource_map[layer->name].get());
+        if (!conv_res || conv_res->filter_format != OIHW) {
+            return nullptr;
+        }
+        auto data_type = conv_res->filter_handle.GetDataType();
+        if (data_type != DATA_TYPE_FLOAT && data_type != DATA_TYPE_HALF) {
+            return nullptr;
+        }
+        return dynamic_cast<ConvLayerParam *>(layer->param.get());
+    }
+
+    static bool IsDepthwise(ConvLayerParam *param) {
+        return param->group > 1 && param->group == param->output_channel && param->input_channel == 1;
+    }
+
+    // the input channels of the filter take any order of the input, the output channels any order of the output
+    static bool IsPermutableConv(std::shared_ptr<LayerInfo> layer, NetResource *resource) {
+        auto conv_param = GetConvParam(layer, resource);
+        return conv_param && conv_param->group == 1;
+    }
+
+    static bool IsDepthwiseConv(std::shared_ptr<LayerInfo> layer, NetResource *resource) {
+        auto conv_param = GetConvParam(layer, resource);
+        return conv_param && IsDepthwise(conv_param);
+    }
+
+    static bool IsChannelwise(std::shared_ptr<LayerInfo> layer) {
+        return kChannelwiseLayers.count(layer->type) > 0 && layer->inputs.size() == 1 &&
+               layer->outputs.size() == 1 && !layer->param->quantized;
+    }
+
+    static int GetChannels(ChannelGraph &graph, const std::string &blob) {
+        auto iter = graph.channels.find(blob);
+        return iter == graph.channels.end() ? 0 : iter->second;
+    }
+
+    // a slice of channels [begin, end) of the input, the other dims are kept
+    static bool GetChannelRange(std::shared_ptr<LayerInfo> layer, int channels, int &begin, int &end) {
+        auto param = dynamic_cast<StrideSliceLayerParam *>(layer->param.get());
+        if (layer->type != LAYER_STRIDED_SLICE || !param || param->quantized || layer->inputs.size() != 1 ||
+            layer->outputs.size() != 1 || channels <= 0 || param->begins.size() != 4 || param->ends.size() != 4 ||
+            param->strides.size() != 4) {
+            return false;
+        }
+        // order [w h c n]
+        for (int i = 0; i < 4; i++) {
+            if (param->strides[i] != 1 || (i != 2 && (param->begins[i] != 0 || param->ends[i] != 0))) {
+                return false;
+            }
+        }
+        begin = param->begins[2];
+        end   = param->ends[2] <= 0 ? param->ends[2] + channels : param->ends[2];
+        return begin >= 0 && begin < end && end <= channels;
+    }
+
+    static int GetShuffleGroup(ChannelGraph &graph, std::shared_ptr<LayerInfo> layer) {
+        auto param = dynamic_cast<ShuffleLayerParam *>(layer->param.get());
+        if (layer->type != LAYER_SHUFFLE_CHANNEL || !param || param->group <= 1 || layer->inputs.size() != 1 ||
+            layer->outputs.size() != 1) {
+            return 0;
+        }
+        int channels = GetChannels(graph, layer->inputs[0]);
+        return (channels > 0 && channels % param->group == 0) ? param->group : 0;
+    }
+
+    // channel c of the shuffle input is channel ShuffledChannel(c) of the output
+    static int ShuffledChannel(int channel, int channels, int group) {
+        const int group_column = channels / group;
+        return (channel % group_column) * group + channel / group_column;
+    }
+
+    static bool IsChannelConcat(ChannelGraph &graph, std::shared_ptr<LayerInfo> layer) {
+        auto param = dynamic_cast<ConcatLayerParam *>(layer->param.get());
+        return layer->type == LAYER_CONCAT && param && param->axis == 1 && layer->outputs.size() == 1 &&
+               GetChannels(graph, layer->outputs[0]) > 0;
+    }
+
+    // layers moving the channels of their inputs to known channels of their output
+    static bool IsChannelPath(ChannelGraph &graph, std::shared_ptr<LayerInfo> layer) {
+        int begin = 0, end = 0;
+        return IsChannelwise(layer) || IsDepthwiseConv(layer, graph.resource) || IsChannelConcat(graph, layer) ||
+               GetShuffleGroup(graph, layer) > 0 ||
+               GetChannelRange(layer, GetChannels(graph, layer->inputs[0]), begin, end);
+    }
+
+    static void InferChannels(ChannelGraph &graph) {
+        auto &channels = graph.channels;
+        for (auto &iter : graph.structure->inputs_shape_map) {
+            if (iter.second.size() > 1) {
+                channels[iter.first] = iter.second[1];
+            }
+        }
+        for (auto layer : graph.structure->layers) {
+            auto conv_param = dynamic_cast<ConvLayerParam *>(layer->param.get());
+            if (layer->type == LAYER_CONVOLUTION && conv_param && layer->inputs.size() == 1) {
+                channels[layer->inputs[0]] = conv_param->input_channel * conv_param->group;
+            }
+        }
+        for (auto layer : graph.structure->layers) {
+            if (layer->inputs.empty() || layer->outputs.size() != 1) {
+                continue;
+            }
+            auto output     = layer->outputs[0];
+            int in_channels = GetChannels(graph, layer->inputs[0]);
+            auto conv_param = dynamic_cast<ConvLayerParam *>(layer->param.get());
+            int begin = 0, end = 0;
+            if (layer->type == LAYER_CONVOLUTION && conv_param) {
+                channels[output] = conv_param->output_channel;
+            } else if ((IsChannelwise(layer) || layer->type == LAYER_SHUFFLE_CHANNEL) && in_channels > 0) {
+                channels[output] = in_channels;
+            } else if (GetChannelRange(layer, in_channels, begin, end)) {
+                channels[output] = end - begin;
+            } else if (layer->type == LAYER_CONCAT) {
+                int sum = 0;
+                for (auto &input : layer->inputs) {
+                    int input_channels = GetChannels(graph, input);
+                    sum                = (sum < 0 || input_channels <= 0) ? -1 : sum + input_channels;
+                }
+                if (sum > 0) {
+                    channels[output] = sum;
+                }
+            }
+        }
+    }
+
+    static void TraceChannel(ChannelGraph &graph, const std::string &blob, int channel, bool stored,
+                             std::string &path);
+
+    static void TraceLayer(ChannelGraph &graph, std::shared_ptr<LayerInfo> layer, const std::string &blob,
+                           int channel, bool stored, std::string &path) {
+        if (IsPermutableConv(layer, graph.resource)) {
+            path += "A";
+            return;
+        }
+        if (!IsChannelPath(graph, layer)) {
+            path += "F" + std::to_string(channel);
+            return;
+        }
+
+        auto output  = layer->outputs[0];
+        int channels = GetChannels(graph, blob);
+        int group    = GetShuffleGroup(graph, layer);
+        int begin = 0, end = 0;
+        if (layer->type == LAYER_CONCAT) {
+            int offset = 0;
+            for (auto &input : layer->inputs) {
+                if (input == blob) {
+                    TraceChannel(graph, output, channel + offset, stored, path);
+                }
+                offset += GetChannels(graph, input);
+            }
+        } else if (group > 0) {
+            // a removed shuffle moves no data
+            bool removed = graph.removed.count(layer) > 0;
+            TraceChannel(graph, output, (stored && removed) ? channel : ShuffledChannel(channel, channels, group),
+                         stored, path);
+        } else if (GetChannelRange(layer, channels, begin, end)) {
+            auto strided = graph.strided_slices.find(layer);
+            if (stored && strided != graph.strided_slices.end()) {
+                int index = strided->second.first;
+                int count = strided->second.second;
+                if (channel % count == index) {
+                    TraceChannel(graph, output, channel / count, stored, path);
+                }
+            } else if (channel >= begin && channel < end) {
+                TraceChannel(graph, output, channel - begin, stored, path);
+            }
+        } else {
+            TraceChannel(graph, output, channel, stored, path);
+        }
+    }
+
+    /*
+     * The path of a channel of the blob through the layers moving channels, up to the convs absorbing any
+     * channel order and the layers needing the channel at its place. The channel is read as the logical
+     * channel, or with stored as the channel the data is stored in once the shuffles in graph.removed are
+     * gone and their slices read strided channels. The data of a logical channel can be stored in any channel
+     * with the same path.
+     */
+    static void TraceChannel(ChannelGraph &graph, const std::string &blob, int channel, bool stored,
+                             std::string &path) {
+        if (graph.structure->outputs.count(blob) > 0) {
+            path += "F" + std::to_string(channel);
+        }
+        for (auto layer : graph.consumers[blob]) {
+            path += "(" + layer->name + " ";
+            TraceLayer(graph, layer, blob, channel, stored, path);
+            path += ")";
+        }
+    }
+
+    // blobs above the blob whose channel order is decided by the layer writing them
+    static void FindSources(ChannelGraph &graph, const std::string &blob, std::set<std::string> &sources,
+                            std::set<std::string> &visited) {
+        if (!visited.insert(blob).second) {
+            return;
+        }
+        auto producer = graph.producers.find(blob);
+        if (producer == graph.producers.end() || !IsChannelPath(graph, producer->second)) {
+            sources.insert(blob);
+            return;
+        }
+        for (auto &input : producer->second->inputs) {
+            FindSources(graph, input, sources, visited);
+        }
+    }
+
+    /*
+     * The channel orders of the blobs feeding the removed shuffles. A blob written by a group 1 conv takes any
+     * order sending each channel along its logical path, the conv permutes its output channels. The other blobs
+     * keep their order, so each channel must take its logical path from where it is.
+     */
+    static bool PlanChannelOrders(ChannelGraph &graph, std::map<std::string, ChannelOrder> &orders) {
+        orders.clear();
+        std::set<std::string> sources, visited;
+        for (auto shuffle : graph.removed) {
+            FindSources(graph, shuffle->inputs[0], sources, visited);
+        }
+        for (auto &blob : sources) {
+            int channels = GetChannels(graph, blob);
+            if (channels <= 0) {
+                return false;
+            }
+            std::map<std::string, std::vector<int>> logical_paths, stored_paths;
+            for (int c = 0; c < channels; c++) {
+                std::string logical_path, stored_path;
+                TraceChannel(graph, blob, c, false, logical_path);
+                TraceChannel(graph, blob, c, true, stored_path);
+                logical_paths[logical_path].push_back(c);
+                stored_paths[stored_path].push_back(c);
+            }
+
+            auto producer = graph.producers.find(blob);
+            if (producer == graph.producers.end() || !IsPermutableConv(producer->second, graph.resource)) {
+                if (logical_paths != stored_paths) {
+                    return false;
+                }
+                continue;
+            }
+            ChannelOrder order(channels);
+            bool identity = true;
+            for (auto &iter : logical_paths) {
+                auto stored = stored_paths.find(iter.first);
+                if (stored == stored_paths.end() || stored->second.size() != iter.second.size()) {
+                    return false;
+                }
+                for (int i = 0; i < iter.second.size(); i++) {
+                    order[iter.second[i]] = stored->second[i];
+                    identity              = identity && iter.second[i] == stored->second[i];
+                }
+            }
+            if (!identity) {
+                orders[blob] = order;
+            }
+        }
+        return true;
+    }
+
+    // slices reading the shuffle must split its channels into equal ranges, slice j of m then reads the input
+    // channels j, j + m, j + 2m ...
+    static bool GetStridedSlices(ChannelGraph &graph, std::shared_ptr<LayerInfo> shuffle,
+                                 std::map<std::shared_ptr<LayerInfo>, std::pair<int, int>> &slices) {
+        std::vector<std::shared_ptr<LayerInfo>> slice_layers;
+        for (auto layer : graph.consumers[shuffle->outputs[0]]) {
+            if (layer->type == LAYER_STRIDED_SLICE) {
+                slice_layers.push_back(layer);
+            }
+        }
+        if (slice_layers.empty()) {
+            return true;
+        }
+        const int channels = GetChannels(graph, shuffle->outputs[0]);
+        const int count    = (int)slice_layers.size();
+        if (channels % count != 0) {
+            return false;
+        }
+        const int range_size = channels / count;
+        std::set<int> indices;
+        for (auto layer : slice_layers) {
+            int begin = 0, end = 0;
+            if (!GetChannelRange(layer, channels, begin, end) || end - begin != range_size ||
+                begin % range_size != 0 || !indices.insert(begin / range_size).second) {
+                return false;
+            }
+            slices[layer] = std::make_pair(begin / range_size, count);
+        }
+        return true;
+    }
+
+    static bool IsRemovableShuffle(ChannelGraph &graph, std::shared_ptr<LayerInfo> shuffle) {
+        if (GetShuffleGroup(graph, shuffle) <= 0 || shuffle->param->quantized) {
+            return false;
+        }
+        auto input  = shuffle->inputs[0];
+        auto output = shuffle->outputs[0];
+        if (graph.structure->outputs.count(output) > 0) {
+            // the layer writing the input takes the name of the net output
+            auto producer = graph.producers.find(input);
+            if (producer == graph.producers.end() || producer->second->outputs.size() != 1 ||
+                producer->second->type == LAYER_SHUFFLE_CHANNEL || graph.consumers[input].size() != 1 ||
+                graph.structure->outputs.count(input) > 0) {
+                return false;
+            }
+        }
+        std::map<std::shared_ptr<LayerInfo>, std::pair<int, int>> slices;
+        return GetStridedSlices(graph, shuffle, slices);
+    }
+
+    static bool TryRemoveShuffles(ChannelGraph &graph, const std::vector<std::shared_ptr<LayerInfo>> &shuffles) {
+        auto removed        = graph.removed;
+        auto strided_slices = graph.strided_slices;
+        for (auto shuffle : shuffles) {
+            graph.removed.insert(shuffle);
+            GetStridedSlices(graph, shuffle, graph.strided_slices);
+        }
+        std::map<std::string, ChannelOrder> orders;
+        if (PlanChannelOrders(graph, orders)) {
+            return true;
+        }
+        graph.removed        = removed;
+        graph.strided_slices = strided_slices;
+        return false;
+    }
+
+    // channel c of the buffer moves to channel dst_channels[c], the buffer is [outer][channels][inner]
+    static RawBuffer PermuteChannels(RawBuffer &buffer, const std::vector<int> &dst_channels, int outer) {
+        RawBuffer src = buffer;
+        if (src.GetDataType() == DATA_TYPE_HALF) {
+            src = ConvertHalfHandle(src);
+        }
+        const int channels = (int)dst_channels.size();
+        const int inner    = src.GetDataCount() / (outer * channels);
+
+        RawBuffer dst(src.GetBytesSize());
+        dst.SetDataType(DATA_TYPE_FLOAT);
+        auto src_data = src.force_to<float *>();
+        auto dst_data = dst.force_to<float *>();
+        for (int o = 0; o < outer; o++) {
+            for (int c = 0; c < channels; c++) {
+                memcpy(dst_data + (o * channels + dst_channels[c]) * inner, src_data + (o * channels + c) * inner,
+                       inner * sizeof(float));
+            }
+        }
+        return dst;
+    }
+
+    // the resource may be shared with the unoptimized network, permute a copy of it
+    static void PermuteConvResource(std::shared_ptr<LayerInfo> layer, NetResource *resource,
+                                    const std::vector<int> &dst_channels, bool input_channels) {
+        auto conv_param = dynamic_cast<ConvLayerParam *>(layer->param.get());
+        auto conv_res   = std::make_shared<ConvLayerResource>(
+            *dynamic_cast<ConvLayerResource *>(resource->resource_map[layer->name].get()));
+        if (input_channels) {
+            conv_res->filter_handle =
+                PermuteChannels(conv_res->filter_handle, dst_channels, conv_param->output_channel);
+        } else {
+            conv_res->filter_handle = PermuteChannels(conv_res->filter_handle, dst_channels, 1);
+            if (conv_param->bias && conv_res->bias_handle.GetDataCount() == dst_channels.size()) {
+                conv_res->bias_handle = PermuteChannels(conv_res->bias_handle, dst_channels, 1);
+            }
+        }
+        resource->resource_map[layer->name] = conv_res;
+    }
+
+    static int StoredChannel(const ChannelOrder &order, int channel) {
+        return order.empty() ? channel : order[channel];
+    }
+
+    // moves the weights to the planned channel orders and sends the orders down to the convs absorbing them
+    static void ApplyChannelOrders(ChannelGraph &graph, std::map<std::string, ChannelOrder> &orders) {
+        for (auto &iter : orders) {
+            PermuteConvResource(graph.producers[iter.first], graph.resource, iter.second, false);
+        }
+
+        for (auto layer : graph.structure->layers) {
+            if (layer->inputs.empty()) {
+                continue;
+            }
+            auto input = orders.find(layer->inputs[0]);
+            if (IsPermutableConv(layer, graph.resource)) {
+                if (input != orders.end()) {
+                    PermuteConvResource(layer, graph.resource, input->second, true);
+                }
+                continue;
+            }
+            if (!IsChannelPath(graph, layer)) {
+                continue;
+            }
+
+            auto output   = layer->outputs[0];
+            auto in_order = input == orders.end() ? ChannelOrder() : input->second;
+            int channels  = GetChannels(graph, layer->inputs[0]);
+            int group     = GetShuffleGroup(graph, layer);
+            int begin = 0, end = 0;
+            ChannelOrder out_order;
+            if (layer->type == LAYER_CONCAT) {
+                int offset = 0;
+                out_order.resize(GetChannels(graph, output));
+                for (auto &name : layer->inputs) {
+                    auto iter       = orders.find(name);
+                    auto name_order = iter == orders.end() ? ChannelOrder() : iter->second;
+                    for (int c = 0; c < GetChannels(graph, name); c++) {
+                        out_order[offset + c] = offset + StoredChannel(name_order, c);
+                    }
+                    offset += GetChannels(graph, name);
+                }
+            } else if (group > 0) {
+                bool removed = graph.removed.count(layer) > 0;
+                out_order.resize(channels);
+                for (int c = 0; c < channels; c++) {
+                    int stored = StoredChannel(in_order, c);
+                    out_order[ShuffledChannel(c, channels, group)] =
+                        removed ? stored : ShuffledChannel(stored, channels, group);
+                }
+            } else if (GetChannelRange(layer, channels, begin, end)) {
+                auto strided = graph.strided_slices.find(layer);
+                out_order.resize(end - begin);
+                for (int c = begin; c < end; c++) {
+                    int stored = StoredChannel(in_order, c);
+                    out_order[c - begin] =
+                        strided == graph.strided_slices.end() ? stored - begin : stored / strided->second.second;
+                }
+            } else {
+                if (in_order.empty()) {
+                    continue;
+                }
+                if (IsDepthwiseConv(layer, graph.resource)) {
+                    PermuteConvResource(layer, graph.resource, in_order, false);
+                }
+                out_order = in_order;
+            }
+            bool identity = true;
+            for (int c = 0; c < out_order.size(); c++) {
+                identity = identity && out_order[c] == c;
+            }
+            if (!identity) {
+                orders[output] = out_order;
+            }
+        }
+    }
+
+    // the slices of a removed shuffle read strided channels, the consumers of the shuffle read its input
+    static void RemoveShuffles(ChannelGraph &graph) {
+        auto structure = graph.structure;
+        for (auto &iter : graph.strided_slices) {
+            auto slice = iter.first;
+            auto param =
+                std::make_shared<StrideSliceLayerParam>(*dynamic_cast<StrideSliceLayerParam *>(slice->param.get()));
+            param->begins[2]  = iter.second.first;
+            param->ends[2]    = GetChannels(graph, slice->inputs[0]);
+            param->strides[2] = iter.second.second;
+            slice->param      = param;
+        }
+
+        std::map<std::string, std::string> renamed;
+        for (auto shuffle : graph.removed) {
+            auto input  = shuffle->inputs[0];
+            auto output = shuffle->outputs[0];
+            if (structure->outputs.count(output) > 0) {
+                // keep the name of the net output
+                graph.producers[input]->outputs = {output};
+                structure->blobs.erase(input);
+            } else {
+                renamed[output] = input;
+                structure->blobs.erase(output);
+            }
+        }
+
+        std::vector<std::shared_ptr<LayerInfo>> layers_kept;
+        for (auto layer : structure->layers) {
+            if (graph.removed.count(layer) > 0) {
+                continue;
+            }
+            for (auto &name : layer->inputs) {
+                while (renamed.count(name) > 0) {
+                    name = renamed[name];
+                }
+            }
+            layers_kept.push_back(layer);
+        }
+        structure->layers = layers_kept;
+    }
+
+    std::string NetOptimizerFoldShuffle::Strategy() {
+        return kNetOptimizerFoldShuffle;
+    }
+
+    bool NetOptimizerFoldShuffle::SupportDevice(DeviceType device) {
+        return true;
+    }
+
+    Status NetOptimizerFoldShuffle::Optimize(NetStructure *structure, NetResource *resource) {
+        if (!structure) {
+            LOGE("Error: empty NetStructure\n");
+            return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
+        }
+
+        // weights are permuted, nothing to fold without them
+        if (!resource || structure->layers.size() <= 1) {
+            return TNN_OK;
+        }
+
+        ChannelGraph graph;
+        graph.structure = structure;
+        graph.resource  = resource;
+        for (auto layer : structure->layers) {
+            for (auto &name : layer->inputs) {
+                graph.consumers[name].push_back(layer);
+            }
+            for (auto &name : layer->outputs) {
+                graph.producers[name] = layer;
+            }
+        }
+        InferChannels(graph);
+
+        // shuffles sharing a source blob, e.g. the units of a ShuffleNet stage, are planned together
+        std::vector<std::vector<std::shared_ptr<LayerInfo>>> shuffle_groups;
+        std::map<std::string, int> source_groups;
+        for (auto layer : structure->layers) {
+            if (!IsRemovableShuffle(graph, layer)) {
+                continue;
+            }
+            std::set<std::string> sources, visited;
+            FindSources(graph, layer->inputs[0], sources, visited);
+            int group_id = (int)shuffle_groups.size();
+            for (auto &source : sources) {
+                if (source_groups.count(source) > 0) {
+                    group_id = std::min(group_id, source_groups[source]);
+                }
+            }
+            if (group_id == shuffle_groups.size()) {
+                shuffle_groups.push_back({});
+            }
+            shuffle_groups[group_id].push_back(layer);
+            for (auto &source : sources) {
+                source_groups[source] = group_id;
+            }
+        }
+
+        // a group that cannot go as a whole is tried shuffle by shuffle from its end
+        for (auto &shuffles : shuffle_groups) {
+            if (TryRemoveShuffles(graph, shuffles)) {
+                continue;
+            }
+            for (auto iter = shuffles.rbegin(); iter != shuffles.rend(); iter++) {
+                TryRemoveShuffles(graph, {*iter});
+            }
+        }
+        if (graph.removed.empty()) {
+            return TNN_OK;
+        }
+
+        std::map<std::string, ChannelOrder> orders;
+        PlanChannelOrders(graph, orders);
+        ApplyChannelOrders(graph, orders);
+        for (auto shuffle : graph.removed) {
+            LOGD("Fold shuffle channel %s into conv weights\n", shuffle->name.c_str());
+        }
+        RemoveShuffles(graph);
+
+        return TNN_OK;
+    }
+
+}  // namespace optimizer
+
+}  // namespace TNN_NS
@@ -0,0 +1,234 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/optimizer/net_optimizer_fuse_elementwise.h"
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "tnn/core/layer_type.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/optimizer/optimizer_const.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+namespace optimizer {
+
+    // P2 priority: fuse after conv relu fuse and before reformat insert
+    NetOptimizerRegister<NetOptimizerFuseElementwise> g_net_optimizer_fuse_elementwise(OptPriority::P2);
+
+    static const std::string fused_name_suffix = "_fused_elementwise";
+
+    static std::map<LayerType, FusedElementwiseOpType> kFusibleLayerMap = {
+        {LAYER_ADD, FusedElementwiseOpAdd},         {LAYER_SUB, FusedElementwiseOpSub},
+        {LAYER_MUL, FusedElementwiseOpMul},         {LAYER_DIV, FusedElementwiseOpDiv},
+        {LAYER_SIGMOID, FusedElementwiseOpSigmoid}, {LAYER_EXP, FusedElementwiseOpExp},
+        {LAYER_CLIP, FusedElementwiseOpClip},       {LAYER_HARDSIGMOID, FusedElementwiseOpHardSigmoid}};
+
+    struct ElementwiseChain {
+        std::string input;
+        std::vector<std::shared_ptr<LayerInfo>> layers;
+        std::shared_ptr<FusedElementwiseLayerParam> param;
+        std::shared_ptr<FusedElementwiseLayerResource> resource;
+    };
+
+    // only constants that can never broadcast the running value up are fused, the shape of the running value
+    // stays the shape of the chain input. Shapes are unknown here: a constant with less than 4 dims is matched
+    // against the running value at runtime like MultidirBroadcastLayer does, a 4 dims constant could be larger
+    // than the running value and is only fused if it is a single element.
+    static bool GetConstant(std::shared_ptr<LayerInfo> layer, NetResource *resource, RawBuffer &handle,
+                            DimsVector &shape) {
+        if (!resource || resource->resource_map.count(layer->name) == 0) {
+            return false;
+        }
+        auto layer_res = dynamic_cast<EltwiseLayerResource *>(resource->resource_map[layer->name].get());
+        if (!layer_res || layer_res->element_handle.GetDataCount() <= 0) {
+            return false;
+        }
+
+        shape = layer_res->element_shape;
+        if (shape.size() >= 4 && DimsVectorUtils::Count(shape) != 1) {
+            return false;
+        }
+
+        handle = layer_res->element_handle;
+        if (handle.GetDataType() == DATA_TYPE_HALF) {
+            handle = ConvertHalfHandle(handle);
+        }
+        return handle.GetDataType() == DATA_TYPE_FLOAT;
+    }
+
+    static bool AppendLayer(ElementwiseChain &chain, std::shared_ptr<LayerInfo> layer, const std::string &running,
+                            NetResource *resource) {
+        auto fusible = kFusibleLayerMap.find(layer->type);
+        if (fusible == kFusibleLayerMap.end() || layer->param->quantized || layer->outputs.size() != 1) {
+            return false;
+        }
+
+        FusedElementwiseOp op;
+        op.type = fusible->second;
+        if (op.type == FusedElementwiseOpSigmoid || op.type == FusedElementwiseOpExp ||
+            op.type == FusedElementwiseOpClip || op.type == FusedElementwiseOpHardSigmoid) {
+            if (layer->inputs.size() != 1 || layer->inputs[0] != running) {
+                return false;
+            }
+            if (op.type == FusedElementwiseOpClip) {
+                auto clip_param = dynamic_cast<ClipLayerParam *>(layer->param.get());
+                if (!clip_param) {
+                    return false;
+                }
+                op.alpha = clip_param->min;
+                op.beta  = clip_param->max;
+            } else if (op.type == FusedElementwiseOpHardSigmoid) {
+                auto hard_sigmoid_param = dynamic_cast<HardSigmoidLayerParam *>(layer->param.get());
+                if (!hard_sigmoid_param) {
+                    return false;
+                }
+                op.alpha = hard_sigmoid_param->alpha;
+                op.beta  = hard_sigmoid_param->beta;
+            }
+        } else {
+            auto broadcast_param = dynamic_cast<MultidirBroadcastLayerParam *>(layer->param.get());
+            if (!broadcast_param) {
+                return false;
+            }
+            if (layer->inputs.size() == 1 && layer->inputs[0] == running) {
+                RawBuffer handle;
+                DimsVector shape;
+                if (!GetConstant(layer, resource, handle, shape)) {
+                    return false;
+                }
+                op.operand        = FusedElementwiseOperandConstant;
+                op.operand_first  = broadcast_param->weight_input_index == 0;
+                op.constant_index = (int)chain.resource->constant_handles.size();
+                chain.resource->constant_handles.push_back(handle);
+                chain.resource->constant_shapes.push_back(shape);
+            } else if (layer->inputs.size() == 2 && !chain.layers.empty() &&
+                       ((layer->inputs[0] == running && layer->inputs[1] == chain.input) ||
+                        (layer->inputs[0] == chain.input && layer->inputs[1] == running))) {
+                // the input of the chain has the shape of the running value
+                op.operand       = FusedElementwiseOperandInput;
+                op.operand_first = layer->inputs[0] == chain.input;
+            } else {
+                return false;
+            }
+        }
+
+        chain.param->ops.push_back(op);
+        chain.layers.push_back(layer);
+        return true;
+    }
+
+    std::string NetOptimizerFuseElementwise::Strategy() {
+        return kNetOptimizerFuseElementwise;
+    }
+
+    bool NetOptimizerFuseElementwise::SupportDevice(DeviceType device) {
+        return device == DEVICE_ARM || device == DEVICE_NAIVE;
+    }
+
+    Status NetOptimizerFuseElementwise::Optimize(NetStructure *structure, NetResource *resource) {
+        if (!structure) {
+            LOGE("Error: empty NetStructure\n");
+            return Status(TNNERR_NET_ERR, "Error: empty NetStructure");
+        }
+
+        std::vector<std::shared_ptr<LayerInfo>> layers_orig = structure->layers;
+        const int count                                     = (const int)layers_orig.size();
+        if (count <= 1) {
+            return TNN_OK;
+        }
+
+        std::map<std::string, std::vector<std::shared_ptr<LayerInfo>>> consumers;
+        for (auto layer : layers_orig) {
+            for (auto name : layer->inputs) {
+                consumers[name].push_back(layer);
+            }
+        }
+
+        std::set<std::shared_ptr<LayerInfo>> fused_layers;
+        std::map<std::shared_ptr<LayerInfo>, std::shared_ptr<LayerInfo>> replace_map;
+        for (auto layer : layers_orig) {
+            if (fused_layers.count(layer) > 0 || layer->inputs.empty()) {
+                continue;
+            }
+
+            ElementwiseChain chain;
+            chain.input    = layer->inputs[0];
+            chain.param    = std::make_shared<FusedElementwiseLayerParam>();
+            chain.resource = std::make_shared<FusedElementwiseLayerResource>();
+            if (!AppendLayer(chain, layer, chain.input, resource)) {
+                continue;
+            }
+            while (true) {
+                auto running = chain.layers.back()->outputs[0];
+                if (structure->outputs.count(running) > 0 || consumers[running].size() != 1 ||
+                    !AppendLayer(chain, consumers[running][0], running, resource)) {
+                    break;
+                }
+            }
+            if (chain.layers.size() < 2) {
+                continue;
+            }
+
+            auto last             = chain.layers.back();
+            auto fused_layer      = std::make_shared<LayerInfo>();
+            fused_layer->type     = LAYER_FUSED_ELEMENTWISE;
+            fused_layer->type_str = "FusedElementwise";
+            fused_layer->name     = last->name + fused_name_suffix;
+            fused_layer->inputs   = {chain.input};
+            fused_layer->outputs  = last->outputs;
+            chain.param->type     = fused_layer->type_str;
+            chain.param->name     = fused_layer->name;
+            fused_layer->param    = chain.param;
+            if (!chain.resource->constant_handles.empty()) {
+                chain.resource->name                      = fused_layer->name;
+                resource->resource_map[fused_layer->name] = chain.resource;
+            }
+
+            for (int i = 0; i < chain.layers.size(); i++) {
+                fused_layers.insert(chain.layers[i]);
+                if (i + 1 < chain.layers.size()) {
+                    structure->blobs.erase(chain.layers[i]->outputs[0]);
+                }
+            }
+            replace_map[last] = fused_layer;
+            LOGD("Fuse %d elementwise layers into %s\n", (int)chain.layers.size(), fused_layer->name.c_str());
+        }
+
+        if (replace_map.empty()) {
+            return TNN_OK;
+        }
+
+        std::vector<std::shared_ptr<LayerInfo>> layers_fused;
+        for (auto layer : layers_orig) {
+            if (replace_map.count(layer) > 0) {
+                layers_fused.push_back(replace_map[layer]);
+            } else if (fused_layers.count(layer) == 0) {
+                layers_fused.push_back(layer);
+            }
+        }
+        structure->layers = layers_fused;
+
+        return TNN_OK;
+    }
+
+}  // namespace optimizer
+
+}  // namespace TNN_NS
@@ -32,7 +32,6 @@ namespace optimizer {
 
     Status NetOptimizerManager::Optimize(NetStructure *structure, NetResource *resource, DeviceType device) {
         auto &optimizer_map = NetOptimizerManager::GetNetOptimizerMap();
-        std::sort(NetOptimizerManager::GetNetOptimizerSeq().begin(), NetOptimizerManager::GetNetOptimizerSeq().end());
 
         for (auto iter : NetOptimizerManager::GetNetOptimizerSeq()) {
             auto optimizer = optimizer_map[iter.second];
@@ -47,11 +46,43 @@ namespace optimizer {
         return TNN_OK;
     }
 
+    std::shared_ptr<DefaultModelInterpreter> NetOptimizerManager::Optimize(
+        std::shared_ptr<DefaultModelInterpreter> interpreter, DeviceType device, Status &status) {
+        status = TNN_OK;
+        if (interpreter->IsOptimized(device)) {
+            return interpreter;
+        }
+
+        auto optimized = interpreter->Copy();
+        status         = Optimize(optimized->GetNetStructure(), optimized->GetNetResource(), device);
+        if (status != TNN_OK) {
+            return nullptr;
+        }
+        optimized->SetOptimized(device);
+        return optimized;
+    }
+
+    std::vector<std::string> NetOptimizerManager::GetStrategies(DeviceType device) {
+        auto &optimizer_map = NetOptimizerManager::GetNetOptimizerMap();
+
+        std::vector<std::string> strategies;
+        for (auto iter : NetOptimizerManager::GetNetOptimizerSeq()) {
+            if (optimizer_map[iter.second]->SupportDevice(device)) {
+                strategies.push_back(iter.second);
+            }
+        }
+        return strategies;
+    }
+
     void NetOptimizerManager::RegisterNetOptimizer(NetOptimizer *optimizer, OptPriority prior) {
         if (optimizer && optimizer->Strategy().length() > 0) {
             auto &optimizer_map                  = NetOptimizerManager::GetNetOptimizerMap();
             optimizer_map[optimizer->Strategy()] = std::shared_ptr<NetOptimizer>(optimizer);
-            NetOptimizerManager::GetNetOptimizerSeq().push_back(std::make_pair(prior, optimizer->Strategy()));
+            // optimizers register during static initialization, the sequence is kept sorted here
+            // so that Optimize and GetStrategies only read it
+            auto &optimizer_seq = NetOptimizerManager::GetNetOptimizerSeq();
+            auto item           = std::make_pair(prior, optimizer->Strategy());
+            optimizer_seq.insert(std::upper_bound(optimizer_seq.begin(), optimizer_seq.end(), item), item);
         }
     }
 
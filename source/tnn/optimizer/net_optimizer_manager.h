@@ -23,6 +23,7 @@
 
 #include "tnn/core/common.h"
 #include "tnn/core/status.h"
+#include "tnn/interpreter/default_model_interpreter.h"
 #include "tnn/interpreter/net_resource.h"
 #include "tnn/interpreter/net_structure.h"
 #include "tnn/optimizer/net_optimizer.h"
@@ -39,7 +40,9 @@ namespace optimizer {
         //
         P2 = 2,
         // LAST
-        PLAST = 1000
+        PLAST = 1000,
+        // AFTER LAST: clean up layers inserted by PLAST optimizers
+        PPOST = 1001
     } OptPriority;
 
     //@brief net optimize: fuse relu and relu6 to convolution
@@ -47,6 +50,14 @@ namespace optimizer {
     public:
         static Status Optimize(NetStructure *structure, NetResource *resource, DeviceType device);
 
+        //@brief return an interpreter holding the network of interpreter optimized for the device. The network
+        // of interpreter is left as interpreted and a copy is optimized, unless it is optimized for the device already.
+        static std::shared_ptr<DefaultModelInterpreter> Optimize(std::shared_ptr<DefaultModelInterpreter> interpreter,
+                                                                 DeviceType device, Status &status);
+
+        //@brief strategies of the optimizers run for the device, in the order they run
+        static std::vector<std::string> GetStrategies(DeviceType device);
+
         static void RegisterNetOptimizer(NetOptimizer *ptimizer, OptPriority prior);
 
     private:
@@ -27,6 +27,18 @@ static const std::string kNetOptimizerInsertReformat =
 
 static const std::string kNetOptimizerRemoveLayers =
     "net_optimizer_remove_layers";
+
+static const std::string kNetOptimizerEliminateReformat =
+    "net_optimizer_eliminate_reformat";
+
+static const std::string kNetOptimizerFuseElementwise =
+    "net_optimizer_fuse_elementwise";
+
+static const std::string kNetOptimizerComposePermute =
+    "net_optimizer_compose_permute";
+
+static const std::string kNetOptimizerFoldShuffle =
+    "net_optimizer_fold_shuffle";
 }
 
 #endif // TNN_SOURCE_TNN_OPTIMIZER_OPTIMIZER_CONST_H_
@@ -1009,8 +1009,8 @@ void ApplyNMSFast(const vector<NormalizedBBox>& bboxes, const vector<float>& sco
     // Do nms.
     float adaptive_threshold = nms_threshold;
     indices->clear();
-    while (score_index_vec.size() != 0) {
-        const int idx = score_index_vec.front().second;
+    for (size_t i = 0; i < score_index_vec.size(); ++i) {
+        const int idx = score_index_vec[i].second;
         bool keep     = true;
         for (int k = 0; k < indices->size(); ++k) {
             if (keep) {
@@ -1024,7 +1024,6 @@ void ApplyNMSFast(const vector<NormalizedBBox>& bboxes, const vector<float>& sco
         if (keep) {
             indices->push_back(idx);
         }
-        score_index_vec.erase(score_index_vec.begin());
         if (keep && eta < 1 && adaptive_threshold > 0.5) {
             adaptive_threshold *= eta;
         }
@@ -14,7 +14,10 @@
 
 #include "tnn/utils/data_format_converter.h"
 
+#include <algorithm>
+
 #include "tnn/core/macro.h"
+#include "tnn/utils/permute_utils.h"
 
 namespace TNN_NS {
 
@@ -88,52 +91,56 @@ static Status ConvertWeightsFromGOIHWToGOIHW16(T *src, T *dst, int group, int in
     return TNN_OK;
 };
 
+// the layouts below are transposes of [c][h * w] planes, the channels past channel are zero.
+// nchw4 transposes each group of 4 channels, the full groups of a batch run in one batched transpose
+// and the partial last groups of all batches in another one.
 template <class T>
 static Status ConvertFromNCHWToNCHW4(T *src, T *dst, int num, int channel, int height, int width) {
     int round_channel = ROUND_UP(channel, 4);
+    int full_channel  = channel / 4 * 4;
+    int hw            = height * width;
+    // without a partial group the groups of all batches are evenly spaced and run in a single transpose
+    int calls  = full_channel == channel ? 1 : num;
+    int groups = full_channel == channel ? num * channel / 4 : channel / 4;
+    for (int n = 0; n < calls; n++) {
+        // to   [c/4][h][w][4]
+        // from [c][h][w]
+        RETURN_ON_NEQ(PermuteUtils::Transpose(src + n * channel * hw, dst + n * round_channel * hw, groups, 4 * hw,
+                                              4 * hw, 4, hw, hw, 4, sizeof(T)),
+                      TNN_OK);
+    }
+    if (full_channel == channel) {
+        return TNN_OK;
+    }
+
+    int valid = channel - full_channel;
+    RETURN_ON_NEQ(PermuteUtils::Transpose(src + full_channel * hw, dst + full_channel * hw, num, channel * hw,
+                                          round_channel * hw, valid, hw, hw, 4, sizeof(T)),
+                  TNN_OK);
     for (int n = 0; n < num; n++) {
-        auto n_dst = dst + n * round_channel * height * width;
-        auto n_src = src + n * channel * height * width;
-        for (int c = 0; c < round_channel; c++) {
-            auto z = c / 4, r = c % 4;
-            auto z_dst = n_dst + z * height * width * 4 + r;
-            auto z_src = n_src + c * height * width;
-#pragma clang loop vectorize(enable)
-            for (int h = 0; h < height; h++) {
-#pragma clang loop vectorize(enable) unroll(enable)
-                for (int w = 0; w < width; w++) {
-                    // to   [c/4][h][w][4]
-                    // from [c][h][w]
-                    // dst[(z * height * width + h * width + w) * 4 + r] =
-                    // src[ c * height * width + h * width + w];
-                    if (c < channel)
-                        z_dst[(h * width + w) * 4] = z_src[h * width + w];
-                    else
-                        z_dst[(h * width + w) * 4] = 0;
-                }
+        auto z_dst = dst + n * round_channel * hw + full_channel * hw;
+        for (int i = 0; i < hw; i++) {
+            for (int r = valid; r < 4; r++) {
+                z_dst[i * 4 + r] = 0;
             }
         }
     }
     return TNN_OK;
 };
+
 template <class T>
 static Status ConvertFromNCHWToNHWC4(T *src, T *dst, int num, int channel, int height, int width) {
     int round_channel = ROUND_UP(channel, 4);
+    int hw            = height * width;
     for (int n = 0; n < num; n++) {
-        auto n_dst = dst + n * round_channel * height * width;
-        auto n_src = src + n * channel * height * width;
-        for (int h = 0; h < height; h++) {
-            for (int w = 0; w < width; w++) {
-                auto z_dst = n_dst + (h * width + w) * round_channel;
-                auto z_src = n_src + h * width + w;
-                for (int c = 0; c < round_channel; c++) {
-                    // to   [c][h][w]
-                    // from [h][w][c4]
-                    if (c < channel)
-                        z_dst[c] = z_src[c * height * width];
-                    else
-                        z_dst[c] = 0;
-                }
+        auto n_dst = dst + n * round_channel * hw;
+        auto n_src = src + n * channel * hw;
+        // to   [h][w][c4]
+        // from [c][h][w]
+        RETURN_ON_NEQ(PermuteUtils::Transpose(n_src, n_dst, channel, hw, hw, round_channel, sizeof(T)), TNN_OK);
+        for (int i = 0; i < hw; i++) {
+            for (int c = channel; c < round_channel; c++) {
+                n_dst[i * round_channel + c] = 0;
             }
         }
     }
@@ -143,46 +150,35 @@ static Status ConvertFromNCHWToNHWC4(T *src, T *dst, int num, int channel, int h
 template <class T>
 static Status ConvertFromNCHW4ToNCHW(T *src, T *dst, int num, int channel, int height, int width) {
     int round_channel = ROUND_UP(channel, 4);
-    for (int n = 0; n < num; n++) {
-        auto n_src = src + n * round_channel * height * width;
-        auto n_dst = dst + n * channel * height * width;
-        for (int c = 0; c < channel; c++) {
-            auto z = c / 4, r = c % 4;
-            auto z_src = n_src + z * height * width * 4 + r;
-            auto z_dst = n_dst + c * height * width;
-#pragma clang loop vectorize(enable)
-            for (int h = 0; h < height; h++) {
-#pragma clang loop vectorize(enable) unroll(enable)
-                for (int w = 0; w < width; w++) {
-                    // to [c][h][w]
-                    // from   [c/4][h][w][4]
-                    z_dst[h * width + w] = z_src[(h * width + w) * 4];
-                }
-            }
-        }
+    int full_channel  = channel / 4 * 4;
+    int hw            = height * width;
+    int calls  = full_channel == channel ? 1 : num;
+    int groups = full_channel == channel ? num * channel / 4 : channel / 4;
+    for (int n = 0; n < calls; n++) {
+        // to   [c][h][w]
+        // from [c/4][h][w][4]
+        RETURN_ON_NEQ(PermuteUtils::Transpose(src + n * round_channel * hw, dst + n * channel * hw, groups, 4 * hw,
+                                              4 * hw, hw, 4, 4, hw, sizeof(T)),
+                      TNN_OK);
     }
-    return TNN_OK;
+    if (full_channel == channel) {
+        return TNN_OK;
+    }
+
+    return PermuteUtils::Transpose(src + full_channel * hw, dst + full_channel * hw, num, round_channel * hw,
+                                   channel * hw, hw, channel - full_channel, 4, hw, sizeof(T));
 };
 
 template <class T>
 static Status ConvertFromNHWC4ToNCHW(T *src, T *dst, int num, int channel, int height, int width) {
     int round_channel = ROUND_UP(channel, 4);
+    int hw            = height * width;
     for (int n = 0; n < num; n++) {
-        auto n_src = src + n * round_channel * height * width;
-        auto n_dst = dst + n * channel * height * width;
-        for (int c = 0; c < channel; c++) {
-            auto z_src = n_src + c;
-            auto z_dst = n_dst + c * height * width;
-#pragma clang loop vectorize(enable)
-            for (int h = 0; h < height; h++) {
-#pragma clang loop vectorize(enable) unroll(enable)
-                for (int w = 0; w < width; w++) {
-                    // to [c][h][w]
-                    // from   [c/4][h][w][4]
-                    z_dst[h * width + w] = z_src[(h * width + w) * round_channel];
-                }
-            }
-        }
+        auto n_src = src + n * round_channel * hw;
+        auto n_dst = dst + n * channel * hw;
+        // to   [c][h][w]
+        // from [h][w][c4]
+        RETURN_ON_NEQ(PermuteUtils::Transpose(n_src, n_dst, hw, channel, round_channel, hw, sizeof(T)), TNN_OK);
     }
     return TNN_OK;
 };
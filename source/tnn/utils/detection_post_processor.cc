@@ -0,0 +1,415 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/detection_post_processor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "tnn/core/macro.h"
+#include "tnn/device/cpu/acc/compute/compute_vec.h"
+#include "tnn/utils/bbox_util.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/omp_utils.h"
+#include "tnn/utils/permute_utils.h"
+
+namespace TNN_NS {
+
+// refinedet moves the priors its arm rates below this objectness to the background class
+static const float kObjectnessScore = 0.1f;
+// kept boxes compared with a candidate per step of hard nms
+static const int kNMSChunk = 64;
+
+void BoxArray::Resize(int count) {
+    xmin.resize(count);
+    ymin.resize(count);
+    xmax.resize(count);
+    ymax.resize(count);
+    area.resize(count);
+}
+
+void BoxArray::CopyBox(int dst_index, const BoxArray &src, int index) {
+    xmin[dst_index] = src.xmin[index];
+    ymin[dst_index] = src.ymin[index];
+    xmax[dst_index] = src.xmax[index];
+    ymax[dst_index] = src.ymax[index];
+    area[dst_index] = src.area[index];
+}
+
+void BoxArray::SwapBox(int i, int j) {
+    std::swap(xmin[i], xmin[j]);
+    std::swap(ymin[i], ymin[j]);
+    std::swap(xmax[i], xmax[j]);
+    std::swap(ymax[i], ymax[j]);
+    std::swap(area[i], area[j]);
+}
+
+static inline void SetBox(BoxArray &boxes, int i, float xmin, float ymin, float xmax, float ymax) {
+    boxes.xmin[i] = xmin;
+    boxes.ymin[i] = ymin;
+    boxes.xmax[i] = xmax;
+    boxes.ymax[i] = ymax;
+    boxes.area[i] = (xmax < xmin || ymax < ymin) ? 0.f : (xmax - xmin) * (ymax - ymin);
+}
+
+// score descending, equal scores in label and prior order as a stable sort would leave them
+static inline bool ScoreGreater(const Detection &a, const Detection &b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    if (a.label != b.label) {
+        return a.label < b.label;
+    }
+    return a.index < b.index;
+}
+
+static inline bool LabelLess(const Detection &a, const Detection &b) {
+    return a.label < b.label;
+}
+
+// sort by score and keep the top_k first, -1 keeps all
+static void KeepTopK(std::vector<Detection> &detections, int top_k) {
+    if (top_k > -1 && top_k < (int)detections.size()) {
+        std::nth_element(detections.begin(), detections.begin() + top_k, detections.end(), ScoreGreater);
+        detections.resize(top_k);
+    }
+    std::sort(detections.begin(), detections.end(), ScoreGreater);
+}
+
+// iou[j - begin] = iou of box i of boxes and box j of others for j in [begin, end),
+// in the float steps of JaccardOverlap so that the nms decisions match it
+static void ComputeIoU(const BoxArray &boxes, int i, const BoxArray &others, int begin, int end, float *iou) {
+    typedef VecF::F F;
+    const float xmin = boxes.xmin[i], ymin = boxes.ymin[i];
+    const float xmax = boxes.xmax[i], ymax = boxes.ymax[i];
+    const float area = boxes.area[i];
+
+    F v_xmin = VecF::Set(xmin), v_ymin = VecF::Set(ymin);
+    F v_xmax = VecF::Set(xmax), v_ymax = VecF::Set(ymax);
+    F v_area = VecF::Set(area);
+    F v_zero = VecF::Set(0.f);
+    int j    = begin;
+    for (; j + VecF::kWidth <= end; j += VecF::kWidth) {
+        F w     = VecF::Sub(VecF::Min(v_xmax, VecF::Load(&others.xmax[j])), VecF::Max(v_xmin, VecF::Load(&others.xmin[j])));
+        F h     = VecF::Sub(VecF::Min(v_ymax, VecF::Load(&others.ymax[j])), VecF::Max(v_ymin, VecF::Load(&others.ymin[j])));
+        F inter = VecF::Mul(w, h);
+        F uni   = VecF::Sub(VecF::Add(v_area, VecF::Load(&others.area[j])), inter);
+        F valid = VecF::And(VecF::Less(v_zero, w), VecF::Less(v_zero, h));
+        VecF::Save(iou + j - begin, VecF::Select(valid, VecF::Div(inter, uni), v_zero));
+    }
+    for (; j < end; j++) {
+        float w = std::min(xmax, others.xmax[j]) - std::max(xmin, others.xmin[j]);
+        float h = std::min(ymax, others.ymax[j]) - std::max(ymin, others.ymin[j]);
+        if (w > 0 && h > 0) {
+            float inter    = w * h;
+            iou[j - begin] = inter / (area + others.area[j] - inter);
+        } else {
+            iou[j - begin] = 0.f;
+        }
+    }
+}
+
+// whether box i of boxes overlaps one of the first count of kept by more than threshold
+static bool Overlaps(const BoxArray &boxes, int i, const BoxArray &kept, int count, float threshold, float *iou) {
+    for (int begin = 0; begin < count; begin += kNMSChunk) {
+        int end = std::min(count, begin + kNMSChunk);
+        ComputeIoU(boxes, i, kept, begin, end, iou);
+        for (int k = 0; k < end - begin; k++) {
+            if (!(iou[k] <= threshold)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+// one pass over the priors per loc class, variances of 1 leave the target encoded offsets unscaled
+static void DecodeBoxes(const float *loc, int loc_stride, const BoxArray &priors, const float *variances,
+                        int code_type, bool variance_encoded_in_target, int count, BoxArray &boxes) {
+    for (int p = 0; p < count; p++, loc += loc_stride) {
+        const float *var = variances + p * 4;
+        float v0 = 1.f, v1 = 1.f, v2 = 1.f, v3 = 1.f;
+        if (!variance_encoded_in_target) {
+            v0 = var[0];
+            v1 = var[1];
+            v2 = var[2];
+            v3 = var[3];
+        }
+        const float prior_xmin = priors.xmin[p], prior_ymin = priors.ymin[p];
+        const float prior_xmax = priors.xmax[p], prior_ymax = priors.ymax[p];
+
+        float xmin, ymin, xmax, ymax;
+        if (code_type == PriorBoxParameter_CodeType_CORNER) {
+            xmin = prior_xmin + v0 * loc[0];
+            ymin = prior_ymin + v1 * loc[1];
+            xmax = prior_xmax + v2 * loc[2];
+            ymax = prior_ymax + v3 * loc[3];
+        } else if (code_type == PriorBoxParameter_CodeType_CENTER_SIZE) {
+            float prior_width    = prior_xmax - prior_xmin;
+            float prior_height   = prior_ymax - prior_ymin;
+            float prior_center_x = (prior_xmin + prior_xmax) / 2.f;
+            float prior_center_y = (prior_ymin + prior_ymax) / 2.f;
+            float center_x       = v0 * loc[0] * prior_width + prior_center_x;
+            float center_y       = v1 * loc[1] * prior_height + prior_center_y;
+            float width          = std::exp(v2 * loc[2]) * prior_width;
+            float height         = std::exp(v3 * loc[3]) * prior_height;
+            xmin                 = center_x - width / 2.f;
+            ymin                 = center_y - height / 2.f;
+            xmax                 = center_x + width / 2.f;
+            ymax                 = center_y + height / 2.f;
+        } else {
+            float prior_width  = prior_xmax - prior_xmin;
+            float prior_height = prior_ymax - prior_ymin;
+            xmin               = prior_xmin + v0 * loc[0] * prior_width;
+            ymin               = prior_ymin + v1 * loc[1] * prior_height;
+            xmax               = prior_xmax + v2 * loc[2] * prior_width;
+            ymax               = prior_ymax + v3 * loc[3] * prior_height;
+        }
+        SetBox(boxes, p, xmin, ymin, xmax, ymax);
+    }
+}
+
+const BoxArray &DetectionPostProcessor::LabelBoxes(int label, DetectionOutputLayerParam *param) {
+    return boxes_[param->share_location ? 0 : label];
+}
+
+void DetectionPostProcessor::DecodeImage(const float *loc_data, const float *arm_loc_data,
+                                         DetectionOutputLayerParam *param) {
+    const int num_loc_classes = (int)boxes_.size();
+    const BoxArray *priors    = &priors_;
+    if (arm_loc_data) {
+        refined_priors_.Resize(num_priors_);
+        DecodeBoxes(arm_loc_data, num_loc_classes * 4, priors_, variances_, param->code_type,
+                    param->variance_encoded_in_target, num_priors_, refined_priors_);
+        priors = &refined_priors_;
+    }
+    for (int c = 0; c < num_loc_classes; c++) {
+        int label = param->share_location ? -1 : c;
+        if (label == param->background_label_id) {
+            continue;
+        }
+        boxes_[c].Resize(num_priors_);
+        DecodeBoxes(loc_data + c * 4, num_loc_classes * 4, *priors, variances_, param->code_type,
+                    param->variance_encoded_in_target, num_priors_, boxes_[c]);
+    }
+}
+
+void DetectionPostProcessor::ScoreImage(const float *conf_data, const float *arm_conf_data,
+                                        DetectionOutputLayerParam *param) {
+    const int num_classes = param->num_classes;
+    scores_.resize(num_classes * num_priors_);
+    // [prior][class] to [class][prior], each class is then scanned contiguously
+    PermuteUtils::Transpose(conf_data, scores_.data(), num_priors_, num_classes, num_classes, num_priors_,
+                            sizeof(float));
+    if (arm_conf_data) {
+        for (int p = 0; p < num_priors_; p++) {
+            if (arm_conf_data[p * 2 + 1] < kObjectnessScore) {
+                for (int c = 0; c < num_classes; c++) {
+                    scores_[c * num_priors_ + p] = c == 0 ? 1.f : 0.f;
+                }
+            }
+        }
+    }
+}
+
+void DetectionPostProcessor::SelectCandidates(int label, float threshold, std::vector<Detection> &candidates) {
+    const float *scores = scores_.data() + label * num_priors_;
+    for (int p = 0; p < num_priors_; p++) {
+        if (scores[p] > threshold) {
+            Detection detection = {scores[p], label, p};
+            candidates.push_back(detection);
+        }
+    }
+}
+
+void DetectionPostProcessor::ApplyNMS(NMSScratch &scratch, DetectionOutputLayerParam *param,
+                                      std::vector<Detection> &detections) {
+    auto &candidates = scratch.candidates;
+    auto &boxes      = scratch.candidate_boxes;
+    const int count  = (int)candidates.size();
+    boxes.Resize(count);
+    for (int j = 0; j < count; j++) {
+        boxes.CopyBox(j, LabelBoxes(candidates[j].label, param), candidates[j].index);
+    }
+
+    const float nms_threshold = param->nms_param.nms_threshold;
+    if (param->nms_type == NMSTypeHard) {
+        // a candidate is kept if no kept box overlaps it, the threshold shrinks by eta after each kept box
+        auto &kept = scratch.kept_boxes;
+        kept.Resize(count);
+        scratch.iou.resize(kNMSChunk);
+        float adaptive_threshold = nms_threshold;
+        int kept_count           = 0;
+        for (int j = 0; j < count; j++) {
+            if (Overlaps(boxes, j, kept, kept_count, adaptive_threshold, scratch.iou.data())) {
+                continue;
+            }
+            kept.CopyBox(kept_count++, boxes, j);
+            detections.push_back(candidates[j]);
+            if (param->eta < 1 && adaptive_threshold > 0.5) {
+                adaptive_threshold *= param->eta;
+            }
+        }
+        return;
+    }
+
+    // soft nms: keep the best remaining candidate, decay the scores of the rest by their overlap with it
+    // and drop the ones that fall to the confidence threshold
+    scratch.iou.resize(count);
+    const float score_threshold = param->confidence_threshold;
+    const bool gaussian         = param->nms_type == NMSTypeSoftGaussian;
+    int end                     = count;
+    for (int i = 0; i < end; i++) {
+        int best = i;
+        for (int j = i + 1; j < end; j++) {
+            if (ScoreGreater(candidates[j], candidates[best])) {
+                best = j;
+            }
+        }
+        std::swap(candidates[i], candidates[best]);
+        boxes.SwapBox(i, best);
+        detections.push_back(candidates[i]);
+
+        ComputeIoU(boxes, i, boxes, i + 1, end, scratch.iou.data());
+        int next = i + 1;
+        for (int j = i + 1; j < end; j++) {
+            float iou   = scratch.iou[j - i - 1];
+            float decay = gaussian ? std::exp(-iou * iou / param->soft_nms_sigma)
+                                   : (iou > nms_threshold ? 1.f - iou : 1.f);
+            float score = candidates[j].score * decay;
+            if (score > score_threshold) {
+                candidates[next]       = candidates[j];
+                candidates[next].score = score;
+                boxes.CopyBox(next, boxes, j);
+                next++;
+            }
+        }
+        end = next;
+    }
+}
+
+Status DetectionPostProcessor::CheckParam(DetectionOutputLayerParam *param) {
+    if (param->nms_type != NMSTypeHard && param->nms_type != NMSTypeSoftLinear &&
+        param->nms_type != NMSTypeSoftGaussian) {
+        LOGE("Error: detection output nms_type %d is unsupported\n", param->nms_type);
+        return Status(TNNERR_PARAM_ERR, "detection output nms_type is unsupported");
+    }
+    if (param->nms_type == NMSTypeSoftGaussian && !(param->soft_nms_sigma > 0)) {
+        LOGE("Error: detection output soft_nms_sigma %f must be positive\n", param->soft_nms_sigma);
+        return Status(TNNERR_PARAM_ERR, "detection output soft_nms_sigma must be positive");
+    }
+    return TNN_OK;
+}
+
+Status DetectionPostProcessor::Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                                       DetectionOutputLayerParam *param) {
+    if (inputs.size() < 3 || outputs.empty()) {
+        LOGE("Error: detection output needs loc, conf and prior inputs\n");
+        return Status(TNNERR_PARAM_ERR, "detection output needs loc, conf and prior inputs");
+    }
+    const int num             = inputs[0]->GetBlobDesc().dims[0];
+    const int num_classes     = param->num_classes;
+    const int num_loc_classes = param->share_location ? 1 : num_classes;
+    num_priors_               = inputs[2]->GetBlobDesc().dims[2] / 4;
+
+    const float *loc_data      = static_cast<const float *>(inputs[0]->GetHandle().base);
+    const float *conf_data     = static_cast<const float *>(inputs[1]->GetHandle().base);
+    const float *prior_data    = static_cast<const float *>(inputs[2]->GetHandle().base);
+    const float *arm_conf_data = inputs.size() >= 4 ? static_cast<const float *>(inputs[3]->GetHandle().base) : nullptr;
+    const float *arm_loc_data  = inputs.size() >= 5 ? static_cast<const float *>(inputs[4]->GetHandle().base) : nullptr;
+
+    priors_.Resize(num_priors_);
+    for (int p = 0; p < num_priors_; p++) {
+        const float *prior = prior_data + p * 4;
+        SetBox(priors_, p, prior[0], prior[1], prior[2], prior[3]);
+    }
+    variances_ = prior_data + num_priors_ * 4;
+    boxes_.resize(num_loc_classes);
+    class_detections_.resize(num_classes);
+    thread_scratch_.resize(OMP_MAX_THREADS_NUM_);
+    rows_.clear();
+
+    const int loc_size = num_priors_ * num_loc_classes * 4;
+    for (int n = 0; n < num; n++) {
+        DecodeImage(loc_data + n * loc_size, arm_loc_data ? arm_loc_data + n * loc_size : nullptr, param);
+        ScoreImage(conf_data + n * num_priors_ * num_classes,
+                   arm_conf_data ? arm_conf_data + n * num_priors_ * 2 : nullptr, param);
+
+        image_detections_.clear();
+        if (param->class_agnostic) {
+            auto &scratch = thread_scratch_[0];
+            scratch.candidates.clear();
+            for (int c = 0; c < num_classes; c++) {
+                if (c != param->background_label_id) {
+                    SelectCandidates(c, param->confidence_threshold, scratch.candidates);
+                }
+            }
+            KeepTopK(scratch.candidates, param->nms_param.top_k);
+            ApplyNMS(scratch, param, image_detections_);
+        } else {
+            OMP_PARALLEL_FOR_DYNAMIC_
+            for (int c = 0; c < num_classes; c++) {
+                auto &detections = class_detections_[c];
+                detections.clear();
+                if (c == param->background_label_id) {
+                    continue;
+                }
+                auto &scratch = thread_scratch_[OMP_TID_];
+                scratch.candidates.clear();
+                SelectCandidates(c, param->confidence_threshold, scratch.candidates);
+                KeepTopK(scratch.candidates, param->nms_param.top_k);
+                ApplyNMS(scratch, param, detections);
+            }
+            for (int c = 0; c < num_classes; c++) {
+                image_detections_.insert(image_detections_.end(), class_detections_[c].begin(),
+                                         class_detections_[c].end());
+            }
+        }
+
+        if (param->keep_top_k > -1 && (int)image_detections_.size() > param->keep_top_k) {
+            KeepTopK(image_detections_, param->keep_top_k);
+        }
+        // rows are grouped by label, in nms order within a label
+        std::stable_sort(image_detections_.begin(), image_detections_.end(), LabelLess);
+        for (const auto &detection : image_detections_) {
+            const BoxArray &boxes = LabelBoxes(detection.label, param);
+            const int p           = detection.index;
+            const float row[7]    = {static_cast<float>(n), static_cast<float>(detection.label), detection.score,
+                                  boxes.xmin[p], boxes.ymin[p], boxes.xmax[p], boxes.ymax[p]};
+            rows_.insert(rows_.end(), row, row + 7);
+        }
+    }
+
+    Blob *output_blob = outputs[0];
+    float *top_data   = static_cast<float *>(output_blob->GetHandle().base);
+    const int num_kept = (int)rows_.size() / 7;
+    if (num_kept == 0) {
+        // one fake row of -1 per image
+        const int count = DimsVectorUtils::Count(output_blob->GetBlobDesc().dims);
+        for (int i = 0; i < count; i++) {
+            top_data[i] = -1.f;
+        }
+        output_blob->GetBlobDesc().dims[2] = num;
+        for (int i = 0; i < num; i++) {
+            top_data[i * 7] = static_cast<float>(i);
+        }
+    } else {
+        output_blob->GetBlobDesc().dims[2] = num_kept;
+        memcpy(top_data, rows_.data(), rows_.size() * sizeof(float));
+    }
+    return TNN_OK;
+}
+
+}  // namespace TNN_NS
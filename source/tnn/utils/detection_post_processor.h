@@ -0,0 +1,93 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_DETECTION_POST_PROCESSOR_H_
+#define TNN_SOURCE_TNN_UTILS_DETECTION_POST_PROCESSOR_H_
+
+#include <vector>
+
+#include "tnn/core/blob.h"
+#include "tnn/core/status.h"
+#include "tnn/interpreter/layer_param.h"
+
+namespace TNN_NS {
+
+// boxes in structure of arrays, the area of a box with xmax < xmin or ymax < ymin is 0
+struct BoxArray {
+    std::vector<float> xmin;
+    std::vector<float> ymin;
+    std::vector<float> xmax;
+    std::vector<float> ymax;
+    std::vector<float> area;
+
+    void Resize(int count);
+    // copy box index of src to box dst_index
+    void CopyBox(int dst_index, const BoxArray &src, int index);
+    void SwapBox(int i, int j);
+};
+
+// one detection of an image, index is the prior of the box
+struct Detection {
+    float score;
+    int label;
+    int index;
+};
+
+// decode, nms and keep top k of ssd style detection outputs. the buffers are kept across
+// forwards, an instance reused for the same shapes does not allocate
+class DetectionPostProcessor {
+public:
+    // @brief TNNERR_PARAM_ERR for an unknown nms_type or a soft_nms_sigma the gaussian decay can not divide by
+    static Status CheckParam(DetectionOutputLayerParam *param);
+
+    // @brief inputs are loc, conf, prior and optionally the arm conf and arm loc of refinedet,
+    // outputs[0] gets rows of [image_id, label, score, xmin, ymin, xmax, ymax]
+    Status Forward(const std::vector<Blob *> &inputs, const std::vector<Blob *> &outputs,
+                   DetectionOutputLayerParam *param);
+
+private:
+    struct NMSScratch {
+        std::vector<Detection> candidates;
+        BoxArray candidate_boxes;
+        BoxArray kept_boxes;
+        std::vector<float> iou;
+    };
+
+    void DecodeImage(const float *loc_data, const float *arm_loc_data, DetectionOutputLayerParam *param);
+    void ScoreImage(const float *conf_data, const float *arm_conf_data, DetectionOutputLayerParam *param);
+    void SelectCandidates(int label, float threshold, std::vector<Detection> &candidates);
+    void ApplyNMS(NMSScratch &scratch, DetectionOutputLayerParam *param, std::vector<Detection> &detections);
+    const BoxArray &LabelBoxes(int label, DetectionOutputLayerParam *param);
+
+    int num_priors_ = 0;
+    BoxArray priors_;
+    // [prior][4] after the prior boxes in the prior blob
+    const float *variances_ = nullptr;
+    // priors moved by the arm loc of refinedet
+    BoxArray refined_priors_;
+    // decoded boxes of the current image, one array per loc class
+    std::vector<BoxArray> boxes_;
+    // scores of the current image in [class][prior]
+    std::vector<float> scores_;
+    // nms results of the current image per class
+    std::vector<std::vector<Detection>> class_detections_;
+    std::vector<Detection> image_detections_;
+    std::vector<NMSScratch> thread_scratch_;
+    // output rows of all images
+    std::vector<float> rows_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_DETECTION_POST_PROCESSOR_H_
@@ -0,0 +1,84 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/fused_elementwise_utils.h"
+
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+// constants only broadcast into the running value, NetOptimizerFuseElementwise never fuses one that grows it
+static Status GetConstantShape(const DimsVector &origin, int count, const DimsVector &dims, DimsVector &shape,
+                               int &type) {
+    shape = origin;
+    if (shape.size() < 4) {
+        shape = {1, 1, 1, 1};
+        if (count == 1) {
+            // single element
+        } else if (count == dims[1]) {
+            shape[1] = count;
+        } else if (count == DimsVectorUtils::Count(dims, 1)) {
+            shape[1] = dims[1];
+            shape[2] = dims[2];
+            shape[3] = dims[3];
+        } else if (count == dims[3]) {
+            shape[3] = count;
+        } else {
+            LOGE("Error: unsupported broadcast type of fused elementwise constant\n");
+            return Status(TNNERR_LAYER_ERR, "Error: unsupported broadcast type of fused elementwise constant");
+        }
+    }
+
+    if (DimsVectorUtils::Count(shape) == 1) {
+        type = BroadcastTypeSingle;
+    } else if (DimsVectorUtils::Equal(shape, dims)) {
+        type = BroadcastTypeNormal;
+    } else if (shape[0] == 1 && DimsVectorUtils::Equal(shape, dims, 1)) {
+        type = BroadcastTypeElement;
+    } else if (shape[0] == 1 && shape[1] == dims[1] && DimsVectorUtils::Count(shape, 2) == 1) {
+        type = BroadcastTypeChannel;
+    } else if (DimsVectorUtils::Count(shape, 0, 3) == 1 && shape[3] == dims[3]) {
+        type = BroadcastTypeWidth;
+    } else {
+        LOGE("Error: unsupported broadcast type of fused elementwise constant\n");
+        return Status(TNNERR_LAYER_ERR, "Error: unsupported broadcast type of fused elementwise constant");
+    }
+    return TNN_OK;
+}
+
+Status FusedElementwiseUtils::GetConstantBroadcast(FusedElementwiseLayerResource *resource, const DimsVector &dims,
+                                                   std::vector<DimsVector> &shapes, std::vector<int> &types) {
+    shapes.clear();
+    types.clear();
+    if (!resource) {
+        return TNN_OK;
+    }
+    if (dims.size() != 4) {
+        LOGE("Error: fused elementwise layer only supports 4 dims\n");
+        return Status(TNNERR_LAYER_ERR, "Error: fused elementwise layer only supports 4 dims");
+    }
+    for (int i = 0; i < resource->constant_handles.size(); i++) {
+        DimsVector shape;
+        int type = BroadcastTypeUnknown;
+        RETURN_ON_NEQ(GetConstantShape(resource->constant_shapes[i], resource->constant_handles[i].GetDataCount(),
+                                       dims, shape, type),
+                      TNN_OK);
+        shapes.push_back(shape);
+        types.push_back(type);
+    }
+    return TNN_OK;
+}
+
+}  // namespace TNN_NS
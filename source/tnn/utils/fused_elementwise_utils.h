@@ -0,0 +1,37 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_FUSED_ELEMENTWISE_UTILS_H_
+#define TNN_SOURCE_TNN_UTILS_FUSED_ELEMENTWISE_UTILS_H_
+
+#include <vector>
+
+#include "tnn/core/common.h"
+#include "tnn/core/status.h"
+#include "tnn/interpreter/layer_resource.h"
+
+namespace TNN_NS {
+
+class FusedElementwiseUtils {
+public:
+    // @brief normalizes the shape of every constant of a fused elementwise layer to 4 dims against dims, the
+    // shape of the running value, and returns the BroadcastType each one is read with. The resource may be
+    // shared by several networks and is not written.
+    static Status GetConstantBroadcast(FusedElementwiseLayerResource *resource, const DimsVector &dims,
+                                       std::vector<DimsVector> &shapes, std::vector<int> &types);
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_FUSED_ELEMENTWISE_UTILS_H_
@@ -0,0 +1,246 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/layer_cost_utils.h"
+
+#include <algorithm>
+
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+static double KernelSize(const std::vector<int> &kernels) {
+    double size = 1;
+    for (auto kernel : kernels) {
+        size *= kernel;
+    }
+    return size;
+}
+
+static double ConvMacs(ConvLayerParam *conv_param, const DimsVector &input_dim, const DimsVector &output_dim) {
+    if (!conv_param || input_dim.size() < 2) {
+        return 0;
+    }
+    double input_channel = input_dim[1] / std::max(conv_param->group, 1);
+    return DimsVectorUtils::Count(output_dim) * input_channel * KernelSize(conv_param->kernels);
+}
+
+static double DeconvMacs(ConvLayerParam *conv_param, const DimsVector &input_dim, const DimsVector &output_dim) {
+    if (!conv_param || output_dim.size() < 2) {
+        return 0;
+    }
+    // each input pixel scatters a kernel into output_channel / group outputs
+    double output_channel = output_dim[1] / std::max(conv_param->group, 1);
+    return DimsVectorUtils::Count(input_dim) * output_channel * KernelSize(conv_param->kernels);
+}
+
+static double InnerProductMacs(InnerProductLayerParam *ip_param, const DimsVector &input_dim) {
+    if (!ip_param) {
+        return 0;
+    }
+    double batch = DimsVectorUtils::Count(input_dim, 0, ip_param->axis);
+    double k     = DimsVectorUtils::Count(input_dim, ip_param->axis);
+    return batch * k * ip_param->num_output;
+}
+
+double GetLayerMacs(LayerType type, LayerParam *param, const std::vector<DimsVector> &input_dims,
+                    const std::vector<DimsVector> &output_dims) {
+    if (input_dims.empty() || output_dims.empty()) {
+        return 0;
+    }
+    double macs = 0;
+    switch (type) {
+        case LAYER_CONVOLUTION:
+        case LAYER_CONVOLUTION_DEPTHWISE:
+        case LAYER_CONVOLUTION_3D:
+            macs = ConvMacs(dynamic_cast<ConvLayerParam *>(param), input_dims[0], output_dims[0]);
+            break;
+        case LAYER_DECONVOLUTION:
+            macs = DeconvMacs(dynamic_cast<ConvLayerParam *>(param), input_dims[0], output_dims[0]);
+            break;
+        case LAYER_INNER_PRODUCT:
+            macs = InnerProductMacs(dynamic_cast<InnerProductLayerParam *>(param), input_dims[0]);
+            break;
+        default:
+            break;
+    }
+    return macs / 1000.0 / 1000.0;
+}
+
+static double PoolingFlops(PoolingLayerParam *pool_param, const DimsVector &input_dim, const DimsVector &output_dim) {
+    double kernel_size = pool_param ? KernelSize(pool_param->kernels) : 0;
+    // global pooling has zero sized kernels, every input is read once
+    if (kernel_size <= 0) {
+        return DimsVectorUtils::Count(input_dim);
+    }
+    return DimsVectorUtils::Count(output_dim) * kernel_size;
+}
+
+double GetLayerFlops(LayerType type, LayerParam *param, LayerResource *resource,
+                     const std::vector<DimsVector> &input_dims, const std::vector<DimsVector> &output_dims) {
+    if (input_dims.empty() || output_dims.empty()) {
+        return 0;
+    }
+    const auto &input_dim  = input_dims[0];
+    const auto &output_dim = output_dims[0];
+    double output_count    = DimsVectorUtils::Count(output_dim);
+
+    double flops = 0;
+    switch (type) {
+        case LAYER_CONVOLUTION:
+        case LAYER_CONVOLUTION_DEPTHWISE:
+        case LAYER_CONVOLUTION_3D:
+        case LAYER_DECONVOLUTION: {
+            auto conv_param = dynamic_cast<ConvLayerParam *>(param);
+            flops           = 2.0 * GetLayerMacs(type, param, input_dims, output_dims) * 1000.0 * 1000.0;
+            if (conv_param && conv_param->bias) {
+                flops += output_count;
+            }
+            break;
+        }
+        case LAYER_INNER_PRODUCT: {
+            auto ip_param = dynamic_cast<InnerProductLayerParam *>(param);
+            flops         = 2.0 * GetLayerMacs(type, param, input_dims, output_dims) * 1000.0 * 1000.0;
+            if (ip_param && ip_param->has_bias) {
+                flops += output_count;
+            }
+            break;
+        }
+        case LAYER_POOLING:
+        case LAYER_POOLING_3D:
+            flops = PoolingFlops(dynamic_cast<PoolingLayerParam *>(param), input_dim, output_dim);
+            break;
+        case LAYER_ADD:
+        case LAYER_SUB:
+        case LAYER_MUL:
+        case LAYER_DIV:
+        case LAYER_MAXIMUM:
+        case LAYER_MINIMUM:
+        case LAYER_HARDSWISH:
+        case LAYER_SIGNED_MUL: {
+            // n inputs need n - 1 ops per output, a single input is combined with a weight
+            int op_count = std::max((int)input_dims.size() - 1, 1);
+            flops        = output_count * op_count;
+            break;
+        }
+        case LAYER_FUSED_ELEMENTWISE: {
+            auto fused_param = dynamic_cast<FusedElementwiseLayerParam *>(param);
+            flops            = output_count * (fused_param ? fused_param->ops.size() : 1);
+            break;
+        }
+        case LAYER_BATCH_NORM:
+        case LAYER_SCALE:
+            flops = 2.0 * output_count;
+            break;
+        case LAYER_RELU:
+        case LAYER_RELU6:
+        case LAYER_PRELU:
+        case LAYER_CLIP:
+        case LAYER_SIGMOID:
+        case LAYER_TANH:
+        case LAYER_HARDSIGMOID:
+        case LAYER_ELU:
+        case LAYER_SELU:
+        case LAYER_EXP:
+        case LAYER_LOG:
+        case LAYER_SQRT:
+        case LAYER_ABS:
+        case LAYER_NEG:
+            flops = output_count;
+            break;
+        case LAYER_SOFTMAX:
+            // max, subtract, exp, sum and divide for every element
+            flops = 5.0 * DimsVectorUtils::Count(input_dim);
+            break;
+        case LAYER_REDUCE_SUM:
+        case LAYER_REDUCE_MEAN:
+        case LAYER_REDUCE_MAX:
+        case LAYER_REDUCE_MIN:
+        case LAYER_REDUCE_PROD:
+        case LAYER_REDUCE_L1:
+        case LAYER_REDUCE_L2:
+        case LAYER_REDUCE_LOG_SUM:
+        case LAYER_REDUCE_LOG_SUM_EXP:
+        case LAYER_REDUCE_SUM_SQUARE:
+            flops = DimsVectorUtils::Count(input_dim);
+            break;
+        default:
+            break;
+    }
+    return flops / 1000.0 / 1000.0;
+}
+
+double GetLayerBandwidth(LayerType type, LayerParam *param, const std::vector<DimsVector> &input_dims,
+                         const std::vector<DimsVector> &output_dims, DataType data_type, double weight_bytes) {
+    double data_type_size = DataTypeUtils::GetBytesSize(data_type);
+    double bytes          = weight_bytes;
+    for (const auto &dims : input_dims) {
+        bytes += DimsVectorUtils::Count(dims) * data_type_size;
+    }
+    for (const auto &dims : output_dims) {
+        bytes += DimsVectorUtils::Count(dims) * data_type_size;
+    }
+    return bytes / 1000.0 / 1000.0;
+}
+
+// the accs expand half weights to float when they load the resource
+static double HandleBytes(RawBuffer &handle, bool runtime) {
+    if (runtime && handle.GetDataType() == DATA_TYPE_HALF) {
+        return (double)handle.GetDataCount() * sizeof(float);
+    }
+    return handle.GetBytesSize();
+}
+
+static double ResourceBytes(LayerResource *resource, bool runtime) {
+    double bytes = 0;
+    if (auto conv_resource = dynamic_cast<ConvLayerResource *>(resource)) {
+        bytes += HandleBytes(conv_resource->filter_handle, runtime) +
+                 HandleBytes(conv_resource->bias_handle, runtime) + HandleBytes(conv_resource->scale_handle, runtime);
+    } else if (auto ip_resource = dynamic_cast<InnerProductLayerResource *>(resource)) {
+        bytes += HandleBytes(ip_resource->weight_handle, runtime) + HandleBytes(ip_resource->bias_handle, runtime) +
+                 HandleBytes(ip_resource->scale_handle, runtime);
+    } else if (auto bn_resource = dynamic_cast<BatchNormLayerResource *>(resource)) {
+        bytes += HandleBytes(bn_resource->scale_handle, runtime) + HandleBytes(bn_resource->bias_handle, runtime);
+    } else if (auto prelu_resource = dynamic_cast<PReluLayerResource *>(resource)) {
+        bytes += HandleBytes(prelu_resource->slope_handle, runtime);
+    } else if (auto eltwise_resource = dynamic_cast<EltwiseLayerResource *>(resource)) {
+        bytes += HandleBytes(eltwise_resource->element_handle, runtime);
+    } else if (auto fused_resource = dynamic_cast<FusedElementwiseLayerResource *>(resource)) {
+        for (auto &handle : fused_resource->constant_handles) {
+            bytes += HandleBytes(handle, runtime);
+        }
+    } else if (auto scale_resource = dynamic_cast<IntScaleResource *>(resource)) {
+        bytes += HandleBytes(scale_resource->scale_handle, runtime) + HandleBytes(scale_resource->bias_handle, runtime);
+    } else if (auto const_resource = dynamic_cast<ConstLayerResource *>(resource)) {
+        bytes += HandleBytes(const_resource->weight_handle, runtime);
+    } else if (auto hdr_resource = dynamic_cast<HdrGuideLayerResource *>(resource)) {
+        bytes += HandleBytes(hdr_resource->ccm_weight_handle, runtime) +
+                 HandleBytes(hdr_resource->ccm_bias_handle, runtime) +
+                 HandleBytes(hdr_resource->shifts_handle, runtime) + HandleBytes(hdr_resource->slopes_handle, runtime) +
+                 HandleBytes(hdr_resource->projection_weight_handle, runtime) +
+                 HandleBytes(hdr_resource->projection_bias_handle, runtime);
+    }
+    return bytes;
+}
+
+double GetLayerResourceBytes(LayerResource *resource) {
+    return ResourceBytes(resource, false);
+}
+
+double GetLayerRuntimeResourceBytes(LayerResource *resource) {
+    return ResourceBytes(resource, true);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,51 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_LAYER_COST_UTILS_H_
+#define TNN_SOURCE_TNN_UTILS_LAYER_COST_UTILS_H_
+
+#include <vector>
+
+#include "tnn/core/common.h"
+#include "tnn/core/layer_type.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+
+namespace TNN_NS {
+
+// @brief mega multiply-accumulates of one forward for conv, deconv and inner product, 0 for other layers
+double GetLayerMacs(LayerType type, LayerParam *param, const std::vector<DimsVector> &input_dims,
+                    const std::vector<DimsVector> &output_dims);
+
+// @brief mega flops of one forward, a multiply-add counts as two flops. fast algorithms such as
+// winograd are counted as the direct algorithm, so the achieved GFLOP/s of different conv
+// implementations stay comparable. layers without arithmetic return 0.
+double GetLayerFlops(LayerType type, LayerParam *param, LayerResource *resource,
+                     const std::vector<DimsVector> &input_dims, const std::vector<DimsVector> &output_dims);
+
+// @brief mega bytes moved by one forward: all inputs and outputs once plus the weights
+// @param weight_bytes bytes of the weights one forward reads, the packed weights of the acc if it packs them,
+// GetLayerRuntimeResourceBytes otherwise
+double GetLayerBandwidth(LayerType type, LayerParam *param, const std::vector<DimsVector> &input_dims,
+                         const std::vector<DimsVector> &output_dims, DataType data_type, double weight_bytes);
+
+// @brief bytes of the weights held by the resource, as stored in the model
+double GetLayerResourceBytes(LayerResource *resource);
+
+// @brief bytes of the weights held by the resource once loaded, half weights count as float
+double GetLayerRuntimeResourceBytes(LayerResource *resource);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_LAYER_COST_UTILS_H_
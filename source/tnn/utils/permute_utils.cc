@@ -0,0 +1,298 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "tnn/utils/permute_utils.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+
+#include "tnn/utils/omp_utils.h"
+
+#ifdef TNN_USE_NEON
+#include <arm_neon.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace TNN_NS {
+
+// rows and cols of one cache block, 32 x 32 floats of src and of dst stay in l1
+static const int kTransposeBlock = 32;
+
+template <typename T>
+static inline void TransposeScalar(const T *src, T *dst, int rows, int cols, int src_stride, int dst_stride) {
+    for (int c = 0; c < cols; c++) {
+        for (int r = 0; r < rows; r++) {
+            dst[c * dst_stride + r] = src[r * src_stride + c];
+        }
+    }
+}
+
+// full 4 x 4 tiles in registers, the ragged edges element by element
+template <typename T>
+static void TransposeBlock(const T *src, T *dst, int rows, int cols, int src_stride, int dst_stride) {
+    TransposeScalar(src, dst, rows, cols, src_stride, dst_stride);
+}
+
+#if defined(TNN_USE_NEON) || defined(__SSE2__)
+static inline void Transpose4x4(const float *src, float *dst, int src_stride, int dst_stride) {
+#ifdef TNN_USE_NEON
+    float32x4x2_t q01 = vtrnq_f32(vld1q_f32(src), vld1q_f32(src + src_stride));
+    float32x4x2_t q23 = vtrnq_f32(vld1q_f32(src + 2 * src_stride), vld1q_f32(src + 3 * src_stride));
+    vst1q_f32(dst, vcombine_f32(vget_low_f32(q01.val[0]), vget_low_f32(q23.val[0])));
+    vst1q_f32(dst + dst_stride, vcombine_f32(vget_low_f32(q01.val[1]), vget_low_f32(q23.val[1])));
+    vst1q_f32(dst + 2 * dst_stride, vcombine_f32(vget_high_f32(q01.val[0]), vget_high_f32(q23.val[0])));
+    vst1q_f32(dst + 3 * dst_stride, vcombine_f32(vget_high_f32(q01.val[1]), vget_high_f32(q23.val[1])));
+#else
+    __m128 r0 = _mm_loadu_ps(src);
+    __m128 r1 = _mm_loadu_ps(src + src_stride);
+    __m128 r2 = _mm_loadu_ps(src + 2 * src_stride);
+    __m128 r3 = _mm_loadu_ps(src + 3 * src_stride);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(dst, r0);
+    _mm_storeu_ps(dst + dst_stride, r1);
+    _mm_storeu_ps(dst + 2 * dst_stride, r2);
+    _mm_storeu_ps(dst + 3 * dst_stride, r3);
+#endif
+}
+
+// 4 byte elements move as float bits, the shuffles leave any pattern unchanged
+template <>
+void TransposeBlock(const float *src, float *dst, int rows, int cols, int src_stride, int dst_stride) {
+    int rows_4 = rows / 4 * 4;
+    int cols_4 = cols / 4 * 4;
+    for (int r = 0; r < rows_4; r += 4) {
+        for (int c = 0; c < cols_4; c += 4) {
+            Transpose4x4(src + r * src_stride + c, dst + c * dst_stride + r, src_stride, dst_stride);
+        }
+    }
+    TransposeScalar(src + cols_4, dst + cols_4 * dst_stride, rows, cols - cols_4, src_stride, dst_stride);
+    TransposeScalar(src + rows_4 * src_stride, dst + rows_4, rows - rows_4, cols_4, src_stride, dst_stride);
+}
+#endif
+
+// one task: rows [row_start, row_start + kTransposeBlock) of the plane, blocked along the cols
+template <typename T>
+static void TransposeRows(const T *src, T *dst, int rows, int cols, int src_stride, int dst_stride, int row_start) {
+    int row_count = std::min(kTransposeBlock, rows - row_start);
+    src += row_start * src_stride;
+    dst += row_start;
+    for (int c = 0; c < cols; c += kTransposeBlock) {
+        TransposeBlock(src + c, dst + c * dst_stride, row_count, std::min(kTransposeBlock, cols - c), src_stride,
+                       dst_stride);
+    }
+}
+
+template <typename T>
+static void Transpose(const T *src, T *dst, int batch, int src_batch_stride, int dst_batch_stride, int rows, int cols,
+                      int src_stride, int dst_stride) {
+    int row_blocks = UP_DIV(rows, kTransposeBlock);
+    int tasks      = batch * row_blocks;
+    OMP_PARALLEL_FOR_
+    for (int t = 0; t < tasks; t++) {
+        int b = t / row_blocks;
+        TransposeRows(src + b * src_batch_stride, dst + b * dst_batch_stride, rows, cols, src_stride, dst_stride,
+                      t % row_blocks * kTransposeBlock);
+    }
+}
+
+// offsets of every coordinate of dims in src and in dst
+static void EnumerateOffsets(const DimsVector &dims, const std::vector<int> &src_strides,
+                             const std::vector<int> &dst_strides, std::vector<int> &src_offsets,
+                             std::vector<int> &dst_offsets) {
+    src_offsets = {0};
+    dst_offsets = {0};
+    for (int d = 0; d < (int)dims.size(); d++) {
+        std::vector<int> src_next, dst_next;
+        for (size_t i = 0; i < src_offsets.size(); i++) {
+            for (int k = 0; k < dims[d]; k++) {
+                src_next.push_back(src_offsets[i] + k * src_strides[d]);
+                dst_next.push_back(dst_offsets[i] + k * dst_strides[d]);
+            }
+        }
+        src_offsets.swap(src_next);
+        dst_offsets.swap(dst_next);
+    }
+}
+
+// drops dims of size 1 and merges the src dims that stay adjacent and in order in dst
+static void MergeDims(const DimsVector &dims, const std::vector<int> &orders, DimsVector &merged_dims,
+                      std::vector<int> &merged_orders) {
+    std::vector<int> kept;
+    for (int o : orders) {
+        if (dims[o] != 1) {
+            kept.push_back(o);
+        }
+    }
+    // runs of consecutive src dims in dst order, each run is one merged dim
+    std::vector<std::pair<int, int>> runs;
+    for (int o : kept) {
+        if (!runs.empty() && runs.back().second == o - 1) {
+            runs.back().second = o;
+        } else {
+            runs.push_back(std::make_pair(o, o));
+        }
+    }
+    std::vector<std::pair<int, int>> sorted_runs = runs;
+    std::sort(sorted_runs.begin(), sorted_runs.end());
+    merged_dims.clear();
+    merged_orders.clear();
+    for (const auto &run : sorted_runs) {
+        int size = 1;
+        for (int d = run.first; d <= run.second; d++) {
+            size *= dims[d];
+        }
+        merged_dims.push_back(size);
+    }
+    for (const auto &run : runs) {
+        merged_orders.push_back(
+            (int)(std::lower_bound(sorted_runs.begin(), sorted_runs.end(), run) - sorted_runs.begin()));
+    }
+}
+
+template <typename T>
+static void Permute(const T *src, T *dst, const DimsVector &dims, const std::vector<int> &orders) {
+    int count = 1;
+    for (int d : dims) {
+        count *= d;
+    }
+
+    DimsVector merged_dims;
+    std::vector<int> merged_orders;
+    MergeDims(dims, orders, merged_dims, merged_orders);
+    int rank = (int)merged_dims.size();
+    if (rank <= 1) {
+        memcpy(dst, src, count * sizeof(T));
+        return;
+    }
+
+    std::vector<int> src_strides(rank, 1), dst_strides(rank, 1);
+    for (int d = rank - 2; d >= 0; d--) {
+        src_strides[d] = src_strides[d + 1] * merged_dims[d + 1];
+    }
+    // dst stride of each src dim
+    int stride = 1;
+    for (int i = rank - 1; i >= 0; i--) {
+        dst_strides[merged_orders[i]] = stride;
+        stride *= merged_dims[merged_orders[i]];
+    }
+
+    // the last src dim stays last: contiguous runs. otherwise the last src dim and the src dim that ends up
+    // last in dst span the plane that is transposed, merging leaves them apart
+    int row_dim = merged_orders[rank - 1];
+    int col_dim = rank - 1;
+    DimsVector outer_dims;
+    std::vector<int> outer_src_strides, outer_dst_strides;
+    for (int d = 0; d < rank; d++) {
+        if (d != row_dim && d != col_dim) {
+            outer_dims.push_back(merged_dims[d]);
+            outer_src_strides.push_back(src_strides[d]);
+            outer_dst_strides.push_back(dst_strides[d]);
+        }
+    }
+    std::vector<int> src_offsets, dst_offsets;
+    EnumerateOffsets(outer_dims, outer_src_strides, outer_dst_strides, src_offsets, dst_offsets);
+
+    if (row_dim == col_dim) {
+        int runs = (int)src_offsets.size();
+        OMP_PARALLEL_FOR_
+        for (int o = 0; o < runs; o++) {
+            memcpy(dst + dst_offsets[o], src + src_offsets[o], merged_dims[col_dim] * sizeof(T));
+        }
+        return;
+    }
+
+    int rows       = merged_dims[row_dim];
+    int cols       = merged_dims[col_dim];
+    int src_stride = src_strides[row_dim];
+    int dst_stride = dst_strides[col_dim];
+    int row_blocks = UP_DIV(rows, kTransposeBlock);
+    int tasks      = (int)src_offsets.size() * row_blocks;
+    OMP_PARALLEL_FOR_
+    for (int t = 0; t < tasks; t++) {
+        int o = t / row_blocks;
+        TransposeRows(src + src_offsets[o], dst + dst_offsets[o], rows, cols, src_stride, dst_stride,
+                      t % row_blocks * kTransposeBlock);
+    }
+}
+
+Status PermuteUtils::Permute(const void *src, void *dst, const DimsVector &dims, const std::vector<int> &orders,
+                             int element_size) {
+    if (orders.size() != dims.size()) {
+        LOGE("Error: permute orders do not match the dims\n");
+        return Status(TNNERR_PARAM_ERR, "permute orders do not match the dims");
+    }
+    std::vector<bool> used(dims.size(), false);
+    for (int o : orders) {
+        if (o < 0 || o >= (int)dims.size() || used[o]) {
+            LOGE("Error: invalid permute orders\n");
+            return Status(TNNERR_PARAM_ERR, "invalid permute orders");
+        }
+        used[o] = true;
+    }
+
+    switch (element_size) {
+        case 1:
+            TNN_NS::Permute(static_cast<const uint8_t *>(src), static_cast<uint8_t *>(dst), dims, orders);
+            break;
+        case 2:
+            TNN_NS::Permute(static_cast<const uint16_t *>(src), static_cast<uint16_t *>(dst), dims, orders);
+            break;
+        case 4:
+            TNN_NS::Permute(static_cast<const float *>(src), static_cast<float *>(dst), dims, orders);
+            break;
+        case 8:
+            TNN_NS::Permute(static_cast<const uint64_t *>(src), static_cast<uint64_t *>(dst), dims, orders);
+            break;
+        default:
+            LOGE("Error: permute does not support element size %d\n", element_size);
+            return Status(TNNERR_PARAM_ERR, "permute does not support the element size");
+    }
+    return TNN_OK;
+}
+
+Status PermuteUtils::Transpose(const void *src, void *dst, int rows, int cols, int src_stride, int dst_stride,
+                               int element_size) {
+    return Transpose(src, dst, 1, 0, 0, rows, cols, src_stride, dst_stride, element_size);
+}
+
+Status PermuteUtils::Transpose(const void *src, void *dst, int batch, int src_batch_stride, int dst_batch_stride,
+                               int rows, int cols, int src_stride, int dst_stride, int element_size) {
+    switch (element_size) {
+        case 1:
+            TNN_NS::Transpose(static_cast<const uint8_t *>(src), static_cast<uint8_t *>(dst), batch, src_batch_stride,
+                              dst_batch_stride, rows, cols, src_stride, dst_stride);
+            break;
+        case 2:
+            TNN_NS::Transpose(static_cast<const uint16_t *>(src), static_cast<uint16_t *>(dst), batch,
+                              src_batch_stride, dst_batch_stride, rows, cols, src_stride, dst_stride);
+            break;
+        case 4:
+            TNN_NS::Transpose(static_cast<const float *>(src), static_cast<float *>(dst), batch, src_batch_stride,
+                              dst_batch_stride, rows, cols, src_stride, dst_stride);
+            break;
+        case 8:
+            TNN_NS::Transpose(static_cast<const uint64_t *>(src), static_cast<uint64_t *>(dst), batch,
+                              src_batch_stride, dst_batch_stride, rows, cols, src_stride, dst_stride);
+            break;
+        default:
+            LOGE("Error: transpose does not support element size %d\n", element_size);
+            return Status(TNNERR_PARAM_ERR, "transpose does not support the element size");
+    }
+    return TNN_OK;
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,48 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_PERMUTE_UTILS_H_
+#define TNN_SOURCE_TNN_UTILS_PERMUTE_UTILS_H_
+
+#include <vector>
+
+#include "tnn/core/common.h"
+#include "tnn/core/macro.h"
+#include "tnn/core/status.h"
+
+namespace TNN_NS {
+
+class PermuteUtils {
+public:
+    // @brief reorder the dims of dense data, dim i of dst is dim orders[i] of src.
+    // dims of size 1 are dropped and dims that stay adjacent are merged, what is left runs as
+    // contiguous copies when the last dim stays last and as blocked 2d transposes otherwise
+    // @param element_size bytes of one element, 1, 2, 4 or 8
+    static Status Permute(const void *src, void *dst, const DimsVector &dims, const std::vector<int> &orders,
+                          int element_size);
+
+    // @brief dst[c * dst_stride + r] = src[r * src_stride + c] for r < rows, c < cols
+    // @param element_size bytes of one element, 1, 2, 4 or 8
+    static Status Transpose(const void *src, void *dst, int rows, int cols, int src_stride, int dst_stride,
+                            int element_size);
+
+    // @brief Transpose of batch planes in one parallel region, plane b reads src + b * src_batch_stride
+    // and writes dst + b * dst_batch_stride, strides are in elements
+    static Status Transpose(const void *src, void *dst, int batch, int src_batch_stride, int dst_batch_stride,
+                            int rows, int cols, int src_stride, int dst_stride, int element_size);
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_PERMUTE_UTILS_H_
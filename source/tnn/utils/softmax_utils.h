@@ -0,0 +1,214 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_SOURCE_TNN_UTILS_SOFTMAX_UTILS_H_
+#define TNN_SOURCE_TNN_UTILS_SOFTMAX_UTILS_H_
+
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+
+#include "tnn/core/macro.h"
+
+namespace TNN_NS {
+
+/*
+ * softmax along the middle dim of [outer, channel, inside], shared by the devices that run it on float registers.
+ * the first pass keeps a running max per block of channels, rescales the running sum when the max grows and
+ * leaves exp(x - block max) in dst; the second pass applies the block max correction and 1 / sum. a block of a row
+ * or of a tile stays in l1 between its two reads, so the input is read once from memory instead of three times.
+ *
+ * V is the register of the device: typedef F, kWidth lanes, and static Load, Save, Set, Add, Sub, Mul, Max, Exp.
+ */
+template <typename V>
+class SoftmaxUtils {
+public:
+    typedef typename V::F F;
+
+    // channels per block of the running max
+    static const int kBlockSize = 1024;
+    // lanes of one tile when the softmax dim is not the last one
+    static const int kTileSize = 64;
+
+    // @brief lanes of one tile, channels per block and floats of scratch one thread needs
+    static void Layout(int channel, int inside, int &tile, int &block_size, size_t &workspace_per_thread) {
+        if (inside == 1) {
+            tile                 = 1;
+            block_size           = kBlockSize;
+            workspace_per_thread = UP_DIV(channel, block_size);
+        } else {
+            tile                 = std::min(inside, kTileSize);
+            block_size           = std::max(16, kBlockSize / tile);
+            workspace_per_thread = (size_t)(UP_DIV(channel, block_size) + 3) * tile;
+        }
+        workspace_per_thread = ROUND_UP(workspace_per_thread, 16);
+    }
+
+    // @brief softmax dim is the last one, one row of channel floats, dst may be src
+    static void Row(const float *src, float *dst, int channel, float *block_max) {
+        float max = -INFINITY;
+        float sum = 0;
+        for (int start = 0, b = 0; start < channel; start += kBlockSize, b++) {
+            int count  = std::min(kBlockSize, channel - start);
+            float next = std::max(max, RowMax(src + start, count));
+            if (next > max) {
+                sum *= std::exp(max - next);
+                max = next;
+            }
+            sum += RowExpSum(src + start, dst + start, count, max);
+            block_max[b] = max;
+        }
+
+        float inv_sum = 1.0f / sum;
+        for (int start = 0, b = 0; start < channel; start += kBlockSize, b++) {
+            int count = std::min(kBlockSize, channel - start);
+            RowScale(dst + start, count, std::exp(block_max[b] - max) * inv_sum);
+        }
+    }
+
+    // @brief softmax dim is not the last one, lanes [0, tile) of the inside dim, consecutive channels are inside
+    // apart, dst may be src
+    static void Tile(const float *src, float *dst, int channel, int inside, int tile, int block_size,
+                     float *workspace) {
+        float *max       = workspace;
+        float *sum       = max + tile;
+        float *next      = sum + tile;
+        float *block_max = next + tile;
+        std::fill(max, max + tile, -INFINITY);
+        std::fill(sum, sum + tile, 0.0f);
+
+        for (int start = 0, b = 0; start < channel; start += block_size, b++) {
+            int end = std::min(channel, start + block_size);
+            memcpy(next, max, tile * sizeof(float));
+            for (int c = start; c < end; c++) {
+                LanesMax(next, src + c * inside, tile);
+            }
+            for (int i = 0; i < tile; i++) {
+                if (next[i] > max[i]) {
+                    sum[i] *= std::exp(max[i] - next[i]);
+                    max[i] = next[i];
+                }
+            }
+            for (int c = start; c < end; c++) {
+                LanesExpSum(dst + c * inside, src + c * inside, max, sum, tile);
+            }
+            memcpy(block_max + b * tile, max, tile * sizeof(float));
+        }
+
+        for (int start = 0, b = 0; start < channel; start += block_size, b++) {
+            int end      = std::min(channel, start + block_size);
+            float *scale = next;
+            for (int i = 0; i < tile; i++) {
+                scale[i] = std::exp(block_max[b * tile + i] - max[i]) / sum[i];
+            }
+            for (int c = start; c < end; c++) {
+                LanesMul(dst + c * inside, scale, tile);
+            }
+        }
+    }
+
+private:
+    static float RowMax(const float *src, int count) {
+        F max = V::Set(-INFINITY);
+        int i = 0;
+        for (; i + V::kWidth <= count; i += V::kWidth) {
+            max = V::Max(max, V::Load(src + i));
+        }
+        float lanes[V::kWidth];
+        V::Save(lanes, max);
+        float result = -INFINITY;
+        for (int j = 0; j < V::kWidth; j++) {
+            result = std::max(result, lanes[j]);
+        }
+        for (; i < count; i++) {
+            result = std::max(result, src[i]);
+        }
+        return result;
+    }
+
+    // dst = exp(src - max), returns the sum of dst
+    static float RowExpSum(const float *src, float *dst, int count, float max) {
+        F shift = V::Set(max);
+        F sum   = V::Set(0.0f);
+        int i   = 0;
+        for (; i + V::kWidth <= count; i += V::kWidth) {
+            F value = V::Exp(V::Sub(V::Load(src + i), shift));
+            V::Save(dst + i, value);
+            sum = V::Add(sum, value);
+        }
+        float lanes[V::kWidth];
+        V::Save(lanes, sum);
+        float result = 0;
+        for (int j = 0; j < V::kWidth; j++) {
+            result += lanes[j];
+        }
+        for (; i < count; i++) {
+            dst[i] = std::exp(src[i] - max);
+            result += dst[i];
+        }
+        return result;
+    }
+
+    static void RowScale(float *dst, int count, float scale) {
+        F factor = V::Set(scale);
+        int i    = 0;
+        for (; i + V::kWidth <= count; i += V::kWidth) {
+            V::Save(dst + i, V::Mul(V::Load(dst + i), factor));
+        }
+        for (; i < count; i++) {
+            dst[i] *= scale;
+        }
+    }
+
+    // dst = max(dst, src) over the lanes of a tile
+    static void LanesMax(float *dst, const float *src, int count) {
+        int i = 0;
+        for (; i + V::kWidth <= count; i += V::kWidth) {
+            V::Save(dst + i, V::Max(V::Load(dst + i), V::Load(src + i)));
+        }
+        for (; i < count; i++) {
+            dst[i] = std::max(dst[i], src[i]);
+        }
+    }
+
+    // dst = exp(src - max), sum += dst
+    static void LanesExpSum(float *dst, const float *src, const float *max, float *sum, int count) {
+        int i = 0;
+        for (; i + V::kWidth <= count; i += V::kWidth) {
+            F value = V::Exp(V::Sub(V::Load(src + i), V::Load(max + i)));
+            V::Save(dst + i, value);
+            V::Save(sum + i, V::Add(V::Load(sum + i), value));
+        }
+        for (; i < count; i++) {
+            dst[i] = std::exp(src[i] - max[i]);
+            sum[i] += dst[i];
+        }
+    }
+
+    // dst *= scale
+    static void LanesMul(float *dst, const float *scale, int count) {
+        int i = 0;
+        for (; i + V::kWidth <= count; i += V::kWidth) {
+            V::Save(dst + i, V::Mul(V::Load(dst + i), V::Load(scale + i)));
+        }
+        for (; i < count; i++) {
+            dst[i] *= scale[i];
+        }
+    }
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_SOURCE_TNN_UTILS_SOFTMAX_UTILS_H_
@@ -50,4 +50,32 @@ DEFINE_string(pr, "HIGH", precision_message);
 
 DEFINE_string(is, "", input_shape_message);
 
+DEFINE_string(lt, "", layer_profile_message);
+
+DEFINE_string(pk, "", machine_peak_message);
+
+DEFINE_bool(hc, false, hardware_counters_message);
+
+DEFINE_string(bp, "fp32,bfp16,int8", benchmark_precision_message);
+
+DEFINE_string(bf, "", benchmark_filter_message);
+
+DEFINE_string(lc, "", load_clients_message);
+
+DEFINE_string(li, "1", load_instances_message);
+
+DEFINE_double(lq, 0, load_qps_message);
+
+DEFINE_double(ld, 10, load_duration_message);
+
+DEFINE_string(lj, "", load_json_message);
+
+DEFINE_string(bj, "", benchmark_json_message);
+
+DEFINE_bool(ms, false, memory_stats_message);
+
+DEFINE_int32(hm, 0, health_monitor_message);
+
+DEFINE_bool(st, false, startup_stats_message);
+
 }  // namespace TNN_NS
@@ -59,6 +59,38 @@ static const char precision_message[] = "compute precision(HIGH, NORMAL, LOW)";
 
 static const char input_shape_message[] = "input shape: name[n,c,h,w]";
 
+static const char layer_profile_message[] =
+    "enable layer profiler, write <path>.trace.json (chrome trace) and <path>.summary.json";
+
+static const char machine_peak_message[] = "machine peak for layer profiler: <GFLOP/s>,<GB/s>";
+
+static const char hardware_counters_message[] = "read cpu hardware counters in the layer profiler, linux only(default false)";
+
+static const char benchmark_precision_message[] = "layer benchmark precisions(default fp32,bfp16,int8)";
+
+static const char benchmark_filter_message[] = "only run the layer benchmark cases whose layer name contains it";
+
+static const char load_clients_message[] =
+    "load generator client threads, a list sweeps them(eg: 1,2,4,8), empty disables the load generator";
+
+static const char load_instances_message[] = "load generator instances, a list sweeps them(eg: 1,2,4, default 1)";
+
+static const char load_qps_message[] = "load generator total target qps, 0 for closed loop(default 0)";
+
+static const char load_duration_message[] = "load generator seconds of each run(default 10)";
+
+static const char load_json_message[] = "write the load generator results in json to the path";
+
+static const char benchmark_json_message[] = "write the time of each iteration in json to the path";
+
+static const char startup_stats_message[] =
+    "print the time of the startup phases and the layers slowest to init(default false)";
+
+static const char health_monitor_message[] =
+    "check nan/inf and int8 saturation of the layer outputs every n forwards, 0 disables it(default 0)";
+
+static const char memory_stats_message[] = "print the memory held by the instance after forward(default false)";
+
 DECLARE_bool(h);
 
 DECLARE_string(mt);
@@ -93,6 +125,34 @@ DECLARE_string(pr);
 
 DECLARE_string(is);
 
+DECLARE_string(lt);
+
+DECLARE_string(pk);
+
+DECLARE_bool(hc);
+
+DECLARE_string(bp);
+
+DECLARE_string(bf);
+
+DECLARE_string(lc);
+
+DECLARE_string(li);
+
+DECLARE_double(lq);
+
+DECLARE_double(ld);
+
+DECLARE_string(lj);
+
+DECLARE_string(bj);
+
+DECLARE_bool(ms);
+
+DECLARE_int32(hm);
+
+DECLARE_bool(st);
+
 }  // namespace TNN_NS
 
 #endif  // TNN_TEST_FLAGS_H_
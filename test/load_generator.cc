@@ -0,0 +1,313 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "test/load_generator.h"
+
+#include <math.h>
+#include <stdio.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+
+#include "test/flags.h"
+#include "test/test.h"
+
+namespace TNN_NS {
+
+namespace test {
+
+    using std::chrono::duration;
+    using std::chrono::steady_clock;
+
+    LoadInstance::LoadInstance(std::shared_ptr<Instance> instance) : instance_(instance) {
+        BlobMap input_blob_map;
+        BlobMap output_blob_map;
+        instance_->GetAllInputBlobs(input_blob_map);
+        instance_->GetAllOutputBlobs(output_blob_map);
+        instance_->GetCommandQueue(&command_queue_);
+
+        input_mat_map_ = CreateBlobMatMap(input_blob_map, FLAGS_it);
+        InitInputMatMap(input_mat_map_);
+        input_converters_map_ = CreateBlobConverterMap(input_blob_map);
+        input_params_map_     = CreateConvertParamMap(input_mat_map_);
+
+        output_mat_map_        = CreateBlobMatMap(output_blob_map, 0);
+        output_converters_map_ = CreateBlobConverterMap(output_blob_map);
+        output_params_map_     = CreateConvertParamMap(output_mat_map_);
+    }
+
+    LoadInstance::~LoadInstance() {
+        FreeMatMapMemory(input_mat_map_);
+        FreeMatMapMemory(output_mat_map_);
+    }
+
+    Status LoadInstance::Infer() {
+        for (auto element : input_converters_map_) {
+            auto name     = element.first;
+            Status status = element.second->ConvertFromMatAsync(*input_mat_map_[name], input_params_map_[name],
+                                                                command_queue_);
+            if (status != TNN_OK) {
+                return status;
+            }
+        }
+        Status status = instance_->ForwardAsync(nullptr);
+        if (status != TNN_OK) {
+            return status;
+        }
+        for (auto element : output_converters_map_) {
+            auto name = element.first;
+            status    = element.second->ConvertToMat(*output_mat_map_[name], output_params_map_[name], command_queue_);
+            if (status != TNN_OK) {
+                return status;
+            }
+        }
+        return TNN_OK;
+    }
+
+    InstancePool::InstancePool(int count) {
+        for (int i = count - 1; i >= 0; --i) {
+            free_list_.push_back(i);
+        }
+    }
+
+    int InstancePool::Acquire() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this] { return !free_list_.empty(); });
+        int index = free_list_.back();
+        free_list_.pop_back();
+        return index;
+    }
+
+    void InstancePool::Release(int index) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            free_list_.push_back(index);
+        }
+        cond_.notify_one();
+    }
+
+    double LoadResult::Throughput() const {
+        return duration_s > 0 ? latencies.size() / duration_s : 0;
+    }
+
+    // nearest rank percentile, the latencies are sorted once the run is done
+    double LoadResult::Percentile(double percent) const {
+        if (latencies.empty()) {
+            return 0;
+        }
+        int rank = (int)ceil(percent / 100.0 * latencies.size()) - 1;
+        rank     = std::min(std::max(rank, 0), (int)latencies.size() - 1);
+        return latencies[rank];
+    }
+
+    Status LoadGenerator::Init(ModelConfig& model_config, NetworkConfig& network_config,
+                               InputShapesMap& input_shape) {
+        network_config_ = network_config;
+        input_shape_    = input_shape;
+        return net_.Init(model_config);
+    }
+
+    Status LoadGenerator::CreateInstances(int instance_count, int warmup_count) {
+        instances_.clear();
+        for (int i = 0; i < instance_count; ++i) {
+            Status status;
+            auto instance = net_.CreateInst(network_config_, status, input_shape_);
+            if (status != TNN_OK) {
+                return status;
+            }
+            instance->SetCpuNumThreads(std::max(FLAGS_th, 1));
+
+            auto load_instance = std::make_shared<LoadInstance>(instance);
+            for (int j = 0; j < warmup_count; ++j) {
+                status = load_instance->Infer();
+                if (status != TNN_OK) {
+                    return status;
+                }
+            }
+            instances_.push_back(load_instance);
+        }
+        pool_ = std::make_shared<InstancePool>(instance_count);
+        return TNN_OK;
+    }
+
+    LoadResult LoadGenerator::Run(int client_count, double target_qps, double duration_s) {
+        std::vector<LoadResult> client_results(client_count);
+        std::vector<std::thread> clients;
+        auto begin = steady_clock::now();
+        for (int i = 0; i < client_count; ++i) {
+            clients.emplace_back(&LoadGenerator::RunClient, this, i, client_count, target_qps, duration_s,
+                                 std::ref(client_results[i]));
+        }
+        for (auto& client : clients) {
+            client.join();
+        }
+
+        LoadResult result;
+        result.clients    = client_count;
+        result.instances  = (int)instances_.size();
+        result.target_qps = target_qps;
+        // requests in flight at the deadline still complete, count them in the duration
+        result.duration_s = duration<double>(steady_clock::now() - begin).count();
+        for (auto& client_result : client_results) {
+            result.errors += client_result.errors;
+            result.latencies.insert(result.latencies.end(), client_result.latencies.begin(),
+                                    client_result.latencies.end());
+        }
+        std::sort(result.latencies.begin(), result.latencies.end());
+        return result;
+    }
+
+    /*
+     * With a target qps each client sends at total_qps / clients, the clients are
+     * staggered so the arrivals are evenly spaced. A late request is sent at once
+     * and its latency still starts at the scheduled arrival, so a saturated host
+     * shows up as growing latency instead of a lower send rate.
+     */
+    void LoadGenerator::RunClient(int client_index, int client_count, double target_qps, double duration_s,
+                                  LoadResult& result) {
+        auto begin = steady_clock::now();
+        auto end   = begin + std::chrono::duration_cast<steady_clock::duration>(duration<double>(duration_s));
+        auto interval = std::chrono::duration_cast<steady_clock::duration>(
+            duration<double>(target_qps > 0 ? client_count / target_qps : 0));
+        auto offset = interval * client_index / client_count;
+
+        for (steady_clock::rep request = 0;; ++request) {
+            auto arrival = target_qps > 0 ? begin + offset + interval * request : steady_clock::now();
+            if (arrival >= end) {
+                break;
+            }
+            if (target_qps > 0) {
+                std::this_thread::sleep_until(arrival);
+            }
+
+            int index     = pool_->Acquire();
+            Status status = instances_[index]->Infer();
+            pool_->Release(index);
+
+            if (status != TNN_OK) {
+                result.errors++;
+                continue;
+            }
+            result.latencies.push_back(duration<double, std::milli>(steady_clock::now() - arrival).count());
+        }
+    }
+
+    void LoadGenerator::PrintResult(std::string model_name, const LoadResult& result) {
+        printf(
+            "%-45s clients = %-3d instances = %-3d | qps = %8.2f | p50 = %8.3f ms | p90 = %8.3f ms | p99 = %8.3f ms "
+            "| p999 = %8.3f ms | errors = %d \n",
+            model_name.c_str(), result.clients, result.instances, result.Throughput(), result.Percentile(50),
+            result.Percentile(90), result.Percentile(99), result.Percentile(99.9), result.errors);
+    }
+
+    std::string LoadGenerator::GetJsonReport(std::string model_name, const std::vector<LoadResult>& results) {
+        std::ostringstream ostr;
+        ostr << std::setprecision(6) << "{\n  \"model\": \"" << model_name << "\",\n  \"device\": \"" << FLAGS_dt
+             << "\",\n  \"cpu_threads\": " << std::max(FLAGS_th, 1) << ",\n  \"runs\": [";
+        for (int i = 0; i < results.size(); ++i) {
+            auto& result = results[i];
+            double mean  = 0;
+            for (auto latency : result.latencies) {
+                mean += latency;
+            }
+            mean /= std::max((int)result.latencies.size(), 1);
+
+            ostr << (i > 0 ? "," : "") << "\n    {\"clients\": " << result.clients
+                 << ", \"instances\": " << result.instances << ", \"target_qps\": " << result.target_qps
+                 << ", \"duration_s\": " << result.duration_s << ", \"requests\": " << result.latencies.size()
+                 << ", \"errors\": " << result.errors << ", \"throughput_qps\": " << result.Throughput() << ",\n";
+            ostr << "     \"latency_ms\": {\"mean\": " << mean
+                 << ", \"min\": " << (result.latencies.empty() ? 0 : result.latencies.front())
+                 << ", \"p50\": " << result.Percentile(50) << ", \"p90\": " << result.Percentile(90)
+                 << ", \"p99\": " << result.Percentile(99) << ", \"p999\": " << result.Percentile(99.9)
+                 << ", \"max\": " << (result.latencies.empty() ? 0 : result.latencies.back()) << "},\n";
+
+            // log spaced buckets, each bound is 1.25x the last
+            ostr << "     \"histogram_ms\": [";
+            int index       = 0;
+            bool first_item = true;
+            for (double bound = 0.05; index < result.latencies.size(); bound *= 1.25) {
+                int count = 0;
+                while (index < result.latencies.size() && result.latencies[index] <= bound) {
+                    count++;
+                    index++;
+                }
+                if (count > 0) {
+                    ostr << (first_item ? "" : ", ") << "{\"le\": " << bound << ", \"count\": " << count << "}";
+                    first_item = false;
+                }
+            }
+            ostr << "]}";
+        }
+        ostr << "\n  ]\n}\n";
+        return ostr.str();
+    }
+
+    static std::vector<int> ParseCountList(std::string list_str) {
+        std::stringstream ss(list_str);
+        std::string item;
+        std::vector<int> counts;
+        while (std::getline(ss, item, ',')) {
+            int count = atoi(item.c_str());
+            if (count > 0) {
+                counts.push_back(count);
+            }
+        }
+        return counts;
+    }
+
+    int RunLoadGenerator(ModelConfig& model_config, NetworkConfig& network_config, InputShapesMap& input_shape) {
+        auto client_counts   = ParseCountList(FLAGS_lc);
+        auto instance_counts = ParseCountList(FLAGS_li);
+        if (client_counts.empty() || instance_counts.empty()) {
+            printf("Parameter -lc and -li should be lists of positive numbers \n");
+            return -1;
+        }
+
+        std::string model_name = FLAGS_mp;
+        if (FLAGS_mp.find_last_of("/") != -1) {
+            model_name = FLAGS_mp.substr(FLAGS_mp.find_last_of("/") + 1);
+        }
+
+        LoadGenerator generator;
+        if (!CheckResult("init tnn", generator.Init(model_config, network_config, input_shape))) {
+            return -1;
+        }
+
+        std::vector<LoadResult> results;
+        for (auto instance_count : instance_counts) {
+            if (!CheckResult("create instances", generator.CreateInstances(instance_count, FLAGS_wc))) {
+                return -1;
+            }
+            for (auto client_count : client_counts) {
+                auto result = generator.Run(client_count, FLAGS_lq, FLAGS_ld);
+                LoadGenerator::PrintResult(model_name, result);
+                results.push_back(result);
+            }
+        }
+
+        if (!FLAGS_lj.empty()) {
+            std::ofstream json_file(FLAGS_lj);
+            json_file << LoadGenerator::GetJsonReport(model_name, results);
+        }
+        return 0;
+    }
+
+}  // namespace test
+
+}  // namespace TNN_NS
@@ -0,0 +1,117 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_TEST_LOAD_GENERATOR_H_
+#define TNN_TEST_LOAD_GENERATOR_H_
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "tnn/core/common.h"
+#include "tnn/core/instance.h"
+#include "tnn/core/macro.h"
+#include "tnn/core/status.h"
+#include "tnn/core/tnn.h"
+#include "tnn/utils/blob_converter.h"
+
+namespace TNN_NS {
+
+namespace test {
+
+    // @brief one instance with its own input and output mats
+    class LoadInstance {
+    public:
+        LoadInstance(std::shared_ptr<Instance> instance);
+        ~LoadInstance();
+
+        // @brief convert the inputs, forward and convert the outputs
+        Status Infer();
+
+    private:
+        std::shared_ptr<Instance> instance_;
+        void* command_queue_ = nullptr;
+        MatMap input_mat_map_;
+        MatMap output_mat_map_;
+        std::map<std::string, std::shared_ptr<BlobConverter>> input_converters_map_;
+        std::map<std::string, std::shared_ptr<BlobConverter>> output_converters_map_;
+        std::map<std::string, MatConvertParam> input_params_map_;
+        std::map<std::string, MatConvertParam> output_params_map_;
+    };
+
+    // @brief the instances clients take turns on, a client waits if all are busy
+    class InstancePool {
+    public:
+        InstancePool(int count);
+        int Acquire();
+        void Release(int index);
+
+    private:
+        std::mutex mutex_;
+        std::condition_variable cond_;
+        std::vector<int> free_list_;
+    };
+
+    struct LoadResult {
+        int clients       = 0;
+        int instances     = 0;
+        double target_qps = 0;
+        double duration_s = 0;
+        int errors        = 0;
+        // latency of each request in ms, from its scheduled arrival to its completion
+        std::vector<double> latencies;
+
+        double Throughput() const;
+        double Percentile(double percent) const;
+    };
+
+    // @brief N client threads send requests to M instances, either closed loop,
+    // each client sends the next request once the last one is done, or at a fixed
+    // total qps. Latencies of the fixed qps mode count the time a request waits.
+    class LoadGenerator {
+    public:
+        Status Init(ModelConfig& model_config, NetworkConfig& network_config, InputShapesMap& input_shape);
+
+        // @brief create the instances, warm each up with warmup_count requests
+        Status CreateInstances(int instance_count, int warmup_count);
+
+        // @brief run the clients for the duration on the current instances
+        LoadResult Run(int client_count, double target_qps, double duration_s);
+
+        static void PrintResult(std::string model_name, const LoadResult& result);
+
+        static std::string GetJsonReport(std::string model_name, const std::vector<LoadResult>& results);
+
+    private:
+        void RunClient(int client_index, int client_count, double target_qps, double duration_s,
+                       LoadResult& result);
+
+        TNN net_;
+        NetworkConfig network_config_;
+        InputShapesMap input_shape_;
+        std::vector<std::shared_ptr<LoadInstance>> instances_;
+        std::shared_ptr<InstancePool> pool_;
+    };
+
+    // @brief run the load generator sweeps given by the -lc and -li flags
+    int RunLoadGenerator(ModelConfig& model_config, NetworkConfig& network_config, InputShapesMap& input_shape);
+
+}  // namespace test
+
+}  // namespace TNN_NS
+
+#endif  // TNN_TEST_LOAD_GENERATOR_H_
@@ -26,6 +26,7 @@
 #include <string>
 
 #include "test/flags.h"
+#include "test/load_generator.h"
 #include "test/test_utils.h"
 #include "test/timer.h"
 #include "tnn/core/common.h"
@@ -69,6 +70,10 @@ namespace test {
 
         srand(102);
 
+        if (!FLAGS_lc.empty()) {
+            return RunLoadGenerator(model_config, network_config, input_shape);
+        }
+
         TNN net;
         Status ret = net.Init(model_config);
         if (CheckResult("init tnn", ret)) {
@@ -78,6 +83,10 @@ namespace test {
             }
             instance->SetCpuNumThreads(std::max(FLAGS_th, 1));
 
+            if (FLAGS_st) {
+                PrintStartupStats(net, instance);
+            }
+
             //get blob 
             BlobMap input_blob_map;
             BlobMap output_blob_map;
@@ -114,6 +123,20 @@ namespace test {
 #if TNN_PROFILE
             instance->StartProfile();
 #endif
+            if (!FLAGS_lt.empty()) {
+                instance->SetLayerProfilerEnabled(true);
+                double peak_gflops = 0, peak_gbytes_per_second = 0;
+                if (sscanf(FLAGS_pk.c_str(), "%lf,%lf", &peak_gflops, &peak_gbytes_per_second) == 2) {
+                    instance->SetLayerProfilerMachinePeak(peak_gflops, peak_gbytes_per_second);
+                }
+                if (FLAGS_hc) {
+                    CheckResult("enable hardware counters", instance->SetLayerProfilerCountersEnabled(true));
+                }
+            }
+
+            if (FLAGS_hm > 0) {
+                EnableHealthMonitor(instance);
+            }
             
             std::string model_name = FLAGS_mp;
             if(FLAGS_mp.find_last_of("/") != -1) {
@@ -142,11 +165,23 @@ namespace test {
 #endif
             CheckResult("Forward", ret);
 
+            if (!FLAGS_lt.empty()) {
+                WriteLayerProfile(instance);
+            }
+
             if (!FLAGS_op.empty()) {
                 WriteOutput(output_mat_map);
             }
  
             timer.Print();
+
+            if (FLAGS_ms) {
+                PrintMemoryStats(instance);
+            }
+
+            if (!FLAGS_bj.empty()) {
+                WriteBenchmarkJson(model_name, input_blob_map, timer.GetSamples());
+            }
  
             FreeMatMapMemory(input_mat_map);
             FreeMatMapMemory(output_mat_map);
@@ -167,6 +202,12 @@ namespace test {
             return false;
         }
 
+        if (!FLAGS_lc.empty() && (FLAGS_ld <= 0 || FLAGS_lq < 0)) {
+            printf("Parameter -ld should be greater than zero and -lq should not be negative \n");
+            ShowUsage();
+            return false;
+        }
+
         if (FLAGS_mp.empty()) {
             printf("Parameter -mp is not set \n");
             ShowUsage();
@@ -192,6 +233,18 @@ namespace test {
         printf("    -pr \"<precision >\"    \t%s \n", precision_message);
         printf("    -is \"<input shape>\"   \t%s \n", input_shape_message);
         printf("    -fc \"<format for compare>\t%s \n", output_format_cmp_message);
+        printf("    -lt \"<path prefix>\"   \t%s \n", layer_profile_message);
+        printf("    -pk \"<gflops,gbps>\"   \t%s \n", machine_peak_message);
+        printf("    -hc                     \t%s \n", hardware_counters_message);
+        printf("    -lc \"<client threads>\"\t%s \n", load_clients_message);
+        printf("    -li \"<instances>\"     \t%s \n", load_instances_message);
+        printf("    -lq \"<qps>\"           \t%s \n", load_qps_message);
+        printf("    -ld \"<seconds>\"       \t%s \n", load_duration_message);
+        printf("    -lj \"<path>\"          \t%s \n", load_json_message);
+        printf("    -bj \"<path>\"          \t%s \n", benchmark_json_message);
+        printf("    -ms                     \t%s \n", memory_stats_message);
+        printf("    -hm \"<interval>\"      \t%s \n", health_monitor_message);
+        printf("    -st                     \t%s \n", startup_stats_message);
     }
 
     void SetCpuAffinity() {
@@ -442,6 +495,97 @@ namespace test {
         f.close();
     }
 
+    void WriteLayerProfile(std::shared_ptr<Instance> instance) {
+        std::string trace, summary;
+        if (!CheckResult("get layer profiler trace", instance->GetLayerProfilerTrace(trace)) ||
+            !CheckResult("get layer profiler summary", instance->GetLayerProfilerSummary(summary))) {
+            return;
+        }
+        std::ofstream trace_file(FLAGS_lt + ".trace.json");
+        trace_file << trace;
+        trace_file.close();
+        std::ofstream summary_file(FLAGS_lt + ".summary.json");
+        summary_file << summary;
+        summary_file.close();
+    }
+
+    void EnableHealthMonitor(std::shared_ptr<Instance> instance) {
+        HealthMonitorConfig config;
+        config.sample_interval = FLAGS_hm;
+        config.callback        = [](const BlobHealthStats& stats) {
+            printf("health alert 0x%x: layer %s blob %s, nan %lld, inf %lld, saturated %lld of %lld, min %g, max %g\n",
+                   stats.alerts, stats.layer_name.c_str(), stats.blob_name.c_str(), stats.nan_count,
+                   stats.inf_count, stats.saturated_count, stats.count, stats.min, stats.max);
+        };
+        CheckResult("enable health monitor", instance->SetHealthMonitorEnabled(true, config));
+    }
+
+    void PrintStartupStats(TNN& net, std::shared_ptr<Instance> instance) {
+        StartupStats init_stats, instance_stats;
+        if (!CheckResult("get tnn startup stats", net.GetStartupStats(init_stats)) ||
+            !CheckResult("get instance startup stats", instance->GetStartupStats(instance_stats))) {
+            return;
+        }
+        auto print_phases = [](const char* title, StartupStats& stats) {
+            printf("%s: %.3f ms\n", title, stats.total_ms);
+            for (auto& phase : stats.phases) {
+                printf("    %-20s %10.3f ms\n", phase.name.c_str(), phase.time_ms);
+            }
+        };
+        print_phases("tnn init", init_stats);
+        print_phases("create instance", instance_stats);
+        printf("slowest layers to init:\n");
+        for (auto& layer : instance_stats.slowest_layers) {
+            printf("    %-40s %-16s %10.3f ms\n", layer.layer_name.c_str(), layer.type_name.c_str(), layer.time_ms);
+        }
+    }
+
+    void PrintMemoryStats(std::shared_ptr<Instance> instance) {
+        MemoryStats stats;
+        if (!CheckResult("get memory stats", instance->GetMemoryStats(stats))) {
+            return;
+        }
+        auto mb = [](size_t bytes) { return bytes / 1024.0 / 1024.0; };
+        printf("memory: activation %.3f MB, weights %.3f MB, packed weights %.3f MB, workspace %.3f MB, "
+               "mat cache %.3f MB, total %.3f MB\n",
+               mb(stats.activation_bytes), mb(stats.weight_bytes), mb(stats.packed_weight_bytes),
+               mb(stats.workspace_bytes), mb(stats.mat_cache_bytes), mb(stats.total_bytes));
+        printf("device memory: current %.3f MB, peak %.3f MB\n", mb(stats.device_current_bytes),
+               mb(stats.device_peak_bytes));
+    }
+
+    /*
+     * Same layout as the layer benchmark report, results keyed by
+     * model/shape/device/precision with the time of every iteration.
+     */
+    void WriteBenchmarkJson(std::string model_name, BlobMap& input_blob_map, std::vector<float> samples) {
+        std::string shape;
+        for (auto iter : input_blob_map) {
+            shape += shape.empty() ? "" : ";";
+            auto dims = iter.second->GetBlobDesc().dims;
+            for (int i = 0; i < dims.size(); ++i) {
+                shape += (i > 0 ? "x" : "") + std::to_string(dims[i]);
+            }
+        }
+        float sum = 0;
+        for (auto sample : samples) {
+            sum += sample;
+        }
+
+        std::ofstream f(FLAGS_bj);
+        f << std::setprecision(6) << "{\n  \"results\": {\n    \"" << model_name << "/" << shape << "/" << FLAGS_dt << "/"
+          << FLAGS_pr << "\": {";
+        f << "\"model\": \"" << model_name << "\", \"shape\": \"" << shape << "\", \"device\": \"" << FLAGS_dt
+          << "\", \"precision\": \"" << FLAGS_pr << "\", \"warmup_count\": " << FLAGS_wc
+          << ", \"repeat_count\": " << samples.size() << ", \"mean_ms\": " << sum / std::max((int)samples.size(), 1)
+          << ", \"samples_ms\": [";
+        for (int i = 0; i < samples.size(); ++i) {
+            f << (i > 0 ? ", " : "") << samples[i];
+        }
+        f << "]}\n  }\n}\n";
+        f.close();
+    }
+
     void FreeMatMapMemory(MatMap& mat_map) {
         for(auto iter : mat_map) {
             free(iter.second->GetData());
@@ -20,6 +20,7 @@
 #include "tnn/core/instance.h"
 #include "tnn/core/macro.h"
 #include "tnn/core/status.h"
+#include "tnn/core/tnn.h"
 #include "tnn/utils/blob_converter.h"
 
 namespace TNN_NS {
@@ -52,6 +53,16 @@ namespace test {
 
     void WriteOutput(MatMap& outputs);
 
+    void WriteLayerProfile(std::shared_ptr<Instance> instance);
+
+    void EnableHealthMonitor(std::shared_ptr<Instance> instance);
+
+    void PrintStartupStats(TNN& net, std::shared_ptr<Instance> instance);
+
+    void PrintMemoryStats(std::shared_ptr<Instance> instance);
+
+    void WriteBenchmarkJson(std::string model_name, BlobMap& input_blob_map, std::vector<float> samples);
+
     void FreeMatMapMemory(MatMap& mat_map);
 
 }  // namespace test
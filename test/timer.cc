@@ -29,16 +29,17 @@ Timer::Timer(std::string timer_info) {
 }
 
 void Timer::Start() {
-    start_ = system_clock::now();
+    start_ = steady_clock::now();
 }
 
 void Timer::Stop() {
-    stop_ = system_clock::now();
+    stop_ = steady_clock::now();
     float delta = duration_cast<microseconds>(stop_ - start_).count() / 1000.0f;
     min_         = static_cast<float>(fmin(min_, delta));
     max_         = static_cast<float>(fmax(max_, delta));
     sum_ += delta;
     count_++;
+    samples_.push_back(delta);
 }
 
 void Timer::Reset() {
@@ -46,7 +47,8 @@ void Timer::Reset() {
     max_ = FLT_MIN;
     sum_ = 0.0f;
     count_ = 0;
-    stop_ = start_ = system_clock::now();
+    samples_.clear();
+    stop_ = start_ = steady_clock::now();
 }
    
 void Timer::Print() {
@@ -60,6 +62,10 @@ void Timer::Print() {
            min_str, max_str, avg_str);
 }
 
+std::vector<float> Timer::GetSamples() {
+    return samples_;
+}
+
 } // namespace test
 
 } // namespace TNN_NS
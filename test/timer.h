@@ -17,6 +17,7 @@
 
 #include <chrono>
 #include <string>
+#include <vector>
 
 #include "tnn/core/macro.h"
 
@@ -25,7 +26,7 @@ namespace TNN_NS {
 namespace test {
 
 using std::chrono::time_point;
-using std::chrono::system_clock;
+using std::chrono::steady_clock;
 
 class Timer {
 public:
@@ -34,15 +35,18 @@ public:
     void Stop();
     void Reset();
     void Print();
+    // @brief time of each Start/Stop pair in ms
+    std::vector<float> GetSamples();
 
 private:
     float min_;
     float max_;
     float sum_;
     std::string timer_info_;
-    time_point<system_clock> start_;
-    time_point<system_clock> stop_;
+    time_point<steady_clock> start_;
+    time_point<steady_clock> stop_;
     int count_;
+    std::vector<float> samples_;
 };
 
 } // namespace test
@@ -0,0 +1,337 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "test/unit_test/layer_benchmark/layer_benchmark.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <sstream>
+
+#include "test/test_utils.h"
+#include "test/unit_test/unit_test_common.h"
+#include "test/unit_test/utils/network_helpers.h"
+#include "tnn/core/blob_int8.h"
+#include "tnn/interpreter/layer_resource_generator.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/blob_converter.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/layer_cost_utils.h"
+
+namespace TNN_NS {
+
+static std::string PrecisionName(DataType precision) {
+    if (precision == DATA_TYPE_BFP16) {
+        return "bfp16";
+    } else if (precision == DATA_TYPE_INT8) {
+        return "int8";
+    } else if (precision == DATA_TYPE_HALF) {
+        return "fp16";
+    }
+    return "fp32";
+}
+
+// nearest rank percentile of sorted samples
+static double Percentile(const std::vector<double>& sorted, double percent) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    int rank = (int)ceil(percent / 100.0 * sorted.size()) - 1;
+    rank     = std::min(std::max(rank, 0), (int)sorted.size() - 1);
+    return sorted[rank];
+}
+
+std::string LayerBenchmarkResult::Key() const {
+    return layer + "/" + shape + "/" + device + "/" + precision;
+}
+
+LayerBenchmark::LayerBenchmark() {}
+
+LayerBenchmark::~LayerBenchmark() {
+    ReleaseBlobs();
+    if (device_context_) {
+        delete device_context_;
+        device_context_ = nullptr;
+    }
+}
+
+Status LayerBenchmark::Init(std::string device_name, std::vector<std::string> library_path, int num_threads) {
+    device_name_ = device_name;
+    device_      = GetDevice(ConvertDeviceType(device_name));
+    if (!device_) {
+        LOGE("Error: device %s is null\n", device_name.c_str());
+        return Status(TNNERR_DEVICE_NOT_SUPPORT, "device is null");
+    }
+
+    device_context_ = device_->CreateContext(0);
+    if (!device_context_) {
+        LOGE("Error: context of device %s is null\n", device_name.c_str());
+        return Status(TNNERR_DEVICE_CONTEXT_CREATE, "device context is null");
+    }
+
+    Status status = device_context_->LoadLibrary(library_path);
+    if (status != TNN_OK) {
+        return status;
+    }
+    return device_context_->SetNumThreads(std::max(1, num_threads));
+}
+
+Status LayerBenchmark::Run(const LayerBenchmarkCase& bench_case, DataType precision, int warmup_count,
+                           int repeat_count, LayerBenchmarkResult& result) {
+    // as in the layer unit tests, only arm runs bfp16 and int8
+    if (precision != DATA_TYPE_FLOAT && device_->GetDeviceType() != DEVICE_ARM) {
+        return Status(TNNERR_DEVICE_NOT_SUPPORT, "low precision is only benchmarked on arm");
+    }
+
+    LayerParam* param = bench_case.param.get();
+    param->quantized  = precision == DATA_TYPE_INT8;
+
+    Status status = CreateInputBlobs(bench_case, precision);
+    if (status != TNN_OK) {
+        ReleaseBlobs();
+        return status;
+    }
+
+    LayerResource* resource = nullptr;
+    GenerateRandomResource(bench_case.type, param, &resource, inputs_);
+    std::shared_ptr<LayerResource> resource_holder(resource);
+
+    std::shared_ptr<BaseLayer> layer(CreateLayer(bench_case.type));
+    if (!layer) {
+        ReleaseBlobs();
+        LOGE("Error: CreateLayer nil, type:%d\n", bench_case.type);
+        return Status(TNNERR_CREATE_LAYER, "Error: CreateLayer nil, type");
+    }
+
+    status = CreateOutputBlobs(bench_case, precision);
+    if (status == TNN_OK) {
+        status = layer->Init(device_context_, param, resource, inputs_, outputs_, device_);
+    }
+    for (auto blob : outputs_) {
+        if (status == TNN_OK) {
+            status = BlobHandleAllocate(blob, device_);
+        }
+    }
+    if (status == TNN_OK) {
+        status = InitInputBlobsDataRandom(bench_case.ensure_input_positive);
+    }
+    if (status == TNN_OK) {
+        status = layer->Reshape();
+    }
+    for (int i = 0; i < warmup_count && status == TNN_OK; ++i) {
+        status = Forward(layer.get());
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < repeat_count && status == TNN_OK; ++i) {
+        auto begin = std::chrono::steady_clock::now();
+        status     = Forward(layer.get());
+        auto end   = std::chrono::steady_clock::now();
+        samples.push_back(std::chrono::duration<double, std::milli>(end - begin).count());
+    }
+    if (status == TNN_OK) {
+        std::vector<DimsVector> inputs_dims, outputs_dims;
+        for (auto blob : inputs_) {
+            inputs_dims.push_back(blob->GetBlobDesc().dims);
+        }
+        for (auto blob : outputs_) {
+            outputs_dims.push_back(blob->GetBlobDesc().dims);
+        }
+        result.mflops = GetLayerFlops(bench_case.type, param, resource, inputs_dims, outputs_dims);
+    }
+
+    layer.reset();
+    ReleaseBlobs();
+    if (status != TNN_OK) {
+        return status;
+    }
+
+    result.layer        = bench_case.layer;
+    result.shape        = bench_case.shape;
+    result.device       = device_name_;
+    result.precision    = PrecisionName(precision);
+    result.warmup_count = warmup_count;
+    result.samples      = samples;
+
+    std::vector<double> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+    double sum = 0, square_sum = 0;
+    for (auto sample : samples) {
+        sum += sample;
+        square_sum += sample * sample;
+    }
+    int count        = std::max((int)samples.size(), 1);
+    result.mean_ms   = sum / count;
+    result.stddev_ms = sqrt(std::max(square_sum / count - result.mean_ms * result.mean_ms, 0.0));
+    result.min_ms    = sorted.empty() ? 0 : sorted.front();
+    result.max_ms    = sorted.empty() ? 0 : sorted.back();
+    result.p50_ms    = Percentile(sorted, 50);
+    result.p90_ms    = Percentile(sorted, 90);
+    result.p99_ms    = Percentile(sorted, 99);
+    return TNN_OK;
+}
+
+// Create and allocate the input blobs, int8 blobs carry a random scale
+Status LayerBenchmark::CreateInputBlobs(const LayerBenchmarkCase& bench_case, DataType precision) {
+    for (auto dims : bench_case.inputs_dims) {
+        BlobDesc desc;
+        desc.device_type = device_->GetDeviceType();
+        desc.data_type   = precision;
+        desc.dims        = dims;
+
+        Blob* blob = nullptr;
+        if (precision == DATA_TYPE_INT8) {
+            auto blob_int8 = new BlobInt8(desc);
+            blob_int8->SetIntResource(CreateIntScale(dims[1]));
+            blob = blob_int8;
+        } else {
+            blob = new Blob(desc);
+        }
+        inputs_.push_back(blob);
+
+        Status status = BlobHandleAllocate(blob, device_);
+        if (status != TNN_OK) {
+            return status;
+        }
+    }
+    return TNN_OK;
+}
+
+/*
+ * Create the output blobs, the layer infers their shapes in Init. The int8 accs read
+ * the output scale in Init, so its channels come from the param.
+ */
+Status LayerBenchmark::CreateOutputBlobs(const LayerBenchmarkCase& bench_case, DataType precision) {
+    BlobDesc desc;
+    desc.device_type = device_->GetDeviceType();
+    desc.data_type   = precision;
+
+    if (precision == DATA_TYPE_INT8) {
+        int channel = bench_case.inputs_dims[0][1];
+        if (auto conv_param = dynamic_cast<ConvLayerParam*>(bench_case.param.get())) {
+            channel = conv_param->output_channel;
+        } else if (auto ip_param = dynamic_cast<InnerProductLayerParam*>(bench_case.param.get())) {
+            channel = ip_param->num_output;
+        }
+        auto blob_int8 = new BlobInt8(desc);
+        blob_int8->SetIntResource(CreateIntScale(channel));
+        outputs_.push_back(blob_int8);
+    } else {
+        outputs_.push_back(new Blob(desc));
+    }
+    return TNN_OK;
+}
+
+Status LayerBenchmark::InitInputBlobsDataRandom(bool ensure_input_positive) {
+    void* command_queue;
+    device_context_->GetCommandQueue(&command_queue);
+
+    for (int index = 0; index < inputs_.size(); ++index) {
+        Blob* blob       = inputs_[index];
+        DimsVector dims  = blob->GetBlobDesc().dims;
+        int count        = DimsVectorUtils::Count(dims);
+        DataType dtype   = blob->GetBlobDesc().data_type;
+        MatType mat_type = NCHW_FLOAT;
+        if (dtype == DATA_TYPE_BFP16) {
+            mat_type = RESERVED_BFP16_TEST;
+        } else if (dtype == DATA_TYPE_INT8) {
+            mat_type = RESERVED_INT8_TEST;
+        }
+
+        Mat source(DEVICE_NAIVE, mat_type, dims);
+        void* data = source.GetData();
+        if (mat_type == NCHW_FLOAT) {
+            InitRandom(static_cast<float*>(data), count, ensure_input_positive ? 0.0f : -1.0f, 1.0f);
+        } else if (mat_type == RESERVED_INT8_TEST) {
+            InitRandom(static_cast<int8_t*>(data), count, ensure_input_positive ? (int8_t)0 : (int8_t)-8, (int8_t)8);
+        } else {
+            InitRandom(static_cast<bfp16_t*>(data), count, bfp16_t(ensure_input_positive ? 0.0f : -1.0f),
+                       bfp16_t(1.0f));
+        }
+
+        MatConvertParam param;
+        param.scale = std::vector<float>(dims[1], 1);
+        param.bias  = std::vector<float>(dims[1], 0);
+
+        BlobConverter blob_converter(blob);
+        Status status = blob_converter.ConvertFromMat(source, param, command_queue);
+        if (status != TNN_OK) {
+            LOGE("input blob_converter failed (%s)\n", status.description().c_str());
+            return status;
+        }
+    }
+    return TNN_OK;
+}
+
+Status LayerBenchmark::Forward(BaseLayer* layer) {
+    Status status = device_context_->OnInstanceForwardBegin();
+    if (status != TNN_OK) {
+        return status;
+    }
+    status = layer->Forward();
+    if (status != TNN_OK) {
+        return status;
+    }
+    status = device_context_->OnInstanceForwardEnd();
+    if (status != TNN_OK) {
+        return status;
+    }
+    return device_context_->Synchronize();
+}
+
+void LayerBenchmark::ReleaseBlobs() {
+    std::vector<Blob*> blobs = inputs_;
+    blobs.insert(blobs.end(), outputs_.begin(), outputs_.end());
+    for (auto blob : blobs) {
+        if (blob->GetBlobDesc().data_type == DATA_TYPE_INT8) {
+            delete static_cast<BlobInt8*>(blob)->GetIntResource();
+        }
+        if (blob->GetHandle().base) {
+            BlobHandleFree(blob, device_);
+        }
+        delete blob;
+    }
+    inputs_.clear();
+    outputs_.clear();
+}
+
+std::string LayerBenchmark::GetJsonReport(const std::vector<LayerBenchmarkResult>& results) {
+    std::ostringstream ostr;
+    ostr << std::setprecision(6) << "{\n  \"results\": {";
+    for (int i = 0; i < results.size(); ++i) {
+        auto& result = results[i];
+        ostr << (i > 0 ? "," : "") << "\n    \"" << result.Key() << "\": {";
+        ostr << "\"layer\": \"" << result.layer << "\", \"shape\": \"" << result.shape << "\", \"device\": \""
+             << result.device << "\", \"precision\": \"" << result.precision << "\", ";
+        ostr << "\"warmup_count\": " << result.warmup_count << ", \"repeat_count\": " << result.samples.size()
+             << ", ";
+        ostr << "\"min_ms\": " << result.min_ms << ", \"max_ms\": " << result.max_ms
+             << ", \"mean_ms\": " << result.mean_ms << ", \"stddev_ms\": " << result.stddev_ms
+             << ", \"p50_ms\": " << result.p50_ms << ", \"p90_ms\": " << result.p90_ms
+             << ", \"p99_ms\": " << result.p99_ms << ", ";
+        ostr << "\"mflops\": " << result.mflops
+             << ", \"gflops_per_s\": " << (result.mean_ms > 0 ? result.mflops / result.mean_ms : 0) << ", ";
+        ostr << "\"samples_ms\": [";
+        for (int j = 0; j < result.samples.size(); ++j) {
+            ostr << (j > 0 ? ", " : "") << result.samples[j];
+        }
+        ostr << "]}";
+    }
+    ostr << "\n  }\n}\n";
+    return ostr.str();
+}
+
+}  // namespace TNN_NS
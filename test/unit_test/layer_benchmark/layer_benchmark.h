@@ -0,0 +1,106 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_TEST_UNIT_TEST_LAYER_BENCHMARK_LAYER_BENCHMARK_H_
+#define TNN_TEST_UNIT_TEST_LAYER_BENCHMARK_LAYER_BENCHMARK_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/blob.h"
+#include "tnn/core/common.h"
+#include "tnn/core/context.h"
+#include "tnn/core/layer_type.h"
+#include "tnn/core/status.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/layer/base_layer.h"
+
+namespace TNN_NS {
+
+// @brief one point of a layer parameter sweep
+struct LayerBenchmarkCase {
+    // short name of the layer variant, ie, conv1x1, conv_depthwise
+    std::string layer;
+    // readable shape of the case, ie, 1x64x56x56_o64_s1
+    std::string shape;
+    LayerType type;
+    std::shared_ptr<LayerParam> param;
+    // input dims, the data type is decided by the precision
+    std::vector<DimsVector> inputs_dims;
+    // some layers only accept positive inputs
+    bool ensure_input_positive = false;
+};
+
+// @brief timings of one case on one device with one precision
+struct LayerBenchmarkResult {
+    std::string layer;
+    std::string shape;
+    std::string device;
+    std::string precision;
+    int warmup_count = 0;
+    // time of each repetition in ms
+    std::vector<double> samples;
+    double min_ms    = 0;
+    double max_ms    = 0;
+    double mean_ms   = 0;
+    double stddev_ms = 0;
+    double p50_ms    = 0;
+    double p90_ms    = 0;
+    double p99_ms    = 0;
+    double mflops    = 0;
+
+    // @brief layer/shape/device/precision, unique within a report
+    std::string Key() const;
+};
+
+// @brief the representative shapes of each benchmarked layer type
+std::vector<LayerBenchmarkCase> CreateLayerBenchmarkCases();
+
+// @brief runs the layer of a case on the device and times its forward
+class LayerBenchmark {
+public:
+    LayerBenchmark();
+    ~LayerBenchmark();
+
+    // @brief create the context of the device, ie, NAIVE, ARM, OPENCL
+    Status Init(std::string device_name, std::vector<std::string> library_path, int num_threads);
+
+    // @brief warm up and time a case, returns error if the device does not support the case
+    Status Run(const LayerBenchmarkCase& bench_case, DataType precision, int warmup_count, int repeat_count,
+               LayerBenchmarkResult& result);
+
+    // @brief json report keyed by layer, shape, device and precision
+    static std::string GetJsonReport(const std::vector<LayerBenchmarkResult>& results);
+
+private:
+    Status CreateInputBlobs(const LayerBenchmarkCase& bench_case, DataType precision);
+    Status CreateOutputBlobs(const LayerBenchmarkCase& bench_case, DataType precision);
+    Status InitInputBlobsDataRandom(bool ensure_input_positive);
+    Status Forward(BaseLayer* layer);
+    void ReleaseBlobs();
+
+    std::string device_name_;
+    AbstractDevice* device_  = nullptr;
+    Context* device_context_ = nullptr;
+
+    std::vector<Blob*> inputs_;
+    std::vector<Blob*> outputs_;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_TEST_UNIT_TEST_LAYER_BENCHMARK_LAYER_BENCHMARK_H_
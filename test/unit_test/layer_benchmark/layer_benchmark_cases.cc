@@ -0,0 +1,204 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <sstream>
+
+#include "test/unit_test/layer_benchmark/layer_benchmark.h"
+
+namespace TNN_NS {
+
+static std::string DimsToString(const DimsVector& dims) {
+    std::ostringstream ostr;
+    for (int i = 0; i < dims.size(); ++i) {
+        ostr << (i > 0 ? "x" : "") << dims[i];
+    }
+    return ostr.str();
+}
+
+static LayerBenchmarkCase CreateConvCase(std::string layer, int input_channel, int output_channel, int size,
+                                         int kernel, int stride, int group) {
+    auto param            = std::make_shared<ConvLayerParam>();
+    param->name           = layer;
+    param->input_channel  = input_channel / group;
+    param->output_channel = output_channel;
+    param->group          = group;
+    param->kernels        = {kernel, kernel};
+    param->strides        = {stride, stride};
+    param->dialations     = {1, 1};
+    param->pads           = {kernel / 2, kernel / 2, kernel / 2, kernel / 2};
+    param->bias           = 1;
+
+    LayerBenchmarkCase bench_case;
+    bench_case.layer       = layer;
+    bench_case.type        = LAYER_CONVOLUTION;
+    bench_case.param       = param;
+    bench_case.inputs_dims = {{1, input_channel, size, size}};
+    bench_case.shape       = DimsToString(bench_case.inputs_dims[0]) + "_o" + std::to_string(output_channel) + "_k" +
+                       std::to_string(kernel) + "_s" + std::to_string(stride);
+    return bench_case;
+}
+
+static LayerBenchmarkCase CreateInnerProductCase(int input_channel, int num_output) {
+    auto param        = std::make_shared<InnerProductLayerParam>();
+    param->name       = "inner_product";
+    param->num_output = num_output;
+    param->has_bias   = 1;
+    param->axis       = 1;
+
+    LayerBenchmarkCase bench_case;
+    bench_case.layer       = "inner_product";
+    bench_case.type        = LAYER_INNER_PRODUCT;
+    bench_case.param       = param;
+    bench_case.inputs_dims = {{1, input_channel, 1, 1}};
+    bench_case.shape       = DimsToString(bench_case.inputs_dims[0]) + "_o" + std::to_string(num_output);
+    return bench_case;
+}
+
+// kernel 0 means global pooling
+static LayerBenchmarkCase CreatePoolingCase(std::string layer, int pool_type, int channel, int size, int kernel,
+                                            int stride) {
+    auto param            = std::make_shared<PoolingLayerParam>();
+    param->name           = layer;
+    param->pool_type      = pool_type;
+    param->kernels_params = {kernel, kernel};
+    param->kernels        = {kernel, kernel};
+    param->strides        = {stride, stride};
+    param->pads           = {0, 0, 0, 0};
+    param->kernel_indexs  = {-1, -1};
+
+    LayerBenchmarkCase bench_case;
+    bench_case.layer       = layer;
+    bench_case.type        = LAYER_POOLING;
+    bench_case.param       = param;
+    bench_case.inputs_dims = {{1, channel, size, size}};
+    bench_case.shape       = DimsToString(bench_case.inputs_dims[0]) + "_k" + std::to_string(kernel) + "_s" +
+                       std::to_string(stride);
+    return bench_case;
+}
+
+static LayerBenchmarkCase CreateElementwiseCase(std::string layer, LayerType type, int input_count, int channel,
+                                                int size) {
+    std::shared_ptr<LayerParam> param;
+    if (input_count > 1) {
+        param = std::make_shared<MultidirBroadcastLayerParam>();
+    } else {
+        param = std::make_shared<LayerParam>();
+    }
+    param->name = layer;
+
+    LayerBenchmarkCase bench_case;
+    bench_case.layer = layer;
+    bench_case.type  = type;
+    bench_case.param = param;
+    for (int i = 0; i < input_count; ++i) {
+        bench_case.inputs_dims.push_back({1, channel, size, size});
+    }
+    bench_case.shape = DimsToString(bench_case.inputs_dims[0]);
+    return bench_case;
+}
+
+static LayerBenchmarkCase CreateSoftmaxCase(int channel, int size) {
+    auto param  = std::make_shared<SoftmaxLayerParam>();
+    param->name = "softmax";
+    param->axis = 1;
+
+    LayerBenchmarkCase bench_case;
+    bench_case.layer       = "softmax";
+    bench_case.type        = LAYER_SOFTMAX;
+    bench_case.param       = param;
+    bench_case.inputs_dims = {{1, channel, size, size}};
+    bench_case.shape       = DimsToString(bench_case.inputs_dims[0]) + "_axis1";
+    return bench_case;
+}
+
+static LayerBenchmarkCase CreateReduceCase(std::string layer, LayerType type, int channel, int size,
+                                           std::vector<int> axis) {
+    auto param       = std::make_shared<ReduceLayerParam>();
+    param->name      = layer;
+    param->axis      = axis;
+    param->keep_dims = 1;
+
+    LayerBenchmarkCase bench_case;
+    bench_case.layer       = layer;
+    bench_case.type        = type;
+    bench_case.param       = param;
+    bench_case.inputs_dims = {{1, channel, size, size}};
+    bench_case.shape       = DimsToString(bench_case.inputs_dims[0]) + "_axis";
+    for (auto item : axis) {
+        bench_case.shape += std::to_string(item);
+    }
+    return bench_case;
+}
+
+/*
+ * The shapes follow the layers of mobilenet, resnet and segmentation heads at 224x224,
+ * from large and shallow to small and deep.
+ */
+std::vector<LayerBenchmarkCase> CreateLayerBenchmarkCases() {
+    std::vector<LayerBenchmarkCase> cases;
+
+    // first layer of most image models
+    cases.push_back(CreateConvCase("conv_c3", 3, 32, 224, 3, 2, 1));
+    cases.push_back(CreateConvCase("conv_c3", 3, 64, 224, 7, 2, 1));
+
+    const int pointwise_shapes[][3] = {{32, 64, 112}, {64, 64, 56}, {128, 128, 28}, {256, 256, 14}, {512, 512, 7}};
+    for (auto shape : pointwise_shapes) {
+        cases.push_back(CreateConvCase("conv1x1", shape[0], shape[1], shape[2], 1, 1, 1));
+    }
+
+    // stride 1 3x3 convs are computed with winograd on arm
+    const int conv3x3_shapes[][3] = {{32, 32, 56}, {64, 64, 56}, {128, 128, 28}, {256, 256, 14}, {512, 512, 7}};
+    for (auto shape : conv3x3_shapes) {
+        cases.push_back(CreateConvCase("conv3x3", shape[0], shape[1], shape[2], 3, 1, 1));
+    }
+    cases.push_back(CreateConvCase("conv3x3", 64, 128, 56, 3, 2, 1));
+
+    const int depthwise_shapes[][3] = {{32, 112, 1}, {96, 112, 2}, {144, 56, 1}, {192, 28, 1}, {576, 14, 1}};
+    for (auto shape : depthwise_shapes) {
+        cases.push_back(CreateConvCase("conv_depthwise", shape[0], shape[0], shape[1], 3, shape[2], shape[0]));
+    }
+
+    const int inner_product_shapes[][2] = {{512, 128}, {1024, 1000}, {1280, 1000}, {2048, 1000}};
+    for (auto shape : inner_product_shapes) {
+        cases.push_back(CreateInnerProductCase(shape[0], shape[1]));
+    }
+
+    cases.push_back(CreatePoolingCase("max_pooling", 0, 64, 112, 3, 2));
+    cases.push_back(CreatePoolingCase("max_pooling", 0, 256, 28, 2, 2));
+    cases.push_back(CreatePoolingCase("avg_pooling", 1, 256, 28, 2, 2));
+    cases.push_back(CreatePoolingCase("global_avg_pooling", 1, 1024, 7, 0, 1));
+    cases.push_back(CreatePoolingCase("global_avg_pooling", 1, 2048, 7, 0, 1));
+
+    const int elementwise_shapes[][2] = {{64, 56}, {256, 14}, {1024, 7}};
+    for (auto shape : elementwise_shapes) {
+        cases.push_back(CreateElementwiseCase("add", LAYER_ADD, 2, shape[0], shape[1]));
+        cases.push_back(CreateElementwiseCase("mul", LAYER_MUL, 2, shape[0], shape[1]));
+        cases.push_back(CreateElementwiseCase("relu", LAYER_RELU, 1, shape[0], shape[1]));
+        cases.push_back(CreateElementwiseCase("sigmoid", LAYER_SIGMOID, 1, shape[0], shape[1]));
+    }
+
+    // classification scores and per pixel segmentation scores
+    cases.push_back(CreateSoftmaxCase(1000, 1));
+    cases.push_back(CreateSoftmaxCase(21, 128));
+    cases.push_back(CreateSoftmaxCase(256, 32));
+
+    cases.push_back(CreateReduceCase("reduce_mean", LAYER_REDUCE_MEAN, 1024, 7, {1}));
+    cases.push_back(CreateReduceCase("reduce_mean", LAYER_REDUCE_MEAN, 256, 28, {1}));
+    cases.push_back(CreateReduceCase("reduce_sum", LAYER_REDUCE_SUM, 256, 28, {1}));
+    cases.push_back(CreateReduceCase("reduce_max", LAYER_REDUCE_MAX, 256, 28, {1}));
+
+    return cases;
+}
+
+}  // namespace TNN_NS
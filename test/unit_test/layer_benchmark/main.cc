@@ -0,0 +1,117 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <stdio.h>
+
+#include <fstream>
+
+#include "test/flags.h"
+#include "test/unit_test/layer_benchmark/layer_benchmark.h"
+#include "tnn/utils/split_utils.h"
+
+namespace TNN_NS {
+
+// enough repetitions for the percentiles if -ic and -wc are not given
+static const int kDefaultRepeatCount = 50;
+static const int kDefaultWarmupCount = 5;
+
+void ShowUsage() {
+    printf("    -dt \"<device type>\"  %s \n", device_type_message);
+    printf("    -lp \"<dependent library path>\"  %s \n", library_path_message);
+    printf("    -ic \"<number>\"        repetitions of each case (default %d) \n", kDefaultRepeatCount);
+    printf("    -wc \"<number>\"        warm up count of each case (default %d) \n", kDefaultWarmupCount);
+    printf("    -th \"<number>\"        %s \n", cpu_thread_num_message);
+    printf("    -bp \"<precisions>\"    %s \n", benchmark_precision_message);
+    printf("    -bf \"<layer>\"         %s \n", benchmark_filter_message);
+    printf("    -op \"<path>\"          write the json report to the path \n");
+}
+
+static bool ParsePrecisions(std::string precisions_str, std::vector<std::string>& names,
+                            std::vector<DataType>& precisions) {
+    SplitUtils::SplitStr(precisions_str.c_str(), names, ",");
+    for (auto name : names) {
+        if (name == "fp32") {
+            precisions.push_back(DATA_TYPE_FLOAT);
+        } else if (name == "bfp16") {
+            precisions.push_back(DATA_TYPE_BFP16);
+        } else if (name == "int8") {
+            precisions.push_back(DATA_TYPE_INT8);
+        } else {
+            printf("unknown precision: %s\n", name.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+int RunLayerBenchmark() {
+    std::vector<std::string> precision_names;
+    std::vector<DataType> precisions;
+    if (!ParsePrecisions(FLAGS_bp, precision_names, precisions)) {
+        return -1;
+    }
+    int repeat_count = gflags::GetCommandLineFlagInfoOrDie("ic").is_default ? kDefaultRepeatCount : FLAGS_ic;
+    int warmup_count = gflags::GetCommandLineFlagInfoOrDie("wc").is_default ? kDefaultWarmupCount : FLAGS_wc;
+
+    std::vector<std::string> library_path;
+    if (!FLAGS_lp.empty()) {
+        library_path.push_back(FLAGS_lp);
+    }
+    LayerBenchmark benchmark;
+    Status status = benchmark.Init(FLAGS_dt, library_path, FLAGS_th);
+    if (status != TNN_OK) {
+        printf("layer benchmark init failed: %s\n", status.description().c_str());
+        return -1;
+    }
+
+    std::vector<LayerBenchmarkResult> results;
+    for (int i = 0; i < precisions.size(); ++i) {
+        for (auto bench_case : CreateLayerBenchmarkCases()) {
+            if (bench_case.layer.find(FLAGS_bf) == std::string::npos) {
+                continue;
+            }
+            LayerBenchmarkResult result;
+            status = benchmark.Run(bench_case, precisions[i], warmup_count, repeat_count, result);
+            if (status != TNN_OK) {
+                printf("%-20s %-28s %-6s skipped: %s\n", bench_case.layer.c_str(), bench_case.shape.c_str(),
+                       precision_names[i].c_str(), status.description().c_str());
+                continue;
+            }
+            printf("%-20s %-28s %-6s mean = %8.3f ms | stddev = %7.3f ms | p50 = %8.3f ms | p99 = %8.3f ms | "
+                   "gflops = %g\n",
+                   result.layer.c_str(), result.shape.c_str(), result.precision.c_str(), result.mean_ms,
+                   result.stddev_ms, result.p50_ms, result.p99_ms,
+                   result.mean_ms > 0 ? result.mflops / result.mean_ms : 0);
+            results.push_back(result);
+        }
+    }
+
+    if (!FLAGS_op.empty()) {
+        std::ofstream json_stream(FLAGS_op);
+        json_stream << LayerBenchmark::GetJsonReport(results);
+        printf("json report: %s\n", FLAGS_op.c_str());
+    }
+    return 0;
+}
+
+}  // namespace TNN_NS
+
+int main(int argc, char* argv[]) {
+    gflags::ParseCommandLineNonHelpFlags(&argc, &argv, true);
+    if (TNN_NS::FLAGS_h) {
+        TNN_NS::ShowUsage();
+        return 0;
+    }
+    return TNN_NS::RunLayerBenchmark();
+}
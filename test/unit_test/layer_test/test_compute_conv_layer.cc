@@ -0,0 +1,235 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "test/test_utils.h"
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/blob_int8.h"
+#include "tnn/device/cpu/acc/cpu_conv_layer_acc.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/naive_compute.h"
+
+namespace TNN_NS {
+
+// a shape class of the cpu conv and the kernel CpuConvLayerAcc::Init must select for it
+struct ConvComputeCase {
+    std::string name;
+    int input_channel;
+    int output_channel;
+    int group;
+    int input_size;
+    int kernel;
+    int stride;
+    int dilation;
+    int pad;
+    std::string impl;
+};
+
+static std::ostream &operator<<(std::ostream &os, const ConvComputeCase &conv_case) {
+    return os << conv_case.name;
+}
+
+// the cpu conv runs depthwise, winograd or im2col + gemm kernels. it is the reference of the device layer
+// tests and of tools/model_check, so each path is checked against NaiveConv here.
+class ComputeConvTest : public ::testing::TestWithParam<std::tuple<ConvComputeCase, int, DataType>> {};
+
+INSTANTIATE_TEST_SUITE_P(
+    LayerTest, ComputeConvTest,
+    ::testing::Combine(
+        testing::Values(
+            // odd output channels leave a partial weight panel
+            ConvComputeCase{"gemm_1x1", 8, 11, 1, 16, 1, 1, 1, 0, "gemm"},
+            ConvComputeCase{"gemm_3x3_s2", 17, 20, 1, 16, 3, 2, 1, 1, "gemm"},
+            ConvComputeCase{"gemm_3x3_dilation", 8, 11, 1, 16, 3, 1, 2, 2, "gemm"},
+            ConvComputeCase{"gemm_3x3_few_channels", 3, 6, 1, 16, 3, 1, 1, 1, "gemm"},
+            ConvComputeCase{"gemm_5x5", 3, 6, 1, 16, 5, 1, 1, 2, "gemm"},
+            ConvComputeCase{"gemm_group", 16, 22, 2, 7, 3, 1, 1, 1, "gemm"},
+            ConvComputeCase{"gemm_depthwise_dilation", 13, 13, 13, 17, 3, 1, 2, 2, "gemm"},
+            ConvComputeCase{"gemm_depthwise_7x7", 13, 13, 13, 17, 7, 1, 1, 3, "gemm"},
+            ConvComputeCase{"depthwise_3x3_s1", 13, 13, 13, 17, 3, 1, 1, 1, "depthwise"},
+            ConvComputeCase{"depthwise_3x3_s2", 4, 4, 4, 6, 3, 2, 1, 0, "depthwise"},
+            ConvComputeCase{"depthwise_5x5_s1", 13, 13, 13, 6, 5, 1, 1, 2, "depthwise"},
+            ConvComputeCase{"depthwise_5x5_s2", 1, 1, 1, 17, 5, 2, 1, 2, "depthwise"},
+            ConvComputeCase{"winograd4", 16, 19, 1, 13, 3, 1, 1, 0, "winograd4"},
+            ConvComputeCase{"winograd4_pad", 8, 11, 1, 28, 3, 1, 1, 1, "winograd4"},
+            ConvComputeCase{"winograd6", 16, 19, 1, 7, 3, 1, 1, 0, "winograd6"},
+            ConvComputeCase{"winograd6_pad", 64, 67, 1, 12, 3, 1, 1, 1, "winograd6"}),
+        // activation
+        testing::Values(ActivationType_None, ActivationType_ReLU, ActivationType_ReLU6),
+        // data_type
+        testing::Values(DATA_TYPE_FLOAT, DATA_TYPE_BFP16, DATA_TYPE_INT8)));
+
+TEST_P(ComputeConvTest, ComputeConv) {
+    auto conv_case      = std::get<0>(GetParam());
+    int activation_type = std::get<1>(GetParam());
+    auto dtype          = std::get<2>(GetParam());
+    if (dtype == DATA_TYPE_INT8 && activation_type == ActivationType_ReLU6) {
+        GTEST_SKIP();
+    }
+
+    int kernel      = conv_case.kernel;
+    int stride      = conv_case.stride;
+    int dilation    = conv_case.dilation;
+    int pad         = conv_case.pad;
+    int group       = conv_case.group;
+    int output_size = (conv_case.input_size + 2 * pad - dilation * (kernel - 1) - 1) / stride + 1;
+
+    DimsVector dims_input  = {2, conv_case.input_channel, conv_case.input_size, conv_case.input_size};
+    DimsVector dims_output = {2, conv_case.output_channel, output_size, output_size};
+    int input_count        = DimsVectorUtils::Count(dims_input);
+    int output_count       = DimsVectorUtils::Count(dims_output);
+    int output_channel     = conv_case.output_channel;
+    int filter_count       = output_channel * conv_case.input_channel / group * kernel * kernel;
+
+    ConvLayerParam param;
+    param.name            = "Conv";
+    param.input_channel   = conv_case.input_channel / group;
+    param.output_channel  = output_channel;
+    param.group           = group;
+    param.kernels         = {kernel, kernel};
+    param.strides         = {stride, stride};
+    param.dialations      = {dilation, dilation};
+    param.pads            = {pad, pad, pad, pad};
+    param.bias            = 1;
+    param.activation_type = activation_type;
+    param.quantized       = dtype == DATA_TYPE_INT8;
+
+    ConvLayerResource resource;
+    IntScaleResource input_scale, output_scale;
+    std::vector<float> scale(output_channel);
+    int data_bytes = DataTypeUtils::GetBytesSize(dtype);
+    std::vector<char> input(input_count * data_bytes);
+    std::vector<char> output(output_count * data_bytes), ref(output_count * data_bytes);
+    if (dtype == DATA_TYPE_INT8) {
+        std::vector<int8_t> filter(filter_count);
+        std::vector<int32_t> bias(output_channel);
+        InitRandom(reinterpret_cast<int8_t *>(input.data()), input_count, (int8_t)8);
+        InitRandom(filter.data(), filter_count, (int8_t)8);
+        InitRandom(bias.data(), output_channel, (int32_t)1000);
+        InitRandom(scale.data(), output_channel, 0.01f, 0.05f);
+        resource.filter_handle = RawBuffer(filter_count * sizeof(int8_t), reinterpret_cast<char *>(filter.data()));
+        resource.filter_handle.SetDataType(DATA_TYPE_INT8);
+        resource.bias_handle = RawBuffer(output_channel * sizeof(int32_t), reinterpret_cast<char *>(bias.data()));
+        resource.bias_handle.SetDataType(DATA_TYPE_INT32);
+        // the output scale is 1, the acc scales the outputs by the weight scales as they are
+        resource.scale_handle = RawBuffer(output_channel * sizeof(float), reinterpret_cast<char *>(scale.data()));
+        float unit_scale          = 1.0f;
+        input_scale.scale_handle  = RawBuffer(sizeof(float), reinterpret_cast<char *>(&unit_scale));
+        output_scale.scale_handle = RawBuffer(sizeof(float), reinterpret_cast<char *>(&unit_scale));
+
+        NaiveConv<int8_t, int8_t, int32_t, int8_t>(input.data(), ref.data(), filter.data(), bias.data(), dims_input,
+                                                   dims_output, stride, stride, kernel, kernel, pad, pad, group,
+                                                   dilation, activation_type, scale.data(), output_channel);
+    } else {
+        std::vector<float> input_fp(input_count), filter(filter_count), bias(output_channel);
+        InitRandom(input_fp.data(), input_count, 1.0f);
+        InitRandom(filter.data(), filter_count, 1.0f);
+        InitRandom(bias.data(), output_channel, 1.0f);
+        resource.filter_handle = RawBuffer(filter_count * sizeof(float), reinterpret_cast<char *>(filter.data()));
+        resource.filter_handle.SetDataType(DATA_TYPE_FLOAT);
+        resource.bias_handle = RawBuffer(output_channel * sizeof(float), reinterpret_cast<char *>(bias.data()));
+        resource.bias_handle.SetDataType(DATA_TYPE_FLOAT);
+
+        if (dtype == DATA_TYPE_BFP16) {
+            auto input_bf = reinterpret_cast<bfp16_t *>(input.data());
+            std::copy(input_fp.begin(), input_fp.end(), input_bf);
+            NaiveConv<bfp16_t, float, float, bfp16_t>(input_bf, ref.data(), filter.data(), bias.data(), dims_input,
+                                                      dims_output, stride, stride, kernel, kernel, pad, pad, group,
+                                                      dilation, activation_type, nullptr, 0);
+        } else {
+            std::copy(input_fp.begin(), input_fp.end(), reinterpret_cast<float *>(input.data()));
+            NaiveConv<float, float, float, float>(input.data(), ref.data(), filter.data(), bias.data(), dims_input,
+                                                  dims_output, stride, stride, kernel, kernel, pad, pad, group,
+                                                  dilation, activation_type, nullptr, 0);
+        }
+    }
+
+    BlobDesc input_desc;
+    input_desc.device_type = DEVICE_NAIVE;
+    input_desc.data_type   = dtype;
+    input_desc.data_format = DATA_FORMAT_NCHW;
+    input_desc.dims        = dims_input;
+    BlobDesc output_desc   = input_desc;
+    output_desc.dims       = dims_output;
+    BlobHandle input_handle, output_handle;
+    input_handle.base  = input.data();
+    output_handle.base = output.data();
+    std::shared_ptr<Blob> input_blob, output_blob;
+    if (dtype == DATA_TYPE_INT8) {
+        auto input_int8  = std::make_shared<BlobInt8>(input_desc, input_handle);
+        auto output_int8 = std::make_shared<BlobInt8>(output_desc, output_handle);
+        input_int8->SetIntResource(&input_scale);
+        output_int8->SetIntResource(&output_scale);
+        input_blob  = input_int8;
+        output_blob = output_int8;
+    } else {
+        input_blob  = std::make_shared<Blob>(input_desc, input_handle);
+        output_blob = std::make_shared<Blob>(output_desc, output_handle);
+    }
+    std::vector<Blob *> inputs  = {input_blob.get()};
+    std::vector<Blob *> outputs = {output_blob.get()};
+
+    auto device = GetDevice(DEVICE_NAIVE);
+    std::shared_ptr<Context> context(device->CreateContext(0));
+    std::shared_ptr<AbstractLayerAcc> acc(device->CreateLayerAcc(LAYER_CONVOLUTION));
+    ASSERT_TRUE(context && acc);
+    Status status = acc->Init(context.get(), &param, &resource, inputs, outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+    status = acc->Forward(inputs, outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+
+    // int8 convs always run the gemm
+    auto conv_acc = dynamic_cast<CpuConvLayerAcc *>(acc.get());
+    ASSERT_TRUE(conv_acc != nullptr);
+    EXPECT_EQ(dtype == DATA_TYPE_INT8 ? "gemm" : conv_case.impl, conv_acc->GetImplName());
+
+    if (dtype == DATA_TYPE_INT8) {
+        EXPECT_EQ(0, CompareData(reinterpret_cast<int8_t *>(output.data()), reinterpret_cast<int8_t *>(ref.data()),
+                                 output_count));
+    } else if (dtype == DATA_TYPE_BFP16) {
+        EXPECT_EQ(0, CompareData(reinterpret_cast<bfp16_t *>(output.data()), reinterpret_cast<bfp16_t *>(ref.data()),
+                                 output_count, 0.05f));
+    } else if (conv_acc->GetImplName().find("winograd") == 0) {
+        // the transforms round differently from a direct conv, with inputs, weights and bias in [-1, 1] the fp32
+        // error divided by the 9 * ic + 1 terms summed per output measured below 1.5e-6 for F(4x4, 3x3) and
+        // 3e-6 for F(6x6, 3x3), the bounds keep a margin.
+        auto result     = reinterpret_cast<float *>(output.data());
+        auto reference  = reinterpret_cast<float *>(ref.data());
+        float max_error = 0;
+        for (int i = 0; i < output_count; i++) {
+            max_error = std::max(max_error, std::fabs(result[i] - reference[i]));
+        }
+        float bound = conv_case.impl == "winograd4" ? 4e-6f : 1e-5f;
+        EXPECT_LE(max_error, bound * (9 * conv_case.input_channel + 1));
+    } else {
+        EXPECT_EQ(0, CompareData(reinterpret_cast<float *>(output.data()), reinterpret_cast<float *>(ref.data()),
+                                 output_count, 0.001f));
+    }
+}
+
+}  // namespace TNN_NS
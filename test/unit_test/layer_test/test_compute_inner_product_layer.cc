@@ -0,0 +1,183 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "test/test_utils.h"
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/core/blob_int8.h"
+#include "tnn/interpreter/layer_param.h"
+#include "tnn/interpreter/layer_resource.h"
+#include "tnn/utils/bfp16.h"
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/half_utils.h"
+#include "tnn/utils/naive_compute.h"
+
+namespace TNN_NS {
+
+// the cpu inner product runs a gemv for a batch of 1 and packs larger batches into panels, a batch of 33 leaves
+// a partial panel. it is the reference of the device layer tests, so each path is checked against NaiveFC here.
+class ComputeInnerProductTest : public ::testing::TestWithParam<std::tuple<int, int, DataType, bool>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ComputeInnerProductTest,
+                         ::testing::Combine(
+                             // batch
+                             testing::Values(1, 2, 33),
+                             // output channel, odd leaves a partial weight panel
+                             testing::Values(8, 13),
+                             // data_type
+                             testing::Values(DATA_TYPE_FLOAT, DATA_TYPE_BFP16, DATA_TYPE_INT8),
+                             // weights and bias stored in half by the model
+                             testing::Values(false, true)));
+
+static RawBuffer CreateFloatHandle(std::vector<float> &data, bool half) {
+    int count = (int)data.size();
+    if (!half) {
+        RawBuffer buffer(count * sizeof(float), reinterpret_cast<char *>(data.data()));
+        buffer.SetDataType(DATA_TYPE_FLOAT);
+        return buffer;
+    }
+    RawBuffer buffer(count * 2);
+    ConvertFromFloatToHalf(data.data(), buffer.force_to<void *>(), count);
+    buffer.SetDataType(DATA_TYPE_HALF);
+    // the reference reads the values the half weights hold
+    ConvertFromHalfToFloat(buffer.force_to<void *>(), data.data(), count);
+    return buffer;
+}
+
+TEST_P(ComputeInnerProductTest, ComputeInnerProduct) {
+    int batch          = std::get<0>(GetParam());
+    int output_channel = std::get<1>(GetParam());
+    auto dtype         = std::get<2>(GetParam());
+    bool half          = std::get<3>(GetParam());
+    if (dtype == DATA_TYPE_INT8 && half) {
+        GTEST_SKIP();
+    }
+
+    DimsVector dims_input  = {batch, 11, 3, 3};
+    DimsVector dims_output = {batch, output_channel, 1, 1};
+    int input_count        = DimsVectorUtils::Count(dims_input);
+    int output_count       = DimsVectorUtils::Count(dims_output);
+    int input_size         = DimsVectorUtils::Count(dims_input, 1);
+    int weight_count       = output_channel * input_size;
+
+    InnerProductLayerParam param;
+    param.name       = "InnerProduct";
+    param.num_output = output_channel;
+    param.has_bias   = 1;
+    param.axis       = 1;
+    param.quantized  = dtype == DATA_TYPE_INT8;
+
+    InnerProductLayerResource resource;
+    IntScaleResource input_scale, output_scale;
+    std::vector<float> scale(output_channel);
+    int data_bytes = DataTypeUtils::GetBytesSize(dtype);
+    std::vector<char> input(input_count * data_bytes);
+    std::vector<char> output(output_count * data_bytes), ref(output_count * data_bytes);
+    if (dtype == DATA_TYPE_INT8) {
+        std::vector<int8_t> weights(weight_count);
+        std::vector<int32_t> bias(output_channel);
+        InitRandom(reinterpret_cast<int8_t *>(input.data()), input_count, (int8_t)8);
+        InitRandom(weights.data(), weight_count, (int8_t)8);
+        InitRandom(bias.data(), output_channel, (int32_t)1000);
+        InitRandom(scale.data(), output_channel, 0.01f, 0.05f);
+        resource.weight_handle = RawBuffer(weight_count * sizeof(int8_t), reinterpret_cast<char *>(weights.data()));
+        resource.weight_handle.SetDataType(DATA_TYPE_INT8);
+        resource.bias_handle = RawBuffer(output_channel * sizeof(int32_t), reinterpret_cast<char *>(bias.data()));
+        resource.bias_handle.SetDataType(DATA_TYPE_INT32);
+        // the output scale is 1, the acc scales the outputs by the weight scales as they are
+        resource.scale_handle = RawBuffer(output_channel * sizeof(float), reinterpret_cast<char *>(scale.data()));
+        float unit_scale          = 1.0f;
+        input_scale.scale_handle  = RawBuffer(sizeof(float), reinterpret_cast<char *>(&unit_scale));
+        output_scale.scale_handle = RawBuffer(sizeof(float), reinterpret_cast<char *>(&unit_scale));
+
+        NaiveFC(input.data(), ref.data(), weights.data(), scale.data(), output_channel, bias.data(), dims_input,
+                dims_output);
+    } else {
+        std::vector<float> input_fp(input_count), weights(weight_count), bias(output_channel);
+        InitRandom(input_fp.data(), input_count, 1.0f);
+        InitRandom(weights.data(), weight_count, 1.0f);
+        InitRandom(bias.data(), output_channel, 1.0f);
+        resource.weight_handle = CreateFloatHandle(weights, half);
+        resource.bias_handle   = CreateFloatHandle(bias, half);
+
+        if (dtype == DATA_TYPE_BFP16) {
+            // the acc keeps fp32 weights for bfp16 blobs, the reference runs fp32 on the bfp16 inputs
+            auto input_bf = reinterpret_cast<bfp16_t *>(input.data());
+            std::copy(input_fp.begin(), input_fp.end(), input_bf);
+            std::copy(input_bf, input_bf + input_count, input_fp.begin());
+            std::vector<float> ref_fp(output_count);
+            NaiveFC(input_fp.data(), ref_fp.data(), weights.data(), bias.data(), dims_input, dims_output);
+            std::copy(ref_fp.begin(), ref_fp.end(), reinterpret_cast<bfp16_t *>(ref.data()));
+        } else {
+            std::copy(input_fp.begin(), input_fp.end(), reinterpret_cast<float *>(input.data()));
+            NaiveFC(reinterpret_cast<float *>(input.data()), reinterpret_cast<float *>(ref.data()), weights.data(),
+                    bias.data(), dims_input, dims_output);
+        }
+    }
+
+    BlobDesc input_desc;
+    input_desc.device_type = DEVICE_NAIVE;
+    input_desc.data_type   = dtype;
+    input_desc.data_format = DATA_FORMAT_NCHW;
+    input_desc.dims        = dims_input;
+    BlobDesc output_desc   = input_desc;
+    output_desc.dims       = dims_output;
+    BlobHandle input_handle, output_handle;
+    input_handle.base  = input.data();
+    output_handle.base = output.data();
+    std::shared_ptr<Blob> input_blob, output_blob;
+    if (dtype == DATA_TYPE_INT8) {
+        auto input_int8  = std::make_shared<BlobInt8>(input_desc, input_handle);
+        auto output_int8 = std::make_shared<BlobInt8>(output_desc, output_handle);
+        input_int8->SetIntResource(&input_scale);
+        output_int8->SetIntResource(&output_scale);
+        input_blob  = input_int8;
+        output_blob = output_int8;
+    } else {
+        input_blob  = std::make_shared<Blob>(input_desc, input_handle);
+        output_blob = std::make_shared<Blob>(output_desc, output_handle);
+    }
+    std::vector<Blob *> inputs  = {input_blob.get()};
+    std::vector<Blob *> outputs = {output_blob.get()};
+
+    auto device = GetDevice(DEVICE_NAIVE);
+    std::shared_ptr<Context> context(device->CreateContext(0));
+    std::shared_ptr<AbstractLayerAcc> acc(device->CreateLayerAcc(LAYER_INNER_PRODUCT));
+    ASSERT_TRUE(context && acc);
+    Status status = acc->Init(context.get(), &param, &resource, inputs, outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+    status = acc->Forward(inputs, outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+
+    if (dtype == DATA_TYPE_INT8) {
+        EXPECT_EQ(0, CompareData(reinterpret_cast<int8_t *>(output.data()), reinterpret_cast<int8_t *>(ref.data()),
+                                 output_count));
+    } else if (dtype == DATA_TYPE_BFP16) {
+        EXPECT_EQ(0, CompareData(reinterpret_cast<bfp16_t *>(output.data()), reinterpret_cast<bfp16_t *>(ref.data()),
+                                 output_count, 0.05f));
+    } else {
+        EXPECT_EQ(0, CompareData(reinterpret_cast<float *>(output.data()), reinterpret_cast<float *>(ref.data()),
+                                 output_count, 0.001f));
+    }
+}
+
+}  // namespace TNN_NS
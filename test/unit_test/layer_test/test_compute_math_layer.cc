@@ -0,0 +1,154 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/device/cpu/acc/compute/compute_math.h"
+
+namespace TNN_NS {
+
+struct MathCase {
+    void (*func)(const float *src, float *dst, int count);
+    double (*ref)(double);
+    float lower;
+    float upper;
+    double max_ulp;
+};
+
+static double Exp(double x) {
+    return std::exp(x);
+}
+static double Log(double x) {
+    return std::log(x);
+}
+static double Tanh(double x) {
+    return std::tanh(x);
+}
+static double Sigmoid(double x) {
+    return 1.0 / (1.0 + std::exp(-x));
+}
+
+// the ulp bounds documented in compute_math.h, checked on a sample of the floats in each range
+static const MathCase kMathCases[] = {
+    {CPU_EXP, Exp, -87.3f, 88.7f, 1.3},
+    {CPU_LOG, Log, 1.2e-38f, 3e38f, 0.8},
+    {CPU_TANH, Tanh, -20.0f, 20.0f, 1.4},
+    {CPU_SIGMOID, Sigmoid, -87.0f, 87.0f, 3.2},
+};
+
+class ComputeMathTest : public ::testing::TestWithParam<int> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ComputeMathTest,
+                         // exp, log, tanh, sigmoid
+                         testing::Values(0, 1, 2, 3));
+
+static double UlpError(float result, double ref) {
+    float ref_float = static_cast<float>(ref);
+    if (std::isinf(ref_float)) {
+        return result == ref_float ? 0 : INFINITY;
+    }
+    double ulp = std::nextafter(std::fabs(ref_float), INFINITY) - std::fabs(ref_float);
+    return std::fabs(result - ref) / ulp;
+}
+
+TEST_P(ComputeMathTest, ComputeMath) {
+    const MathCase &math = kMathCases[GetParam()];
+
+    // every 4099th float of both signs, the odd count leaves a tail shorter than a register
+    std::vector<float> src;
+    for (uint32_t bits = 0; bits < 0xff800000u; bits += 4099) {
+        float value;
+        memcpy(&value, &bits, sizeof(value));
+        if (value >= math.lower && value <= math.upper) {
+            src.push_back(value);
+        }
+    }
+    std::vector<float> dst(src.size());
+    math.func(src.data(), dst.data(), (int)src.size());
+
+    double worst = 0;
+    for (size_t i = 0; i < src.size(); i++) {
+        worst = std::max(worst, UlpError(dst[i], math.ref(src[i])));
+    }
+    EXPECT_LE(worst, math.max_ulp);
+
+    float special[] = {0.0f, INFINITY, -INFINITY, NAN};
+    math.func(special, special, 4);
+    EXPECT_TRUE(std::isnan(special[3]));
+}
+
+// rows longer than one block of the running max, tiles narrower than a register and the in-place call
+class ComputeSoftmaxTest : public ::testing::TestWithParam<std::tuple<int, int>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ComputeSoftmaxTest,
+                         ::testing::Combine(
+                             // channel
+                             testing::Values(3, 1000, 5000),
+                             // inside
+                             testing::Values(1, 3, 100)));
+
+TEST_P(ComputeSoftmaxTest, ComputeSoftmax) {
+    const int outer   = 2;
+    const int channel = std::get<0>(GetParam());
+    const int inside  = std::get<1>(GetParam());
+    const int count   = outer * channel * inside;
+
+    std::vector<float> src(count);
+    InitRandom(src.data(), count, -30.0f, 30.0f);
+    // a rising row makes the running max grow in every block
+    for (int c = 0; c < channel; c++) {
+        src[c * inside] = -30.0f + 60.0f * c / channel;
+    }
+
+    std::vector<double> ref(count);
+    for (int n = 0; n < outer; n++) {
+        for (int i = 0; i < inside; i++) {
+            const float *x = src.data() + n * channel * inside + i;
+            double max     = -INFINITY;
+            double sum     = 0;
+            for (int c = 0; c < channel; c++) {
+                max = std::max(max, (double)x[c * inside]);
+            }
+            for (int c = 0; c < channel; c++) {
+                sum += std::exp(x[c * inside] - max);
+            }
+            for (int c = 0; c < channel; c++) {
+                ref[n * channel * inside + c * inside + i] = std::exp(x[c * inside] - max) / sum;
+            }
+        }
+    }
+
+    std::vector<float> workspace(CPU_SOFTMAX_WORKSPACE_COUNT(channel, inside));
+    std::vector<float> dst(count);
+    CPU_SOFTMAX(src.data(), dst.data(), outer, channel, inside, workspace.data());
+    CPU_SOFTMAX(src.data(), src.data(), outer, channel, inside, workspace.data());
+
+    double worst = 0;
+    for (int i = 0; i < count; i++) {
+        worst = std::max(worst, std::fabs(dst[i] - ref[i]) / ref[i]);
+        EXPECT_EQ(dst[i], src[i]);
+    }
+    EXPECT_LE(worst, 1e-5);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,136 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/device/cpu/acc/compute/compute_reduce.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+// the layer tests reduce one axis, the engine is checked on axis sets that merge, interleave or cover all dims
+class ComputeReduceTest : public ::testing::TestWithParam<std::tuple<int, int>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ComputeReduceTest,
+                         ::testing::Combine(
+                             // reduce type
+                             testing::Range(0, (int)CPU_REDUCE_LOG_SUM_EXP + 1),
+                             // bit d set reduces dim d
+                             testing::Range(1, 16)));
+
+static double ReduceReference(CpuReduceType type, const std::vector<double> &values) {
+    double result = type == CPU_REDUCE_MAX ? -INFINITY : type == CPU_REDUCE_MIN ? INFINITY
+                                                       : type == CPU_REDUCE_PROD ? 1.0 : 0.0;
+    for (double x : values) {
+        switch (type) {
+            case CPU_REDUCE_MAX:
+                result = std::max(result, x);
+                break;
+            case CPU_REDUCE_MIN:
+                result = std::min(result, x);
+                break;
+            case CPU_REDUCE_PROD:
+                result *= x;
+                break;
+            case CPU_REDUCE_L1:
+                result += std::fabs(x);
+                break;
+            case CPU_REDUCE_L2:
+            case CPU_REDUCE_SUM_SQUARE:
+                result += x * x;
+                break;
+            case CPU_REDUCE_LOG_SUM_EXP:
+                result += std::exp(x);
+                break;
+            default:
+                result += x;
+                break;
+        }
+    }
+    switch (type) {
+        case CPU_REDUCE_MEAN:
+            return result / values.size();
+        case CPU_REDUCE_L2:
+            return std::sqrt(result);
+        case CPU_REDUCE_LOG_SUM:
+        case CPU_REDUCE_LOG_SUM_EXP:
+            return std::log(result);
+        default:
+            return result;
+    }
+}
+
+TEST_P(ComputeReduceTest, ComputeReduce) {
+    auto type = (CpuReduceType)std::get<0>(GetParam());
+    int mask  = std::get<1>(GetParam());
+
+    // the trailing dim is long enough for full registers and a tail, the dim of size 1 is dropped
+    DimsVector dims = {3, 5, 1, 37};
+    std::vector<int> axes;
+    DimsVector output_dims = dims;
+    for (int d = 0; d < 4; d++) {
+        if (mask & (1 << d)) {
+            axes.push_back(d);
+            output_dims[d] = 1;
+        }
+    }
+    std::reverse(axes.begin(), axes.end());
+
+    int count = DimsVectorUtils::Count(dims);
+    std::vector<float> src(count);
+    // positive inputs keep log sum and prod finite
+    InitRandom(src.data(), count, 0.5f, 1.5f);
+
+    int output_count = DimsVectorUtils::Count(output_dims);
+    std::vector<std::vector<double>> groups(output_count);
+    for (int i = 0; i < count; i++) {
+        int index = i, output_index = 0, stride = 1;
+        for (int d = 3; d >= 0; d--) {
+            int coord = index % dims[d];
+            index /= dims[d];
+            output_index += (mask & (1 << d) ? 0 : coord) * stride;
+            stride *= output_dims[d];
+        }
+        groups[output_index].push_back(src[i]);
+    }
+
+    std::vector<float> dst(output_count);
+    CPU_REDUCE(type, src.data(), dst.data(), CPU_REDUCE_PLAN(dims, axes));
+    for (int i = 0; i < output_count; i++) {
+        double ref = ReduceReference(type, groups[i]);
+        EXPECT_NEAR(dst[i], ref, 1e-5 * std::max(1.0, std::fabs(ref))) << "output " << i;
+    }
+}
+
+TEST(ComputeReduceSumTest, CompensatedSum) {
+    // a float running sum of 4M values of 0.1 drifts by percents, the blocked sum stays within rounding
+    const int count = 4 << 20;
+    std::vector<float> src(count, 0.1f);
+    float dst[3];
+    CPU_REDUCE(CPU_REDUCE_SUM, src.data(), dst, CPU_REDUCE_PLAN({count}, {0}));
+    // the same values as two interleaved lanes
+    CPU_REDUCE(CPU_REDUCE_SUM, src.data(), dst + 1, CPU_REDUCE_PLAN({count / 2, 2}, {0}));
+    double ref = 0.1f * (double)count;
+    EXPECT_NEAR(dst[0], ref, ref * 1e-6);
+    EXPECT_NEAR(dst[1], ref / 2, ref * 1e-6);
+    EXPECT_NEAR(dst[2], ref / 2, ref * 1e-6);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,253 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/core/abstract_device.h"
+#include "tnn/utils/detection_post_processor.h"
+#include "tnn/utils/naive_compute.h"
+
+namespace TNN_NS {
+
+// the post processor against the caffe style reference in naive_compute
+class DetectionOutputTest : public ::testing::TestWithParam<std::tuple<int, int, int, float>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, DetectionOutputTest,
+                         ::testing::Combine(
+                             // share location
+                             testing::Values(0, 1),
+                             // code type
+                             testing::Values(1, 2, 3),
+                             // 0: loc, conf, prior  1: and arm conf  2: and arm loc
+                             testing::Values(0, 1, 2),
+                             // eta
+                             testing::Values(1.0f, 0.9f)));
+
+struct DetectionInputs {
+    std::vector<std::vector<float>> data;
+    std::vector<std::shared_ptr<Blob>> blobs;
+    std::vector<float> output_data;
+    std::shared_ptr<Blob> output;
+
+    void Add(const DimsVector &dims, const std::vector<float> &values) {
+        data.push_back(values);
+        BlobDesc desc;
+        desc.dims = dims;
+        BlobHandle handle;
+        handle.base = data.back().data();
+        blobs.push_back(std::make_shared<Blob>(desc, handle));
+    }
+
+    // a fresh output of [1, 1, keep_top_k, 7] with room for every row the inputs could give
+    Blob *Output(int keep_top_k, int capacity) {
+        output_data.assign(capacity * 7, 0.f);
+        BlobDesc desc;
+        desc.dims = {1, 1, keep_top_k, 7};
+        BlobHandle handle;
+        handle.base = output_data.data();
+        output      = std::make_shared<Blob>(desc, handle);
+        return output.get();
+    }
+
+    std::vector<Blob *> Inputs() {
+        std::vector<Blob *> inputs;
+        for (auto &blob : blobs) {
+            inputs.push_back(blob.get());
+        }
+        return inputs;
+    }
+};
+
+static void MakeInputs(int num, int num_priors, int num_classes, int num_loc_classes, int extra_inputs,
+                       DetectionInputs &inputs) {
+    // boxes of 0.05 to 0.4 spread over the image, most classes see overlapping candidates
+    std::vector<float> prior(num_priors * 8);
+    for (int p = 0; p < num_priors; p++) {
+        float center[2], size[2];
+        InitRandom(center, 2, 0.f, 1.f);
+        InitRandom(size, 2, 0.05f, 0.4f);
+        prior[p * 4]     = center[0] - size[0] / 2;
+        prior[p * 4 + 1] = center[1] - size[1] / 2;
+        prior[p * 4 + 2] = center[0] + size[0] / 2;
+        prior[p * 4 + 3] = center[1] + size[1] / 2;
+        float variance[4] = {0.1f, 0.1f, 0.2f, 0.2f};
+        for (int i = 0; i < 4; i++) {
+            prior[(num_priors + p) * 4 + i] = variance[i];
+        }
+    }
+    std::vector<float> loc(num * num_priors * num_loc_classes * 4);
+    InitRandom(loc.data(), loc.size(), -1.f, 1.f);
+    std::vector<float> conf(num * num_priors * num_classes);
+    InitRandom(conf.data(), conf.size(), 0.f, 1.f);
+
+    inputs.Add({num, num_priors * num_loc_classes * 4, 1, 1}, loc);
+    inputs.Add({num, num_priors * num_classes, 1, 1}, conf);
+    inputs.Add({1, 2, num_priors * 4, 1}, prior);
+    if (extra_inputs >= 1) {
+        std::vector<float> arm_conf(num * num_priors * 2);
+        InitRandom(arm_conf.data(), arm_conf.size(), 0.f, 1.f);
+        inputs.Add({num, num_priors * 2, 1, 1}, arm_conf);
+    }
+    if (extra_inputs >= 2) {
+        std::vector<float> arm_loc(num * num_priors * num_loc_classes * 4);
+        InitRandom(arm_loc.data(), arm_loc.size(), -0.5f, 0.5f);
+        inputs.Add({num, num_priors * num_loc_classes * 4, 1, 1}, arm_loc);
+    }
+}
+
+static DetectionOutputLayerParam MakeParam(int num_classes, bool share_location, int code_type) {
+    DetectionOutputLayerParam param;
+    param.num_classes                = num_classes;
+    param.share_location             = share_location;
+    param.background_label_id        = 0;
+    param.variance_encoded_in_target = false;
+    param.code_type                  = code_type;
+    param.keep_top_k                 = 60;
+    param.confidence_threshold       = 0.3f;
+    param.nms_param.nms_threshold    = 0.45f;
+    param.nms_param.top_k            = 100;
+    param.eta                        = 1.0f;
+    return param;
+}
+
+TEST_P(DetectionOutputTest, MatchesReference) {
+    const bool share_location = std::get<0>(GetParam()) != 0;
+    const int code_type       = std::get<1>(GetParam());
+    const int extra_inputs    = std::get<2>(GetParam());
+    // refinedet decodes the arm loc with the loc of class -1 only
+    if (extra_inputs == 2 && !share_location) {
+        return;
+    }
+
+    const int num = 2, num_priors = 500, num_classes = 5;
+    DetectionInputs inputs;
+    MakeInputs(num, num_priors, num_classes, share_location ? 1 : num_classes, extra_inputs, inputs);
+    auto param = MakeParam(num_classes, share_location, code_type);
+    param.eta  = std::get<3>(GetParam());
+
+    // keep_top_k truncates on the first forward and keeps all detections on the second
+    DetectionPostProcessor processor;
+    for (int keep_top_k : {60, 2000}) {
+        param.keep_top_k = keep_top_k;
+        const int capacity = num * num_classes * num_priors;
+        Blob *expect       = inputs.Output(keep_top_k, capacity);
+        NaiveDetectionOutput(inputs.Inputs(), {expect}, &param);
+        std::vector<float> expect_data(inputs.output_data);
+        int expect_count = expect->GetBlobDesc().dims[2];
+
+        Blob *output = inputs.Output(keep_top_k, capacity);
+        ASSERT_EQ((int)processor.Forward(inputs.Inputs(), {output}, &param), (int)TNN_OK);
+        ASSERT_EQ(output->GetBlobDesc().dims[2], expect_count);
+        ASSERT_GT(expect_count, num);
+        for (int i = 0; i < expect_count * 7; i++) {
+            ASSERT_NEAR(inputs.output_data[i], expect_data[i], 1e-5f) << "row " << i / 7 << " col " << i % 7;
+        }
+    }
+}
+
+// two overlapping boxes of class 1 and a box of class 2 on top of the first
+static void MakeOverlapInputs(DetectionInputs &inputs) {
+    std::vector<float> prior = {0.1f, 0.1f, 0.5f, 0.5f, 0.2f, 0.1f, 0.6f, 0.5f, 0.1f, 0.1f, 0.5f, 0.5f,
+                                0.1f, 0.1f, 0.2f, 0.2f, 0.1f, 0.1f, 0.2f, 0.2f, 0.1f, 0.1f, 0.2f, 0.2f};
+    std::vector<float> loc(3 * 4, 0.f);
+    // [prior][class] of background, class 1 and class 2
+    std::vector<float> conf = {0.f, 0.9f, 0.f, 0.f, 0.7f, 0.f, 0.f, 0.f, 0.7f};
+    inputs.Add({1, 12, 1, 1}, loc);
+    inputs.Add({1, 9, 1, 1}, conf);
+    inputs.Add({1, 2, 12, 1}, prior);
+}
+
+TEST(DetectionOutputModeTest, ClassAgnostic) {
+    DetectionInputs inputs;
+    MakeOverlapInputs(inputs);
+    auto param = MakeParam(3, true, 1);
+
+    DetectionPostProcessor processor;
+    Blob *output = inputs.Output(param.keep_top_k, 3);
+    ASSERT_EQ((int)processor.Forward(inputs.Inputs(), {output}, &param), (int)TNN_OK);
+    // per class the box of class 2 survives, the two boxes of class 1 overlap by 0.6
+    ASSERT_EQ(output->GetBlobDesc().dims[2], 2);
+    EXPECT_EQ(inputs.output_data[1], 1.f);
+    EXPECT_EQ(inputs.output_data[7 + 1], 2.f);
+
+    param.class_agnostic = 1;
+    output               = inputs.Output(param.keep_top_k, 3);
+    ASSERT_EQ((int)processor.Forward(inputs.Inputs(), {output}, &param), (int)TNN_OK);
+    // the box of class 2 is the box of the best class 1 detection
+    ASSERT_EQ(output->GetBlobDesc().dims[2], 1);
+    EXPECT_EQ(inputs.output_data[1], 1.f);
+    EXPECT_FLOAT_EQ(inputs.output_data[2], 0.9f);
+}
+
+TEST(DetectionOutputModeTest, SoftNMS) {
+    DetectionInputs inputs;
+    MakeOverlapInputs(inputs);
+    auto param = MakeParam(3, true, 1);
+    // the iou of the two class 1 boxes
+    const float iou = 0.12f / 0.2f;
+
+    DetectionPostProcessor processor;
+    param.nms_type = NMSTypeSoftLinear;
+    Blob *output   = inputs.Output(param.keep_top_k, 3);
+    ASSERT_EQ((int)processor.Forward(inputs.Inputs(), {output}, &param), (int)TNN_OK);
+    // 0.7 * (1 - 0.6) falls below the confidence threshold
+    ASSERT_EQ(output->GetBlobDesc().dims[2], 2);
+    EXPECT_FLOAT_EQ(inputs.output_data[2], 0.9f);
+    EXPECT_EQ(inputs.output_data[7 + 1], 2.f);
+
+    param.nms_type       = NMSTypeSoftGaussian;
+    param.soft_nms_sigma = 1.f;
+    output               = inputs.Output(param.keep_top_k, 3);
+    ASSERT_EQ((int)processor.Forward(inputs.Inputs(), {output}, &param), (int)TNN_OK);
+    ASSERT_EQ(output->GetBlobDesc().dims[2], 3);
+    EXPECT_FLOAT_EQ(inputs.output_data[2], 0.9f);
+    EXPECT_NEAR(inputs.output_data[7 + 2], 0.7f * std::exp(-iou * iou), 1e-5f);
+    EXPECT_EQ(inputs.output_data[14 + 1], 2.f);
+}
+
+TEST(DetectionOutputModeTest, RejectInvalidNMSParam) {
+    DetectionInputs inputs;
+    MakeOverlapInputs(inputs);
+    std::vector<Blob *> outputs = {inputs.Output(3, 3)};
+    auto device                 = GetDevice(DEVICE_NAIVE);
+    std::shared_ptr<Context> context(device->CreateContext(0));
+
+    // an unknown nms type and a gaussian decay dividing by a sigma of 0 or less
+    std::vector<std::pair<int, float>> invalid_params = {
+        {3, 0.5f}, {-1, 0.5f}, {NMSTypeSoftGaussian, 0.f}, {NMSTypeSoftGaussian, -1.f}};
+    for (auto &nms : invalid_params) {
+        auto param           = MakeParam(3, true, 1);
+        param.nms_type       = nms.first;
+        param.soft_nms_sigma = nms.second;
+        EXPECT_EQ((int)DetectionPostProcessor::CheckParam(&param), (int)TNNERR_PARAM_ERR);
+
+        std::shared_ptr<AbstractLayerAcc> acc(device->CreateLayerAcc(LAYER_DETECTION_OUTPUT));
+        ASSERT_TRUE(context && acc);
+        EXPECT_EQ((int)acc->Init(context.get(), &param, nullptr, inputs.Inputs(), outputs), (int)TNNERR_PARAM_ERR);
+    }
+
+    // the sigma is unused by the other nms types
+    auto param           = MakeParam(3, true, 1);
+    param.nms_type       = NMSTypeSoftLinear;
+    param.soft_nms_sigma = 0.f;
+    EXPECT_EQ((int)DetectionPostProcessor::CheckParam(&param), (int)TNN_OK);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,100 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "test/test_utils.h"
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/device/cpu/acc/compute/compute_elewise.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+// the element-wise engine classifies each operand once, every pattern is checked against plain broadcast
+// indexing on ranks the layer tests do not reach
+class ElewiseBroadcastTest : public ::testing::TestWithParam<std::tuple<int, int, bool>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, ElewiseBroadcastTest,
+                         ::testing::Combine(
+                             // rank
+                             testing::Values(1, 2, 3, 5),
+                             // broadcast mask of the second operand, bit i set broadcasts dim i
+                             testing::Range(0, 32),
+                             // the first operand is broadcast too
+                             testing::Values(false, true)));
+
+static DimsVector BroadcastShape(const DimsVector &shape, int mask) {
+    DimsVector result = shape;
+    for (int i = 0; i < (int)shape.size(); i++) {
+        if (mask & (1 << i)) {
+            result[i] = 1;
+        }
+    }
+    return result;
+}
+
+static int BroadcastIndex(int index, const DimsVector &output_shape, const DimsVector &input_shape) {
+    int input_index = 0, stride = 1;
+    for (int i = (int)output_shape.size() - 1; i >= 0; i--) {
+        int coord = index % output_shape[i];
+        index /= output_shape[i];
+        if (input_shape[i] != 1) {
+            input_index += coord * stride;
+        }
+        stride *= input_shape[i];
+    }
+    return input_index;
+}
+
+TEST_P(ElewiseBroadcastTest, ElewiseBroadcast) {
+    int rank         = std::get<0>(GetParam());
+    int mask         = std::get<1>(GetParam());
+    bool broadcast_a = std::get<2>(GetParam());
+    if (mask >= (1 << rank)) {
+        GTEST_SKIP();
+    }
+
+    const int sizes[] = {2, 3, 5, 4, 7};
+    DimsVector shape_output(sizes, sizes + rank);
+    DimsVector shape_a = broadcast_a ? BroadcastShape(shape_output, 1) : shape_output;
+    DimsVector shape_b = BroadcastShape(shape_output, mask);
+    // a third operand with a single dim, aligned to the last dim of the output
+    DimsVector shape_c      = {shape_output[rank - 1]};
+    DimsVector shape_c_full = BroadcastShape(shape_output, (1 << (rank - 1)) - 1);
+    int count               = DimsVectorUtils::Count(shape_output);
+
+    std::vector<float> a(DimsVectorUtils::Count(shape_a)), b(DimsVectorUtils::Count(shape_b));
+    std::vector<float> c(shape_c[0]);
+    InitRandom(a.data(), a.size(), 1.0f, 2.0f);
+    InitRandom(b.data(), b.size(), 1.0f, 2.0f);
+    InitRandom(c.data(), c.size(), 1.0f, 2.0f);
+
+    std::vector<void *> input_ptrs = {a.data(), b.data(), c.data()};
+    std::vector<CpuBroadcastPlan> plans;
+    for (const auto &shape : {shape_a, shape_b, shape_c}) {
+        plans.push_back(CPU_BROADCAST_PLAN(shape, shape_output));
+    }
+
+    std::vector<float> output(count), ref(count);
+    for (int i = 0; i < count; i++) {
+        float value_a = a[BroadcastIndex(i, shape_output, shape_a)];
+        float value_b = b[BroadcastIndex(i, shape_output, shape_b)];
+        float value_c = c[BroadcastIndex(i, shape_output, shape_c_full)];
+        ref[i]        = value_a - value_b - value_c;
+    }
+    CPU_SUB(input_ptrs, plans, output.data(), shape_output);
+    EXPECT_EQ(0, CompareData(output.data(), ref.data(), count, 0.0001f));
+}
+
+}  // namespace TNN_NS
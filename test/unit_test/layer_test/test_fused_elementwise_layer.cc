@@ -0,0 +1,110 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "test/unit_test/layer_test/layer_test.h"
+#include "test/unit_test/unit_test_common.h"
+#include "test/unit_test/utils/network_helpers.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+class FusedElementwiseLayerTest : public LayerTest,
+                                  public ::testing::WithParamInterface<std::tuple<int, int, int, int, DataType>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, FusedElementwiseLayerTest,
+                         ::testing::Combine(testing::Values(1, 2), testing::Values(1, 3, 4, 13),
+                                            testing::Values(1, 6, 9),
+                                            // constant type: single, channel, element, width
+                                            testing::Values(0, 1, 2, 3), testing::Values(DATA_TYPE_FLOAT)));
+
+TEST_P(FusedElementwiseLayerTest, FusedElementwiseLayer) {
+    // get param
+    int batch          = std::get<0>(GetParam());
+    int channel        = std::get<1>(GetParam());
+    int input_size     = std::get<2>(GetParam());
+    int constant_type  = std::get<3>(GetParam());
+    DataType data_type = std::get<4>(GetParam());
+    DeviceType dev     = ConvertDeviceType(FLAGS_dt);
+
+    if (DEVICE_ARM != dev && DEVICE_NAIVE != dev) {
+        GTEST_SKIP();
+    }
+
+    DimsVector constant_dims = {1, 1, 1, 1};
+    if (1 == constant_type) {
+        constant_dims = {1, channel, 1, 1};
+    } else if (2 == constant_type) {
+        constant_dims = {1, channel, input_size, input_size};
+    } else if (3 == constant_type) {
+        constant_dims = {1, 1, 1, input_size};
+    }
+
+    // resource
+    std::shared_ptr<FusedElementwiseLayerResource> resource(new FusedElementwiseLayerResource());
+    int constant_count = DimsVectorUtils::Count(constant_dims);
+    for (int i = 0; i < 2; i++) {
+        RawBuffer buffer(constant_count * sizeof(float));
+        InitRandom(buffer.force_to<float*>(), constant_count, 1.0f);
+        resource->constant_handles.push_back(buffer);
+        resource->constant_shapes.push_back(constant_dims);
+    }
+
+    // param: clip(sigmoid(exp(c1 - hard_sigmoid(x * c0 + x))), 0.1, 0.9)
+    FusedElementwiseLayerParam param;
+    param.name = "FusedElementwise";
+
+    FusedElementwiseOp op;
+    op.type           = FusedElementwiseOpMul;
+    op.operand        = FusedElementwiseOperandConstant;
+    op.constant_index = 0;
+    param.ops.push_back(op);
+
+    op         = FusedElementwiseOp();
+    op.type    = FusedElementwiseOpAdd;
+    op.operand = FusedElementwiseOperandInput;
+    param.ops.push_back(op);
+
+    op       = FusedElementwiseOp();
+    op.type  = FusedElementwiseOpHardSigmoid;
+    op.alpha = 0.2f;
+    op.beta  = 0.5f;
+    param.ops.push_back(op);
+
+    op                = FusedElementwiseOp();
+    op.type           = FusedElementwiseOpSub;
+    op.operand        = FusedElementwiseOperandConstant;
+    op.constant_index = 1;
+    op.operand_first  = true;
+    param.ops.push_back(op);
+
+    op      = FusedElementwiseOp();
+    op.type = FusedElementwiseOpExp;
+    param.ops.push_back(op);
+
+    op      = FusedElementwiseOp();
+    op.type = FusedElementwiseOpSigmoid;
+    param.ops.push_back(op);
+
+    op       = FusedElementwiseOp();
+    op.type  = FusedElementwiseOpClip;
+    op.alpha = 0.1f;
+    op.beta  = 0.9f;
+    param.ops.push_back(op);
+
+    auto inputs_desc  = CreateInputBlobsDesc(batch, channel, input_size, 1, data_type);
+    auto outputs_desc = CreateOutputBlobsDesc(1, data_type);
+    Run(LAYER_FUSED_ELEMENTWISE, &param, resource.get(), inputs_desc, outputs_desc);
+}
+
+}  // namespace TNN_NS
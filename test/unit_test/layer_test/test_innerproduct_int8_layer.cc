@@ -23,7 +23,7 @@ class InnerProductInt8LayerTest : public LayerTest,
                                   public ::testing::WithParamInterface<std::tuple<int, int, int>> {};
 
 INSTANTIATE_TEST_SUITE_P(LayerTest, InnerProductInt8LayerTest,
-                         ::testing::Combine(testing::Values(1), testing::Values(3, 4, 8, 9, 16),
+                         ::testing::Combine(testing::Values(1, 2, 33), testing::Values(3, 4, 8, 9, 16),
                                             // output channel
                                             testing::Values(1)));
 
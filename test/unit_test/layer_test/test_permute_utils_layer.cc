@@ -0,0 +1,168 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <tuple>
+#include <vector>
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/interpreter/raw_buffer.h"
+#include "tnn/utils/data_format_converter.h"
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/permute_utils.h"
+
+namespace TNN_NS {
+
+// the layer tests cover float orders of rank 4, the engine is checked on every order of rank 4 with
+// dims that merge, drop and leave tails in the blocked transpose
+class PermuteUtilsTest : public ::testing::TestWithParam<std::tuple<int, int, int>> {};
+
+INSTANTIATE_TEST_SUITE_P(LayerTest, PermuteUtilsTest,
+                         ::testing::Combine(
+                             // index of the order among the 24 orders of rank 4
+                             testing::Range(0, 24),
+                             // dims
+                             testing::Range(0, 3),
+                             // element size
+                             testing::Values(1, 2, 4, 8)));
+
+static void NaivePermuteBytes(const uint8_t *src, uint8_t *dst, const DimsVector &dims,
+                              const std::vector<int> &orders, int element_size) {
+    int rank  = (int)dims.size();
+    int count = DimsVectorUtils::Count(dims);
+    DimsVector output_dims(rank);
+    for (int i = 0; i < rank; i++) {
+        output_dims[i] = dims[orders[i]];
+    }
+    std::vector<int> src_strides(rank, 1);
+    for (int d = rank - 2; d >= 0; d--) {
+        src_strides[d] = src_strides[d + 1] * dims[d + 1];
+    }
+    for (int i = 0; i < count; i++) {
+        int index = i, src_index = 0;
+        for (int d = rank - 1; d >= 0; d--) {
+            src_index += (index % output_dims[d]) * src_strides[orders[d]];
+            index /= output_dims[d];
+        }
+        memcpy(dst + i * element_size, src + src_index * element_size, element_size);
+    }
+}
+
+TEST_P(PermuteUtilsTest, Permute) {
+    int order_index  = std::get<0>(GetParam());
+    int dims_index   = std::get<1>(GetParam());
+    int element_size = std::get<2>(GetParam());
+
+    std::vector<int> orders = {0, 1, 2, 3};
+    for (int i = 0; i < order_index; i++) {
+        std::next_permutation(orders.begin(), orders.end());
+    }
+    const DimsVector all_dims[] = {{2, 3, 37, 45}, {1, 67, 1, 35}, {3, 1, 5, 1}};
+    DimsVector dims             = all_dims[dims_index];
+
+    int bytes = DimsVectorUtils::Count(dims) * element_size;
+    std::vector<uint8_t> src(bytes), dst(bytes, 0), ref(bytes, 0);
+    for (int i = 0; i < bytes; i++) {
+        src[i] = (uint8_t)(i * 131 + i / 251);
+    }
+
+    Status status = PermuteUtils::Permute(src.data(), dst.data(), dims, orders, element_size);
+    ASSERT_EQ((int)status, TNN_OK);
+    NaivePermuteBytes(src.data(), ref.data(), dims, orders, element_size);
+    EXPECT_EQ(dst, ref);
+}
+
+TEST(PermuteUtilsTransposeTest, StridedTranspose) {
+    // strides wider than the transposed block leave the padding untouched
+    const int rows = 35, cols = 70, src_stride = 72, dst_stride = 36;
+    std::vector<float> src(rows * src_stride), dst(cols * dst_stride, -1.0f);
+    InitRandom(src.data(), (int)src.size(), -1.0f, 1.0f);
+
+    Status status = PermuteUtils::Transpose(src.data(), dst.data(), rows, cols, src_stride, dst_stride, sizeof(float));
+    ASSERT_EQ((int)status, TNN_OK);
+    for (int c = 0; c < cols; c++) {
+        for (int r = 0; r < dst_stride; r++) {
+            float expect = r < rows ? src[r * src_stride + c] : -1.0f;
+            ASSERT_EQ(dst[c * dst_stride + r], expect) << "row " << r << " col " << c;
+        }
+    }
+}
+
+TEST(PermuteUtilsTransposeTest, NCHW4Converter) {
+    // full channel groups run as batched transposes, the partial last groups of all batches in another one
+    const int num = 2, height = 3, width = 5, hw = height * width;
+    for (int channel = 1; channel <= 9; channel++) {
+        int round_channel = ROUND_UP(channel, 4);
+        std::vector<float> src(num * channel * hw), nchw4(num * round_channel * hw, -1.0f), dst(src.size(), -1.0f);
+        InitRandom(src.data(), (int)src.size(), -1.0f, 1.0f);
+
+        Status status = DataFormatConverter::ConvertFromNCHWToNCHW4Float(src.data(), nchw4.data(), num, channel,
+                                                                         height, width);
+        ASSERT_EQ((int)status, TNN_OK);
+        for (int n = 0; n < num; n++) {
+            for (int c = 0; c < round_channel; c++) {
+                for (int i = 0; i < hw; i++) {
+                    float expect = c < channel ? src[(n * channel + c) * hw + i] : 0.0f;
+                    ASSERT_EQ(nchw4[(n * round_channel + c / 4 * 4) * hw + i * 4 + c % 4], expect)
+                        << "channel " << channel << " n " << n << " c " << c << " i " << i;
+                }
+            }
+        }
+
+        status = DataFormatConverter::ConvertFromNCHW4ToNCHWFloat(nchw4.data(), dst.data(), num, channel, height,
+                                                                  width);
+        ASSERT_EQ((int)status, TNN_OK);
+        EXPECT_EQ(dst, src) << "channel " << channel;
+    }
+}
+
+TEST(PermuteUtilsTransposeTest, InvalidParam) {
+    float src[6], dst[6];
+    Status status = PermuteUtils::Transpose(src, dst, 2, 3, 3, 2, 3);
+    EXPECT_NE((int)status, TNN_OK);
+    status = PermuteUtils::Permute(src, dst, {2, 3}, {0, 0}, sizeof(float));
+    EXPECT_NE((int)status, TNN_OK);
+}
+
+TEST(PermuteUtilsTransposeTest, RawBufferPermute) {
+    // every data type is transposed with its element size, the 2 byte bfp16 and 4 byte int32 as well
+    const int outter = 3, inner = 5;
+    for (auto data_type : {DATA_TYPE_FLOAT, DATA_TYPE_HALF, DATA_TYPE_BFP16, DATA_TYPE_INT8, DATA_TYPE_INT32}) {
+        int element_size = DataTypeUtils::GetBytesSize(data_type);
+        std::vector<uint8_t> src(outter * inner * element_size);
+        for (int i = 0; i < src.size(); i++) {
+            src[i] = (uint8_t)i;
+        }
+        RawBuffer buffer((int)src.size(), reinterpret_cast<char *>(src.data()));
+        buffer.SetDataType(data_type);
+        ASSERT_EQ((int)buffer.Permute(outter, inner), TNN_OK);
+
+        std::vector<uint8_t> ref(src.size());
+        NaivePermuteBytes(src.data(), ref.data(), {outter, inner}, {1, 0}, element_size);
+        auto data = buffer.force_to<uint8_t *>();
+        EXPECT_EQ(std::vector<uint8_t>(data, data + src.size()), ref) << "data type " << data_type;
+    }
+
+    RawBuffer buffer(16);
+    // no data type has this element size
+    buffer.SetDataType((DataType)-1);
+    EXPECT_EQ((int)buffer.Permute(2, 2), (int)TNNERR_PARAM_ERR);
+}
+
+}  // namespace TNN_NS
@@ -23,11 +23,11 @@ class SoftmaxLayerTest : public LayerTest,
                          public ::testing::WithParamInterface<std::tuple<int, int, int, int, DataType>> {};
 
 INSTANTIATE_TEST_SUITE_P(LayerTest, SoftmaxLayerTest,
-                         ::testing::Combine(testing::Values(1), testing::Values(10, 12, 10, 12), testing::Values(10),
+                         ::testing::Combine(testing::Values(1, 2), testing::Values(10, 12, 10, 12), testing::Values(10),
                                             // axis
                                             testing::Values(1, 2),
                                             // dtype
-                                            testing::Values(DATA_TYPE_FLOAT)));
+                                            testing::Values(DATA_TYPE_FLOAT, DATA_TYPE_BFP16)));
 
 TEST_P(SoftmaxLayerTest, SoftmaxLayer) {
     // get param
@@ -41,6 +41,10 @@ TEST_P(SoftmaxLayerTest, SoftmaxLayer) {
     if (data_type == DATA_TYPE_INT8 && DEVICE_ARM != dev) {
         GTEST_SKIP();
     }
+    // channel 10 is not a multiple of 4, the bfp16 path converts the c4 padded blob
+    if (data_type == DATA_TYPE_BFP16 && DEVICE_ARM != dev) {
+        GTEST_SKIP();
+    }
 
     if (channel < 2) {
         GTEST_SKIP();
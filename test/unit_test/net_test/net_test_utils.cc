@@ -0,0 +1,106 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "test/unit_test/net_test/net_test_utils.h"
+
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/utils/blob_converter.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+void NetTestInterpreter::AddLayer(LayerType type, const std::string &type_str, const std::string &name,
+                                  std::vector<std::string> inputs, std::vector<std::string> outputs,
+                                  std::shared_ptr<LayerParam> param, std::shared_ptr<LayerResource> resource) {
+    auto layer      = std::make_shared<LayerInfo>();
+    layer->type     = type;
+    layer->type_str = type_str;
+    layer->name     = name;
+    layer->inputs   = inputs;
+    layer->outputs  = outputs;
+    layer->param    = param ? param : std::make_shared<LayerParam>();
+
+    layer->param->type = type_str;
+    layer->param->name = name;
+
+    auto structure = GetNetStructure();
+    structure->layers.push_back(layer);
+    for (auto &output : outputs) {
+        structure->blobs.insert(output);
+    }
+    if (resource) {
+        resource->name                              = name;
+        GetNetResource()->resource_map[layer->name] = resource;
+    }
+}
+
+std::shared_ptr<NetTestInterpreter> CreateNetTestInterpreter(const InputShapesMap &inputs,
+                                                             const std::set<std::string> &outputs) {
+    auto interpreter            = std::make_shared<NetTestInterpreter>();
+    auto structure              = interpreter->GetNetStructure();
+    structure->inputs_shape_map = inputs;
+    structure->outputs          = outputs;
+    for (auto &input : inputs) {
+        structure->blobs.insert(input.first);
+    }
+    return interpreter;
+}
+
+Status ForwardNetwork(DefaultNetwork &network, const NetTestDataMap &inputs, NetTestDataMap &outputs) {
+    void *command_queue = nullptr;
+    RETURN_ON_NEQ(network.GetCommandQueue(&command_queue), TNN_OK);
+
+    BlobMap input_blobs;
+    RETURN_ON_NEQ(network.GetAllInputBlobs(input_blobs), TNN_OK);
+    for (auto &iter : input_blobs) {
+        auto data = inputs.find(iter.first);
+        if (data == inputs.end()) {
+            return Status(TNNERR_PARAM_ERR, "missing data of network input");
+        }
+        auto dims = iter.second->GetBlobDesc().dims;
+        Mat mat(DEVICE_NAIVE, NCHW_FLOAT, dims, const_cast<float *>(data->second.data()));
+        MatConvertParam param;
+        param.scale = std::vector<float>(dims[1], 1.0f);
+        param.bias  = std::vector<float>(dims[1], 0.0f);
+        BlobConverter converter(iter.second);
+        RETURN_ON_NEQ(converter.ConvertFromMat(mat, param, command_queue), TNN_OK);
+    }
+
+    RETURN_ON_NEQ(network.Forward(), TNN_OK);
+
+    BlobMap output_blobs;
+    RETURN_ON_NEQ(network.GetAllOutputBlobs(output_blobs), TNN_OK);
+    outputs.clear();
+    for (auto &iter : output_blobs) {
+        auto dims = iter.second->GetBlobDesc().dims;
+        std::vector<float> data(DimsVectorUtils::Count(dims));
+        Mat mat(DEVICE_NAIVE, NCHW_FLOAT, dims, data.data());
+        BlobConverter converter(iter.second);
+        RETURN_ON_NEQ(converter.ConvertToMat(mat, MatConvertParam(), command_queue), TNN_OK);
+        outputs[iter.first] = data;
+    }
+    return TNN_OK;
+}
+
+NetTestDataMap CreateNetTestInputs(const InputShapesMap &shapes) {
+    NetTestDataMap inputs;
+    for (auto &iter : shapes) {
+        std::vector<float> data(DimsVectorUtils::Count(iter.second));
+        InitRandom(data.data(), data.size(), 1.0f);
+        inputs[iter.first] = data;
+    }
+    return inputs;
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,57 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_TEST_UNIT_TEST_NET_TEST_NET_TEST_UTILS_H_
+#define TNN_TEST_UNIT_TEST_NET_TEST_NET_TEST_UTILS_H_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tnn/core/default_network.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+
+namespace TNN_NS {
+
+typedef std::map<std::string, std::vector<float>> NetTestDataMap;
+
+// @brief holds a network built in code by the test, there is no model file to interpret
+class NetTestInterpreter : public DefaultModelInterpreter {
+public:
+    virtual ~NetTestInterpreter() {}
+
+    virtual Status Interpret(std::vector<std::string> params) {
+        return TNN_OK;
+    }
+
+    // @brief appends a layer, its outputs are added to the blobs of the network
+    void AddLayer(LayerType type, const std::string &type_str, const std::string &name,
+                  std::vector<std::string> inputs, std::vector<std::string> outputs,
+                  std::shared_ptr<LayerParam> param, std::shared_ptr<LayerResource> resource = nullptr);
+};
+
+// @brief creates the interpreter of a network with the given inputs and outputs
+std::shared_ptr<NetTestInterpreter> CreateNetTestInterpreter(const InputShapesMap &inputs,
+                                                             const std::set<std::string> &outputs);
+
+// @brief fills the inputs of the network from NCHW float data, forwards it and reads every output as NCHW float
+Status ForwardNetwork(DefaultNetwork &network, const NetTestDataMap &inputs, NetTestDataMap &outputs);
+
+// @brief random NCHW float data for every input of the shapes
+NetTestDataMap CreateNetTestInputs(const InputShapesMap &shapes);
+
+}  // namespace TNN_NS
+
+#endif  // TNN_TEST_UNIT_TEST_NET_TEST_NET_TEST_UTILS_H_
@@ -0,0 +1,217 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "test/unit_test/net_test/net_test_utils.h"
+#include "tnn/optimizer/net_optimizer_eliminate_reformat.h"
+
+namespace TNN_NS {
+
+static const std::string blob_scale_suffix = "_scale_data_";
+
+static void AddBlobScale(NetTestInterpreter *interpreter, const std::string &blob, float scale) {
+    auto resource = std::make_shared<IntScaleResource>();
+    RawBuffer scale_buffer(4 * sizeof(float));
+    RawBuffer bias_buffer(4 * sizeof(float));
+    for (int i = 0; i < 4; i++) {
+        scale_buffer.force_to<float *>()[i] = scale;
+        bias_buffer.force_to<float *>()[i]  = 0.0f;
+    }
+    resource->scale_handle = scale_buffer;
+    resource->bias_handle  = bias_buffer;
+    interpreter->GetNetResource()->resource_map[blob + blob_scale_suffix] = resource;
+}
+
+static std::shared_ptr<LayerParam> CreateParam(bool quantized) {
+    auto param       = std::make_shared<LayerParam>();
+    param->quantized = quantized;
+    return param;
+}
+
+static std::shared_ptr<ReformatLayerParam> CreateReformatParam(DataType src_type, DataType dst_type) {
+    auto param      = std::make_shared<ReformatLayerParam>();
+    param->src_type = src_type;
+    param->dst_type = dst_type;
+    return param;
+}
+
+static Status EliminateReformat(NetTestInterpreter *interpreter) {
+    optimizer::NetOptimizerEliminateReformat optimizer;
+    return optimizer.Optimize(interpreter->GetNetStructure(), interpreter->GetNetResource());
+}
+
+static std::shared_ptr<LayerInfo> FindLayer(NetStructure *structure, const std::string &name) {
+    for (auto &layer : structure->layers) {
+        if (layer->name == name) {
+            return layer;
+        }
+    }
+    return nullptr;
+}
+
+// relu_a(int8) -> reformat(int8 -> float) -> reformat(float -> int8) -> relu_b(int8)
+static std::shared_ptr<NetTestInterpreter> CreateInt8ReformatPair(float scale_a, float scale_b) {
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 2, 2}}}, {"y"});
+    interpreter->AddLayer(LAYER_RELU, "ReLU", "relu_a", {"x"}, {"a"}, CreateParam(true));
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "dequant", {"a"}, {"a_float"},
+                          CreateReformatParam(DATA_TYPE_INT8, DATA_TYPE_FLOAT));
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "quant", {"a_float"}, {"b"},
+                          CreateReformatParam(DATA_TYPE_FLOAT, DATA_TYPE_INT8));
+    interpreter->AddLayer(LAYER_RELU, "ReLU", "relu_b", {"b"}, {"y"}, CreateParam(true));
+    AddBlobScale(interpreter.get(), "a", scale_a);
+    AddBlobScale(interpreter.get(), "b", scale_b);
+    return interpreter;
+}
+
+// conv_a(int8) -> reformat(int8 -> float) -> relu/pooling(float) -> reformat(float -> int8) -> conv_b(int8)
+static std::shared_ptr<NetTestInterpreter> CreateInt8Sandwich(LayerType type, float scale_src, float scale_dst) {
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 4, 4}}}, {"y"});
+    interpreter->AddLayer(LAYER_CONVOLUTION, "Convolution", "conv_a", {"x"}, {"src"}, CreateParam(true));
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "dequant", {"src"}, {"in"},
+                          CreateReformatParam(DATA_TYPE_INT8, DATA_TYPE_FLOAT));
+    if (LAYER_POOLING == type) {
+        interpreter->AddLayer(LAYER_POOLING, "Pooling", "layer", {"in"}, {"out"},
+                              std::make_shared<PoolingLayerParam>());
+    } else {
+        interpreter->AddLayer(LAYER_RELU, "ReLU", "layer", {"in"}, {"out"}, CreateParam(false));
+    }
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "quant", {"out"}, {"dst"},
+                          CreateReformatParam(DATA_TYPE_FLOAT, DATA_TYPE_INT8));
+    interpreter->AddLayer(LAYER_CONVOLUTION, "Convolution", "conv_b", {"dst"}, {"y"}, CreateParam(true));
+    AddBlobScale(interpreter.get(), "src", scale_src);
+    AddBlobScale(interpreter.get(), "dst", scale_dst);
+    return interpreter;
+}
+
+TEST(EliminateReformatOptimizerTest, CancelInt8Pair) {
+    auto interpreter = CreateInt8ReformatPair(0.5f, 0.5f);
+    auto structure   = interpreter->GetNetStructure();
+    ASSERT_EQ((int)EliminateReformat(interpreter.get()), TNN_OK);
+
+    ASSERT_EQ(structure->layers.size(), 2);
+    EXPECT_EQ(FindLayer(structure, "relu_b")->inputs, std::vector<std::string>({"a"}));
+    EXPECT_EQ(structure->blobs.count("a_float"), 0);
+    EXPECT_EQ(structure->blobs.count("b"), 0);
+
+    // each reformat is recorded under its own input blob, both have the dims of a
+    auto &eliminated = structure->eliminated_reformats;
+    ASSERT_EQ(eliminated.size(), 2);
+    EXPECT_EQ(eliminated[0].blob, "a");
+    EXPECT_EQ(eliminated[0].dims_blob, "a");
+    EXPECT_EQ(eliminated[0].bytes_per_element, 5);
+    EXPECT_EQ(eliminated[1].blob, "a_float");
+    EXPECT_EQ(eliminated[1].dims_blob, "a");
+    EXPECT_EQ(eliminated[1].bytes_per_element, 5);
+}
+
+TEST(EliminateReformatOptimizerTest, KeepInt8PairWithScaleMismatch) {
+    auto interpreter = CreateInt8ReformatPair(0.5f, 0.25f);
+    auto structure   = interpreter->GetNetStructure();
+    ASSERT_EQ((int)EliminateReformat(interpreter.get()), TNN_OK);
+
+    EXPECT_EQ(structure->layers.size(), 4);
+    EXPECT_EQ(FindLayer(structure, "relu_b")->inputs, std::vector<std::string>({"b"}));
+    EXPECT_TRUE(structure->eliminated_reformats.empty());
+}
+
+TEST(EliminateReformatOptimizerTest, CancelFloatPair) {
+    // float -> int8 -> float loses no precision the consumer relies on, no scale is needed
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 2, 2}}}, {"y"});
+    interpreter->AddLayer(LAYER_RELU, "ReLU", "relu_a", {"x"}, {"a"}, CreateParam(false));
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "quant", {"a"}, {"a_int8"},
+                          CreateReformatParam(DATA_TYPE_FLOAT, DATA_TYPE_INT8));
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "dequant", {"a_int8"}, {"b"},
+                          CreateReformatParam(DATA_TYPE_INT8, DATA_TYPE_FLOAT));
+    interpreter->AddLayer(LAYER_RELU, "ReLU", "relu_b", {"b"}, {"y"}, CreateParam(false));
+    auto structure = interpreter->GetNetStructure();
+    ASSERT_EQ((int)EliminateReformat(interpreter.get()), TNN_OK);
+
+    ASSERT_EQ(structure->layers.size(), 2);
+    EXPECT_EQ(FindLayer(structure, "relu_b")->inputs, std::vector<std::string>({"a"}));
+    EXPECT_EQ(structure->eliminated_reformats.size(), 2);
+}
+
+class EliminateReformatMoveLayerTest : public ::testing::TestWithParam<LayerType> {};
+
+INSTANTIATE_TEST_SUITE_P(NetTest, EliminateReformatMoveLayerTest, ::testing::Values(LAYER_RELU, LAYER_POOLING));
+
+TEST_P(EliminateReformatMoveLayerTest, MoveLayerIntoInt8) {
+    auto interpreter    = CreateInt8Sandwich(GetParam(), 0.5f, 0.5f);
+    auto structure      = interpreter->GetNetStructure();
+    auto original_param = FindLayer(structure, "layer")->param;
+    ASSERT_EQ((int)EliminateReformat(interpreter.get()), TNN_OK);
+
+    ASSERT_EQ(structure->layers.size(), 3);
+    auto layer = FindLayer(structure, "layer");
+    EXPECT_TRUE(layer->param->quantized);
+    EXPECT_EQ(layer->inputs, std::vector<std::string>({"src"}));
+    EXPECT_EQ(layer->outputs, std::vector<std::string>({"dst"}));
+    EXPECT_EQ(layer->param->type, original_param->type);
+    // the param may be shared with the unoptimized network, it is copied and not changed
+    EXPECT_NE(layer->param, original_param);
+    EXPECT_FALSE(original_param->quantized);
+    if (LAYER_POOLING == GetParam()) {
+        EXPECT_NE(dynamic_cast<PoolingLayerParam *>(layer->param.get()), nullptr);
+    }
+
+    auto &eliminated = structure->eliminated_reformats;
+    ASSERT_EQ(eliminated.size(), 2);
+    EXPECT_EQ(eliminated[0].blob, "src");
+    EXPECT_EQ(eliminated[0].dims_blob, "src");
+    EXPECT_EQ(eliminated[1].blob, "out");
+    EXPECT_EQ(eliminated[1].dims_blob, "dst");
+}
+
+TEST_P(EliminateReformatMoveLayerTest, KeepLayerWithScaleMismatch) {
+    auto interpreter = CreateInt8Sandwich(GetParam(), 0.5f, 0.25f);
+    auto structure   = interpreter->GetNetStructure();
+    auto resource    = interpreter->GetNetResource();
+    auto dst_scale   = resource->resource_map["dst" + blob_scale_suffix];
+    ASSERT_EQ((int)EliminateReformat(interpreter.get()), TNN_OK);
+
+    // conv_b is calibrated to the scale of dst, the int8 layer would write dst with the scale of src
+    EXPECT_EQ(structure->layers.size(), 5);
+    EXPECT_FALSE(FindLayer(structure, "layer")->param->quantized);
+    EXPECT_EQ(FindLayer(structure, "conv_b")->inputs, std::vector<std::string>({"dst"}));
+    EXPECT_EQ(resource->resource_map["dst" + blob_scale_suffix], dst_scale);
+    EXPECT_TRUE(structure->eliminated_reformats.empty());
+}
+
+TEST_P(EliminateReformatMoveLayerTest, MoveLayerIntoFloat) {
+    // float -> reformat(float -> int8) -> layer(int8) -> reformat(int8 -> float) -> float
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 4, 4}}}, {"y"});
+    interpreter->AddLayer(LAYER_CONVOLUTION, "Convolution", "conv_a", {"x"}, {"src"}, CreateParam(false));
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "quant", {"src"}, {"in"},
+                          CreateReformatParam(DATA_TYPE_FLOAT, DATA_TYPE_INT8));
+    auto param       = LAYER_POOLING == GetParam() ? std::make_shared<PoolingLayerParam>() : CreateParam(true);
+    param->quantized = true;
+    interpreter->AddLayer(GetParam(), "Layer", "layer", {"in"}, {"out"}, param);
+    interpreter->AddLayer(LAYER_REFORMAT, "Reformat", "dequant", {"out"}, {"dst"},
+                          CreateReformatParam(DATA_TYPE_INT8, DATA_TYPE_FLOAT));
+    interpreter->AddLayer(LAYER_CONVOLUTION, "Convolution", "conv_b", {"dst"}, {"y"}, CreateParam(false));
+    AddBlobScale(interpreter.get(), "in", 0.5f);
+    AddBlobScale(interpreter.get(), "out", 0.25f);
+    auto structure = interpreter->GetNetStructure();
+    ASSERT_EQ((int)EliminateReformat(interpreter.get()), TNN_OK);
+
+    ASSERT_EQ(structure->layers.size(), 3);
+    auto layer = FindLayer(structure, "layer");
+    EXPECT_FALSE(layer->param->quantized);
+    EXPECT_EQ(layer->inputs, std::vector<std::string>({"src"}));
+    EXPECT_EQ(layer->outputs, std::vector<std::string>({"dst"}));
+    EXPECT_EQ(structure->eliminated_reformats.size(), 2);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,321 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "test/flags.h"
+#include "test/test_utils.h"
+#include "test/unit_test/net_test/net_test_utils.h"
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/interpreter/tnn/model_interpreter.h"
+#include "tnn/optimizer/net_optimizer_fold_shuffle.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+
+namespace TNN_NS {
+
+static std::shared_ptr<ConvLayerParam> CreateConvParam(int input_channel, int output_channel, int group,
+                                                       int kernel) {
+    auto param            = std::make_shared<ConvLayerParam>();
+    param->input_channel  = input_channel / group;
+    param->output_channel = output_channel;
+    param->group          = group;
+    param->kernels        = {kernel, kernel};
+    param->strides        = {1, 1};
+    param->dialations     = {1, 1};
+    param->pads           = {kernel / 2, kernel / 2, kernel / 2, kernel / 2};
+    param->bias           = 1;
+    return param;
+}
+
+static std::shared_ptr<ConvLayerResource> CreateConvResource(ConvLayerParam *param) {
+    auto resource    = std::make_shared<ConvLayerResource>();
+    int filter_count = param->output_channel * param->input_channel * param->kernels[0] * param->kernels[1];
+    RawBuffer filter(filter_count * sizeof(float));
+    InitRandom(filter.force_to<float *>(), filter_count, 1.0f);
+    RawBuffer bias(param->output_channel * sizeof(float));
+    InitRandom(bias.force_to<float *>(), param->output_channel, 1.0f);
+    resource->filter_handle = filter;
+    resource->bias_handle   = bias;
+    return resource;
+}
+
+static void AddConv(NetTestInterpreter *interpreter, const std::string &name, const std::string &input,
+                    const std::string &output, int input_channel, int output_channel, int group = 1,
+                    int kernel = 1) {
+    auto param = CreateConvParam(input_channel, output_channel, group, kernel);
+    interpreter->AddLayer(LAYER_CONVOLUTION, "Convolution", name, {input}, {output}, param,
+                          CreateConvResource(param.get()));
+}
+
+static void AddRelu(NetTestInterpreter *interpreter, const std::string &name, const std::string &input,
+                    const std::string &output) {
+    interpreter->AddLayer(LAYER_RELU, "ReLU", name, {input}, {output}, std::make_shared<LayerParam>());
+}
+
+static void AddShuffle(NetTestInterpreter *interpreter, const std::string &name, const std::string &input,
+                       const std::string &output, int group) {
+    auto param   = std::make_shared<ShuffleLayerParam>();
+    param->group = group;
+    interpreter->AddLayer(LAYER_SHUFFLE_CHANNEL, "ShuffleChannel", name, {input}, {output}, param);
+}
+
+// channels [begin, end) of a 4-D blob
+static void AddChannelSlice(NetTestInterpreter *interpreter, const std::string &name, const std::string &input,
+                            const std::string &output, int begin, int end) {
+    auto param     = std::make_shared<StrideSliceLayerParam>();
+    param->begins  = {0, 0, begin, 0};
+    param->ends    = {0, 0, end, 0};
+    param->strides = {1, 1, 1, 1};
+    interpreter->AddLayer(LAYER_STRIDED_SLICE, "StridedSlice", name, {input}, {output}, param);
+}
+
+// the two branch unit of ShuffleNet v2 keeping the channels, the input is split by slices
+static void AddShuffleUnit(NetTestInterpreter *interpreter, const std::string &name, const std::string &input,
+                           const std::string &output, int channels) {
+    int half = channels / 2;
+    AddChannelSlice(interpreter, name + "/slice1", input, name + "/slice1", 0, half);
+    AddChannelSlice(interpreter, name + "/slice2", input, name + "/slice2", half, channels);
+    AddConv(interpreter, name + "/conv1", name + "/slice2", name + "/conv1", half, half);
+    AddRelu(interpreter, name + "/conv1/relu", name + "/conv1", name + "/conv1/relu");
+    AddConv(interpreter, name + "/conv2", name + "/conv1/relu", name + "/conv2", half, half, half, 3);
+    AddConv(interpreter, name + "/conv3", name + "/conv2", name + "/conv3", half, half);
+    AddRelu(interpreter, name + "/conv3/relu", name + "/conv3", name + "/conv3/relu");
+    interpreter->AddLayer(LAYER_CONCAT, "Concat", name + "/concat", {name + "/slice1", name + "/conv3/relu"},
+                          {name + "/concat"}, std::make_shared<ConcatLayerParam>());
+    AddShuffle(interpreter, name + "/shuffle", name + "/concat", output, 2);
+}
+
+// the downsampling unit of ShuffleNet v2 doubling the channels, both branches read the whole input
+static void AddDownsampleUnit(NetTestInterpreter *interpreter, const std::string &name, const std::string &input,
+                              const std::string &output, int channels) {
+    AddConv(interpreter, name + "/branch1/conv1", input, name + "/branch1/conv1", channels, channels, channels, 3);
+    AddConv(interpreter, name + "/branch1/conv2", name + "/branch1/conv1", name + "/branch1/conv2", channels,
+            channels);
+    AddRelu(interpreter, name + "/branch1/relu", name + "/branch1/conv2", name + "/branch1/relu");
+    AddConv(interpreter, name + "/conv1", input, name + "/conv1", channels, channels);
+    AddRelu(interpreter, name + "/conv1/relu", name + "/conv1", name + "/conv1/relu");
+    AddConv(interpreter, name + "/conv2", name + "/conv1/relu", name + "/conv2", channels, channels, channels, 3);
+    AddConv(interpreter, name + "/conv3", name + "/conv2", name + "/conv3", channels, channels);
+    AddRelu(interpreter, name + "/conv3/relu", name + "/conv3", name + "/conv3/relu");
+    interpreter->AddLayer(LAYER_CONCAT, "Concat", name + "/concat", {name + "/branch1/relu", name + "/conv3/relu"},
+                          {name + "/concat"}, std::make_shared<ConcatLayerParam>());
+    AddShuffle(interpreter, name + "/shuffle", name + "/concat", output, 2);
+}
+
+static Status FoldShuffle(DefaultModelInterpreter *interpreter) {
+    optimizer::NetOptimizerFoldShuffle optimizer;
+    return optimizer.Optimize(interpreter->GetNetStructure(), interpreter->GetNetResource());
+}
+
+static int CountLayers(NetStructure *structure, LayerType type) {
+    int count = 0;
+    for (auto &layer : structure->layers) {
+        count += layer->type == type ? 1 : 0;
+    }
+    return count;
+}
+
+static std::vector<float> GetFilter(DefaultModelInterpreter *interpreter, const std::string &name) {
+    auto resource = dynamic_cast<ConvLayerResource *>(interpreter->GetNetResource()->resource_map[name].get());
+    auto &filter  = resource->filter_handle;
+    return std::vector<float>(filter.force_to<float *>(), filter.force_to<float *>() + filter.GetDataCount());
+}
+
+static std::vector<float> GetBias(DefaultModelInterpreter *interpreter, const std::string &name) {
+    auto resource = dynamic_cast<ConvLayerResource *>(interpreter->GetNetResource()->resource_map[name].get());
+    auto &bias    = resource->bias_handle;
+    return std::vector<float>(bias.force_to<float *>(), bias.force_to<float *>() + bias.GetDataCount());
+}
+
+// channel c of the output of a shuffle reads channel ShuffleSource(c) of its input
+static int ShuffleSource(int channel, int channels, int group) {
+    return (channel % group) * (channels / group) + channel / group;
+}
+
+// the folded network must compute what the network as built computes
+static void ExpectSameOutputs(DefaultModelInterpreter *interpreter, DefaultModelInterpreter *folded,
+                              const InputShapesMap &input_shapes) {
+    DeviceType device_type = ConvertDeviceType(FLAGS_dt);
+    NetworkConfig net_config;
+    net_config.device_type = device_type;
+    net_config.precision   = PRECISION_HIGH;
+    ModelConfig model_config;
+    auto inputs = CreateNetTestInputs(input_shapes);
+
+    DefaultNetwork network;
+    Status status = network.Init(net_config, model_config, interpreter, input_shapes);
+    ASSERT_EQ((int)status, TNN_OK);
+    NetTestDataMap outputs;
+    status = ForwardNetwork(network, inputs, outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+
+    DefaultNetwork folded_network;
+    status = folded_network.Init(net_config, model_config, folded, input_shapes);
+    ASSERT_EQ((int)status, TNN_OK);
+    NetTestDataMap folded_outputs;
+    status = ForwardNetwork(folded_network, inputs, folded_outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+
+    ASSERT_EQ(outputs.size(), folded_outputs.size());
+    for (auto &iter : outputs) {
+        auto &folded_output = folded_outputs[iter.first];
+        ASSERT_EQ(iter.second.size(), folded_output.size());
+        EXPECT_EQ(CompareData(iter.second.data(), folded_output.data(), iter.second.size(), 0.001), 0);
+    }
+}
+
+static bool IsDeviceSupported() {
+    DeviceType device_type = ConvertDeviceType(FLAGS_dt);
+    return DEVICE_ARM == device_type || DEVICE_NAIVE == device_type;
+}
+
+TEST(FoldShuffleOptimizerTest, FoldIntoConsumer) {
+    // conv_a -> shuffle -> conv_b
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 3, 3}}}, {"y"});
+    AddConv(interpreter.get(), "conv_a", "x", "a", 4, 8);
+    AddShuffle(interpreter.get(), "shuffle", "a", "b", 2);
+    AddConv(interpreter.get(), "conv_b", "b", "y", 8, 4);
+
+    auto folded = interpreter->Copy();
+    ASSERT_EQ((int)FoldShuffle(folded.get()), TNN_OK);
+    EXPECT_EQ(CountLayers(folded->GetNetStructure(), LAYER_SHUFFLE_CHANNEL), 0);
+
+    // conv_b reads the channels of a, input channel c of its filter moves to the channel shuffled into c
+    auto filter        = GetFilter(interpreter.get(), "conv_b");
+    auto folded_filter = GetFilter(folded.get(), "conv_b");
+    for (int o = 0; o < 4; o++) {
+        for (int c = 0; c < 8; c++) {
+            EXPECT_EQ(folded_filter[o * 8 + ShuffleSource(c, 8, 2)], filter[o * 8 + c]);
+        }
+    }
+    EXPECT_EQ(GetFilter(folded.get(), "conv_a"), GetFilter(interpreter.get(), "conv_a"));
+
+    if (IsDeviceSupported()) {
+        ExpectSameOutputs(interpreter.get(), folded.get(), {{"x", {1, 4, 3, 3}}});
+    }
+}
+
+TEST(FoldShuffleOptimizerTest, FoldIntoProducer) {
+    // conv_a -> relu -> shuffle -> net output, conv_a writes its output channels shuffled
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 3, 3}}}, {"y"});
+    AddConv(interpreter.get(), "conv_a", "x", "a", 4, 6);
+    AddRelu(interpreter.get(), "relu", "a", "b");
+    AddShuffle(interpreter.get(), "shuffle", "b", "y", 3);
+
+    auto folded = interpreter->Copy();
+    ASSERT_EQ((int)FoldShuffle(folded.get()), TNN_OK);
+    auto structure = folded->GetNetStructure();
+    EXPECT_EQ(CountLayers(structure, LAYER_SHUFFLE_CHANNEL), 0);
+    EXPECT_EQ(structure->layers.back()->outputs, std::vector<std::string>({"y"}));
+
+    auto filter        = GetFilter(interpreter.get(), "conv_a");
+    auto bias          = GetBias(interpreter.get(), "conv_a");
+    auto folded_filter = GetFilter(folded.get(), "conv_a");
+    auto folded_bias   = GetBias(folded.get(), "conv_a");
+    for (int o = 0; o < 6; o++) {
+        int src = ShuffleSource(o, 6, 3);
+        EXPECT_EQ(folded_bias[o], bias[src]);
+        for (int c = 0; c < 4; c++) {
+            EXPECT_EQ(folded_filter[o * 4 + c], filter[src * 4 + c]);
+        }
+    }
+
+    if (IsDeviceSupported()) {
+        ExpectSameOutputs(interpreter.get(), folded.get(), {{"x", {1, 4, 3, 3}}});
+    }
+}
+
+TEST(FoldShuffleOptimizerTest, KeepShuffleOfNetInput) {
+    // nothing writes the input, its channels cannot be ordered
+    auto interpreter = CreateNetTestInterpreter({{"x", {1, 4, 3, 3}}}, {"y"});
+    AddShuffle(interpreter.get(), "shuffle", "x", "a", 2);
+    AddRelu(interpreter.get(), "relu", "a", "y");
+
+    ASSERT_EQ((int)FoldShuffle(interpreter.get()), TNN_OK);
+    EXPECT_EQ(CountLayers(interpreter->GetNetStructure(), LAYER_SHUFFLE_CHANNEL), 1);
+}
+
+TEST(FoldShuffleOptimizerTest, FoldShuffleNetUnits) {
+    // conv -> downsample unit -> 2 units -> conv, the slices of each unit read a shuffle
+    InputShapesMap input_shapes = {{"x", {1, 3, 5, 5}}};
+    auto interpreter            = CreateNetTestInterpreter(input_shapes, {"y"});
+    AddConv(interpreter.get(), "conv0", "x", "conv0", 3, 8, 1, 3);
+    AddRelu(interpreter.get(), "conv0/relu", "conv0", "conv0/relu");
+    AddDownsampleUnit(interpreter.get(), "unit1", "conv0/relu", "unit1", 8);
+    AddShuffleUnit(interpreter.get(), "unit2", "unit1", "unit2", 16);
+    AddShuffleUnit(interpreter.get(), "unit3", "unit2", "unit3", 16);
+    AddConv(interpreter.get(), "conv5", "unit3", "y", 16, 8);
+
+    auto folded = interpreter->Copy();
+    ASSERT_EQ((int)FoldShuffle(folded.get()), TNN_OK);
+    EXPECT_EQ(CountLayers(folded->GetNetStructure(), LAYER_SHUFFLE_CHANNEL), 0);
+
+    if (IsDeviceSupported()) {
+        ExpectSameOutputs(interpreter.get(), folded.get(), input_shapes);
+    }
+}
+
+// @brief reads the structure of a tnnproto, the weights are filled by the test
+class ProtoInterpreter : public ModelInterpreter {
+public:
+    Status InterpretProtoFile(const std::string &path) {
+        std::ifstream file(path);
+        std::stringstream content;
+        content << file.rdbuf();
+        return InterpretProto(content.str());
+    }
+};
+
+TEST(FoldShuffleOptimizerTest, FoldShuffleNetV2) {
+    ProtoInterpreter interpreter;
+    // the model is found from the source tree of the test
+    std::string source = __FILE__;
+    std::string path   = source.substr(0, source.rfind("test/unit_test/net_test")) +
+                       "benchmark/benchmark-model/shufflenet_v2_x0.5.tnnproto";
+    if (!std::ifstream(path).good() || interpreter.InterpretProtoFile(path) != TNN_OK) {
+        GTEST_SKIP();
+    }
+
+    auto structure = interpreter.GetNetStructure();
+    auto resource  = interpreter.GetNetResource();
+    for (auto &layer : structure->layers) {
+        if (layer->type == LAYER_CONVOLUTION) {
+            resource->resource_map[layer->name] =
+                CreateConvResource(dynamic_cast<ConvLayerParam *>(layer->param.get()));
+        } else if (layer->type == LAYER_BATCH_NORM) {
+            auto bn_resource = std::make_shared<BatchNormLayerResource>();
+            RawBuffer scale(3 * sizeof(float));
+            RawBuffer bias(3 * sizeof(float));
+            InitRandom(scale.force_to<float *>(), 3, 1.0f);
+            InitRandom(bias.force_to<float *>(), 3, 1.0f);
+            bn_resource->scale_handle           = scale;
+            bn_resource->bias_handle            = bias;
+            resource->resource_map[layer->name] = bn_resource;
+        }
+    }
+    ASSERT_EQ(CountLayers(structure, LAYER_SHUFFLE_CHANNEL), 16);
+
+    auto folded = interpreter.Copy();
+    ASSERT_EQ((int)FoldShuffle(folded.get()), TNN_OK);
+    EXPECT_EQ(CountLayers(folded->GetNetStructure(), LAYER_SHUFFLE_CHANNEL), 0);
+
+    if (IsDeviceSupported()) {
+        ExpectSameOutputs(&interpreter, folded.get(), structure->inputs_shape_map);
+    }
+}
+
+}  // namespace TNN_NS
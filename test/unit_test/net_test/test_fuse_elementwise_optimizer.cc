@@ -0,0 +1,152 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "test/flags.h"
+#include "test/test_utils.h"
+#include "test/unit_test/net_test/net_test_utils.h"
+#include "test/unit_test/unit_test_common.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
+#include "tnn/utils/dims_vector_utils.h"
+
+namespace TNN_NS {
+
+typedef enum {
+    ConstantSingle   = 0,
+    ConstantChannel  = 1,
+    ConstantElement  = 2,
+    ConstantWidth    = 3,
+    ConstantSingle4D = 4,
+    // a [1, C, H, W] constant multiplied into a [N, C, 1, 1] input grows the running value
+    ConstantBroadcastUp = 5,
+} FuseElementwiseConstant;
+
+class FuseElementwiseOptimizerTest
+    : public ::testing::TestWithParam<std::tuple<int, int, int, FuseElementwiseConstant>> {};
+
+INSTANTIATE_TEST_SUITE_P(NetTest, FuseElementwiseOptimizerTest,
+                         ::testing::Combine(testing::Values(1, 2), testing::Values(1, 3, 8),
+                                            testing::Values(1, 5),
+                                            testing::Values(ConstantSingle, ConstantChannel, ConstantElement,
+                                                            ConstantWidth, ConstantSingle4D, ConstantBroadcastUp)));
+
+static std::shared_ptr<EltwiseLayerResource> CreateConstant(DimsVector shape) {
+    auto resource = std::make_shared<EltwiseLayerResource>();
+    int count     = DimsVectorUtils::Count(shape);
+    RawBuffer buffer(count * sizeof(float));
+    InitRandom(buffer.force_to<float *>(), count, 1.0f);
+    resource->element_handle = buffer;
+    resource->element_shape  = shape;
+    return resource;
+}
+
+static std::shared_ptr<MultidirBroadcastLayerParam> CreateBroadcastParam(int weight_input_index) {
+    auto param                = std::make_shared<MultidirBroadcastLayerParam>();
+    param->weight_input_index = weight_input_index;
+    return param;
+}
+
+static int CountLayers(NetStructure *structure, LayerType type) {
+    int count = 0;
+    for (auto &layer : structure->layers) {
+        count += layer->type == type ? 1 : 0;
+    }
+    return count;
+}
+
+// the network optimized by NetOptimizerManager must compute what the network as built computes
+TEST_P(FuseElementwiseOptimizerTest, FusedMatchesUnfused) {
+    int batch              = std::get<0>(GetParam());
+    int channel            = std::get<1>(GetParam());
+    int size               = std::get<2>(GetParam());
+    auto constant          = std::get<3>(GetParam());
+    DeviceType device_type = ConvertDeviceType(FLAGS_dt);
+
+    if (DEVICE_ARM != device_type && DEVICE_NAIVE != device_type) {
+        GTEST_SKIP();
+    }
+
+    DimsVector input_dims    = {batch, channel, size, size};
+    DimsVector constant_dims = {1};
+    if (ConstantChannel == constant) {
+        constant_dims = {channel};
+    } else if (ConstantElement == constant) {
+        constant_dims = {channel * size * size};
+    } else if (ConstantWidth == constant) {
+        constant_dims = {size};
+    } else if (ConstantSingle4D == constant) {
+        constant_dims = {1, 1, 1, 1};
+    } else if (ConstantBroadcastUp == constant) {
+        // the arm binary layers broadcast a [N, C, 1, 1] input per channel only, keep the batch 1
+        input_dims    = {1, channel, 1, 1};
+        constant_dims = {1, channel, size, size};
+    }
+
+    // clip(sigmoid(exp(c1 - hard_sigmoid(x * c0 + x))), 0.1, 0.9)
+    InputShapesMap input_shapes = {{"x", input_dims}};
+    auto interpreter            = CreateNetTestInterpreter(input_shapes, {"y"});
+    interpreter->AddLayer(LAYER_MUL, "Mul", "mul", {"x"}, {"mul_out"}, CreateBroadcastParam(1),
+                          CreateConstant(constant_dims));
+    interpreter->AddLayer(LAYER_ADD, "Add", "add", {"mul_out", "x"}, {"add_out"}, CreateBroadcastParam(1));
+    auto hard_sigmoid_param   = std::make_shared<HardSigmoidLayerParam>();
+    hard_sigmoid_param->alpha = 0.2f;
+    hard_sigmoid_param->beta  = 0.5f;
+    interpreter->AddLayer(LAYER_HARDSIGMOID, "HardSigmoid", "hard_sigmoid", {"add_out"}, {"hard_sigmoid_out"},
+                          hard_sigmoid_param);
+    interpreter->AddLayer(LAYER_SUB, "Sub", "sub", {"hard_sigmoid_out"}, {"sub_out"}, CreateBroadcastParam(0),
+                          CreateConstant({1}));
+    interpreter->AddLayer(LAYER_EXP, "Exp", "exp", {"sub_out"}, {"exp_out"}, nullptr);
+    interpreter->AddLayer(LAYER_SIGMOID, "Sigmoid", "sigmoid", {"exp_out"}, {"sigmoid_out"}, nullptr);
+    auto clip_param = std::make_shared<ClipLayerParam>();
+    clip_param->min = 0.1f;
+    clip_param->max = 0.9f;
+    interpreter->AddLayer(LAYER_CLIP, "Clip", "clip", {"sigmoid_out"}, {"y"}, clip_param);
+
+    auto optimized = interpreter->Copy();
+    Status status  = optimizer::NetOptimizerManager::Optimize(optimized->GetNetStructure(),
+                                                             optimized->GetNetResource(), device_type);
+    ASSERT_EQ((int)status, TNN_OK);
+    EXPECT_EQ(CountLayers(optimized->GetNetStructure(), LAYER_FUSED_ELEMENTWISE), 1);
+    // a constant that may grow the running value is never fused
+    bool grows = ConstantBroadcastUp == constant && DimsVectorUtils::Count(constant_dims) > 1;
+    EXPECT_EQ(CountLayers(optimized->GetNetStructure(), LAYER_MUL), grows ? 1 : 0);
+
+    NetworkConfig net_config;
+    net_config.device_type = device_type;
+    net_config.precision   = PRECISION_HIGH;
+    ModelConfig model_config;
+    auto inputs = CreateNetTestInputs(input_shapes);
+
+    DefaultNetwork unfused_network;
+    status = unfused_network.Init(net_config, model_config, interpreter.get(), input_shapes);
+    ASSERT_EQ((int)status, TNN_OK);
+    NetTestDataMap unfused_outputs;
+    status = ForwardNetwork(unfused_network, inputs, unfused_outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+
+    DefaultNetwork fused_network;
+    status = fused_network.Init(net_config, model_config, optimized.get(), input_shapes);
+    ASSERT_EQ((int)status, TNN_OK);
+    NetTestDataMap fused_outputs;
+    status = ForwardNetwork(fused_network, inputs, fused_outputs);
+    ASSERT_EQ((int)status, TNN_OK);
+
+    auto &unfused = unfused_outputs["y"];
+    auto &fused   = fused_outputs["y"];
+    ASSERT_EQ(unfused.size(), fused.size());
+    EXPECT_EQ(CompareData(unfused.data(), fused.data(), unfused.size(), 0.001), 0);
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,204 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <stdint.h>
+#include <string.h>
+
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+#include <vector>
+
+#include "tnn/core/health_monitor.h"
+#include "tnn/core/macro.h"
+#include "tnn/utils/half_utils.h"
+
+namespace TNN_NS {
+
+class HealthMonitorTest : public ::testing::TestWithParam<std::tuple<DataType, DataFormat, int>> {};
+
+INSTANTIATE_TEST_SUITE_P(NetTest, HealthMonitorTest,
+                         ::testing::Combine(testing::Values(DATA_TYPE_FLOAT, DATA_TYPE_BFP16, DATA_TYPE_HALF,
+                                                            DATA_TYPE_INT8),
+                                            testing::Values(DATA_FORMAT_NCHW, DATA_FORMAT_NC4HW4, DATA_FORMAT_NHWC4),
+                                            // channel, a multiple of 4 has no padding
+                                            testing::Values(3, 5, 8)));
+
+// offset of element (n, c, i) of the layout, i indexes the area
+static int LayoutOffset(DataFormat format, int channel, int area, int n, int c, int i) {
+    int c_r4 = ROUND_UP(channel, 4);
+    if (format == DATA_FORMAT_NC4HW4) {
+        return n * c_r4 * area + c / 4 * area * 4 + i * 4 + c % 4;
+    } else if (format == DATA_FORMAT_NHWC4) {
+        return (n * area + i) * c_r4 + c;
+    }
+    return (n * channel + c) * area + i;
+}
+
+// stores the float values as the data type, bfp16 keeps the high half of fp32
+static std::vector<char> ToDataType(std::vector<float> data, DataType data_type) {
+    std::vector<char> bytes;
+    if (data_type == DATA_TYPE_FLOAT) {
+        bytes.resize(data.size() * sizeof(float));
+        memcpy(bytes.data(), data.data(), bytes.size());
+    } else if (data_type == DATA_TYPE_BFP16) {
+        bytes.resize(data.size() * sizeof(uint16_t));
+        for (int i = 0; i < data.size(); i++) {
+            uint32_t bits;
+            memcpy(&bits, &data[i], sizeof(float));
+            uint16_t high = bits >> 16;
+            memcpy(bytes.data() + i * sizeof(uint16_t), &high, sizeof(uint16_t));
+        }
+    } else if (data_type == DATA_TYPE_HALF) {
+        // ConvertFromFloatToHalf clamps inf to the half range, nan and inf are written as bits
+        bytes.resize(data.size() * sizeof(uint16_t));
+        ConvertFromFloatToHalf(data.data(), bytes.data(), (int)data.size());
+        for (int i = 0; i < data.size(); i++) {
+            if (std::isnan(data[i]) || std::isinf(data[i])) {
+                uint16_t bits = std::isnan(data[i]) ? 0x7e00 : data[i] > 0 ? 0x7c00 : 0xfc00;
+                memcpy(bytes.data() + i * sizeof(uint16_t), &bits, sizeof(uint16_t));
+            }
+        }
+    } else {
+        bytes.resize(data.size());
+        for (int i = 0; i < data.size(); i++) {
+            bytes[i] = (int8_t)data[i];
+        }
+    }
+    return bytes;
+}
+
+// known values, nan, inf and int8 saturation in the valid elements, padding that would change every count
+TEST_P(HealthMonitorTest, CountsPerDataTypeAndLayout) {
+    DataType data_type = std::get<0>(GetParam());
+    DataFormat format  = std::get<1>(GetParam());
+    int channel        = std::get<2>(GetParam());
+    int batch = 2, height = 3, width = 2;
+    int area  = height * width;
+    int c_r4  = format == DATA_FORMAT_NCHW ? channel : ROUND_UP(channel, 4);
+    bool int8 = data_type == DATA_TYPE_INT8;
+
+    // padding: nan for the float types, saturated and far out of range for int8
+    std::vector<float> values(batch * c_r4 * area, int8 ? 127.0f : NAN);
+    double sum = 0;
+    int count  = 0;
+    for (int n = 0; n < batch; n++) {
+        for (int c = 0; c < channel; c++) {
+            for (int i = 0; i < area; i++) {
+                // integers in [-3, 3] are exact in every data type
+                float value = (float)(((n * channel + c) * area + i) % 7 - 3);
+                values[LayoutOffset(format, channel, area, n, c, i)] = value;
+                sum += value;
+                count++;
+            }
+        }
+    }
+    int nan = 0, inf = 0, saturated = 0;
+    // replace three valid elements, one of them in the last partial channel block
+    int special[3] = {LayoutOffset(format, channel, area, 0, 0, 0), LayoutOffset(format, channel, area, 1, 1, 2),
+                      LayoutOffset(format, channel, area, 1, channel - 1, area - 1)};
+    float special_values[3];
+    if (int8) {
+        special_values[0] = 127;
+        special_values[1] = -128;
+        special_values[2] = 127;
+        saturated         = 3;
+    } else {
+        special_values[0] = NAN;
+        special_values[1] = INFINITY;
+        special_values[2] = -INFINITY;
+        nan               = 1;
+        inf               = 2;
+    }
+    for (int s = 0; s < 3; s++) {
+        sum -= values[special[s]];
+        values[special[s]] = special_values[s];
+    }
+    float min = -3.0f, max = 3.0f;
+    double mean = sum / (count - 3);
+    if (int8) {
+        min  = -128.0f;
+        max  = 127.0f;
+        mean = (sum + 127 - 128 + 127) / count;
+    }
+
+    auto bytes = ToDataType(values, data_type);
+    BlobDesc desc;
+    desc.data_type   = data_type;
+    desc.data_format = format;
+    desc.dims        = {batch, channel, height, width};
+    desc.name        = "output";
+    BlobHandle handle;
+    handle.base = bytes.data();
+    Blob blob(desc, handle);
+
+    BlobHealthStats stats;
+    ASSERT_EQ((int)HealthMonitor::ComputeBlobStats(&blob, stats), TNN_OK);
+    EXPECT_EQ(stats.count, count);
+    EXPECT_EQ(stats.nan_count, nan);
+    EXPECT_EQ(stats.inf_count, inf);
+    EXPECT_EQ(stats.saturated_count, saturated);
+    EXPECT_FLOAT_EQ(stats.min, min);
+    EXPECT_FLOAT_EQ(stats.max, max);
+    EXPECT_NEAR(stats.mean, mean, 1e-5);
+
+    // the alerts the counts raise
+    HealthMonitorConfig config;
+    config.abs_max_threshold     = 2.5f;
+    config.int8_saturation_ratio = 0.01f;
+    int alerts                   = 0;
+    config.callback              = [&](const BlobHealthStats &alert_stats) { alerts |= alert_stats.alerts; };
+    HealthMonitor monitor(config);
+    ASSERT_TRUE(monitor.SampleForward());
+    monitor.CheckLayer("layer", {&blob});
+    int expected = int8 ? HEALTH_ALERT_INT8_SATURATION : HEALTH_ALERT_NAN | HEALTH_ALERT_INF | HEALTH_ALERT_OVERFLOW;
+    EXPECT_EQ(alerts, expected);
+    ASSERT_EQ((int)monitor.GetStats().size(), 1);
+    EXPECT_EQ(monitor.GetStats()[0].layer_name, "layer");
+}
+
+// a block of the vectorized float path without nan or inf, then one with both
+TEST(HealthMonitorFloatTest, LongBlobFallsBackPerBlock) {
+    int count = 4096 * 2 + 7;
+    std::vector<float> values(count);
+    double sum = 0;
+    for (int i = 0; i < count; i++) {
+        values[i] = (float)(i % 11) - 5;
+        sum += values[i];
+    }
+    sum -= values[5000] + values[count - 1];
+    values[5000]      = NAN;
+    values[count - 1] = INFINITY;
+
+    BlobDesc desc;
+    desc.data_type   = DATA_TYPE_FLOAT;
+    desc.data_format = DATA_FORMAT_NCHW;
+    desc.dims        = {1, count, 1, 1};
+    BlobHandle handle;
+    handle.base = values.data();
+    Blob blob(desc, handle);
+
+    BlobHealthStats stats;
+    ASSERT_EQ((int)HealthMonitor::ComputeBlobStats(&blob, stats), TNN_OK);
+    EXPECT_EQ(stats.count, count);
+    EXPECT_EQ(stats.nan_count, 1);
+    EXPECT_EQ(stats.inf_count, 1);
+    EXPECT_FLOAT_EQ(stats.min, -5.0f);
+    EXPECT_FLOAT_EQ(stats.max, 5.0f);
+    EXPECT_NEAR(stats.mean, sum / (count - 2), 1e-5);
+}
+
+}  // namespace TNN_NS
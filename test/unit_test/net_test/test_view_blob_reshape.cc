@@ -0,0 +1,130 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "test/flags.h"
+#include "test/test_utils.h"
+#include "test/unit_test/net_test/net_test_utils.h"
+#include "tnn/optimizer/net_optimizer_compose_permute.h"
+
+namespace TNN_NS {
+
+// y = relu(x) permuted by the orders, the permute output is computed here
+static std::vector<float> PermuteReluReference(const std::vector<float> &x, DimsVector dims,
+                                               const std::vector<int> &orders) {
+    DimsVector output_dims(4);
+    for (int i = 0; i < 4; i++) {
+        output_dims[i] = dims[orders[i]];
+    }
+    std::vector<float> y(x.size());
+    std::vector<int> index(4);
+    for (int i = 0; i < (int)y.size(); i++) {
+        // index of y[i] in the output dims
+        for (int d = 3, rest = i; d >= 0; d--) {
+            index[d] = rest % output_dims[d];
+            rest /= output_dims[d];
+        }
+        int src = 0;
+        for (int d = 0; d < 4; d++) {
+            int input_index = 0;
+            for (int o = 0; o < 4; o++) {
+                input_index = orders[o] == d ? index[o] : input_index;
+            }
+            src = src * dims[d] + input_index;
+        }
+        y[i] = std::max(x[src], 0.0f);
+    }
+    return y;
+}
+
+// forwards the network at each of the dims and checks y = relu(x) permuted by the orders
+static void ExpectPermuteReluAfterReshape(DefaultModelInterpreter *interpreter, const std::vector<int> &orders,
+                                          const std::vector<DimsVector> &dims_list) {
+    NetworkConfig net_config;
+    net_config.device_type = ConvertDeviceType(FLAGS_dt);
+    net_config.precision   = PRECISION_HIGH;
+    ModelConfig model_config;
+
+    DefaultNetwork network;
+    Status status = network.Init(net_config, model_config, interpreter, {{"x", dims_list[0]}});
+    ASSERT_EQ((int)status, TNN_OK);
+
+    for (auto dims : dims_list) {
+        InputShapesMap shapes = {{"x", dims}};
+        status                = network.Reshape(shapes);
+        ASSERT_EQ((int)status, TNN_OK);
+
+        auto inputs = CreateNetTestInputs(shapes);
+        NetTestDataMap outputs;
+        status = ForwardNetwork(network, inputs, outputs);
+        ASSERT_EQ((int)status, TNN_OK);
+
+        auto expected = PermuteReluReference(inputs["x"], dims, orders);
+        ASSERT_EQ(outputs["y"].size(), expected.size());
+        EXPECT_EQ(CompareData(expected.data(), outputs["y"].data(), expected.size(), 0.001), 0);
+    }
+}
+
+static std::shared_ptr<NetTestInterpreter> CreatePermuteRelu(DimsVector dims, std::vector<std::vector<int>> orders) {
+    auto interpreter = CreateNetTestInterpreter({{"x", dims}}, {"y"});
+    interpreter->AddLayer(LAYER_RELU, "ReLU", "relu", {"x"}, {"relu_out"}, nullptr);
+    for (int i = 0; i < orders.size(); i++) {
+        auto permute_param    = std::make_shared<PermuteLayerParam>();
+        permute_param->orders = orders[i];
+        std::string input     = i == 0 ? "relu_out" : "permute_out" + std::to_string(i - 1);
+        std::string output    = i + 1 == orders.size() ? "y" : "permute_out" + std::to_string(i);
+        interpreter->AddLayer(LAYER_PERMUTE, "Permute", "permute" + std::to_string(i), {input}, {output},
+                              permute_param);
+    }
+    return interpreter;
+}
+
+class ViewBlobReshapeTest : public ::testing::TestWithParam<int> {};
+
+INSTANTIATE_TEST_SUITE_P(NetTest, ViewBlobReshapeTest, ::testing::Values(1, 3, 8));
+
+// the permute swaps a dim of 1 at Init and shares the memory of its input,
+// after reshape the dim is not 1 anymore and the permute has to copy the data
+TEST_P(ViewBlobReshapeTest, ViewBecomesCopyAfterReshape) {
+    int channel      = GetParam();
+    auto interpreter = CreatePermuteRelu({1, channel, 1, 8}, {{0, 1, 3, 2}});
+    ExpectPermuteReluAfterReshape(interpreter.get(), {0, 1, 3, 2}, {{1, channel, 1, 8}, {1, channel, 2, 4}});
+}
+
+// the memory of the detached output must hold a later reshape back up to the dims of Init
+TEST_P(ViewBlobReshapeTest, ReshapeUpAfterDetach) {
+    int channel      = GetParam();
+    auto interpreter = CreatePermuteRelu({1, channel, 1, 16}, {{0, 1, 3, 2}});
+    ExpectPermuteReluAfterReshape(interpreter.get(), {0, 1, 3, 2},
+                                  {{1, channel, 1, 16}, {1, channel, 2, 4}, {1, channel, 2, 8}, {1, channel, 4, 4}});
+}
+
+// two permutes composed by NetOptimizerComposePermute into a view, detached and grown by reshape
+TEST_P(ViewBlobReshapeTest, ComposedPermuteAfterReshape) {
+    int channel      = GetParam();
+    auto interpreter = CreatePermuteRelu({1, 1, 4, 16 * channel}, {{0, 2, 1, 3}, {0, 1, 3, 2}});
+    auto optimized   = interpreter->Copy();
+    optimizer::NetOptimizerComposePermute optimizer;
+    Status status = optimizer.Optimize(optimized->GetNetStructure(), optimized->GetNetResource());
+    ASSERT_EQ((int)status, TNN_OK);
+    ASSERT_EQ(optimized->GetNetStructure()->layers.size(), 2);
+
+    ExpectPermuteReluAfterReshape(optimized.get(), {0, 2, 3, 1},
+                                  {{1, 1, 4, 16 * channel}, {1, 2, 4, 4 * channel}, {1, 2, 4, 8 * channel}});
+}
+
+}  // namespace TNN_NS
@@ -0,0 +1,169 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <fstream>
+#include <sstream>
+
+#include "model_cost_analyzer.h"
+#include "tnn/core/common.h"
+#include "tnn/utils/split_utils.h"
+
+using namespace TNN_NS;
+
+DeviceType ConvertDeviceType(std::string device_type) {
+    if ("ARM" == device_type) {
+        return DEVICE_ARM;
+    } else if ("OPENCL" == device_type) {
+        return DEVICE_OPENCL;
+    } else if ("METAL" == device_type) {
+        return DEVICE_METAL;
+    } else if ("CUDA" == device_type) {
+        return DEVICE_CUDA;
+    } else {
+        return DEVICE_NAIVE;
+    }
+}
+
+bool ReadFile(std::string file_name, std::string& content) {
+    std::ifstream stream(file_name, std::ios::binary);
+    if (!stream.is_open() || !stream.good()) {
+        printf("read %s failed!\n", file_name.c_str());
+        return false;
+    }
+    content = std::string((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// input shapes in the format of name[n,c,h,w];name[n,c,h,w]
+bool ParseInputShapes(std::string input_shapes_str, InputShapesMap& input_shapes) {
+    std::vector<std::string> shape_strs;
+    SplitUtils::SplitStr(input_shapes_str.c_str(), shape_strs, ";");
+    for (auto shape_str : shape_strs) {
+        int begin = shape_str.find('[');
+        int end   = shape_str.find(']');
+        if (begin == std::string::npos || end == std::string::npos || end < begin) {
+            return false;
+        }
+        std::vector<std::string> dim_strs;
+        SplitUtils::SplitStr(shape_str.substr(begin + 1, end - begin - 1).c_str(), dim_strs, ",");
+        DimsVector dims;
+        for (auto dim_str : dim_strs) {
+            dims.push_back(atoi(dim_str.c_str()));
+        }
+        input_shapes[shape_str.substr(0, begin)] = dims;
+    }
+    return true;
+}
+
+void PrintConfig() {
+    printf(
+        "usage:\n./model_cost [-h] [-p] [-m] [-d] [-s] [-j]\n"
+        "\t-h, --help     \t show this message\n"
+        "\t-p, --proto    \t(require) tnn proto file path\n"
+        "\t-m, --model    \t(optional) tnn model file path, random weights are used if not set\n"
+        "\t-d, --device   \t(optional) the device to plan memory for, ie, NAIVE, ARM, OPENCL, default NAIVE\n"
+        "\t-s, --shape    \t(optional) input shapes, ie, name[1,3,224,224];name2[1,1,8,8]\n"
+        "\t-j, --json     \t(optional) write the json report to the path\n");
+}
+
+int main(int argc, char* argv[]) {
+    std::string proto_file_name;
+    std::string model_file_name;
+    std::string json_file_name;
+    InputShapesMap input_shapes;
+
+    NetworkConfig net_config;
+    net_config.device_type = DEVICE_NAIVE;
+    ModelConfig model_config;
+    model_config.model_type = MODEL_TYPE_TNN;
+
+    struct option long_options[] = {{"proto", required_argument, 0, 'p'}, {"model", required_argument, 0, 'm'},
+                                    {"device", required_argument, 0, 'd'}, {"shape", required_argument, 0, 's'},
+                                    {"json", required_argument, 0, 'j'},   {"help", no_argument, 0, 'h'},
+                                    {0, 0, 0, 0}};
+
+    const char* optstring = "p:m:d:s:j:h";
+
+    if (argc == 1) {
+        PrintConfig();
+        return 0;
+    }
+
+    while (1) {
+        int c = getopt_long(argc, argv, optstring, long_options, nullptr);
+        if (c == -1)
+            break;
+
+        switch (c) {
+            case 'p':
+                proto_file_name = optarg;
+                break;
+            case 'm':
+                model_file_name = optarg;
+                break;
+            case 'd':
+                net_config.device_type = ConvertDeviceType(optarg);
+                break;
+            case 's':
+                if (!ParseInputShapes(optarg, input_shapes)) {
+                    printf("invalid input shapes: %s\n", optarg);
+                    return -1;
+                }
+                break;
+            case 'j':
+                json_file_name = optarg;
+                break;
+            case 'h':
+            case '?':
+                PrintConfig();
+                return 0;
+            default:
+                PrintConfig();
+                break;
+        }
+    }
+
+    std::string proto_content, model_content;
+    if (!ReadFile(proto_file_name, proto_content)) {
+        return -1;
+    }
+    if (!model_file_name.empty() && !ReadFile(model_file_name, model_content)) {
+        return -1;
+    }
+    model_config.params = {proto_content, model_content};
+
+    ModelCostAnalyzer analyzer;
+    Status status = analyzer.Init(model_config, input_shapes);
+    if (status != TNN_OK) {
+        printf("model cost analyzer init failed: %s\n", status.description().c_str());
+        return -1;
+    }
+    status = analyzer.Analyze(net_config);
+    if (status != TNN_OK) {
+        printf("model cost analyze failed: %s\n", status.description().c_str());
+        return -1;
+    }
+
+    printf("%s", analyzer.GetTextReport().c_str());
+    if (!json_file_name.empty()) {
+        std::ofstream json_stream(json_file_name);
+        json_stream << analyzer.GetJsonReport();
+        printf("json report: %s\n", json_file_name.c_str());
+    }
+    return 0;
+}
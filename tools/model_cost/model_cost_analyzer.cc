@@ -0,0 +1,268 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#include "model_cost_analyzer.h"
+
+#include <stdio.h>
+
+#include <iomanip>
+#include <sstream>
+
+#include "tnn/core/blob.h"
+#include "tnn/core/instance.h"
+#include "tnn/core/layer_type.h"
+#include "tnn/core/macro.h"
+#include "tnn/core/tnn.h"
+#include "tnn/interpreter/default_model_interpreter.h"
+#include "tnn/interpreter/layer_resource_generator.h"
+#include "tnn/layer/base_layer.h"
+#include "tnn/utils/data_type_utils.h"
+#include "tnn/utils/dims_vector_utils.h"
+#include "tnn/utils/layer_cost_utils.h"
+
+#ifdef TNN_ARM_ENABLE
+#include "tnn/device/arm/acc/convolution/arm_conv_layer_acc.h"
+#endif
+
+namespace TNN_NS {
+
+static std::string DimsToString(const std::vector<DimsVector>& dims_list) {
+    std::ostringstream ostr;
+    for (int i = 0; i < dims_list.size(); i++) {
+        ostr << (i > 0 ? ";" : "");
+        for (int j = 0; j < dims_list[i].size(); j++) {
+            ostr << (j > 0 ? "x" : "") << dims_list[i][j];
+        }
+    }
+    return ostr.str();
+}
+
+static std::string DimsToJson(const std::vector<DimsVector>& dims_list) {
+    std::ostringstream ostr;
+    ostr << "[";
+    for (int i = 0; i < dims_list.size(); i++) {
+        ostr << (i > 0 ? "," : "") << "[";
+        for (int j = 0; j < dims_list[i].size(); j++) {
+            ostr << (j > 0 ? "," : "") << dims_list[i][j];
+        }
+        ostr << "]";
+    }
+    ostr << "]";
+    return ostr.str();
+}
+
+ModelCostAnalyzer::ModelCostAnalyzer() {}
+
+ModelCostAnalyzer::~ModelCostAnalyzer() {
+    generated_resources_.clear();
+    interpreter_.reset();
+}
+
+Status ModelCostAnalyzer::Init(ModelConfig& model_config, InputShapesMap inputs_shape) {
+    model_config_ = model_config;
+    inputs_shape_ = inputs_shape;
+
+    interpreter_.reset(CreateModelInterpreter(model_config.model_type));
+    if (!interpreter_) {
+        LOGE("model type %d is not supported\n", (int)model_config.model_type);
+        return Status(TNNERR_NET_ERR, "model type is not supported");
+    }
+    return interpreter_->Interpret(model_config.params);
+}
+
+Status ModelCostAnalyzer::Analyze(NetworkConfig& net_config) {
+    Status status = InferLayerCosts();
+    if (status != TNN_OK) {
+        return status;
+    }
+    return PlanMemory(net_config);
+}
+
+/*
+ * Walk the layers in order, infer the output shapes with BaseLayer::InferShapeAhead
+ * and compute the cost of each layer from the inferred shapes.
+ */
+Status ModelCostAnalyzer::InferLayerCosts() {
+    auto default_interpreter = dynamic_cast<DefaultModelInterpreter*>(interpreter_.get());
+    if (!default_interpreter) {
+        return Status(TNNERR_NET_ERR, "interpreter is not a default model interpreter");
+    }
+    NetStructure* net_structure = default_interpreter->GetNetStructure();
+    NetResource* net_resource   = default_interpreter->GetNetResource();
+
+    std::map<std::string, std::shared_ptr<Blob>> blobs;
+    for (auto iter : net_structure->inputs_shape_map) {
+        BlobDesc desc;
+        desc.device_type = DEVICE_NAIVE;
+        desc.data_type   = DATA_TYPE_FLOAT;
+        desc.data_format = DATA_FORMAT_NCHW;
+        desc.dims        = iter.second;
+        if (inputs_shape_.count(iter.first) > 0) {
+            desc.dims = inputs_shape_[iter.first];
+        }
+        desc.name         = iter.first;
+        blobs[iter.first] = std::make_shared<Blob>(desc);
+    }
+
+    layer_costs_.clear();
+    for (auto layer_info : net_structure->layers) {
+        std::shared_ptr<BaseLayer> layer(CreateLayer(layer_info->type));
+        if (!layer) {
+            LOGE("layer %s of type %s is not supported\n", layer_info->name.c_str(), layer_info->type_str.c_str());
+            return Status(TNNERR_LAYER_ERR, "layer type is not supported");
+        }
+
+        std::vector<Blob*> inputs;
+        for (auto name : layer_info->inputs) {
+            if (blobs.count(name) == 0) {
+                LOGE("input blob %s of layer %s is not produced\n", name.c_str(), layer_info->name.c_str());
+                return Status(TNNERR_LAYER_ERR, "input blob is not produced");
+            }
+            inputs.push_back(blobs[name].get());
+        }
+        // outputs of quantized layers and int8 reformats are int8 blobs, as in DefaultNetwork
+        bool is_int8_output =
+            layer_info->param->quantized ||
+            (layer_info->type == LAYER_REFORMAT &&
+             dynamic_cast<ReformatLayerParam*>(layer_info->param.get())->dst_type == DATA_TYPE_INT8);
+        std::vector<Blob*> outputs;
+        for (auto name : layer_info->outputs) {
+            BlobDesc desc  = inputs.empty() ? BlobDesc() : inputs[0]->GetBlobDesc();
+            desc.name      = name;
+            desc.data_type = is_int8_output ? DATA_TYPE_INT8 : DATA_TYPE_FLOAT;
+            blobs[name]    = std::make_shared<Blob>(desc);
+            outputs.push_back(blobs[name].get());
+        }
+
+        LayerParam* param       = layer_info->param.get();
+        LayerResource* resource = nullptr;
+        if (net_resource->resource_map.count(layer_info->name) > 0) {
+            resource = net_resource->resource_map[layer_info->name].get();
+        } else {
+            GenerateRandomResource(layer_info->type, param, &resource, inputs);
+            generated_resources_[layer_info->name] = std::shared_ptr<LayerResource>(resource);
+        }
+
+        Status status = layer->InferShapeAhead(inputs, outputs, param, resource);
+        if (status != TNN_OK) {
+            LOGE("infer shape of layer %s failed\n", layer_info->name.c_str());
+            return status;
+        }
+
+        LayerCostInfo cost;
+        cost.name = layer_info->name;
+        cost.type = layer_info->type_str;
+        for (auto blob : inputs) {
+            cost.input_dims.push_back(blob->GetBlobDesc().dims);
+        }
+        for (auto blob : outputs) {
+            cost.output_dims.push_back(blob->GetBlobDesc().dims);
+            auto& desc = blob->GetBlobDesc();
+            cost.activation_bytes += DimsVectorUtils::Count(desc.dims) * DataTypeUtils::GetBytesSize(desc.data_type);
+        }
+        cost.mmacs       = GetLayerMacs(layer_info->type, param, cost.input_dims, cost.output_dims);
+        cost.mflops      = GetLayerFlops(layer_info->type, param, resource, cost.input_dims, cost.output_dims);
+        cost.param_bytes = GetLayerResourceBytes(resource);
+
+        if (layer_info->type == LAYER_CONVOLUTION && !param->quantized) {
+#ifdef TNN_ARM_ENABLE
+            cost.arm_conv_impl =
+                ArmConvLayerAcc::GetImpFPName(dynamic_cast<ConvLayerParam*>(param), inputs, outputs);
+#else
+            cost.arm_conv_impl = "unknown (arm not built)";
+#endif
+        }
+        layer_costs_.push_back(cost);
+    }
+    return TNN_OK;
+}
+
+/*
+ * Create an instance on the target device, the blob memory planner reports the
+ * memory it reserves for all blobs of a forward.
+ */
+Status ModelCostAnalyzer::PlanMemory(NetworkConfig& net_config) {
+    TNN tnn;
+    Status status = tnn.Init(model_config_);
+    if (status != TNN_OK) {
+        LOGE("tnn init failed: %s\n", status.description().c_str());
+        return status;
+    }
+    auto instance = tnn.CreateInst(net_config, status, inputs_shape_);
+    if (status != TNN_OK || !instance) {
+        LOGE("create instance failed: %s\n", status.description().c_str());
+        return status;
+    }
+    return instance->GetForwardMemorySize(planned_memory_bytes_);
+}
+
+std::string ModelCostAnalyzer::GetTextReport() {
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(3);
+    ostr << std::left << std::setw(40) << "layer" << std::setw(20) << "type" << std::setw(24) << "output"
+         << std::right << std::setw(12) << "MMACs" << std::setw(12) << "MFLOPs" << std::setw(12) << "param KB"
+         << std::setw(12) << "act KB"
+         << "  arm conv impl\n";
+
+    double total_mmacs = 0, total_mflops = 0, total_param_bytes = 0, total_activation_bytes = 0;
+    for (auto& cost : layer_costs_) {
+        ostr << std::left << std::setw(40) << cost.name << std::setw(20) << cost.type << std::setw(24)
+             << DimsToString(cost.output_dims) << std::right << std::setw(12) << cost.mmacs << std::setw(12)
+             << cost.mflops << std::setw(12) << cost.param_bytes / 1024.0 << std::setw(12)
+             << cost.activation_bytes / 1024.0 << "  " << cost.arm_conv_impl << "\n";
+        total_mmacs += cost.mmacs;
+        total_mflops += cost.mflops;
+        total_param_bytes += cost.param_bytes;
+        total_activation_bytes += cost.activation_bytes;
+    }
+
+    ostr << "\nlayers:               " << layer_costs_.size() << "\n";
+    ostr << "total MMACs:          " << total_mmacs << "\n";
+    ostr << "total MFLOPs:         " << total_mflops << "\n";
+    ostr << "param MB:             " << total_param_bytes / 1024.0 / 1024.0 << "\n";
+    ostr << "activation MB:        " << total_activation_bytes / 1024.0 / 1024.0 << "\n";
+    ostr << "planned memory MB:    " << planned_memory_bytes_ / 1024.0 / 1024.0 << "\n";
+    return ostr.str();
+}
+
+std::string ModelCostAnalyzer::GetJsonReport() {
+    std::ostringstream ostr;
+    ostr << std::fixed << std::setprecision(6);
+    ostr << "{\"layers\":[";
+
+    double total_mmacs = 0, total_mflops = 0, total_param_bytes = 0, total_activation_bytes = 0;
+    for (int i = 0; i < layer_costs_.size(); i++) {
+        auto& cost = layer_costs_[i];
+        ostr << (i > 0 ? ",\n" : "\n") << "{\"layer\":\"" << cost.name << "\",\"op\":\"" << cost.type
+             << "\",\"input_dims\":" << DimsToJson(cost.input_dims)
+             << ",\"output_dims\":" << DimsToJson(cost.output_dims) << ",\"mmacs\":" << cost.mmacs
+             << ",\"mflops\":" << cost.mflops << ",\"param_bytes\":" << (long long)cost.param_bytes
+             << ",\"activation_bytes\":" << (long long)cost.activation_bytes;
+        if (!cost.arm_conv_impl.empty()) {
+            ostr << ",\"arm_conv_impl\":\"" << cost.arm_conv_impl << "\"";
+        }
+        ostr << "}";
+        total_mmacs += cost.mmacs;
+        total_mflops += cost.mflops;
+        total_param_bytes += cost.param_bytes;
+        total_activation_bytes += cost.activation_bytes;
+    }
+    ostr << "\n],\"total\":{\"layers\":" << layer_costs_.size() << ",\"mmacs\":" << total_mmacs
+         << ",\"mflops\":" << total_mflops << ",\"param_bytes\":" << (long long)total_param_bytes
+         << ",\"activation_bytes\":" << (long long)total_activation_bytes
+         << ",\"planned_memory_bytes\":" << planned_memory_bytes_ << "}}\n";
+    return ostr.str();
+}
+
+}  // namespace TNN_NS
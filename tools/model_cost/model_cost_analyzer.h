@@ -0,0 +1,84 @@
+// Tencent is pleased to support the open source community by making TNN available.
+//
+// Copyright (C) 2020 THL A29 Limited, a Tencent company. All rights reserved.
+//
+// Licensed under the BSD 3-Clause License (the "License"); you may not use this file except
+// in compliance with the License. You may obtain a copy of the License at
+//
+// https://opensource.org/licenses/BSD-3-Clause
+//
+// Unless required by applicable law or agreed to in writing, software distributed
+// under the License is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+#ifndef TNN_TOOLS_MODEL_COST_MODEL_COST_ANALYZER_H_
+#define TNN_TOOLS_MODEL_COST_MODEL_COST_ANALYZER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tnn/core/blob.h"
+#include "tnn/core/common.h"
+#include "tnn/core/status.h"
+#include "tnn/interpreter/abstract_model_interpreter.h"
+#include "tnn/interpreter/layer_resource.h"
+
+namespace TNN_NS {
+
+struct LayerCostInfo {
+    std::string name;
+    std::string type;
+    std::vector<DimsVector> input_dims;
+    std::vector<DimsVector> output_dims;
+    // mega multiply-accumulates
+    double mmacs = 0;
+    // mega flops
+    double mflops = 0;
+    // bytes of the weights
+    double param_bytes = 0;
+    // bytes of the float outputs
+    double activation_bytes = 0;
+    // fp conv implementation chosen by ArmConvLayerAcc::GetImpFP, empty for other layers
+    std::string arm_conv_impl;
+};
+
+class ModelCostAnalyzer {
+public:
+    // @brief ModelCostAnalyzer Constructor
+    ModelCostAnalyzer();
+
+    // @brief ModelCostAnalyzer virtual Destructor
+    virtual ~ModelCostAnalyzer();
+
+public:
+    // @brief interpret the model, weights are generated if the model content is empty
+    // @param inputs_shape modify input shape, if empty, it will use the shape in proto
+    Status Init(ModelConfig& model_config, InputShapesMap inputs_shape = InputShapesMap());
+
+    // @brief infer the shape and cost of each layer, then plan the blob memory on the device of net_config
+    Status Analyze(NetworkConfig& net_config);
+
+    // @brief human readable report
+    std::string GetTextReport();
+
+    // @brief json report
+    std::string GetJsonReport();
+
+private:
+    Status InferLayerCosts();
+    Status PlanMemory(NetworkConfig& net_config);
+
+    ModelConfig model_config_;
+    InputShapesMap inputs_shape_;
+    std::shared_ptr<AbstractModelInterpreter> interpreter_;
+    std::map<std::string, std::shared_ptr<LayerResource>> generated_resources_;
+
+    std::vector<LayerCostInfo> layer_costs_;
+    int planned_memory_bytes_ = 0;
+};
+
+}  // namespace TNN_NS
+
+#endif  // TNN_TOOLS_MODEL_COST_MODEL_COST_ANALYZER_H_
@@ -20,6 +20,7 @@
 #include "file_reader.h"
 #include "tnn/interpreter/tnn/objseri.h"
 #include "tnn/interpreter/tnn/model_packer.h"
+#include "tnn/optimizer/net_optimizer_manager.h"
 #include "tnn/utils/dims_vector_utils.h"
 
 namespace TNN_NS {
@@ -122,6 +123,13 @@ Status Calibration::Init(NetworkConfig& net_config, ModelConfig& model_config,
         return TNNERR_INVALID_MODEL;
     }
 
+    // calibrate and save the network the instance runs, optimized for the device
+    interpreter_ = optimizer::NetOptimizerManager::Optimize(interpreter_, net_config.device_type, status);
+    if (status != TNN_OK) {
+        LOGE("optimize the model falied!\n");
+        return TNNERR_INVALID_MODEL;
+    }
+
     instance_ = std::make_shared<Instance>(net_config, model_config);
     status    = instance_->Init(
         std::static_pointer_cast<AbstractModelInterpreter>(interpreter_),